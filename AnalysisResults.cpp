@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * 分析结果实现
+ *
+ * 查找任务的输出文件并读取其摘要；供MainWindow和无界面批处理模式共用
+ * （见AnalysisResults.h）。
+ ******************************************************************************/
+
+#include "AnalysisResults.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <algorithm>
+
+/******************************************************************************
+ * 输出文件
+ *
+ * 输出目录：工作进程报告的数据文件所在目录（没有报告时为任务的输出目录）。
+ * 工作进程没有报告的文件使用输出目录中的默认文件名。
+ ******************************************************************************/
+AnalysisResults AnalysisResults::locate(const AnalysisJob &job)
+{
+    AnalysisResults results;
+    results.outputDir = job.outputDir;
+    const QString dataPath = job.outputs.value("data").toString();
+    if (!dataPath.isEmpty()) {
+        results.outputDir = QFileInfo(dataPath).absolutePath();
+    }
+    const QDir dir(results.outputDir);
+
+    auto reported = [&job, &dir](const char *key, const QString &fileName) {
+        const QString path = job.outputs.value(key).toString();
+        return path.isEmpty() ? dir.absoluteFilePath(fileName) : path;
+    };
+
+    results.summaryCsvPath = dir.absoluteFilePath("data_output.csv");
+    results.summaryJsonPath = dir.absoluteFilePath("data_output.json");
+    results.frameDataPath = reported("frame_data", "frame_data.csv");
+    results.telemetryPath = reported("telemetry", "tracks.ftrk");
+    results.performancePath = reported("performance", "performance.json");
+
+    // 标注视频：编码器为"none"时不渲染
+    results.videoPath = job.outputs.value("video").toString();
+    if (results.videoPath.isEmpty() && job.videoCodec != "none") {
+        const QString extension = (job.videoCodec == "xvid" || job.videoCodec == "mjpg") ? "avi" : "mp4";
+        results.videoPath = dir.absoluteFilePath("output_video." + extension);
+    }
+    return results;
+}
+
+QJsonObject AnalysisResults::readJson(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+/******************************************************************************
+ * 控球摘要
+ *
+ * 从data_output.json读取Python端PossessionStats导出的数据：
+ * - 各球队控球百分比
+ * - 控球帧数最多的三名球员
+ *
+ * 没有控球数据时返回空字符串。
+ ******************************************************************************/
+QString AnalysisResults::possessionSummaryText(const QJsonObject &root)
+{
+    const QJsonObject summary = root["summary"].toObject();
+    QStringList lines;
+    for (int team = 1; team <= 2; ++team) {
+        const QString key = QString("team_%1_possession_percent").arg(team);
+        if (summary.contains(key)) {
+            lines << QString("Team %1 Possession: %2%").arg(team)
+                         .arg(summary[key].toDouble(), 0, 'f', 2);
+        }
+    }
+
+    // 球员控球排名（按控球帧数）
+    struct PlayerPossession { QString team; QString id; int frames; double percent; };
+    QList<PlayerPossession> players;
+    for (const QString &key : root.keys()) {
+        if (key == "summary") {
+            continue;
+        }
+        const QJsonObject teamData = root[key].toObject();
+        for (const QString &playerId : teamData.keys()) {
+            const QJsonObject playerData = teamData[playerId].toObject();
+            const int frames = playerData["possession_frames"].toInt();
+            if (frames > 0) {
+                players.append({key, playerId, frames, playerData["possession_percent"].toDouble()});
+            }
+        }
+    }
+    std::sort(players.begin(), players.end(), [](const PlayerPossession &a, const PlayerPossession &b) {
+        return a.frames > b.frames;
+    });
+
+    if (!players.isEmpty()) {
+        lines << QString() << "Most time on the ball:";
+        for (int i = 0; i < players.size() && i < 3; ++i) {
+            lines << QString("  Player %1 (%2): %3 frames, %4%")
+                         .arg(players[i].id, players[i].team)
+                         .arg(players[i].frames)
+                         .arg(players[i].percent, 0, 'f', 2);
+        }
+    }
+
+    return lines.join("\n");
+}
+
+/******************************************************************************
+ * 批处理摘要
+ *
+ * 各球队控球百分比（没有时省略）和每队球员数。
+ ******************************************************************************/
+QJsonObject AnalysisResults::possessionSummary(const QJsonObject &root)
+{
+    QJsonObject result;
+    const QJsonObject summary = root["summary"].toObject();
+    for (int team = 1; team <= 2; ++team) {
+        const QString key = QString("team_%1_possession_percent").arg(team);
+        if (summary.contains(key)) {
+            result[key] = summary[key].toDouble();
+        }
+        const QString teamKey = QString("team_%1").arg(team);
+        if (root.contains(teamKey)) {
+            result[teamKey + "_players"] = root[teamKey].toObject().size();
+        }
+    }
+    return result;
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * ANALYSIS RESULTS HEADER
+ *
+ * This header defines AnalysisResults, the output files of a finished
+ * analysis job and the summaries read from them.
+ *
+ * WHY:
+ * The GUI (MainWindow::loadJobResults) and the headless batch mode
+ * (BatchRunner) both need to find a job's files, whether reported by the
+ * worker or at their default names in the output directory, and to
+ * summarize data_output.json. This class holds that logic without
+ * depending on Qt Widgets, so the batch mode runs on QCoreApplication.
+ *
+ * FILES (see README "Output Files"):
+ * - data_output.csv / data_output.json: player summary
+ * - frame_data.csv: one row per player per frame
+ * - output_video.mp4 (.avi for XVID/MJPG): annotated video, not rendered
+ *   with codec "none"
+ * - tracks.ftrk: track telemetry
+ * - performance.json: per-stage timings
+ ******************************************************************************/
+
+#ifndef ANALYSISRESULTS_H
+#define ANALYSISRESULTS_H
+
+#include <QString>
+#include <QJsonObject>
+#include "AnalysisScheduler.h"
+
+/**
+ * @struct AnalysisResults
+ * @brief Output file paths of a job and readers for their summaries
+ */
+struct AnalysisResults
+{
+    QString outputDir;          // Directory the job wrote its data files to
+    QString summaryCsvPath;     // data_output.csv
+    QString summaryJsonPath;    // data_output.json
+    QString frameDataPath;      // frame_data.csv
+    QString videoPath;          // Annotated video (empty if the job did not render one)
+    QString telemetryPath;      // tracks.ftrk
+    QString performancePath;    // performance.json
+
+    // Paths reported by the worker, or the default names in the job's output directory
+    static AnalysisResults locate(const AnalysisJob &job);
+
+    static QJsonObject readJson(const QString &path);          // Empty object if missing or invalid
+    static QString possessionSummaryText(const QJsonObject &root);  // Team/player possession of data_output.json
+    static QJsonObject possessionSummary(const QJsonObject &root);   // Team possession and player count
+};
+
+#endif // ANALYSISRESULTS_H
@@ -0,0 +1,662 @@
+/*******************************************************************************
+ * 分析任务调度器实现
+ *
+ * 维护分析任务队列，并把任务分派给常驻Python工作进程池：
+ * - 并发任务数根据CPU核心数和可用内存计算（可手动覆盖）
+ * - 每个任务获得明确的线程预算（核心数 / 并发任务数）
+ * - 每个任务写入自己的输出目录
+ * - 工作进程在任务之间保持运行，模型只加载一次
+ ******************************************************************************/
+
+#include "AnalysisScheduler.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/sysctl.h>
+#endif
+
+// 每个任务的内存估计（MB）：Python + torch + YOLO模型 + 流式模式的帧缓冲
+static const qint64 kMemoryPerJobMB = 1536;
+// 为GUI和系统保留的内存（MB）
+static const qint64 kReservedMemoryMB = 1024;
+// 每个任务至少使用的线程数；低于此值时并行不再划算
+static const int kMinThreadsPerJob = 2;
+
+QString AnalysisJob::statusText(Status status)
+{
+    switch (status) {
+    case Queued:    return "Queued";
+    case Running:   return "Running";
+    case Succeeded: return "Done";
+    case Failed:    return "Failed";
+    case Cancelled: return "Cancelled";
+    }
+    return QString();
+}
+
+/******************************************************************************
+ * 构造函数
+ *
+ * 使用本机的推荐资源计划；工作进程在分派第一个任务时才启动。
+ ******************************************************************************/
+AnalysisScheduler::AnalysisScheduler(const QString &workingDirectory, QObject *parent)
+    : QObject(parent)
+    , workingDirectory(workingDirectory)
+    , plan(recommendedPlan())
+    , codec("h264")
+    , backend("ultralytics")
+    , int8(false)
+    , paused(false)
+    , nextJobNumber(1)
+{
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    shutdown();
+}
+
+/******************************************************************************
+ * 位置：项目根路径
+ *
+ * 通过从可执行文件位置向上搜索来定位项目根目录。
+ * 项目根目录通过同时存在FootAnalysisGUI.pro和foot-Function目录来识别。
+ *
+ * 这使应用程序能够正确工作，无论可执行文件位于何处
+ * （构建目录、安装位置等）。
+ *
+ * 返回：项目根目录的绝对路径
+ ******************************************************************************/
+QString AnalysisScheduler::projectRootPath()
+{
+    // 获取包含可执行文件的目录
+    QString exeDir = QCoreApplication::applicationDirPath();
+
+    // 向上搜索项目根目录（FootAnalysisGUI.pro和foot-Function所在位置）
+    QDir dir(exeDir);
+    int maxLevelsUp = 5;  // 向上搜索的最大层级数
+
+    for (int i = 0; i < maxLevelsUp; ++i) {
+        // 检查foot-Function目录是否存在于此处
+        if (dir.exists("foot-Function") && dir.exists("FootAnalysisGUI.pro")) {
+            qDebug() << "Found project root at:" << dir.absolutePath();
+            return dir.absolutePath();
+        }
+
+        // 向上移动一级
+        if (!dir.cdUp()) {
+            break;  // 已到达文件系统根目录
+        }
+    }
+
+    // 备用方案：假设foot-Function与可执行文件在同一目录
+    // 这处理可执行文件从项目根目录运行的情况
+    qDebug() << "Could not find project root, using exe directory:" << exeDir;
+    return exeDir;
+}
+
+QString AnalysisScheduler::workerScriptPath() const
+{
+    return QDir(workingDirectory).absoluteFilePath("worker.py");
+}
+
+/******************************************************************************
+ * 资源计划
+ *
+ * 并发任务数 = min(核心数 / 每任务最少线程数, (可用内存 - 保留) / 每任务内存)，
+ * 至少为1。每个任务的线程预算 = 核心数 / 并发任务数。
+ * 无法获取可用内存时只按核心数计算。
+ ******************************************************************************/
+ResourcePlan AnalysisScheduler::recommendedPlan()
+{
+    ResourcePlan result;
+    result.cpuCores = qMax(1, QThread::idealThreadCount());
+    result.availableMemoryMB = availableMemoryMB();
+
+    int byCores = qMax(1, result.cpuCores / kMinThreadsPerJob);
+    int byMemory = byCores;
+    if (result.availableMemoryMB > 0) {
+        byMemory = static_cast<int>(
+            qMax<qint64>(1, (result.availableMemoryMB - kReservedMemoryMB) / kMemoryPerJobMB));
+    }
+
+    result.concurrentJobs = qMax(1, qMin(byCores, byMemory));
+    result.threadsPerJob = qMax(1, result.cpuCores / result.concurrentJobs);
+    return result;
+}
+
+qint64 AnalysisScheduler::availableMemoryMB()
+{
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        return static_cast<qint64>(status.ullAvailPhys / (1024 * 1024));
+    }
+#elif defined(Q_OS_LINUX)
+    // MemAvailable包含可回收的页面缓存，比MemFree更接近实际可用内存
+    QFile meminfo("/proc/meminfo");
+    if (meminfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!meminfo.atEnd()) {
+            const QByteArray line = meminfo.readLine();
+            if (line.startsWith("MemAvailable:")) {
+                const QList<QByteArray> parts = line.simplified().split(' ');
+                if (parts.size() >= 2) {
+                    return parts.at(1).toLongLong() / 1024;  // kB -> MB
+                }
+            }
+        }
+    }
+#elif defined(Q_OS_MACOS)
+    // macOS没有简单的"可用内存"接口，以物理内存的一半作为估计
+    quint64 memorySize = 0;
+    size_t length = sizeof(memorySize);
+    if (sysctlbyname("hw.memsize", &memorySize, &length, nullptr, 0) == 0) {
+        return static_cast<qint64>(memorySize / (2 * 1024 * 1024));
+    }
+#endif
+    return -1;
+}
+
+void AnalysisScheduler::setMaxConcurrentJobs(int count)
+{
+    plan.concurrentJobs = qMax(1, count);
+    plan.threadsPerJob = qMax(1, plan.cpuCores / plan.concurrentJobs);
+
+    // 空闲的多余工作进程立即停止；忙碌的在任务完成后停止
+    for (int i = workers.size() - 1; i >= plan.concurrentJobs; --i) {
+        AnalysisWorker *worker = workers.at(i);
+        if (!worker->isBusy()) {
+            workers.removeAt(i);
+            worker->stop();
+            worker->deleteLater();
+        }
+    }
+
+    for (AnalysisWorker *worker : std::as_const(workers)) {
+        worker->setThreadBudget(plan.threadsPerJob);
+    }
+
+    dispatch();
+}
+
+int AnalysisScheduler::maxConcurrentJobs() const
+{
+    return plan.concurrentJobs;
+}
+
+int AnalysisScheduler::threadsPerJob() const
+{
+    return plan.threadsPerJob;
+}
+
+/******************************************************************************
+ * 输出设置
+ *
+ * 输出视频编码器（"h264"、"mp4v"、"xvid"、"mjpg"）；只影响之后排队的任务。
+ * 本地OpenCV不支持H.264时工作进程自动改用MPEG-4（同为MP4）。
+ * "none"表示不绘制和编码标注视频（render_video=false），
+ * 结果在GUI中以叠加层方式显示在输入视频上。
+ ******************************************************************************/
+void AnalysisScheduler::setVideoCodec(const QString &codec)
+{
+    this->codec = codec;
+}
+
+QString AnalysisScheduler::videoCodec() const
+{
+    return codec;
+}
+
+/******************************************************************************
+ * 检测后端
+ *
+ * "ultralytics"（PyTorch）或"onnx"（ONNX Runtime CPU，可选INT8量化模型）；
+ * 只影响之后排队的任务。工作进程在后端改变时重新加载模型。
+ ******************************************************************************/
+void AnalysisScheduler::setDetectionBackend(const QString &backend, bool int8)
+{
+    this->backend = backend;
+    this->int8 = int8 && backend == "onnx";
+}
+
+QString AnalysisScheduler::detectionBackend() const
+{
+    return backend;
+}
+
+bool AnalysisScheduler::int8Inference() const
+{
+    return int8;
+}
+
+/******************************************************************************
+ * 队列管理
+ ******************************************************************************/
+QString AnalysisScheduler::enqueue(const QString &inputPath, const QString &modelPath)
+{
+    AnalysisJob job;
+    job.id = QString("job-%1").arg(nextJobNumber++);
+    job.inputPath = QFileInfo(inputPath).absoluteFilePath();
+    job.modelPath = QFileInfo(modelPath).absoluteFilePath();
+    job.outputDir = makeOutputDirectory(job.inputPath);
+    job.videoCodec = codec;
+    job.detectionBackend = backend;
+    job.int8 = int8;
+    jobList.append(job);
+
+    emit jobAdded(job.id);
+    dispatch();
+    return job.id;
+}
+
+bool AnalysisScheduler::removeJob(const QString &jobId)
+{
+    for (int i = 0; i < jobList.size(); ++i) {
+        if (jobList.at(i).id != jobId) {
+            continue;
+        }
+        if (jobList.at(i).status == AnalysisJob::Running) {
+            return false;  // 运行中的任务不能移除
+        }
+        jobList.removeAt(i);
+        emit jobRemoved(jobId);
+        return true;
+    }
+    return false;
+}
+
+void AnalysisScheduler::clearFinished()
+{
+    QStringList finished;
+    for (const AnalysisJob &job : std::as_const(jobList)) {
+        if (job.isFinished()) {
+            finished.append(job.id);
+        }
+    }
+    for (const QString &jobId : std::as_const(finished)) {
+        removeJob(jobId);
+    }
+}
+
+/******************************************************************************
+ * 取消、暂停和重试
+ *
+ * 排队的任务直接标记为已取消；运行中的任务由工作进程在下一帧之前停止，
+ * 结果到达时（onWorkerJobCancelled）才标记。
+ * 暂停时运行中的任务在工作进程中阻塞，排队的任务不再分派。
+ * 重试的任务使用原来的输出目录，从检查点继续（见AnalysisScheduler.h）。
+ ******************************************************************************/
+bool AnalysisScheduler::cancelJob(const QString &jobId)
+{
+    AnalysisJob *job = findJob(jobId);
+    if (!job) {
+        return false;
+    }
+    if (job->status == AnalysisJob::Running) {
+        runningJobs.value(jobId)->cancelJob();
+        return true;
+    }
+    if (job->status != AnalysisJob::Queued) {
+        return false;
+    }
+
+    job->status = AnalysisJob::Cancelled;
+    emit jobChanged(jobId);
+    emit jobFinished(jobId, false);
+    if (isIdle()) {
+        emit idle();
+    }
+    return true;
+}
+
+void AnalysisScheduler::cancelAll()
+{
+    QStringList jobIds;
+    for (const AnalysisJob &job : std::as_const(jobList)) {
+        if (!job.isFinished()) {
+            jobIds.append(job.id);
+        }
+    }
+    // 先取消排队的任务，避免运行中的任务结束后又分派它们
+    for (const QString &jobId : std::as_const(jobIds)) {
+        if (job(jobId)->status == AnalysisJob::Queued) {
+            cancelJob(jobId);
+        }
+    }
+    for (const QString &jobId : std::as_const(jobIds)) {
+        if (job(jobId) && job(jobId)->status == AnalysisJob::Running) {
+            cancelJob(jobId);
+        }
+    }
+}
+
+bool AnalysisScheduler::retryJob(const QString &jobId)
+{
+    AnalysisJob *job = findJob(jobId);
+    if (!job || (job->status != AnalysisJob::Cancelled && job->status != AnalysisJob::Failed)) {
+        return false;
+    }
+
+    job->status = AnalysisJob::Queued;
+    job->error.clear();
+    job->outputs = QJsonObject();
+    emit jobChanged(jobId);
+    dispatch();
+    return true;
+}
+
+void AnalysisScheduler::setPaused(bool paused)
+{
+    if (paused == this->paused) {
+        return;
+    }
+    this->paused = paused;
+
+    for (auto it = runningJobs.cbegin(); it != runningJobs.cend(); ++it) {
+        if (paused) {
+            it.value()->pauseJob();
+        } else {
+            it.value()->resumeJob();
+        }
+    }
+    if (!paused) {
+        dispatch();
+    }
+}
+
+bool AnalysisScheduler::isPaused() const
+{
+    return paused;
+}
+
+void AnalysisScheduler::preloadModel(const QString &modelPath)
+{
+    for (AnalysisWorker *worker : std::as_const(workers)) {
+        worker->preloadModel(modelPath, backend, int8);
+    }
+}
+
+void AnalysisScheduler::shutdown()
+{
+    for (AnalysisWorker *worker : std::as_const(workers)) {
+        disconnect(worker, nullptr, this, nullptr);
+        worker->stop();
+    }
+    qDeleteAll(workers);
+    workers.clear();
+    runningJobs.clear();
+}
+
+const QList<AnalysisJob> &AnalysisScheduler::jobs() const
+{
+    return jobList;
+}
+
+const AnalysisJob *AnalysisScheduler::job(const QString &jobId) const
+{
+    for (const AnalysisJob &job : jobList) {
+        if (job.id == jobId) {
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+AnalysisJob *AnalysisScheduler::findJob(const QString &jobId)
+{
+    for (AnalysisJob &job : jobList) {
+        if (job.id == jobId) {
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+int AnalysisScheduler::runningJobCount() const
+{
+    return runningJobs.size();
+}
+
+int AnalysisScheduler::queuedJobCount() const
+{
+    int count = 0;
+    for (const AnalysisJob &job : jobList) {
+        if (job.status == AnalysisJob::Queued) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool AnalysisScheduler::isIdle() const
+{
+    return runningJobs.isEmpty() && queuedJobCount() == 0;
+}
+
+/******************************************************************************
+ * 分派任务
+ *
+ * 按队列顺序把排队的任务交给空闲的工作进程；
+ * 运行中的任务数不超过plan.concurrentJobs。需要时创建新的工作进程。
+ * 任务启动失败使队列空闲时发出idle()并返回true，调用者不再重复发出。
+ ******************************************************************************/
+bool AnalysisScheduler::dispatch()
+{
+    QStringList started;
+    QStringList failed;
+
+    for (AnalysisJob &job : jobList) {
+        if (paused || runningJobs.size() >= plan.concurrentJobs) {
+            break;
+        }
+        if (job.status != AnalysisJob::Queued) {
+            continue;
+        }
+
+        // 寻找空闲的工作进程，必要时扩充进程池
+        AnalysisWorker *worker = nullptr;
+        for (AnalysisWorker *candidate : std::as_const(workers)) {
+            if (!candidate->isBusy()) {
+                worker = candidate;
+                break;
+            }
+        }
+        if (!worker) {
+            if (workers.size() >= plan.concurrentJobs) {
+                break;
+            }
+            worker = createWorker();
+        }
+        worker->setThreadBudget(plan.threadsPerJob);
+
+        QJsonObject message;
+        message["job_id"] = job.id;
+        message["input"] = job.inputPath;
+        message["model"] = job.modelPath;
+        message["output"] = job.outputDir;
+        message["streaming"] = true;
+        message["use_cache"] = true;
+        message["threads"] = plan.threadsPerJob;
+        if (job.videoCodec == "none") {
+            message["render_video"] = false;
+        } else {
+            message["video_codec"] = job.videoCodec;
+        }
+        message["backend"] = job.detectionBackend;
+        message["int8"] = job.int8;
+
+        job.threads = plan.threadsPerJob;
+        job.stage.clear();
+        job.progressPercent = 0;
+        job.paused = false;
+        job.snapshot = QJsonObject();
+
+        if (worker->submitJob(message).isEmpty()) {
+            job.status = AnalysisJob::Failed;
+            job.error = worker->lastError();
+            failed.append(job.id);
+            continue;
+        }
+
+        job.status = AnalysisJob::Running;
+        runningJobs.insert(job.id, worker);
+        started.append(job.id);
+    }
+
+    // 遍历结束后再发出信号，接收者可以安全地修改队列
+    for (const QString &jobId : std::as_const(started)) {
+        emit jobChanged(jobId);
+    }
+    for (const QString &jobId : std::as_const(failed)) {
+        emit jobChanged(jobId);
+        emit jobFinished(jobId, false);
+    }
+    if (!failed.isEmpty() && isIdle()) {
+        emit idle();
+        return true;
+    }
+    return false;
+}
+
+AnalysisWorker *AnalysisScheduler::createWorker()
+{
+    AnalysisWorker *worker = new AnalysisWorker(workingDirectory, this);
+    const int workerNumber = workers.size() + 1;
+
+    connect(worker, &AnalysisWorker::jobEvent, this, &AnalysisScheduler::onWorkerJobEvent);
+    connect(worker, &AnalysisWorker::jobFinished, this, &AnalysisScheduler::onWorkerJobFinished);
+    connect(worker, &AnalysisWorker::jobCancelled, this, &AnalysisScheduler::onWorkerJobCancelled);
+    connect(worker, &AnalysisWorker::modelLoaded, this, &AnalysisScheduler::modelLoaded);
+
+    // 多个工作进程的日志交错输出，每行加上工作进程编号
+    connect(worker, &AnalysisWorker::logOutput, this,
+            [this, workerNumber](const QString &text, bool isError) {
+        if (plan.concurrentJobs <= 1) {
+            emit logOutput(text, isError);
+            return;
+        }
+        const QString prefix = QString("[worker %1] ").arg(workerNumber);
+        QStringList lines = text.split('\n');
+        for (QString &line : lines) {
+            line.prepend(prefix);
+        }
+        emit logOutput(lines.join('\n'), isError);
+    });
+
+    workers.append(worker);
+    return worker;
+}
+
+/******************************************************************************
+ * 工作进程回调
+ ******************************************************************************/
+void AnalysisScheduler::onWorkerJobEvent(const QString &jobId, const QJsonObject &event)
+{
+    AnalysisJob *job = findJob(jobId);
+    if (!job) {
+        return;
+    }
+
+    const QString type = event.value("event").toString();
+    if (type == "progress") {
+        job->stage = event.value("stage").toString();
+        const qint64 total = event.value("total").toInteger();
+        const qint64 done = event.value("done").toInteger();
+        job->progressPercent = total > 0 ? static_cast<int>(qMin(done, total) * 100 / total) : 0;
+        emit jobChanged(jobId);
+    } else if (type == "snapshot") {
+        // 部分结果：保留最新的一个，进度条改为跟随其他任务时也能显示
+        job->snapshot = event;
+    } else if (type == "paused" || type == "resumed") {
+        job->paused = type == "paused";
+        emit jobChanged(jobId);
+    }
+
+    emit jobEvent(jobId, event);
+}
+
+void AnalysisScheduler::onWorkerJobFinished(const QString &jobId, bool success,
+                                            const QJsonObject &outputs, const QString &error)
+{
+    finishJob(jobId, success ? AnalysisJob::Succeeded : AnalysisJob::Failed, outputs, error);
+}
+
+void AnalysisScheduler::onWorkerJobCancelled(const QString &jobId)
+{
+    finishJob(jobId, AnalysisJob::Cancelled, QJsonObject(), QString());
+}
+
+void AnalysisScheduler::finishJob(const QString &jobId, AnalysisJob::Status status,
+                                  const QJsonObject &outputs, const QString &error)
+{
+    AnalysisWorker *worker = runningJobs.take(jobId);
+
+    AnalysisJob *job = findJob(jobId);
+    if (job) {
+        const bool success = status == AnalysisJob::Succeeded;
+        job->status = status;
+        job->outputs = outputs;
+        job->error = error;
+        job->paused = false;
+        if (success) {
+            job->progressPercent = 100;
+        }
+        emit jobChanged(jobId);
+        emit jobFinished(jobId, success);
+    }
+
+    // 并发数调低后，多余的工作进程在任务完成时停止
+    const int index = workers.indexOf(worker);
+    if (index >= plan.concurrentJobs) {
+        workers.removeAt(index);
+        worker->stop();
+        worker->deleteLater();
+    }
+
+    if (!dispatch() && isIdle()) {
+        emit idle();
+    }
+}
+
+/******************************************************************************
+ * 输出目录
+ *
+ * foot-Function/output_videos/<视频名称>_<yyyyMMdd_HHmmss>，
+ * 名称重复时追加序号。目录在工作进程写入时创建。
+ ******************************************************************************/
+QString AnalysisScheduler::makeOutputDirectory(const QString &inputPath) const
+{
+    const QDir baseDir(QDir(workingDirectory).absoluteFilePath("output_videos"));
+    const QString baseName = QString("%1_%2")
+        .arg(QFileInfo(inputPath).completeBaseName(),
+             QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+
+    auto isTaken = [this, &baseDir](const QString &name) {
+        const QString path = baseDir.absoluteFilePath(name);
+        if (QFileInfo::exists(path)) {
+            return true;
+        }
+        for (const AnalysisJob &job : jobList) {
+            if (job.outputDir == path) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    QString name = baseName;
+    for (int suffix = 2; isTaken(name); ++suffix) {
+        name = QString("%1_%2").arg(baseName).arg(suffix);
+    }
+    return baseDir.absoluteFilePath(name);
+}
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * ANALYSIS SCHEDULER HEADER
+ *
+ * This header defines the AnalysisScheduler class, which runs a queue of
+ * analysis jobs on a pool of persistent Python workers (AnalysisWorker).
+ *
+ * RESOURCE PLAN:
+ * The number of concurrent jobs is derived from the CPU core count and the
+ * available physical memory; every job gets an explicit thread budget
+ * (cores / concurrent jobs) that the worker applies to torch, OpenCV and
+ * the OpenMP/BLAS pools, so parallel jobs do not oversubscribe the CPU.
+ *
+ * OUTPUT:
+ * Every job writes to its own directory below foot-Function/output_videos,
+ * named after the input video and the time it was queued.
+ *
+ * Jobs run in streaming mode so the memory needed per job does not grow
+ * with the length of the video.
+ *
+ * CANCEL / PAUSE / RESUME:
+ * cancelJob() stops a running job between two frames (a queued job is just
+ * not started); the job ends as Cancelled. setPaused() holds the running
+ * jobs and stops dispatching queued ones. retryJob() queues a cancelled or
+ * failed job again with the same output directory: its detection pass
+ * continues from the checkpoint the cancelled run left in the stub cache,
+ * and stages whose results are already cached are skipped.
+ ******************************************************************************/
+
+#ifndef ANALYSISSCHEDULER_H
+#define ANALYSISSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include "AnalysisWorker.h"
+
+/**
+ * @struct AnalysisJob
+ * @brief One queued, running or finished analysis
+ */
+struct AnalysisJob
+{
+    enum Status { Queued, Running, Succeeded, Failed, Cancelled };
+
+    QString id;
+    QString inputPath;          // Input video
+    QString modelPath;          // YOLO model
+    QString outputDir;          // Per-job output directory
+    Status status = Queued;
+    QString stage;              // Current pipeline stage (from progress events)
+    int progressPercent = 0;    // Progress within the current stage
+    bool paused = false;        // Worker confirmed the job is paused
+    int threads = 0;            // Thread budget the job was started with
+    QString videoCodec;         // Output video codec (worker codec name, e.g. "h264"; "none" = not rendered)
+    QString detectionBackend;   // Detection backend ("ultralytics" or "onnx")
+    bool int8 = false;          // INT8-quantized model (onnx backend only)
+    QJsonObject outputs;        // Output paths reported by the worker
+    QJsonObject snapshot;       // Latest partial result snapshot event (while running)
+    QString error;              // Failure reason
+
+    bool isFinished() const { return status == Succeeded || status == Failed || status == Cancelled; }
+    static QString statusText(Status status);
+};
+
+/**
+ * @struct ResourcePlan
+ * @brief Concurrency and per-job thread budget derived from the machine
+ */
+struct ResourcePlan
+{
+    int cpuCores = 1;
+    qint64 availableMemoryMB = -1;   // -1 if unknown
+    int concurrentJobs = 1;
+    int threadsPerJob = 1;
+};
+
+/**
+ * @class AnalysisScheduler
+ * @brief Job queue dispatching analyses to a pool of persistent workers
+ */
+class AnalysisScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisScheduler(const QString &workingDirectory, QObject *parent = nullptr);
+    ~AnalysisScheduler();
+
+    // ===== LOCATIONS =====
+    static QString projectRootPath();               // Directory with FootAnalysisGUI.pro and foot-Function
+    QString workerScriptPath() const;               // worker.py started by the workers
+
+    // ===== RESOURCE PLAN =====
+    static ResourcePlan recommendedPlan();          // Plan for this machine
+    static qint64 availableMemoryMB();              // Available physical memory, -1 if unknown
+    void setMaxConcurrentJobs(int count);           // Override the number of parallel jobs
+    int maxConcurrentJobs() const;
+    int threadsPerJob() const;                      // Thread budget given to each job
+
+    // ===== OUTPUT =====
+    void setVideoCodec(const QString &codec);       // Codec for jobs queued from now on
+    QString videoCodec() const;
+    void setDetectionBackend(const QString &backend, bool int8);  // Backend for jobs queued from now on
+    QString detectionBackend() const;
+    bool int8Inference() const;
+
+    // ===== QUEUE =====
+    QString enqueue(const QString &inputPath, const QString &modelPath);  // Returns the job id
+    bool removeJob(const QString &jobId);           // Remove a queued or finished job
+    void clearFinished();                           // Remove all finished jobs
+    bool cancelJob(const QString &jobId);           // Cancel a queued or running job
+    void cancelAll();                               // Cancel every queued and running job
+    bool retryJob(const QString &jobId);            // Queue a cancelled/failed job again (resumes)
+    void setPaused(bool paused);                    // Pause running jobs and hold the queue
+    bool isPaused() const;
+    void preloadModel(const QString &modelPath);    // Preload a model in running workers
+    void shutdown();                                // Stop all workers
+
+    const QList<AnalysisJob> &jobs() const;
+    const AnalysisJob *job(const QString &jobId) const;
+    int runningJobCount() const;
+    int queuedJobCount() const;
+    bool isIdle() const;                            // Nothing queued or running
+
+signals:
+    void jobAdded(const QString &jobId);
+    void jobChanged(const QString &jobId);          // Status or progress changed
+    void jobRemoved(const QString &jobId);
+    void jobEvent(const QString &jobId, const QJsonObject &event);
+    void jobFinished(const QString &jobId, bool success);
+    void logOutput(const QString &text, bool isError);
+    void modelLoaded(const QString &modelPath, double seconds);
+    void idle();                                    // Last queued job finished
+
+private slots:
+    void onWorkerJobEvent(const QString &jobId, const QJsonObject &event);
+    void onWorkerJobFinished(const QString &jobId, bool success,
+                             const QJsonObject &outputs, const QString &error);
+    void onWorkerJobCancelled(const QString &jobId);
+
+private:
+    bool dispatch();                                // True if it emitted idle()
+    void finishJob(const QString &jobId, AnalysisJob::Status status,
+                   const QJsonObject &outputs, const QString &error);
+    AnalysisWorker *createWorker();
+    AnalysisJob *findJob(const QString &jobId);
+    QString makeOutputDirectory(const QString &inputPath) const;
+
+    QString workingDirectory;                       // foot-Function directory
+    ResourcePlan plan;                              // Current concurrency and thread budget
+    QString codec;                                  // Output video codec of new jobs
+    QString backend;                                // Detection backend of new jobs
+    bool int8;                                      // INT8 inference for new jobs (onnx backend)
+    QList<AnalysisJob> jobList;                     // All jobs in queue order
+    QList<AnalysisWorker *> workers;                // Worker pool (at most plan.concurrentJobs busy)
+    QHash<QString, AnalysisWorker *> runningJobs;   // Job id → worker running it
+    bool paused;                                    // Queue held by setPaused()
+    int nextJobNumber;
+};
+
+#endif // ANALYSISSCHEDULER_H
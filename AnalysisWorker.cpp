@@ -0,0 +1,500 @@
+/*******************************************************************************
+ * 常驻分析工作进程实现
+ *
+ * 管理一个长时间运行的Python工作进程（foot-Function/worker.py）：
+ * - 进程只启动一次，YOLO模型在多次分析之间保持加载
+ * - 通过QLocalServer接受工作进程的两条单向连线（commands / events）
+ * - 每条消息是一行JSON（格式见worker.py）
+ * - 进程的stdout/stderr作为日志转发给界面
+ *
+ * 如果工作进程在分析期间退出，当前任务报告为失败，
+ * 下一次提交任务时自动重新启动进程。
+ ******************************************************************************/
+
+#include "AnalysisWorker.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QUuid>
+
+/******************************************************************************
+ * 构造函数
+ *
+ * workingDirectory是foot-Function目录，工作进程在其中运行，
+ * 以便找到worker.py和相对路径的stubs目录。
+ ******************************************************************************/
+AnalysisWorker::AnalysisWorker(const QString &workingDirectory, QObject *parent)
+    : QObject(parent)
+    , workingDirectory(workingDirectory)
+    , server(nullptr)
+    , process(nullptr)
+    , commandSocket(nullptr)
+    , eventSocket(nullptr)
+    , threads(0)
+    , stopping(false)
+{
+}
+
+/******************************************************************************
+ * 析构函数
+ *
+ * 请求工作进程退出；超时则强制终止。
+ ******************************************************************************/
+AnalysisWorker::~AnalysisWorker()
+{
+    stop();
+}
+
+bool AnalysisWorker::isRunning() const
+{
+    return process && process->state() != QProcess::NotRunning;
+}
+
+bool AnalysisWorker::isBusy() const
+{
+    return !runningJobId.isEmpty();
+}
+
+QString AnalysisWorker::currentJobId() const
+{
+    return runningJobId;
+}
+
+QString AnalysisWorker::lastError() const
+{
+    return startError;
+}
+
+void AnalysisWorker::setThreadBudget(int threads)
+{
+    this->threads = qMax(0, threads);
+}
+
+int AnalysisWorker::threadBudget() const
+{
+    return threads;
+}
+
+/******************************************************************************
+ * 启动工作进程
+ *
+ * 1. 以唯一名称创建本地服务器（仅当前用户可访问）
+ * 2. 启动 python worker.py --server <完整服务器名称>
+ * 3. 工作进程连线后发送"ready"，排队的命令随即送出
+ *
+ * 进程已在运行时直接返回true。
+ ******************************************************************************/
+bool AnalysisWorker::start()
+{
+    if (isRunning()) {
+        return true;
+    }
+
+    startError.clear();
+    stopping = false;
+    resetConnections();
+
+    QString scriptPath = QDir(workingDirectory).absoluteFilePath("worker.py");
+    if (!QFileInfo::exists(scriptPath)) {
+        startError = QString("Worker script not found at: %1").arg(scriptPath);
+        return false;
+    }
+
+    // 创建本地服务器：名称包含进程ID和计数器，避免多个实例冲突
+    if (!server) {
+        static int serverCounter = 0;
+        server = new QLocalServer(this);
+        server->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(server, &QLocalServer::newConnection, this, &AnalysisWorker::onNewConnection);
+
+        QString serverName = QString("foot-analysis-%1-%2")
+            .arg(QCoreApplication::applicationPid())
+            .arg(++serverCounter);
+        QLocalServer::removeServer(serverName);  // 清除崩溃后遗留的套接字文件
+        if (!server->listen(serverName)) {
+            startError = QString("Cannot create local server: %1").arg(server->errorString());
+            delete server;
+            server = nullptr;
+            return false;
+        }
+    }
+
+    // 启动Python工作进程
+    if (!process) {
+        process = new QProcess(this);
+        connect(process, &QProcess::readyReadStandardOutput,
+                this, &AnalysisWorker::onProcessReadyReadStandardOutput);
+        connect(process, &QProcess::readyReadStandardError,
+                this, &AnalysisWorker::onProcessReadyReadStandardError);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &AnalysisWorker::onProcessFinished);
+        connect(process, &QProcess::errorOccurred,
+                this, &AnalysisWorker::onProcessErrorOccurred);
+    }
+
+    QStringList arguments;
+    arguments << scriptPath;
+    arguments << "--server" << server->fullServerName();
+
+    // 线程预算：OpenMP/BLAS线程池在导入时确定，必须通过环境变量设置
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (threads > 0) {
+        const QString count = QString::number(threads);
+        environment.insert("OMP_NUM_THREADS", count);
+        environment.insert("MKL_NUM_THREADS", count);
+        environment.insert("OPENBLAS_NUM_THREADS", count);
+    }
+    process->setProcessEnvironment(environment);
+
+    process->setWorkingDirectory(workingDirectory);
+    process->start("python", arguments);
+
+    if (!process->waitForStarted(3000)) {
+        startError = "Failed to start Python process. Make sure Python is installed and in PATH.";
+        return false;
+    }
+
+    emit logOutput(QString("Started analysis worker: python %1").arg(arguments.join(" ")), false);
+    return true;
+}
+
+/******************************************************************************
+ * 停止工作进程
+ *
+ * 发送shutdown命令并等待进程退出；超过timeoutMs则强制终止。
+ * shutdown也会取消正在运行的任务（在下一帧之前停止并保存检查点），
+ * 该任务报告为失败。
+ ******************************************************************************/
+void AnalysisWorker::stop(int timeoutMs)
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    stopping = true;
+
+    if (commandSocket && commandSocket->state() == QLocalSocket::ConnectedState) {
+        QJsonObject shutdown;
+        shutdown["type"] = "shutdown";
+        sendMessage(shutdown);
+        commandSocket->waitForBytesWritten(timeoutMs);
+    }
+
+    if (!process->waitForFinished(timeoutMs)) {
+        process->kill();
+        process->waitForFinished();
+    }
+}
+
+/******************************************************************************
+ * 提交分析任务
+ *
+ * job包含input、model、output等字段（见worker.py）；
+ * 如果没有job_id则自动生成。工作进程未运行时先启动它。
+ *
+ * 返回任务ID；无法启动工作进程时返回空字符串（原因见lastError()）。
+ ******************************************************************************/
+QString AnalysisWorker::submitJob(const QJsonObject &job)
+{
+    if (!start()) {
+        return QString();
+    }
+
+    QJsonObject message = job;
+    message["type"] = "job";
+    if (message.value("job_id").toString().isEmpty()) {
+        message["job_id"] = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
+    if (threads > 0 && !message.contains("threads")) {
+        message["threads"] = threads;
+    }
+
+    runningJobId = message.value("job_id").toString();
+    sendMessage(message);
+    return runningJobId;
+}
+
+/******************************************************************************
+ * 预加载模型
+ *
+ * 用户选择模型后立即在后台加载，使第一次分析无需等待模型加载。
+ * 只在工作进程已运行时发送；否则模型会随第一个任务加载。
+ ******************************************************************************/
+void AnalysisWorker::preloadModel(const QString &modelPath, const QString &backend, bool int8)
+{
+    if (!isRunning() || modelPath.isEmpty()) {
+        return;
+    }
+
+    QJsonObject message;
+    message["type"] = "load_model";
+    message["model"] = modelPath;
+    message["backend"] = backend;
+    message["int8"] = int8;
+    sendMessage(message);
+}
+
+/******************************************************************************
+ * 任务控制
+ *
+ * 暂停、继续和取消正在运行的任务（工作进程空闲时忽略）。
+ ******************************************************************************/
+void AnalysisWorker::pauseJob()
+{
+    sendJobControl("pause");
+}
+
+void AnalysisWorker::resumeJob()
+{
+    sendJobControl("resume");
+}
+
+void AnalysisWorker::cancelJob()
+{
+    sendJobControl("cancel");
+}
+
+void AnalysisWorker::sendJobControl(const QString &type)
+{
+    if (runningJobId.isEmpty()) {
+        return;
+    }
+
+    QJsonObject message;
+    message["type"] = type;
+    message["job_id"] = runningJobId;
+    sendMessage(message);
+}
+
+/******************************************************************************
+ * 发送消息
+ *
+ * commands连线尚未建立时，消息排队到连线后再发送。
+ ******************************************************************************/
+void AnalysisWorker::sendMessage(const QJsonObject &message)
+{
+    QByteArray line = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    if (commandSocket && commandSocket->state() == QLocalSocket::ConnectedState) {
+        commandSocket->write(line);
+        commandSocket->flush();
+    } else {
+        pendingMessages.append(line);
+    }
+}
+
+/******************************************************************************
+ * 连线处理
+ *
+ * 工作进程建立两条连线，每条的第一行是
+ *   {"type": "hello", "channel": "commands" | "events", "pid": ...}
+ * 收到hello之前无法区分两条连线，所以新连线先等待第一行。
+ ******************************************************************************/
+void AnalysisWorker::onNewConnection()
+{
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, &AnalysisWorker::onSocketReadyRead);
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        if (socket->bytesAvailable() > 0) {
+            readSocket(socket);  // hello可能在连线建立时已经到达
+        }
+    }
+}
+
+void AnalysisWorker::identifySocket(QLocalSocket *socket)
+{
+    if (!socket->canReadLine()) {
+        return;  // 等待完整的hello行
+    }
+
+    QJsonObject hello = QJsonDocument::fromJson(socket->readLine().trimmed()).object();
+    QString channel = hello.value("channel").toString();
+
+    if (hello.value("type").toString() != "hello" || channel.isEmpty()) {
+        emit logOutput("Rejected unknown connection to analysis worker server", true);
+        socket->abort();
+        return;
+    }
+
+    if (channel == "commands") {
+        commandSocket = socket;
+        // 送出连线前排队的命令
+        for (const QByteArray &line : std::as_const(pendingMessages)) {
+            commandSocket->write(line);
+        }
+        pendingMessages.clear();
+        commandSocket->flush();
+    } else if (channel == "events") {
+        eventSocket = socket;
+        eventBuffer.clear();
+    }
+}
+
+void AnalysisWorker::onSocketReadyRead()
+{
+    if (QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender())) {
+        readSocket(socket);
+    }
+}
+
+void AnalysisWorker::readSocket(QLocalSocket *socket)
+{
+    if (socket != eventSocket && socket != commandSocket) {
+        identifySocket(socket);
+        if (socket != eventSocket) {
+            return;
+        }
+    }
+
+    if (socket != eventSocket) {
+        socket->readAll();  // commands连线上不应有数据
+        return;
+    }
+
+    // 逐行解析事件（不完整的行保留到下一次读取）
+    eventBuffer.append(eventSocket->readAll());
+    qsizetype newline;
+    while ((newline = eventBuffer.indexOf('\n')) >= 0) {
+        QByteArray line = eventBuffer.left(newline).trimmed();
+        eventBuffer.remove(0, newline + 1);
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error == QJsonParseError::NoError && doc.isObject()) {
+            handleMessage(doc.object());
+        } else {
+            emit logOutput(QString("Malformed worker message: %1").arg(QString::fromUtf8(line)), true);
+        }
+    }
+}
+
+/******************************************************************************
+ * 处理工作进程消息
+ ******************************************************************************/
+void AnalysisWorker::handleMessage(const QJsonObject &message)
+{
+    const QString type = message.value("type").toString();
+
+    if (type == "event") {
+        emit jobEvent(message.value("job_id").toString(), message.value("event").toObject());
+    } else if (type == "result") {
+        const QString jobId = message.value("job_id").toString();
+        if (jobId == runningJobId) {
+            runningJobId.clear();
+        }
+        const QString status = message.value("status").toString();
+        if (status == "cancelled") {
+            emit jobCancelled(jobId);
+            return;
+        }
+        const bool success = status == "ok";
+        emit jobFinished(jobId, success, message.value("outputs").toObject(),
+                         message.value("error").toString());
+    } else if (type == "model_loaded") {
+        emit modelLoaded(message.value("model").toString(), message.value("seconds").toDouble());
+    } else if (type == "ready") {
+        emit ready();
+    }
+}
+
+/******************************************************************************
+ * 进程输出
+ *
+ * 工作进程的日志写在stderr（logging），普通print写在stdout。
+ * 一次读取可能在行中间结束；只发出完整的行，剩余部分留到下一次读取
+ * （进程退出时发出）。\r（进度条）也视为行结束。
+ ******************************************************************************/
+void AnalysisWorker::onProcessReadyReadStandardOutput()
+{
+    stdoutPartial += process->readAllStandardOutput();
+    emitLogLines(stdoutPartial, false, false);
+}
+
+void AnalysisWorker::onProcessReadyReadStandardError()
+{
+    stderrPartial += process->readAllStandardError();
+    emitLogLines(stderrPartial, true, false);
+}
+
+void AnalysisWorker::emitLogLines(QByteArray &buffer, bool isError, bool flushAll)
+{
+    buffer.replace("\r\n", "\n");
+    buffer.replace('\r', '\n');
+
+    const qsizetype end = flushAll ? buffer.size() : buffer.lastIndexOf('\n') + 1;
+    if (end <= 0) {
+        return;
+    }
+    QString text = QString::fromUtf8(buffer.constData(), end);
+    buffer.remove(0, end);
+    if (text.endsWith('\n')) {
+        text.chop(1);
+    }
+    if (!text.isEmpty()) {
+        emit logOutput(text, isError);
+    }
+}
+
+/******************************************************************************
+ * 进程退出
+ *
+ * 非预期退出时，正在运行的任务报告为失败；下一次提交任务会重新启动进程。
+ ******************************************************************************/
+void AnalysisWorker::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    emitLogLines(stdoutPartial, false, true);
+    emitLogLines(stderrPartial, true, true);
+
+    if (stopping) {
+        failRunningJob("Analysis worker was stopped");
+    } else if (exitStatus == QProcess::CrashExit) {
+        failRunningJob("Analysis worker crashed");
+    } else {
+        failRunningJob(QString("Analysis worker exited unexpectedly (exit code %1)").arg(exitCode));
+    }
+
+    resetConnections();
+    stopping = false;
+    emit stopped();
+}
+
+void AnalysisWorker::onProcessErrorOccurred(QProcess::ProcessError error)
+{
+    // 启动失败不会触发finished信号
+    if (error == QProcess::FailedToStart) {
+        failRunningJob("Failed to start Python process. Make sure Python is installed and in PATH.");
+        resetConnections();
+    }
+}
+
+void AnalysisWorker::failRunningJob(const QString &error)
+{
+    if (runningJobId.isEmpty()) {
+        return;
+    }
+
+    const QString jobId = runningJobId;
+    runningJobId.clear();
+    emit jobFinished(jobId, false, QJsonObject(), error);
+}
+
+void AnalysisWorker::resetConnections()
+{
+    if (commandSocket) {
+        commandSocket->abort();
+        commandSocket->deleteLater();
+        commandSocket = nullptr;
+    }
+    if (eventSocket) {
+        eventSocket->abort();
+        eventSocket->deleteLater();
+        eventSocket = nullptr;
+    }
+    eventBuffer.clear();
+    pendingMessages.clear();
+}
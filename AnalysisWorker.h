@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * ANALYSIS WORKER HEADER
+ *
+ * This header defines the AnalysisWorker class, which manages a persistent
+ * Python analysis process (foot-Function/worker.py) for the GUI.
+ *
+ * WHY A PERSISTENT WORKER:
+ * Starting "python main.py" for every video pays the interpreter start-up,
+ * the ultralytics/torch imports and the YOLO model load each time. The worker
+ * process is started once and keeps the model loaded between jobs; it only
+ * reloads when a different model file is selected.
+ *
+ * PROTOCOL:
+ * The worker connects back to a QLocalServer owned by this class with two
+ * one-way connections ("commands" GUI → worker, "events" worker → GUI).
+ * Every message is one line of JSON; see foot-Function/worker.py for the
+ * full message list. Log output still arrives on the process stdout/stderr
+ * and is forwarded as whole lines (logOutput).
+ *
+ * LIFECYCLE:
+ * - start() launches the process (submitJob() does so on demand)
+ * - Messages sent before the worker has connected are queued
+ * - If the process exits during a job, that job is reported as failed and
+ *   the next submitJob() starts a fresh process
+ * - stop() asks the worker to shut down and kills it after a timeout
+ *
+ * JOB CONTROL:
+ * pauseJob(), resumeJob() and cancelJob() act on the running job. The worker
+ * applies them on its command reader thread, so they take effect between
+ * two frames even while a job runs. A cancelled job ends with jobCancelled();
+ * its detection pass leaves a checkpoint behind and resubmitting the same job
+ * continues from there (see foot-Function/main.py).
+ *
+ * THREAD BUDGET:
+ * setThreadBudget() limits the threads the worker may use. It is exported
+ * as OMP/MKL/OpenBLAS environment variables when the process starts and is
+ * sent with every job so torch and OpenCV follow later changes.
+ ******************************************************************************/
+
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QJsonObject>
+#include <QByteArrayList>
+
+/**
+ * @class AnalysisWorker
+ * @brief Owns one long-lived Python analysis process and talks to it over a local socket
+ */
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisWorker(const QString &workingDirectory, QObject *parent = nullptr);
+    ~AnalysisWorker();
+
+    // ===== PROCESS CONTROL =====
+    bool start();                                  // Launch worker process if not running
+    void stop(int timeoutMs = 3000);               // Request shutdown, kill after timeout
+    bool isRunning() const;                        // Process is running
+    bool isBusy() const;                           // A job has been submitted and not finished
+    QString currentJobId() const;                  // Id of the running job (empty if idle)
+    QString lastError() const;                     // Description of the last start failure
+    void setThreadBudget(int threads);             // Threads per job (0 = library default)
+    int threadBudget() const;
+
+    // ===== JOBS =====
+    QString submitJob(const QJsonObject &job);     // Send a job; returns its id (empty on failure)
+    void preloadModel(const QString &modelPath,    // Load a model before the next job
+                      const QString &backend = "ultralytics", bool int8 = false);
+    void pauseJob();                               // Pause the running job
+    void resumeJob();                              // Continue a paused job
+    void cancelJob();                              // Stop the running job (jobCancelled follows)
+
+signals:
+    void ready();                                                    // Worker connected and idle
+    void modelLoaded(const QString &modelPath, double seconds);     // Worker (re)loaded a model
+    void jobEvent(const QString &jobId, const QJsonObject &event);  // Progress event of a job
+    void jobFinished(const QString &jobId, bool success,
+                     const QJsonObject &outputs, const QString &error);
+    void jobCancelled(const QString &jobId);                         // Job stopped by cancelJob()
+    void logOutput(const QString &text, bool isError);              // Worker stdout/stderr text
+    void stopped();                                                  // Process exited
+
+private slots:
+    void onNewConnection();
+    void onSocketReadyRead();
+    void onProcessReadyReadStandardOutput();
+    void onProcessReadyReadStandardError();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessErrorOccurred(QProcess::ProcessError error);
+
+private:
+    void sendMessage(const QJsonObject &message);
+    void sendJobControl(const QString &type);
+    void handleMessage(const QJsonObject &message);
+    void identifySocket(QLocalSocket *socket);
+    void readSocket(QLocalSocket *socket);
+    void failRunningJob(const QString &error);
+    void resetConnections();
+    void emitLogLines(QByteArray &buffer, bool isError, bool flushAll);  // Complete lines only
+
+    QString workingDirectory;           // foot-Function directory (worker.py, stubs)
+    QLocalServer *server;               // Server the worker connects back to
+    QProcess *process;                  // The Python worker process
+    QPointer<QLocalSocket> commandSocket;  // GUI → worker connection (deleted on disconnect)
+    QPointer<QLocalSocket> eventSocket;    // Worker → GUI connection (deleted on disconnect)
+    QByteArray eventBuffer;             // Incomplete event line carried over between reads
+    QByteArray stdoutPartial;           // Incomplete stdout line carried over between reads
+    QByteArray stderrPartial;           // Incomplete stderr line carried over between reads
+    QByteArrayList pendingMessages;     // Commands queued until the worker connects
+    QString runningJobId;               // Job currently executing in the worker
+    QString startError;                 // Reason the last start() failed
+    int threads;                        // Thread budget (0 = library default)
+    bool stopping;                      // stop() in progress: exit is expected
+};
+
+#endif // ANALYSISWORKER_H
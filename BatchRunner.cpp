@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * 批处理实现
+ *
+ * 无界面模式：把清单中的视频交给AnalysisScheduler，任务结束后用
+ * AnalysisResults读取结果并写出汇总（见BatchRunner.h）。
+ ******************************************************************************/
+
+#include "BatchRunner.h"
+#include "AnalysisResults.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+QString formatDuration(qint64 seconds)
+{
+    return seconds >= 3600
+        ? QString("%1:%2:%3").arg(seconds / 3600).arg(seconds / 60 % 60, 2, 10, QChar('0'))
+                             .arg(seconds % 60, 2, 10, QChar('0'))
+        : QString("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+} // namespace
+
+/******************************************************************************
+ * 构造函数
+ *
+ * 调度器与MainWindow使用相同的工作目录（foot-Function）。
+ ******************************************************************************/
+BatchRunner::BatchRunner(const Options &options, QObject *parent)
+    : QObject(parent)
+    , options(options)
+    , scheduler(nullptr)
+    , queueing(false)
+    , done(false)
+{
+    scheduler = new AnalysisScheduler(
+        QDir(AnalysisScheduler::projectRootPath()).absoluteFilePath("foot-Function"), this);
+
+    connect(scheduler, &AnalysisScheduler::jobChanged, this, &BatchRunner::onJobChanged);
+    connect(scheduler, &AnalysisScheduler::jobFinished, this, &BatchRunner::onJobFinished);
+    connect(scheduler, &AnalysisScheduler::logOutput, this, &BatchRunner::onLogOutput);
+    connect(scheduler, &AnalysisScheduler::idle, this, [this]() {
+        if (!queueing) {
+            finish();
+        }
+    });
+}
+
+QString BatchRunner::errorString() const
+{
+    return error;
+}
+
+/******************************************************************************
+ * 清单
+ *
+ * 每行一个视频；相对路径相对于清单所在目录；忽略空行和以#开头的行。
+ ******************************************************************************/
+QStringList BatchRunner::readManifest(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = QString("Cannot read manifest %1: %2").arg(path, file.errorString());
+        }
+        return QStringList();
+    }
+
+    const QDir baseDir = QFileInfo(path).absoluteDir();
+    QStringList videos;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        videos.append(QDir::cleanPath(baseDir.absoluteFilePath(line)));
+    }
+    if (videos.isEmpty() && error) {
+        *error = QString("Manifest %1 lists no videos").arg(path);
+    }
+    return videos;
+}
+
+/******************************************************************************
+ * 开始
+ *
+ * 检查清单、模型和工作进程脚本，然后把所有视频加入队列。
+ * 不存在的视频不排队，在汇总中记为失败。
+ * 调度器可能在enqueue中立即报告失败并变为空闲，因此排队期间忽略idle，
+ * 排队结束后再检查（结束处理在事件循环中进行）。
+ ******************************************************************************/
+bool BatchRunner::start()
+{
+    const QStringList videos = readManifest(options.manifestPath, &error);
+    if (videos.isEmpty()) {
+        return false;
+    }
+
+    if (options.modelPath.isEmpty()) {
+        options.modelPath = QDir(AnalysisScheduler::projectRootPath()).absoluteFilePath("foot-Function/models/best.pt");
+    }
+    if (!QFileInfo::exists(options.modelPath)) {
+        error = QString("Model file not found: %1").arg(options.modelPath);
+        return false;
+    }
+    if (!QFileInfo::exists(scheduler->workerScriptPath())) {
+        error = QString("Python script not found at: %1").arg(scheduler->workerScriptPath());
+        return false;
+    }
+    if (options.summaryPath.isEmpty()) {
+        const QFileInfo manifest(options.manifestPath);
+        options.summaryPath = manifest.absoluteDir().absoluteFilePath(manifest.completeBaseName() + "_summary.json");
+    }
+
+    if (options.concurrency > 0) {
+        scheduler->setMaxConcurrentJobs(options.concurrency);
+    }
+    scheduler->setVideoCodec(options.videoCodec);
+    scheduler->setDetectionBackend(options.backend, options.int8);
+
+    const ResourcePlan plan = AnalysisScheduler::recommendedPlan();
+    err() << QString("Batch: %1 videos, %2 parallel jobs, %3 threads per job (%4 cores)")
+                 .arg(videos.size()).arg(scheduler->maxConcurrentJobs())
+                 .arg(scheduler->threadsPerJob()).arg(plan.cpuCores) << Qt::endl;
+
+    batchStarted = QDateTime::currentDateTime();
+    queueing = true;
+    for (const QString &video : videos) {
+        Entry entry;
+        entry.inputPath = video;
+        entries.append(entry);
+        if (!QFileInfo::exists(video)) {
+            err() << QString("Skipping %1: input video not found").arg(video) << Qt::endl;
+            continue;
+        }
+        entries.last().jobId = scheduler->enqueue(video, options.modelPath);
+    }
+    queueing = false;
+
+    if (scheduler->isIdle()) {
+        QTimer::singleShot(0, this, &BatchRunner::finish);
+    }
+    return true;
+}
+
+/******************************************************************************
+ * 任务状态
+ ******************************************************************************/
+BatchRunner::Entry *BatchRunner::findEntry(const QString &jobId)
+{
+    for (Entry &entry : entries) {
+        if (!jobId.isEmpty() && entry.jobId == jobId) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void BatchRunner::onJobChanged(const QString &jobId)
+{
+    const AnalysisJob *job = scheduler->job(jobId);
+    Entry *entry = findEntry(jobId);
+    if (!job || !entry || job->status != AnalysisJob::Running) {
+        return;
+    }
+    const QString name = QFileInfo(job->inputPath).fileName();
+    if (!entry->started.isValid()) {
+        entry->started = QDateTime::currentDateTime();
+        err() << QString("[%1] Started %2 -> %3").arg(jobId, name, job->outputDir) << Qt::endl;
+    }
+    // 每个阶段报告一次
+    if (!job->stage.isEmpty() && job->stage != entry->stage) {
+        entry->stage = job->stage;
+        err() << QString("[%1] %2").arg(jobId, QString(job->stage).replace('_', ' ')) << Qt::endl;
+    }
+}
+
+void BatchRunner::onJobFinished(const QString &jobId, bool success)
+{
+    const AnalysisJob *job = scheduler->job(jobId);
+    if (!job) {
+        return;
+    }
+    // enqueue中立即失败的任务还没有登记（汇总中仍按任务状态记录）
+    Entry *entry = findEntry(jobId);
+    if (entry) {
+        entry->finished = QDateTime::currentDateTime();
+    }
+    const qint64 seconds = entry && entry->started.isValid()
+        ? entry->started.secsTo(entry->finished) : 0;
+    if (success) {
+        err() << QString("[%1] Done in %2").arg(jobId, formatDuration(seconds)) << Qt::endl;
+    } else {
+        err() << QString("[%1] %2: %3").arg(jobId, AnalysisJob::statusText(job->status), job->error) << Qt::endl;
+    }
+}
+
+void BatchRunner::onLogOutput(const QString &text, bool isError)
+{
+    Q_UNUSED(isError);
+    if (options.verbose) {
+        err() << text << (text.endsWith('\n') ? "" : "\n") << Qt::flush;
+    }
+}
+
+/******************************************************************************
+ * 汇总
+ *
+ * 每个视频一项：状态、输出目录和文件、控球摘要和运行时间
+ * （performance.json存在时附带总耗时和最慢的阶段）。
+ ******************************************************************************/
+QJsonObject BatchRunner::entrySummary(const Entry &entry) const
+{
+    QJsonObject result;
+    result["input"] = entry.inputPath;
+
+    const AnalysisJob *job = scheduler->job(entry.jobId);
+    if (!job) {
+        result["status"] = "failed";
+        result["error"] = "Input video not found";
+        return result;
+    }
+
+    result["job_id"] = job->id;
+    result["status"] = job->status == AnalysisJob::Succeeded ? "succeeded"
+                     : job->status == AnalysisJob::Cancelled ? "cancelled" : "failed";
+    result["output_dir"] = job->outputDir;
+    if (!job->error.isEmpty()) {
+        result["error"] = job->error;
+    }
+    if (entry.started.isValid()) {
+        result["started"] = entry.started.toString(Qt::ISODate);
+        if (entry.finished.isValid()) {
+            result["elapsed_seconds"] = entry.started.msecsTo(entry.finished) / 1000.0;
+        }
+    }
+    if (job->status != AnalysisJob::Succeeded) {
+        return result;
+    }
+
+    const AnalysisResults files = AnalysisResults::locate(*job);
+    QJsonObject outputs;
+    const QList<QPair<QString, QString>> candidates = {
+        {"data_csv", files.summaryCsvPath},
+        {"data_json", files.summaryJsonPath},
+        {"frame_data", files.frameDataPath},
+        {"video", files.videoPath},
+        {"telemetry", files.telemetryPath},
+        {"performance", files.performancePath},
+    };
+    for (const auto &candidate : candidates) {
+        if (!candidate.second.isEmpty() && QFileInfo::exists(candidate.second)) {
+            outputs[candidate.first] = candidate.second;
+        }
+    }
+    result["outputs"] = outputs;
+
+    const QJsonObject data = AnalysisResults::readJson(files.summaryJsonPath);
+    if (!data.isEmpty()) {
+        result["possession"] = AnalysisResults::possessionSummary(data);
+    }
+
+    const QJsonObject performance = AnalysisResults::readJson(files.performancePath);
+    if (!performance.isEmpty()) {
+        QJsonObject slowest;
+        for (const QJsonValue &value : performance.value("stages").toArray()) {
+            const QJsonObject stage = value.toObject();
+            if (stage.value("wall").toDouble() > slowest.value("wall").toDouble()) {
+                slowest = stage;
+            }
+        }
+        QJsonObject timing;
+        timing["total_wall"] = performance.value("total_wall");
+        if (!slowest.isEmpty()) {
+            timing["slowest_stage"] = slowest.value("stage");
+            timing["slowest_stage_wall"] = slowest.value("wall");
+        }
+        result["performance"] = timing;
+    }
+    return result;
+}
+
+bool BatchRunner::writeSummary(const QJsonObject &summary)
+{
+    QSaveFile file(options.summaryPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(summary).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+void BatchRunner::printResults(const QJsonObject &summary) const
+{
+    QTextStream out(stdout);
+    out << QString("Batch finished in %1: %2 succeeded, %3 failed, %4 cancelled")
+               .arg(formatDuration(qint64(summary.value("elapsed_seconds").toDouble())))
+               .arg(summary.value("succeeded").toInt())
+               .arg(summary.value("failed").toInt())
+               .arg(summary.value("cancelled").toInt()) << Qt::endl;
+    for (const QJsonValue &value : summary.value("jobs").toArray()) {
+        const QJsonObject job = value.toObject();
+        const QString status = job.value("status").toString();
+        QString detail = status == "succeeded" ? job.value("output_dir").toString() : job.value("error").toString();
+        out << QString("  %1 %2 %3  %4")
+                   .arg(status, -9)
+                   .arg(job.contains("elapsed_seconds")
+                            ? formatDuration(qint64(job.value("elapsed_seconds").toDouble())) : QString("-"), 8)
+                   .arg(QFileInfo(job.value("input").toString()).fileName(), detail) << Qt::endl;
+    }
+    out << "Summary: " << options.summaryPath << Qt::endl;
+}
+
+/******************************************************************************
+ * 结束
+ *
+ * 队列空闲后写出汇总、打印结果表并以相应的退出状态结束。
+ ******************************************************************************/
+void BatchRunner::finish()
+{
+    if (done) {
+        return;
+    }
+    done = true;
+
+    QJsonArray jobs;
+    int succeeded = 0;
+    int failed = 0;
+    int cancelled = 0;
+    for (const Entry &entry : std::as_const(entries)) {
+        const QJsonObject job = entrySummary(entry);
+        const QString status = job.value("status").toString();
+        succeeded += status == "succeeded";
+        failed += status == "failed";
+        cancelled += status == "cancelled";
+        jobs.append(job);
+    }
+
+    const QDateTime batchFinished = QDateTime::currentDateTime();
+    QJsonObject summary;
+    summary["manifest"] = QFileInfo(options.manifestPath).absoluteFilePath();
+    summary["model"] = QFileInfo(options.modelPath).absoluteFilePath();
+    summary["started"] = batchStarted.toString(Qt::ISODate);
+    summary["finished"] = batchFinished.toString(Qt::ISODate);
+    summary["elapsed_seconds"] = batchStarted.msecsTo(batchFinished) / 1000.0;
+    summary["concurrency"] = scheduler->maxConcurrentJobs();
+    summary["threads_per_job"] = scheduler->threadsPerJob();
+    summary["video_codec"] = scheduler->videoCodec();
+    summary["backend"] = scheduler->detectionBackend();
+    summary["int8"] = scheduler->int8Inference();
+    summary["succeeded"] = succeeded;
+    summary["failed"] = failed;
+    summary["cancelled"] = cancelled;
+    summary["jobs"] = jobs;
+
+    scheduler->shutdown();
+
+    if (!writeSummary(summary)) {
+        err() << "Failed to write the summary to " << options.summaryPath << Qt::endl;
+        emit finished(SummaryError);
+        return;
+    }
+    printResults(summary);
+    emit finished(failed + cancelled > 0 ? SomeFailed : Succeeded);
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * BATCH RUNNER HEADER
+ *
+ * This header defines BatchRunner, the headless batch mode of the
+ * application (FootAnalysisGUI --batch <manifest>). It analyzes a list of
+ * videos without a display, on QCoreApplication.
+ *
+ * WHY:
+ * Processing servers have no display, but the same binary should run both
+ * interactive sessions on workstations and unattended overnight batches.
+ * BatchRunner drives the AnalysisScheduler that MainWindow uses (same
+ * worker pool, resource plan, per-job output directories and stub cache)
+ * and reads the results with AnalysisResults, so a batch produces exactly
+ * the files an interactive run produces.
+ *
+ * MANIFEST:
+ * A text file with one input video per line. Relative paths are resolved
+ * against the manifest's directory; blank lines and lines starting with #
+ * are ignored.
+ *
+ * OUTPUT:
+ * - One status line per job start, stage and finish on stderr (worker
+ *   output too with --verbose)
+ * - A result table on stdout when the batch ends
+ * - A consolidated JSON summary (default: <manifest>_summary.json next to
+ *   the manifest): settings, counts and one entry per video with its
+ *   status, output files, possession summary and run time
+ *
+ * EXIT STATUS:
+ * - 0 (Succeeded): every video was analyzed
+ * - 1 (SomeFailed): at least one video failed or is missing
+ * - 2 (UsageError): the manifest, model or worker script is unusable; no
+ *   job was started
+ * - 3 (SummaryError): the summary could not be written
+ ******************************************************************************/
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QStringList>
+#include "AnalysisScheduler.h"
+
+/**
+ * @class BatchRunner
+ * @brief Analyzes the videos of a manifest on the scheduler and writes a summary
+ */
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitStatus { Succeeded = 0, SomeFailed = 1, UsageError = 2, SummaryError = 3 };
+
+    struct Options {
+        QString manifestPath;
+        QString modelPath;              // YOLO model (default foot-Function/models/best.pt)
+        QString summaryPath;            // Summary JSON (default <manifest>_summary.json)
+        int concurrency = 0;            // Parallel jobs (0 = recommended for this machine)
+        QString videoCodec = "h264";    // Worker codec name, "none" = no annotated video
+        QString backend = "ultralytics";
+        bool int8 = false;              // INT8 model (onnx backend only)
+        bool verbose = false;           // Forward the worker output to stderr
+    };
+
+    explicit BatchRunner(const Options &options, QObject *parent = nullptr);
+
+    bool start();                       // Queue the manifest; false (see errorString()) if unusable
+    QString errorString() const;
+
+    static QStringList readManifest(const QString &path, QString *error);  // Absolute video paths
+
+signals:
+    void finished(int exitStatus);      // Batch done and summary written
+
+private slots:
+    void onJobChanged(const QString &jobId);
+    void onJobFinished(const QString &jobId, bool success);
+    void onLogOutput(const QString &text, bool isError);
+    void finish();
+
+private:
+    struct Entry {
+        QString inputPath;
+        QString jobId;                  // Empty if the video was not queued (missing)
+        QString stage;                  // Last reported stage
+        QDateTime started;
+        QDateTime finished;
+    };
+
+    QJsonObject entrySummary(const Entry &entry) const;
+    bool writeSummary(const QJsonObject &summary);
+    void printResults(const QJsonObject &summary) const;
+    Entry *findEntry(const QString &jobId);
+
+    Options options;
+    AnalysisScheduler *scheduler;       // Job queue and worker pool (as in MainWindow)
+    QList<Entry> entries;               // Videos in manifest order
+    QDateTime batchStarted;
+    bool queueing;                      // Inside start(): idle() is not the end yet
+    bool done;
+    QString error;
+};
+
+#endif // BATCHRUNNER_H
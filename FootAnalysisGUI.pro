@@ -1,4 +1,4 @@
-QT += core gui widgets multimedia multimediawidgets
+QT += core gui widgets multimedia multimediawidgets network
 
 CONFIG += c++17
 
@@ -8,10 +8,28 @@ CONFIG += c++17
 
 SOURCES += \
     main.cpp \
-    MainWindow.cpp
+    MainWindow.cpp \
+    AnalysisWorker.cpp \
+    AnalysisScheduler.cpp \
+    AnalysisResults.cpp \
+    BatchRunner.cpp \
+    ResultTableModel.cpp \
+    TrackTelemetry.cpp \
+    LogConsole.cpp \
+    OverlayVideoWidget.cpp \
+    PerformanceView.cpp
 
 HEADERS += \
-    MainWindow.h
+    MainWindow.h \
+    AnalysisWorker.h \
+    AnalysisScheduler.h \
+    AnalysisResults.h \
+    BatchRunner.h \
+    ResultTableModel.h \
+    TrackTelemetry.h \
+    LogConsole.h \
+    OverlayVideoWidget.h \
+    PerformanceView.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * 日志控制台实现
+ *
+ * 行先进入环形缓冲区，由定时器批量写入纯文本视图（见LogConsole.h）。
+ ******************************************************************************/
+
+#include "LogConsole.h"
+#include <QFontDatabase>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <algorithm>
+
+/******************************************************************************
+ * 构造函数
+ ******************************************************************************/
+LogConsole::LogConsole(QWidget *parent)
+    : QPlainTextEdit(parent)
+    , ringStart(0)
+    , ringCount(0)
+    , pendingCount(0)
+    , minLevel(Debug)
+    , flushTimer(nullptr)
+{
+    lastLevel[0] = Info;
+    lastLevel[1] = Info;
+
+    setReadOnly(true);
+    setUndoRedoEnabled(false);
+    setLineWrapMode(QPlainTextEdit::NoWrap);   // 不换行：布局代价与行长无关
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    document()->setMaximumBlockCount(kMaxViewLines);
+
+    ring.resize(kMaxBufferedLines);
+
+    flushTimer = new QTimer(this);
+    flushTimer->setInterval(kFlushIntervalMs);
+    flushTimer->setSingleShot(true);
+    connect(flushTimer, &QTimer::timeout, this, &LogConsole::flushPending);
+}
+
+/******************************************************************************
+ * 添加文本
+ *
+ * 只拆分行、判断级别并存入环形缓冲区；视图在下一次定时刷新时更新。
+ ******************************************************************************/
+void LogConsole::appendOutput(const QString &text, bool isStderr)
+{
+    const QStringList lines = text.split('\n');
+    for (const QString &line : lines) {
+        Level &previous = lastLevel[isStderr ? 1 : 0];
+        previous = classify(line, previous, isStderr);
+        appendLine(line, previous, isStderr);
+    }
+}
+
+void LogConsole::appendMessage(const QString &text)
+{
+    const QStringList lines = text.split('\n');
+    for (const QString &line : lines) {
+        appendLine(line, Info, false);
+    }
+}
+
+void LogConsole::appendLine(const QString &text, Level level, bool isStderr)
+{
+    // 缓冲区已满时覆盖最旧的行
+    const int index = (ringStart + ringCount) % kMaxBufferedLines;
+    if (ringCount == kMaxBufferedLines) {
+        ringStart = (ringStart + 1) % kMaxBufferedLines;
+    } else {
+        ++ringCount;
+    }
+    Line &line = ring[index];
+    line.text = text;
+    line.level = level;
+    line.isStderr = isStderr;
+
+    pendingCount = qMin(pendingCount + 1, kMaxBufferedLines);
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void LogConsole::clearLog()
+{
+    flushTimer->stop();
+    for (Line &line : ring) {
+        line.text.clear();
+    }
+    ringStart = 0;
+    ringCount = 0;
+    pendingCount = 0;
+    lastLevel[0] = Info;
+    lastLevel[1] = Info;
+    clear();
+}
+
+/******************************************************************************
+ * 级别过滤
+ *
+ * 从环形缓冲区重建视图（最多kMaxViewLines行）。
+ ******************************************************************************/
+void LogConsole::setMinimumLevel(Level level)
+{
+    if (level == minLevel) {
+        return;
+    }
+    minLevel = level;
+    flushTimer->stop();
+    pendingCount = 0;
+
+    QVector<const Line *> lines;
+    for (int i = ringCount - 1; i >= 0 && lines.size() < kMaxViewLines; --i) {
+        const Line &line = ring.at((ringStart + i) % kMaxBufferedLines);
+        if (line.level >= minLevel) {
+            lines.append(&line);
+        }
+    }
+    std::reverse(lines.begin(), lines.end());
+
+    clear();
+    writeLines(lines);
+}
+
+LogConsole::Level LogConsole::minimumLevel() const
+{
+    return minLevel;
+}
+
+/******************************************************************************
+ * 定时刷新
+ *
+ * 把上次刷新之后加入的行一次写入视图。
+ ******************************************************************************/
+void LogConsole::flushPending()
+{
+    QVector<const Line *> lines;
+    lines.reserve(qMin(pendingCount, kMaxViewLines));
+    for (int i = ringCount - pendingCount; i < ringCount; ++i) {
+        const Line &line = ring.at((ringStart + i) % kMaxBufferedLines);
+        if (line.level >= minLevel) {
+            lines.append(&line);
+        }
+    }
+    pendingCount = 0;
+    if (lines.size() > kMaxViewLines) {
+        lines.remove(0, lines.size() - kMaxViewLines);
+    }
+    writeLines(lines);
+}
+
+/******************************************************************************
+ * 写入视图
+ *
+ * 在一个编辑块中插入；相同格式的连续行合并为一次insertText。
+ * 只有滚动条原本在底部时才滚动到新内容。
+ ******************************************************************************/
+void LogConsole::writeLines(const QVector<const Line *> &lines)
+{
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = verticalScrollBar();
+    const bool atBottom = scrollBar->value() >= scrollBar->maximum() - 2;
+
+    QTextCharFormat normalFormat;
+    QTextCharFormat debugFormat;
+    debugFormat.setForeground(QColor("#6c757d"));
+    QTextCharFormat stderrFormat;
+    stderrFormat.setForeground(QColor("#b02a37"));
+    QTextCharFormat warningFormat;
+    warningFormat.setForeground(QColor("#b35c00"));
+    QTextCharFormat errorFormat;
+    errorFormat.setForeground(QColor("#dc3545"));
+    errorFormat.setFontWeight(QFont::Bold);
+
+    auto formatOf = [&](const Line *line) -> const QTextCharFormat & {
+        switch (line->level) {
+        case Error: return errorFormat;
+        case Warning: return warningFormat;
+        case Debug: return debugFormat;
+        default: return line->isStderr ? stderrFormat : normalFormat;
+        }
+    };
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    bool first = document()->isEmpty();
+    int runStart = 0;
+    while (runStart < lines.size()) {
+        const QTextCharFormat &format = formatOf(lines.at(runStart));
+        int runEnd = runStart + 1;
+        while (runEnd < lines.size() && &formatOf(lines.at(runEnd)) == &format) {
+            ++runEnd;
+        }
+        QString text;
+        for (int i = runStart; i < runEnd; ++i) {
+            if (!first || i > runStart) {
+                text += '\n';
+            }
+            text += lines.at(i)->text;
+        }
+        first = false;
+        cursor.insertText(text, format);
+        runStart = runEnd;
+    }
+    cursor.endEditBlock();
+
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+/******************************************************************************
+ * 级别判断
+ *
+ * - Python logging格式的行（"... - WARNING - ..."）使用其级别
+ * - Traceback和stderr上的异常行（"ValueError: ..."）是错误；
+ *   缩进的行（traceback内容）沿用上一行的级别
+ * - 其他行为Info
+ ******************************************************************************/
+LogConsole::Level LogConsole::classify(const QString &line, Level previous, bool isStderr)
+{
+    static const QRegularExpression levelPattern(" - (DEBUG|INFO|WARNING|ERROR|CRITICAL) - ");
+    static const QRegularExpression continuationPattern("^(\\[worker \\d+\\] )?\\s");
+    static const QRegularExpression exceptionPattern("^(\\[worker \\d+\\] )?[\\w.]+(Error|Exception|Interrupt):");
+
+    const QRegularExpressionMatch match = levelPattern.match(line);
+    if (match.hasMatch()) {
+        const QStringView name = match.capturedView(1);
+        if (name == u"DEBUG") {
+            return Debug;
+        }
+        if (name == u"INFO") {
+            return Info;
+        }
+        if (name == u"WARNING") {
+            return Warning;
+        }
+        return Error;
+    }
+    if (isStderr && (line.contains("Traceback (most recent call last)")
+                     || exceptionPattern.match(line).hasMatch())) {
+        return Error;
+    }
+    if (continuationPattern.match(line).hasMatch()) {
+        return previous;
+    }
+    return Info;
+}
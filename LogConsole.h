@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * LOG CONSOLE HEADER
+ *
+ * This header defines LogConsole, the plain-text view on the Logs tab.
+ *
+ * WHY NOT QTextEdit::append:
+ * Appending every worker read to a rich-text QTextEdit (stderr wrapped in
+ * HTML spans) re-lays out the document on each read, moves the cursor each
+ * time and grows the document without limit. With verbose per-batch logging
+ * that keeps the GUI thread busy.
+ *
+ * DESIGN:
+ * - appendOutput()/appendMessage() only split the text into lines, classify
+ *   their level and store them in a ring buffer (the newest kMaxBufferedLines
+ *   lines); nothing touches the view
+ * - A timer flushes the lines added since the last flush every
+ *   kFlushIntervalMs in one edit block, one text format per run of lines of
+ *   the same level (no HTML)
+ * - The view keeps at most kMaxViewLines lines (oldest dropped)
+ * - setMinimumLevel() hides lower levels; the view is rebuilt from the ring
+ *   buffer, so earlier lines reappear when the filter is relaxed
+ * - The view only follows new output while scrolled to the bottom
+ *
+ * LEVELS:
+ * Lines from the Python logging format ("... - WARNING - ...") use their
+ * level. A traceback is an error, and its indented lines keep the level of
+ * the line before them. Other stderr lines are Info but shown in the stderr
+ * color.
+ ******************************************************************************/
+
+#ifndef LOGCONSOLE_H
+#define LOGCONSOLE_H
+
+#include <QPlainTextEdit>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @class LogConsole
+ * @brief Read-only log view with a bounded line buffer and batched updates
+ */
+class LogConsole : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    enum Level { Debug = 0, Info = 1, Warning = 2, Error = 3 };
+
+    static constexpr int kMaxBufferedLines = 50000;    // Lines kept for re-filtering
+    static constexpr int kMaxViewLines = 10000;        // Lines shown in the view
+    static constexpr int kFlushIntervalMs = 100;
+
+    explicit LogConsole(QWidget *parent = nullptr);
+
+    void appendOutput(const QString &text, bool isStderr);  // Worker stdout/stderr text
+    void appendMessage(const QString &text);                // GUI message (Info)
+    void clearLog();
+
+    void setMinimumLevel(Level level);
+    Level minimumLevel() const;
+
+private slots:
+    void flushPending();
+
+private:
+    struct Line {
+        QString text;
+        Level level = Info;
+        bool isStderr = false;
+    };
+
+    void appendLine(const QString &text, Level level, bool isStderr);
+    void writeLines(const QVector<const Line *> &lines);
+    static Level classify(const QString &line, Level previous, bool isStderr);
+
+    // Ring buffer of the newest kMaxBufferedLines lines
+    QVector<Line> ring;
+    int ringStart;                      // Index of the oldest line
+    int ringCount;
+    int pendingCount;                   // Newest lines not yet written to the view
+
+    Level lastLevel[2];                 // Level of the previous stdout/stderr line
+    Level minLevel;
+    QTimer *flushTimer;
+};
+
+#endif // LOGCONSOLE_H
@@ -3,17 +3,17 @@
  * 
  * 本文件实现足球分析GUI主窗口，提供以下功能：
  * - 视频分析配置的用户界面
- * - 异步Python进程执行和监控
+ * - 分析任务队列：多个视频由常驻Python工作进程池并行分析（模型只加载一次）
  * - 实时进度更新和日志显示
  * - 自动结果加载（CSV/JSON数据、标注视频）
  * - 嵌入式视频播放器和播放控制
  * 
  * 执行流程：
  * 1. 用户通过文件浏览器选择输入视频和YOLO模型
- * 2. 用户点击"开始分析"按钮
- * 3. QProcess启动Python脚本（main.py）并传入参数
- * 4. GUI实时捕获stdout/stderr，保持响应
- * 5. 完成后，自动加载并显示结果
+ * 2. 用户点击"开始分析"按钮（或一次添加多个视频到队列）
+ * 3. 调度器把任务分派给空闲的常驻工作进程（worker.py，按需启动）
+ * 4. GUI实时接收进度事件和日志，保持响应
+ * 5. 每个任务完成后，自动加载并显示其结果（每个任务有自己的输出目录）
  * 6. 用户在表格中查看数据并播放标注视频
  ******************************************************************************/
 
@@ -29,7 +29,8 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
-#include <QTextStream>
+#include <QLocale>
+#include <algorithm>
 
 /******************************************************************************
  * 构造函数
@@ -48,31 +49,78 @@ MainWindow::MainWindow(QWidget *parent)
     , modelPathEdit(nullptr)
     , browseModelButton(nullptr)
     , startButton(nullptr)
-    , outputTextEdit(nullptr)
+    , addVideosButton(nullptr)
+    , pauseButton(nullptr)
+    , cancelButton(nullptr)
+    , concurrencySpinBox(nullptr)
+    , videoCodecComboBox(nullptr)
+    , backendComboBox(nullptr)
+    , resourcePlanLabel(nullptr)
+    , logConsole(nullptr)
+    , logLevelComboBox(nullptr)
     , statusLabel(nullptr)
     , progressBar(nullptr)
+    , progressDetailLabel(nullptr)
     , elapsedTimeLabel(nullptr)
     , elapsedTimer(nullptr)
+    , activeElapsedMs(0)
     , updateTimer(nullptr)
     , resultsTabWidget(nullptr)
     , resultImageLabel(nullptr)
     , resultScrollArea(nullptr)
-    , dataTableWidget(nullptr)
+    , jobQueueTable(nullptr)
+    , removeJobButton(nullptr)
+    , cancelJobButton(nullptr)
+    , resumeJobButton(nullptr)
+    , clearFinishedButton(nullptr)
+    , queueTab(nullptr)
+    , dataTableView(nullptr)
+    , dataModel(nullptr)
+    , dataProxyModel(nullptr)
+    , dataSourceComboBox(nullptr)
+    , dataFilterColumnComboBox(nullptr)
+    , dataFilterEdit(nullptr)
+    , dataFilterTimer(nullptr)
+    , dataRowCountLabel(nullptr)
     , dataTab(nullptr)
     , mediaPlayer(nullptr)
     , audioOutput(nullptr)
     , videoWidget(nullptr)
+    , overlayWidget(nullptr)
+    , videoStack(nullptr)
+    , videoModeComboBox(nullptr)
+    , overlayOptions(nullptr)
+    , positionSlider(nullptr)
+    , positionLabel(nullptr)
     , playPauseButton(nullptr)
     , stopButton(nullptr)
     , videoTab(nullptr)
-    , pythonProcess(nullptr)
+    , performanceView(nullptr)
+    , scheduler(nullptr)
     , analysisRunning(false)
+    , runSucceeded(0)
+    , runFailed(0)
+    , runCancelled(0)
 {
+    // 任务调度器：工作进程池按需启动，之后保持模型加载
+    // （在setupUI之前创建，以便用推荐的并发数初始化控件）
+    scheduler = new AnalysisScheduler(
+        QDir(AnalysisScheduler::projectRootPath()).absoluteFilePath("foot-Function"), this);
+    
     // 加载并应用现代QSS样式表以获得专业外观
     loadStyleSheet();
     
     // 构建整个UI（部件、布局、连接）
     setupUI();
+    
+    connect(scheduler, &AnalysisScheduler::jobAdded, this, &MainWindow::onSchedulerJobAdded);
+    connect(scheduler, &AnalysisScheduler::jobChanged, this, &MainWindow::onSchedulerJobChanged);
+    connect(scheduler, &AnalysisScheduler::jobRemoved, this, &MainWindow::onSchedulerJobRemoved);
+    connect(scheduler, &AnalysisScheduler::jobEvent, this, &MainWindow::onWorkerJobEvent);
+    connect(scheduler, &AnalysisScheduler::jobFinished, this, &MainWindow::onJobFinished);
+    connect(scheduler, &AnalysisScheduler::idle, this, &MainWindow::onQueueIdle);
+    connect(scheduler, &AnalysisScheduler::logOutput, this, &MainWindow::onWorkerLogOutput);
+    connect(scheduler, &AnalysisScheduler::modelLoaded, this, &MainWindow::onWorkerModelLoaded);
     setWindowTitle("Foot Analysis GUI");
     
     // 配置窗口大小以获得最佳用户体验
@@ -84,7 +132,7 @@ MainWindow::MainWindow(QWidget *parent)
  * 析构函数
  * 
  * 清理资源并确保Python进程终止。
- * 停止视频播放并终止任何正在运行的分析进程。
+ * 停止视频播放并关闭所有常驻分析工作进程。
  ******************************************************************************/
 MainWindow::~MainWindow()
 {
@@ -95,52 +143,11 @@ MainWindow::~MainWindow()
     if (audioOutput) {
         delete audioOutput;
     }
-    if (pythonProcess) {
-        if (pythonProcess->state() == QProcess::Running) {
-            pythonProcess->kill();
-            pythonProcess->waitForFinished();
-        }
-        delete pythonProcess;
-    }
-}
-
-/******************************************************************************
- * 实用方法：获取项目根路径
- * 
- * 通过从可执行文件位置向上搜索来定位项目根目录。
- * 项目根目录通过同时存在FootAnalysisGUI.pro和foot-Function目录来识别。
- * 
- * 这使应用程序能够正确工作，无论可执行文件位于何处
- * （构建目录、安装位置等）。
- * 
- * 返回：项目根目录的绝对路径
- ******************************************************************************/
-QString MainWindow::getProjectRootPath() const
-{
-    // 获取包含可执行文件的目录
-    QString exeDir = QCoreApplication::applicationDirPath();
-    
-    // 向上搜索项目根目录（FootAnalysisGUI.pro和foot-Function所在位置）
-    QDir dir(exeDir);
-    int maxLevelsUp = 5;  // 向上搜索的最大层级数
-    
-    for (int i = 0; i < maxLevelsUp; ++i) {
-        // 检查foot-Function目录是否存在于此处
-        if (dir.exists("foot-Function") && dir.exists("FootAnalysisGUI.pro")) {
-            qDebug() << "Found project root at:" << dir.absolutePath();
-            return dir.absolutePath();
-        }
-        
-        // 向上移动一级
-        if (!dir.cdUp()) {
-            break;  // 已到达文件系统根目录
-        }
+    if (scheduler) {
+        // 先断开信号，避免关闭期间回调已部分析构的窗口
+        disconnect(scheduler, nullptr, this, nullptr);
+        scheduler->shutdown();
     }
-    
-    // 备用方案：假设foot-Function与可执行文件在同一目录
-    // 这处理可执行文件从项目根目录运行的情况
-    qDebug() << "Could not find project root, using exe directory:" << exeDir;
-    return exeDir;
 }
 
 /******************************************************************************
@@ -244,6 +251,80 @@ void MainWindow::setupUI()
     startButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     controlLayout->addWidget(startButton);
     
+    // 一次添加多个视频到队列
+    addVideosButton = new QPushButton("Add Videos to Queue...", this);
+    addVideosButton->setToolTip("Queue several videos with the selected model");
+    addVideosButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    controlLayout->addWidget(addVideosButton);
+    
+    // 暂停/取消正在进行的分析（只在运行期间显示）
+    QHBoxLayout *runControlLayout = new QHBoxLayout();
+    runControlLayout->setSpacing(6);
+    pauseButton = new QPushButton("Pause", this);
+    pauseButton->setToolTip("Hold the running jobs between two frames and stop starting queued ones");
+    pauseButton->setVisible(false);
+    cancelButton = new QPushButton("Cancel", this);
+    cancelButton->setToolTip("Cancel all queued and running jobs; cancelled jobs can be resumed "
+                             "from the Job Queue tab");
+    cancelButton->setVisible(false);
+    runControlLayout->addWidget(pauseButton);
+    runControlLayout->addWidget(cancelButton);
+    controlLayout->addLayout(runControlLayout);
+    
+    // 并行任务数（默认值根据核心数和可用内存计算）
+    QHBoxLayout *concurrencyLayout = new QHBoxLayout();
+    concurrencyLayout->setSpacing(6);
+    QLabel *concurrencyLabel = new QLabel("Parallel jobs:", this);
+    concurrencySpinBox = new QSpinBox(this);
+    concurrencySpinBox->setRange(1, qMax(1, AnalysisScheduler::recommendedPlan().cpuCores));
+    concurrencySpinBox->setValue(scheduler->maxConcurrentJobs());
+    concurrencySpinBox->setToolTip("Number of videos analyzed at the same time");
+    concurrencyLayout->addWidget(concurrencyLabel);
+    concurrencyLayout->addStretch();
+    concurrencyLayout->addWidget(concurrencySpinBox);
+    controlLayout->addLayout(concurrencyLayout);
+    
+    // 输出视频编码器（数据为工作进程的编码器名称）
+    QHBoxLayout *codecLayout = new QHBoxLayout();
+    codecLayout->setSpacing(6);
+    QLabel *codecLabel = new QLabel("Output video:", this);
+    videoCodecComboBox = new QComboBox(this);
+    videoCodecComboBox->addItem("H.264 (MP4)", "h264");
+    videoCodecComboBox->addItem("MPEG-4 (MP4)", "mp4v");
+    videoCodecComboBox->addItem("XVID (AVI)", "xvid");
+    videoCodecComboBox->addItem("Motion JPEG (AVI)", "mjpg");
+    videoCodecComboBox->addItem("None (live overlay only)", "none");
+    videoCodecComboBox->setCurrentIndex(videoCodecComboBox->findData(scheduler->videoCodec()));
+    videoCodecComboBox->setToolTip("Codec of the annotated video; H.264 falls back to MPEG-4 "
+                                   "if the local OpenCV build has no H.264 encoder. None skips "
+                                   "rendering; the Video Output tab draws the overlays itself");
+    codecLayout->addWidget(codecLabel);
+    codecLayout->addStretch();
+    codecLayout->addWidget(videoCodecComboBox);
+    controlLayout->addLayout(codecLayout);
+    
+    // 检测后端（数据为工作进程的后端名称，"-int8"后缀表示INT8量化模型）
+    QHBoxLayout *backendLayout = new QHBoxLayout();
+    backendLayout->setSpacing(6);
+    QLabel *backendLabel = new QLabel("Detection:", this);
+    backendComboBox = new QComboBox(this);
+    backendComboBox->addItem("Ultralytics (PyTorch)", "ultralytics");
+    backendComboBox->addItem("ONNX Runtime (CPU)", "onnx");
+    backendComboBox->addItem("ONNX Runtime INT8 (CPU)", "onnx-int8");
+    backendComboBox->setToolTip("Detection backend; ONNX Runtime exports the .pt model to ONNX "
+                                "on first use, INT8 is faster on CPU at a small accuracy cost");
+    backendLayout->addWidget(backendLabel);
+    backendLayout->addStretch();
+    backendLayout->addWidget(backendComboBox);
+    controlLayout->addLayout(backendLayout);
+    
+    resourcePlanLabel = new QLabel(this);
+    resourcePlanLabel->setProperty("elapsedTime", true);
+    resourcePlanLabel->setWordWrap(true);
+    resourcePlanLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    controlLayout->addWidget(resourcePlanLabel);
+    updateResourcePlanLabel();
+    
     // 进度条（初始隐藏）
     progressBar = new QProgressBar(this);
     progressBar->setRange(0, 0);  // 不确定模式
@@ -253,6 +334,15 @@ void MainWindow::setupUI()
     progressBar->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     controlLayout->addWidget(progressBar);
     
+    // 进度详情标签：阶段帧数、吞吐量和剩余时间（初始隐藏）
+    progressDetailLabel = new QLabel(this);
+    progressDetailLabel->setProperty("elapsedTime", true);
+    progressDetailLabel->setAlignment(Qt::AlignCenter);
+    progressDetailLabel->setWordWrap(true);
+    progressDetailLabel->setVisible(false);  // 初始隐藏
+    progressDetailLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    controlLayout->addWidget(progressDetailLabel);
+    
     // 已用时间标签（初始隐藏）
     elapsedTimeLabel = new QLabel("Elapsed: 0:00", this);
     elapsedTimeLabel->setProperty("elapsedTime", true);
@@ -330,6 +420,56 @@ void MainWindow::setupUI()
     summaryLayout->addWidget(resultScrollArea);
     resultsTabWidget->addTab(summaryTab, "Summary");
     
+    // 选项卡：任务队列
+    queueTab = new QWidget();
+    queueTab->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    QVBoxLayout *queueLayout = new QVBoxLayout(queueTab);
+    queueLayout->setContentsMargins(16, 16, 16, 16);
+    queueLayout->setSpacing(12);
+    
+    QHBoxLayout *queueHeaderLayout = new QHBoxLayout();
+    QLabel *queueLabel = new QLabel("Analysis Jobs (double-click a finished job to view its results)", this);
+    queueHeaderLayout->addWidget(queueLabel);
+    queueHeaderLayout->addStretch();
+    
+    removeJobButton = new QPushButton("Remove", this);
+    removeJobButton->setMinimumWidth(70);
+    removeJobButton->setToolTip("Remove the selected queued or finished jobs");
+    queueHeaderLayout->addWidget(removeJobButton);
+    
+    cancelJobButton = new QPushButton("Cancel", this);
+    cancelJobButton->setMinimumWidth(70);
+    cancelJobButton->setToolTip("Cancel the selected queued or running jobs");
+    queueHeaderLayout->addWidget(cancelJobButton);
+    
+    resumeJobButton = new QPushButton("Resume", this);
+    resumeJobButton->setMinimumWidth(70);
+    resumeJobButton->setToolTip("Run the selected cancelled or failed jobs again; detection "
+                                "continues from the last checkpoint");
+    queueHeaderLayout->addWidget(resumeJobButton);
+    
+    clearFinishedButton = new QPushButton("Clear Finished", this);
+    clearFinishedButton->setMinimumWidth(70);
+    queueHeaderLayout->addWidget(clearFinishedButton);
+    
+    queueLayout->addLayout(queueHeaderLayout);
+    
+    jobQueueTable = new QTableWidget(0, 4, this);
+    jobQueueTable->setHorizontalHeaderLabels(QStringList() << "Video" << "Status" << "Progress" << "Output");
+    jobQueueTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    jobQueueTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    jobQueueTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    jobQueueTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    jobQueueTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    jobQueueTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+    jobQueueTable->horizontalHeader()->setStretchLastSection(true);
+    jobQueueTable->verticalHeader()->setVisible(false);
+    jobQueueTable->setAlternatingRowColors(true);
+    jobQueueTable->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    queueLayout->addWidget(jobQueueTable);
+    
+    resultsTabWidget->addTab(queueTab, "Job Queue");
+    
     // 选项卡2：数据表
     dataTab = new QWidget();
     dataTab->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -341,13 +481,53 @@ void MainWindow::setupUI()
     dataLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     dataLayout->addWidget(dataLabel);
     
-    dataTableWidget = new QTableWidget(this);
-    dataTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    dataTableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-    dataTableWidget->horizontalHeader()->setStretchLastSection(true);
-    dataTableWidget->setAlternatingRowColors(true);
-    dataTableWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    dataLayout->addWidget(dataTableWidget);
+    // 数据源和过滤
+    QHBoxLayout *dataToolbarLayout = new QHBoxLayout();
+    dataToolbarLayout->setSpacing(6);
+    dataToolbarLayout->addWidget(new QLabel("Show:", this));
+    dataSourceComboBox = new QComboBox(this);
+    dataSourceComboBox->addItem("Player summary");
+    dataSourceComboBox->addItem("Per-frame data");
+    dataSourceComboBox->setToolTip("Per-frame data: speed, distance, team and possession of every "
+                                   "player in every frame (frame_data.csv)");
+    dataSourceComboBox->setEnabled(false);
+    dataToolbarLayout->addWidget(dataSourceComboBox);
+    dataToolbarLayout->addStretch();
+    dataToolbarLayout->addWidget(new QLabel("Filter:", this));
+    dataFilterColumnComboBox = new QComboBox(this);
+    dataFilterColumnComboBox->addItem("All columns");
+    dataToolbarLayout->addWidget(dataFilterColumnComboBox);
+    dataFilterEdit = new QLineEdit(this);
+    dataFilterEdit->setPlaceholderText("Text or number (numbers match exactly)");
+    dataFilterEdit->setClearButtonEnabled(true);
+    dataToolbarLayout->addWidget(dataFilterEdit);
+    dataRowCountLabel = new QLabel(this);
+    dataRowCountLabel->setProperty("elapsedTime", true);
+    dataToolbarLayout->addWidget(dataRowCountLabel);
+    dataLayout->addLayout(dataToolbarLayout);
+    
+    dataFilterTimer = new QTimer(this);
+    dataFilterTimer->setSingleShot(true);
+    dataFilterTimer->setInterval(300);
+    
+    // 模型/视图：行按页从磁盘读取，排序和过滤由代理模型完成
+    dataModel = new ResultTableModel(this);
+    dataProxyModel = new ResultFilterProxyModel(this);
+    dataProxyModel->setResultModel(dataModel);
+    
+    dataTableView = new QTableView(this);
+    dataTableView->setModel(dataProxyModel);
+    dataTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    dataTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    dataTableView->horizontalHeader()->setStretchLastSection(true);
+    dataTableView->horizontalHeader()->setResizeContentsPrecision(ResultTableModel::kRowsPerPage);
+    dataTableView->horizontalHeader()->setSortIndicatorClearable(true);
+    dataTableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    dataTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    dataTableView->setSortingEnabled(true);
+    dataTableView->setAlternatingRowColors(true);
+    dataTableView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    dataLayout->addWidget(dataTableView);
     
     resultsTabWidget->addTab(dataTab, "Data Table");
     
@@ -358,10 +538,52 @@ void MainWindow::setupUI()
     videoLayout->setContentsMargins(16, 16, 16, 16);
     videoLayout->setSpacing(12);
     
+    // 显示方式：流程渲染的标注视频，或在输入视频上根据追踪遥测即时绘制叠加层
+    QHBoxLayout *videoModeLayout = new QHBoxLayout();
+    videoModeLayout->setSpacing(8);
+    videoModeLayout->addWidget(new QLabel("Show:", this));
+    videoModeComboBox = new QComboBox(this);
+    videoModeComboBox->addItem("Annotated video");
+    videoModeComboBox->addItem("Live overlay on input video");
+    videoModeComboBox->setToolTip("Live overlay plays the original video and draws the annotations "
+                                  "from the track data (tracks.ftrk); no rendered video needed");
+    videoModeComboBox->setEnabled(false);
+    videoModeLayout->addWidget(videoModeComboBox);
+    
+    overlayOptions = new QWidget(this);
+    QHBoxLayout *overlayOptionsLayout = new QHBoxLayout(overlayOptions);
+    overlayOptionsLayout->setContentsMargins(0, 0, 0, 0);
+    overlayOptionsLayout->setSpacing(8);
+    const QList<QPair<QString, OverlayVideoWidget::Overlay>> overlayToggles = {
+        {"Players", OverlayVideoWidget::Players},
+        {"Referees", OverlayVideoWidget::Referees},
+        {"Ball", OverlayVideoWidget::Ball},
+        {"Possession", OverlayVideoWidget::Possession},
+        {"Speed", OverlayVideoWidget::Speed},
+    };
+    for (const auto &toggle : overlayToggles) {
+        QCheckBox *checkBox = new QCheckBox(toggle.first, overlayOptions);
+        checkBox->setChecked(true);
+        const OverlayVideoWidget::Overlay overlay = toggle.second;
+        connect(checkBox, &QCheckBox::toggled, this, [this, overlay](bool checked) {
+            overlayWidget->setOverlayEnabled(overlay, checked);
+        });
+        overlayOptionsLayout->addWidget(checkBox);
+    }
+    overlayOptions->setVisible(false);
+    videoModeLayout->addWidget(overlayOptions);
+    videoModeLayout->addStretch();
+    videoLayout->addLayout(videoModeLayout);
+    
     videoWidget = new QVideoWidget(this);
     videoWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    videoWidget->setMinimumHeight(300);
-    videoLayout->addWidget(videoWidget, 1);
+    overlayWidget = new OverlayVideoWidget(this);
+    overlayWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    videoStack = new QStackedWidget(this);
+    videoStack->addWidget(videoWidget);
+    videoStack->addWidget(overlayWidget);
+    videoStack->setMinimumHeight(300);
+    videoLayout->addWidget(videoStack, 1);
     
     // 视频控制
     QHBoxLayout *controlsLayout = new QHBoxLayout();
@@ -375,9 +597,15 @@ void MainWindow::setupUI()
     stopButton->setMinimumWidth(80);
     stopButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
     
+    positionSlider = new QSlider(Qt::Horizontal, this);
+    positionSlider->setEnabled(false);
+    positionLabel = new QLabel(this);
+    positionLabel->setProperty("elapsedTime", true);
+    
     controlsLayout->addWidget(playPauseButton);
     controlsLayout->addWidget(stopButton);
-    controlsLayout->addStretch();
+    controlsLayout->addWidget(positionSlider, 1);
+    controlsLayout->addWidget(positionLabel);
     
     videoLayout->addLayout(controlsLayout, 0);
     
@@ -395,6 +623,14 @@ void MainWindow::setupUI()
     logsHeaderLayout->addWidget(logsLabel);
     logsHeaderLayout->addStretch();
     
+    logLevelComboBox = new QComboBox(this);
+    logLevelComboBox->addItem("All levels", LogConsole::Debug);
+    logLevelComboBox->addItem("Info and above", LogConsole::Info);
+    logLevelComboBox->addItem("Warnings and errors", LogConsole::Warning);
+    logLevelComboBox->addItem("Errors only", LogConsole::Error);
+    logLevelComboBox->setToolTip("Minimum level of the log lines shown");
+    logsHeaderLayout->addWidget(logLevelComboBox);
+    
     QPushButton *clearLogButton = new QPushButton("Clear", this);
     clearLogButton->setMinimumWidth(70);
     clearLogButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
@@ -402,14 +638,25 @@ void MainWindow::setupUI()
     
     logsLayout->addLayout(logsHeaderLayout);
     
-    outputTextEdit = new QTextEdit(this);
-    outputTextEdit->setReadOnly(true);
-    outputTextEdit->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    outputTextEdit->setMinimumHeight(200);
-    logsLayout->addWidget(outputTextEdit);
+    // 环形缓冲区 + 定时批量刷新的纯文本日志视图
+    logConsole = new LogConsole(this);
+    logConsole->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    logConsole->setMinimumHeight(200);
+    logsLayout->addWidget(logConsole);
     
     resultsTabWidget->addTab(logsTab, "Logs");
     
+    // 选项卡5：性能（各阶段耗时，与同一视频的上一次运行比较）
+    QWidget *performanceTab = new QWidget();
+    performanceTab->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    QVBoxLayout *performanceLayout = new QVBoxLayout(performanceTab);
+    performanceLayout->setContentsMargins(16, 16, 16, 16);
+    performanceLayout->setSpacing(12);
+    performanceView = new PerformanceView(this);
+    performanceLayout->addWidget(performanceView);
+    
+    resultsTabWidget->addTab(performanceTab, "Performance");
+    
     mainAreaLayout->addWidget(resultsTabWidget);
     
     mainSplitter->addWidget(mainArea);
@@ -421,7 +668,10 @@ void MainWindow::setupUI()
     
     // 连接清除日志按钮
     connect(clearLogButton, &QPushButton::clicked, [this]() {
-        outputTextEdit->clear();
+        logConsole->clearLog();
+    });
+    connect(logLevelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        logConsole->setMinimumLevel(LogConsole::Level(logLevelComboBox->currentData().toInt()));
     });
     
     // 初始化媒体播放器
@@ -446,8 +696,48 @@ void MainWindow::setupUI()
     connect(browseInputButton, &QToolButton::clicked, this, &MainWindow::onBrowseInputVideo);
     connect(browseModelButton, &QToolButton::clicked, this, &MainWindow::onBrowseModel);
     connect(startButton, &QPushButton::clicked, this, &MainWindow::onStartAnalysis);
+    connect(addVideosButton, &QPushButton::clicked, this, &MainWindow::onAddVideosToQueue);
+    connect(pauseButton, &QPushButton::clicked, this, &MainWindow::onPauseQueue);
+    connect(cancelButton, &QPushButton::clicked, this, &MainWindow::onCancelQueue);
+    connect(concurrencySpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onConcurrencyChanged);
+    connect(videoCodecComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onVideoCodecChanged);
+    connect(backendComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onDetectionBackendChanged);
+    connect(removeJobButton, &QPushButton::clicked, this, &MainWindow::onRemoveSelectedJobs);
+    connect(cancelJobButton, &QPushButton::clicked, this, &MainWindow::onCancelSelectedJobs);
+    connect(resumeJobButton, &QPushButton::clicked, this, &MainWindow::onResumeSelectedJobs);
+    connect(clearFinishedButton, &QPushButton::clicked, this, &MainWindow::onClearFinishedJobs);
+    connect(jobQueueTable, &QTableWidget::cellDoubleClicked, this, &MainWindow::onQueueItemDoubleClicked);
     connect(playPauseButton, &QPushButton::clicked, this, &MainWindow::onPlayPauseVideo);
     connect(stopButton, &QPushButton::clicked, this, &MainWindow::onStopVideo);
+    connect(videoModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onVideoModeChanged);
+    // 拖动进度条时立即跳转（暂停时也显示该帧及其叠加层）
+    connect(positionSlider, &QSlider::sliderMoved, mediaPlayer, &QMediaPlayer::setPosition);
+    connect(positionSlider, &QSlider::actionTriggered, this, [this]() {
+        mediaPlayer->setPosition(positionSlider->sliderPosition());
+    });
+    connect(mediaPlayer, &QMediaPlayer::durationChanged, this, [this](qint64 duration) {
+        positionSlider->setRange(0, int(duration));
+        updateVideoPositionLabel();
+    });
+    connect(mediaPlayer, &QMediaPlayer::positionChanged, this, [this](qint64 position) {
+        if (!positionSlider->isSliderDown()) {
+            QSignalBlocker blocker(positionSlider);
+            positionSlider->setValue(int(position));
+        }
+        updateVideoPositionLabel();
+    });
+    connect(dataSourceComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onDataSourceChanged);
+    connect(dataFilterColumnComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onDataFilterChanged);
+    connect(dataFilterEdit, &QLineEdit::textChanged, dataFilterTimer, qOverload<>(&QTimer::start));
+    connect(dataFilterTimer, &QTimer::timeout, this, &MainWindow::onDataFilterChanged);
+    connect(dataProxyModel, &QAbstractItemModel::modelReset, this, &MainWindow::updateDataRowCount);
+    connect(dataProxyModel, &QAbstractItemModel::layoutChanged, this, &MainWindow::updateDataRowCount);
 }
 
 /******************************************************************************
@@ -475,8 +765,9 @@ void MainWindow::onBrowseInputVideo()
  * 事件处理程序：浏览模型
  * 
  * 打开文件对话框供用户选择YOLO模型文件。
- * 支持PyTorch模型格式（.pt、.pth）。
+ * 支持PyTorch模型格式（.pt、.pth）和ONNX模型（.onnx，仅ONNX Runtime后端）。
  * 使用所选文件路径更新模型路径文本字段。
+ * 如果工作进程已在运行，立即在后台预加载该模型。
  ******************************************************************************/
 void MainWindow::onBrowseModel()
 {
@@ -484,44 +775,38 @@ void MainWindow::onBrowseModel()
         this,
         "Select YOLO Model",
         QDir::homePath(),
-        "Model Files (*.pt *.pth);;All Files (*.*)"
+        "Model Files (*.pt *.pth *.onnx);;All Files (*.*)"
     );
     
     if (!fileName.isEmpty()) {
         modelPathEdit->setText(fileName);
+        scheduler->preloadModel(fileName);
     }
 }
 
 /******************************************************************************
  * 事件处理程序：开始分析
  * 
- * 作为单独的进程启动Python视频分析管道。
+ * 将所选视频作为分析任务加入队列。
+ * 如果有空闲的工作进程，任务立即开始；否则排队等待。
  * 
  * 验证：
- * - 检查分析是否已在运行
  * - 验证是否提供了输入视频和模型路径
  * - 在开始前验证文件是否存在
+ * - 验证工作进程脚本是否存在
  * 
- * 进程执行：
- * - 从UI清除之前的结果
- * - 为Python脚本构造命令行参数
- * - 将工作目录更改为foot-Function
- * - 启动QProcess异步运行Python main.py
- * - 连接进程信号以进行实时监控
+ * 任务执行（由AnalysisScheduler负责）：
+ * - 工作进程未运行时先启动它（工作目录为foot-Function）
+ * - 每个任务获得线程预算和自己的输出目录
+ * - 模型未改变时工作进程直接复用已加载的模型
  * 
- * UI更新：
- * - 分析期间禁用开始按钮
+ * UI更新（队列从空闲变为活动时）：
+ * - 清除之前的结果
  * - 启动已用时间计数器
  * - 将状态标签更新为"正在运行"
- * - 显示初始日志消息
  ******************************************************************************/
 void MainWindow::onStartAnalysis()
 {
-    if (analysisRunning) {
-        QMessageBox::warning(this, "Analysis Running", "An analysis is already in progress.");
-        return;
-    }
-    
     QString inputVideo = inputVideoPathEdit->text().trimmed();
     QString modelPath = modelPathEdit->text().trimmed();
     
@@ -545,34 +830,48 @@ void MainWindow::onStartAnalysis()
         return;
     }
     
-    // 清除之前的结果
-    outputTextEdit->clear();
-    resultImageLabel->clear();
-    resultImageLabel->setText("Analysis in progress...");
-    dataTableWidget->clearContents();
-    dataTableWidget->setRowCount(0);
-    dataTableWidget->setColumnCount(0);
-    if (mediaPlayer) {
-        mediaPlayer->stop();
+    enqueueVideo(inputVideo, modelPath);
+}
+
+/******************************************************************************
+ * 事件处理程序：添加多个视频到队列
+ * 
+ * 打开多选文件对话框，使用当前选择的模型把每个视频加入队列。
+ ******************************************************************************/
+void MainWindow::onAddVideosToQueue()
+{
+    QString modelPath = modelPathEdit->text().trimmed();
+    
+    if (modelPath.isEmpty() || !QFileInfo::exists(modelPath)) {
+        QMessageBox::warning(this, "Missing Model", "Please select a YOLO model file first.");
+        return;
     }
-    playPauseButton->setEnabled(false);
-    stopButton->setEnabled(false);
-    lastOutputPath.clear();
     
-    // 如果需要，初始化进程
-    if (!pythonProcess) {
-        pythonProcess = new QProcess(this);
-        connect(pythonProcess, &QProcess::readyReadStandardOutput, 
-                this, &MainWindow::onProcessReadyReadStandardOutput);
-        connect(pythonProcess, &QProcess::readyReadStandardError, 
-                this, &MainWindow::onProcessReadyReadStandardError);
-        connect(pythonProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                this, &MainWindow::onProcessFinished);
+    QStringList fileNames = QFileDialog::getOpenFileNames(
+        this,
+        "Select Videos to Analyze",
+        QDir::homePath(),
+        "Video Files (*.mp4 *.avi *.mov *.mkv);;All Files (*.*)"
+    );
+    
+    for (const QString &fileName : std::as_const(fileNames)) {
+        enqueueVideo(fileName, modelPath);
     }
     
-    // 设置Python命令
-    QString projectRoot = getProjectRootPath();
-    QString scriptPath = QDir(projectRoot).absoluteFilePath("foot-Function/main.py");
+    if (!fileNames.isEmpty()) {
+        resultsTabWidget->setCurrentWidget(queueTab);
+    }
+}
+
+/******************************************************************************
+ * 队列：添加一个视频
+ * 
+ * 检查工作进程脚本后把任务交给调度器。
+ * 队列原本空闲时先重置进度界面（调度器可能在enqueue中立即启动任务）。
+ ******************************************************************************/
+void MainWindow::enqueueVideo(const QString &inputVideo, const QString &modelPath)
+{
+    QString scriptPath = scheduler->workerScriptPath();
     
     if (!QFileInfo::exists(scriptPath)) {
         QMessageBox::critical(this, "Script Not Found", 
@@ -580,176 +879,707 @@ void MainWindow::onStartAnalysis()
         return;
     }
     
-    QStringList arguments;
-    arguments << scriptPath;
-    arguments << "--input" << inputVideo;
-    arguments << "--model" << modelPath;
-    
-    // 启动进程
-    QString workingDir = QDir(projectRoot).absoluteFilePath("foot-Function");
-    pythonProcess->setWorkingDirectory(workingDir);
-    pythonProcess->start("python", arguments);
+    if (!analysisRunning) {
+        beginQueueRun();
+    }
     
-    if (!pythonProcess->waitForStarted(3000)) {
-        QMessageBox::critical(this, "Process Error", 
-            "Failed to start Python process. Make sure Python is installed and in PATH.");
-        analysisRunning = false;
-        statusLabel->setText("Error: Failed to start");
-        return;
+    QString jobId = scheduler->enqueue(inputVideo, modelPath);
+    logConsole->appendMessage(QString("Queued %1: %2").arg(jobId, inputVideo));
+}
+
+/******************************************************************************
+ * 队列：开始新一轮运行
+ * 
+ * 队列从空闲变为活动时调用：清除之前的结果并显示进度指示器。
+ ******************************************************************************/
+void MainWindow::beginQueueRun()
+{
+    // 清除之前的结果
+    logConsole->clearLog();
+    resultImageLabel->clear();
+    resultImageLabel->setText("Analysis in progress...");
+    dataModel->clear();
+    dataSummaryPath.clear();
+    dataJsonPath.clear();
+    dataFramePath.clear();
+    {
+        QSignalBlocker blocker(dataSourceComboBox);
+        dataSourceComboBox->setCurrentIndex(0);
+    }
+    dataSourceComboBox->setEnabled(false);
+    if (mediaPlayer) {
+        mediaPlayer->stop();
     }
+    playPauseButton->setEnabled(false);
+    stopButton->setEnabled(false);
+    positionSlider->setEnabled(false);
+    overlayWidget->clearTelemetry();
+    annotatedVideoPath.clear();
+    overlayVideoPath.clear();
+    videoModeComboBox->setEnabled(false);
+    lastOutputPath.clear();
     
     analysisRunning = true;
-    startButton->setEnabled(false);
+    runSucceeded = 0;
+    runFailed = 0;
+    runCancelled = 0;
+    focusedJobId.clear();
+    updateRunControls();
+    
     statusLabel->setText("Running analysis...");
     statusLabel->setStyleSheet("color: #0078d4; padding: 12px; border-left: 4px solid #0078d4; border-radius: 4px; background-color: #f0f8ff;");
     
     // 显示并启动进度指示器
     progressBar->setVisible(true);
-    progressBar->setRange(0, 0);  // 不确定模式
+    progressBar->setRange(0, 0);  // 不确定模式，直到收到第一个进度事件
+    progressBar->setTextVisible(false);
+    progressDetailLabel->setVisible(true);
+    progressDetailLabel->setText("Starting...");
     
+    activeElapsedMs = 0;
     elapsedTimer->start();
     updateTimer->start(1000);  // 每秒更新一次
     elapsedTimeLabel->setVisible(true);
     elapsedTimeLabel->setText("Elapsed: 0:00");
     
-    outputTextEdit->append("=== Analysis Started ===\n");
-    outputTextEdit->append(QString("Command: python %1\n").arg(arguments.join(" ")));
+    logConsole->appendMessage("=== Analysis Started ===\n");
+}
+
+/******************************************************************************
+ * 队列表格
+ * 
+ * 每个任务一行；第0列的UserRole保存任务ID。
+ * 进度列显示当前阶段和百分比，失败时显示错误原因。
+ ******************************************************************************/
+int MainWindow::findJobRow(const QString &jobId) const
+{
+    for (int row = 0; row < jobQueueTable->rowCount(); ++row) {
+        QTableWidgetItem *item = jobQueueTable->item(row, 0);
+        if (item && item->data(Qt::UserRole).toString() == jobId) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void MainWindow::onSchedulerJobAdded(const QString &jobId)
+{
+    const AnalysisJob *job = scheduler->job(jobId);
+    if (!job) {
+        return;
+    }
+    
+    int row = jobQueueTable->rowCount();
+    jobQueueTable->insertRow(row);
+    
+    QTableWidgetItem *videoItem = new QTableWidgetItem(QFileInfo(job->inputPath).fileName());
+    videoItem->setData(Qt::UserRole, jobId);
+    videoItem->setToolTip(job->inputPath);
+    jobQueueTable->setItem(row, 0, videoItem);
+    jobQueueTable->setItem(row, 1, new QTableWidgetItem());
+    jobQueueTable->setItem(row, 2, new QTableWidgetItem());
+    
+    QTableWidgetItem *outputItem = new QTableWidgetItem(QDir(job->outputDir).dirName());
+    outputItem->setToolTip(job->outputDir);
+    jobQueueTable->setItem(row, 3, outputItem);
+    
+    onSchedulerJobChanged(jobId);
+}
+
+void MainWindow::onSchedulerJobChanged(const QString &jobId)
+{
+    const AnalysisJob *job = scheduler->job(jobId);
+    int row = findJobRow(jobId);
+    if (!job || row < 0) {
+        return;
+    }
+    
+    jobQueueTable->item(row, 1)->setText(AnalysisJob::statusText(job->status));
+    
+    QString progressText;
+    switch (job->status) {
+    case AnalysisJob::Queued:
+        break;
+    case AnalysisJob::Running: {
+        QString stageName = job->stage;
+        stageName.replace('_', ' ');
+        progressText = stageName.isEmpty()
+            ? QString("Starting (%1 threads)").arg(job->threads)
+            : QString("%1  %2%").arg(stageName).arg(job->progressPercent);
+        if (job->paused) {
+            progressText += " (paused)";
+        }
+        break;
+    }
+    case AnalysisJob::Cancelled:
+        progressText = job->stage.isEmpty()
+            ? QString("Cancelled before start")
+            : QString("Stopped in %1 at %2%").arg(QString(job->stage).replace('_', ' ')).arg(job->progressPercent);
+        break;
+    case AnalysisJob::Succeeded:
+        progressText = "100%";
+        break;
+    case AnalysisJob::Failed:
+        progressText = job->error;
+        break;
+    }
+    jobQueueTable->item(row, 2)->setText(progressText);
+    jobQueueTable->item(row, 2)->setToolTip(progressText);
+    
+    // 进度条跟随一个正在运行的任务
+    if (focusedJobId.isEmpty() && job->status == AnalysisJob::Running) {
+        focusedJobId = jobId;
+    }
+}
+
+void MainWindow::onSchedulerJobRemoved(const QString &jobId)
+{
+    int row = findJobRow(jobId);
+    if (row >= 0) {
+        jobQueueTable->removeRow(row);
+    }
+}
+
+QStringList MainWindow::selectedJobIds() const
+{
+    QStringList jobIds;
+    const QList<QTableWidgetItem *> selected = jobQueueTable->selectedItems();
+    for (QTableWidgetItem *item : selected) {
+        QTableWidgetItem *idItem = jobQueueTable->item(item->row(), 0);
+        QString jobId = idItem ? idItem->data(Qt::UserRole).toString() : QString();
+        if (!jobId.isEmpty() && !jobIds.contains(jobId)) {
+            jobIds.append(jobId);
+        }
+    }
+    return jobIds;
+}
+
+void MainWindow::onRemoveSelectedJobs()
+{
+    const QStringList jobIds = selectedJobIds();
+    for (const QString &jobId : jobIds) {
+        if (!scheduler->removeJob(jobId)) {
+            logConsole->appendMessage(QString("Cannot remove %1 while it is running").arg(jobId));
+        }
+    }
+    
+    // 移除最后一个排队的任务后队列可能已经空闲
+    if (analysisRunning && scheduler->isIdle()) {
+        onQueueIdle();
+    }
 }
 
 /******************************************************************************
- * 事件处理程序：进程准备读取标准输出
+ * 队列：取消和恢复
  * 
- * 当Python进程写入stdout时自动调用。
- * 实时捕获输出并在分析日志中显示。
- * 自动滚动到底部以显示最新输出。
+ * 运行中的任务在下一帧之前停止，检测遍的状态保存为检查点；
+ * 恢复的任务重新排队（输出目录不变），从检查点继续，
+ * 已缓存的阶段结果直接使用（见AnalysisScheduler.h）。
+ ******************************************************************************/
+void MainWindow::onCancelSelectedJobs()
+{
+    const QStringList jobIds = selectedJobIds();
+    for (const QString &jobId : jobIds) {
+        const AnalysisJob *job = scheduler->job(jobId);
+        if (job && job->status == AnalysisJob::Running) {
+            logConsole->appendMessage(QString("Cancelling %1...").arg(jobId));
+        }
+        scheduler->cancelJob(jobId);
+    }
+}
+
+void MainWindow::onResumeSelectedJobs()
+{
+    const QStringList jobIds = selectedJobIds();
+    for (const QString &jobId : jobIds) {
+        const AnalysisJob *job = scheduler->job(jobId);
+        if (!job || (job->status != AnalysisJob::Cancelled && job->status != AnalysisJob::Failed)) {
+            continue;
+        }
+        if (!analysisRunning) {
+            beginQueueRun();
+        }
+        scheduler->retryJob(jobId);
+        logConsole->appendMessage(QString("Resuming %1: %2").arg(jobId, job->inputPath));
+    }
+}
+
+/******************************************************************************
+ * 运行控制：暂停和取消
+ * 
+ * 暂停时运行中的任务在工作进程中阻塞（进程和已加载的模型保留），
+ * 排队的任务不再启动；继续时从暂停的帧接着处理。
+ ******************************************************************************/
+void MainWindow::onPauseQueue()
+{
+    const bool pause = !scheduler->isPaused();
+    scheduler->setPaused(pause);
+    logConsole->appendMessage(pause ? "=== Analysis Paused ===" : "=== Analysis Resumed ===");
+    
+    if (pause) {
+        // 暂停的时间不计入已用时间：记录到目前为止的时间，继续时重新计时
+        if (elapsedTimer->isValid()) {
+            activeElapsedMs += elapsedTimer->elapsed();
+            elapsedTimer->invalidate();
+        }
+        updateTimer->stop();
+        updateElapsedTime();
+        elapsedTimeLabel->setText(elapsedTimeLabel->text() + " (paused)");
+        statusLabel->setText(QString("Paused · %1").arg(queueSummaryText()));
+        progressDetailLabel->setText("Paused");
+    } else {
+        elapsedTimer->start();
+        updateTimer->start(1000);
+        statusLabel->setText(QString("Running analysis... · %1").arg(queueSummaryText()));
+    }
+    updateRunControls();
+}
+
+void MainWindow::onCancelQueue()
+{
+    logConsole->appendMessage("=== Cancelling Analysis ===");
+    statusLabel->setText("Cancelling...");
+    cancelButton->setEnabled(false);
+    scheduler->cancelAll();
+}
+
+void MainWindow::updateRunControls()
+{
+    pauseButton->setVisible(analysisRunning);
+    cancelButton->setVisible(analysisRunning);
+    cancelButton->setEnabled(analysisRunning);
+    pauseButton->setText(scheduler->isPaused() ? "Resume" : "Pause");
+}
+
+void MainWindow::onClearFinishedJobs()
+{
+    scheduler->clearFinished();
+}
+
+void MainWindow::onQueueItemDoubleClicked(int row, int column)
+{
+    Q_UNUSED(column);
+    
+    QTableWidgetItem *item = jobQueueTable->item(row, 0);
+    const AnalysisJob *job = item ? scheduler->job(item->data(Qt::UserRole).toString()) : nullptr;
+    if (job && job->status == AnalysisJob::Succeeded) {
+        loadJobResults(*job);
+        resultsTabWidget->setCurrentWidget(dataTab);
+    }
+}
+
+/******************************************************************************
+ * 并发设置
+ * 
+ * 修改并行任务数；线程预算随之重新计算（核心数 / 并行任务数）。
+ ******************************************************************************/
+void MainWindow::onConcurrencyChanged(int jobs)
+{
+    scheduler->setMaxConcurrentJobs(jobs);
+    updateResourcePlanLabel();
+}
+
+void MainWindow::onVideoCodecChanged(int index)
+{
+    scheduler->setVideoCodec(videoCodecComboBox->itemData(index).toString());
+}
+
+void MainWindow::onDetectionBackendChanged(int index)
+{
+    const QString data = backendComboBox->itemData(index).toString();
+    const bool int8 = data.endsWith("-int8");
+    scheduler->setDetectionBackend(int8 ? data.chopped(5) : data, int8);
+    
+    // 提前加载新后端的模型（首次使用ONNX时包括导出）
+    const QString modelPath = modelPathEdit->text().trimmed();
+    if (!modelPath.isEmpty() && QFileInfo::exists(modelPath)) {
+        scheduler->preloadModel(QFileInfo(modelPath).absoluteFilePath());
+    }
+}
+
+void MainWindow::updateResourcePlanLabel()
+{
+    const ResourcePlan plan = AnalysisScheduler::recommendedPlan();
+    QString text = QString("%1 thread(s) per job · %2 cores")
+        .arg(scheduler->threadsPerJob()).arg(plan.cpuCores);
+    if (plan.availableMemoryMB > 0) {
+        text += QString(", %1 GB free").arg(plan.availableMemoryMB / 1024.0, 0, 'f', 1);
+    }
+    resourcePlanLabel->setText(text);
+}
+
+QString MainWindow::queueSummaryText() const
+{
+    return QString("%1 running, %2 queued")
+        .arg(scheduler->runningJobCount()).arg(scheduler->queuedJobCount());
+}
+
+/******************************************************************************
+ * 事件处理程序：工作进程日志输出
+ * 
+ * 工作进程写入stdout/stderr时调用（按完整的行）。
+ * 行只存入日志控制台的缓冲区，视图由定时器批量更新，
+ * 因此大量日志不会阻塞GUI线程。stderr和警告/错误行以颜色区分。
  * 
  * 这在分析期间为用户提供实时反馈。
  ******************************************************************************/
-void MainWindow::onProcessReadyReadStandardOutput()
+void MainWindow::onWorkerLogOutput(const QString &text, bool isError)
 {
-    if (pythonProcess) {
-        QByteArray data = pythonProcess->readAllStandardOutput();
-        QString text = QString::fromUtf8(data);
-        outputTextEdit->append(text);
-        
-        // Auto-scroll to bottom
-        QTextCursor cursor = outputTextEdit->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        outputTextEdit->setTextCursor(cursor);
+    logConsole->appendOutput(text, isError);
+}
+
+/******************************************************************************
+ * 事件处理程序：任务事件
+ * 
+ * 进度条只跟随一个正在运行的任务；该任务的事件交给handleProgressEvent()，
+ * 它的部分结果快照交给showPartialResults()。
+ * 所有任务的进度显示在任务队列表格中（见onSchedulerJobChanged()）。
+ * 阶段缓存报告（stage_cache）对所有任务都写入日志。
+ ******************************************************************************/
+void MainWindow::onWorkerJobEvent(const QString &jobId, const QJsonObject &event)
+{
+    // 阶段缓存报告：记录每个任务的命中和重新计算的阶段
+    if (event.value("event").toString() == "stage_cache") {
+        auto names = [&event](const char *key) {
+            QStringList list;
+            for (const QJsonValue &value : event.value(key).toArray()) {
+                list.append(value.toString());
+            }
+            return list.isEmpty() ? QString("-") : list.join(", ");
+        };
+        logConsole->appendMessage(QString("%1 stage cache: cached %2; recomputed %3")
+            .arg(jobId, names("hits"), names("recomputed")));
+        return;
+    }
+    if (jobId != focusedJobId) {
+        return;
     }
+    if (event.value("event").toString() == "snapshot") {
+        if (const AnalysisJob *job = scheduler->job(jobId)) {
+            showPartialResults(*job);
+        }
+    } else if (event.value("event").toString() == "stage_metrics") {
+        // 阶段性能记录：性能选项卡显示进度条跟随的任务
+        const AnalysisJob *job = scheduler->job(jobId);
+        if (job && jobId != performanceJobId) {
+            performanceJobId = jobId;
+            performanceView->startRun(job->inputPath, job->outputDir);
+        }
+        performanceView->addRecord(event);
+    } else {
+        handleProgressEvent(event);
+    }
+}
+
+/******************************************************************************
+ * 事件处理程序：模型已加载
+ * 
+ * 工作进程只在模型改变时重新加载；在日志中记录加载耗时。
+ ******************************************************************************/
+void MainWindow::onWorkerModelLoaded(const QString &modelPath, double seconds)
+{
+    logConsole->appendMessage(QString("Model loaded in %1 s: %2")
+        .arg(seconds, 0, 'f', 1).arg(QFileInfo(modelPath).fileName()));
 }
 
 /******************************************************************************
- * 事件处理程序：进程准备读取标准错误
+ * 事件处理程序：进度事件
  * 
- * 当Python进程写入stderr时自动调用。
- * 实时捕获错误输出并在分析日志中以红色显示。
- * 自动滚动到底部以显示最新输出。
+ * 处理Python管道发出的一个结构化进度事件：
+ *   {"event": "progress", "stage": ..., "done": ..., "total": ...,
+ *    "fps": ..., "eta": ...}
  * 
- * 这帮助用户在分析期间识别问题。
+ * 每个阶段使用自己的进度范围（0..total）；总数未知时切换回不确定模式。
+ * 详情标签显示已处理帧数、当前吞吐量和预计剩余时间。
  ******************************************************************************/
-void MainWindow::onProcessReadyReadStandardError()
+void MainWindow::handleProgressEvent(const QJsonObject &event)
 {
-    if (pythonProcess) {
-        QByteArray data = pythonProcess->readAllStandardError();
-        QString text = QString::fromUtf8(data);
-        outputTextEdit->append(QString("<span style='color: red;'>%1</span>").arg(text.toHtmlEscaped()));
-        
-        // Auto-scroll to bottom
-        QTextCursor cursor = outputTextEdit->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        outputTextEdit->setTextCursor(cursor);
+    if (event.value("event").toString() != "progress") {
+        return;
+    }
+    
+    // 阶段名称："ball_possession" -> "Ball possession"
+    QString stageName = event.value("stage").toString();
+    stageName.replace('_', ' ');
+    if (!stageName.isEmpty()) {
+        stageName[0] = stageName[0].toUpper();
+    }
+    
+    const qint64 done = event.value("done").toInteger();
+    const qint64 total = event.value("total").toInteger();
+    const double fps = event.value("fps").toDouble();
+    const QJsonValue eta = event.value("eta");
+    
+    if (total > 0) {
+        progressBar->setRange(0, static_cast<int>(total));
+        progressBar->setValue(static_cast<int>(qMin(done, total)));
+        progressBar->setFormat(QString("%1  %p%").arg(stageName));
+        progressBar->setTextVisible(true);
+    } else {
+        progressBar->setRange(0, 0);  // 总数未知：不确定模式
+        progressBar->setTextVisible(false);
     }
+    
+    QString detail = total > 0
+        ? QString("%1: %2 / %3").arg(stageName).arg(done).arg(total)
+        : QString("%1: %2").arg(stageName).arg(done);
+    if (fps > 0) {
+        detail += QString("\n%1 fps").arg(fps, 0, 'f', 1);
+        if (eta.isDouble()) {
+            detail += QString(" · ETA %1").arg(formatDuration(eta.toDouble()));
+        }
+    }
+    progressDetailLabel->setText(detail);
+    
+    QString status = QString("Running analysis... (%1)").arg(stageName);
+    if (scheduler->runningJobCount() + scheduler->queuedJobCount() > 1) {
+        status += QString(" · %1").arg(queueSummaryText());
+    }
+    statusLabel->setText(status);
+}
+
+/******************************************************************************
+ * 部分结果
+ * 
+ * 管道在阶段完成时（串流模式的检测阶段中也定期）发出结果快照
+ * （见foot-Function/utils/progress.py）：
+ *   {"event": "snapshot", "stage": ..., "frames": ...,
+ *    "data": {与data_output.json相同}, "outputs": {已写入的结果文件}}
+ * 
+ * - 数据文件尚未写入：快照中的球员摘要直接显示在数据表中
+ * - 数据文件已写入（在绘制视频之前）：与完成后相同从磁盘加载，
+ *   逐帧数据也可以查看，不必等待视频编码
+ * - 摘要选项卡显示目前的控球统计
+ * 
+ * 任务完成后loadJobResults()以最终结果替换。
+ ******************************************************************************/
+void MainWindow::showPartialResults(const AnalysisJob &job)
+{
+    const QJsonObject data = job.snapshot.value("data").toObject();
+    const QJsonObject outputs = job.snapshot.value("outputs").toObject();
+    
+    const QString jsonPath = outputs.value("data").toString();
+    if (!jsonPath.isEmpty() && QFileInfo::exists(jsonPath)) {
+        if (jsonPath != dataJsonPath) {
+            const QDir outputDir(QFileInfo(jsonPath).absolutePath());
+            dataSummaryPath = outputDir.absoluteFilePath("data_output.csv");
+            dataJsonPath = jsonPath;
+            dataFramePath = outputs.value("frame_data").toString();
+            dataSourceComboBox->setEnabled(QFileInfo::exists(dataFramePath));
+            loadDataTable();
+        }
+    } else if (!data.isEmpty()) {
+        dataSummaryPath.clear();
+        dataJsonPath.clear();
+        dataFramePath.clear();
+        {
+            QSignalBlocker blocker(dataSourceComboBox);
+            dataSourceComboBox->setCurrentIndex(0);
+        }
+        dataSourceComboBox->setEnabled(false);
+        displayJsonData(data);
+    }
+    
+    // 串流模式的检测阶段（"analysis"）定期发出目前为止的累计结果
+    QString stageName = job.snapshot.value("stage").toString();
+    stageName.replace('_', ' ');
+    const QString progressText = stageName == "analysis"
+        ? QString("running totals over the first %1 frames").arg(job.snapshot.value("frames").toInt())
+        : QString("after %1, %2 frames").arg(stageName).arg(job.snapshot.value("frames").toInt());
+    QString text = QString("Partial results: %1\n(%2; analysis still running)")
+        .arg(QFileInfo(job.inputPath).fileName(), progressText);
+    const QString possessionText = AnalysisResults::possessionSummaryText(data);
+    if (!possessionText.isEmpty()) {
+        text += "\n\n" + possessionText;
+    }
+    resultImageLabel->setText(text);
 }
 
 /******************************************************************************
- * 事件处理程序：进程完成
+ * 事件处理程序：任务完成
  * 
- * 当Python分析进程完成时调用（成功或失败）。
+ * 当某个分析任务完成时调用（成功或失败）。
+ * 工作进程本身继续运行，等待下一个任务。
  * 
  * 完成处理：
- * - 停止已用时间计数器和进度指示器
- * - 重新启用开始按钮以进行下一次分析
- * - 根据退出代码更新状态标签
+ * - 在日志中记录结果（失败时记录错误原因）
+ * - 成功时加载该任务的结果（最近完成的任务显示在结果选项卡中）
+ * - 进度条改为跟随另一个正在运行的任务
  * 
- * 结果加载（成功时）：
- * - 在foot-Function/output_videos/中搜索输出文件
- * - 将CSV数据加载到表格部件（或将JSON作为备用）
- * - 将输出视频加载到媒体播放器
- * - 切换到数据表选项卡以显示结果
+ * 队列中所有任务完成后，onQueueIdle()显示本轮运行的总结。
+ ******************************************************************************/
+void MainWindow::onJobFinished(const QString &jobId, bool success)
+{
+    const AnalysisJob *job = scheduler->job(jobId);
+    if (!job) {
+        return;
+    }
+    
+    const QString videoName = QFileInfo(job->inputPath).fileName();
+    logConsole->appendMessage(QString("\n=== Analysis Finished: %1 ===\n").arg(videoName));
+    
+    if (success) {
+        ++runSucceeded;
+        loadJobResults(*job);
+    } else if (job->status == AnalysisJob::Cancelled) {
+        ++runCancelled;
+        logConsole->appendMessage(QString("Cancelled %1 (select it in the Job Queue tab and "
+                                          "click Resume to continue)").arg(jobId));
+    } else {
+        ++runFailed;
+        onWorkerLogOutput(QString("Error (%1): %2").arg(videoName, job->error), true);
+    }
+    
+    // 进度条改为跟随下一个正在运行的任务
+    if (jobId == focusedJobId) {
+        focusedJobId.clear();
+        for (const AnalysisJob &other : scheduler->jobs()) {
+            if (other.status == AnalysisJob::Running) {
+                focusedJobId = other.id;
+                break;
+            }
+        }
+        progressBar->setRange(0, 0);
+        progressBar->setTextVisible(false);
+        progressDetailLabel->setText("Starting...");
+    }
+    
+    if (!scheduler->isIdle() && !scheduler->isPaused()) {
+        const QString result = success ? QString("✓ Finished")
+            : job->status == AnalysisJob::Cancelled ? QString("Cancelled") : QString("✗ Failed");
+        statusLabel->setText(QString("%1 %2 · %3").arg(result, videoName, queueSummaryText()));
+    }
+}
+
+/******************************************************************************
+ * 事件处理程序：队列空闲
  * 
- * 错误处理（失败时）：
- * - 显示错误状态
- * - 在日志中显示详细错误消息
+ * 最后一个任务完成后调用：
+ * - 停止已用时间计数器和进度指示器
+ * - 根据本轮成功/失败的任务数更新状态标签
  ******************************************************************************/
-void MainWindow::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void MainWindow::onQueueIdle()
 {
+    if (!analysisRunning) {
+        return;
+    }
+    
     analysisRunning = false;
-    startButton->setEnabled(true);
+    focusedJobId.clear();
+    scheduler->setPaused(false);
+    updateRunControls();
     
     // 隐藏并停止进度指示器
     progressBar->setVisible(false);
+    progressDetailLabel->setVisible(false);
     updateTimer->stop();
     elapsedTimeLabel->setVisible(false);
     
-    outputTextEdit->append("\n=== Analysis Finished ===\n");
-    outputTextEdit->append(QString("Exit Code: %1\n").arg(exitCode));
-    
-    if (exitStatus == QProcess::CrashExit) {
-        statusLabel->setText("✗ Error: Process crashed");
+    const int total = runSucceeded + runFailed + runCancelled;
+    if (runFailed == 0 && runCancelled > 0) {
+        statusLabel->setText(runSucceeded == 0
+            ? QString("Analysis cancelled")
+            : QString("%1 of %2 analyses completed, %3 cancelled").arg(runSucceeded).arg(total).arg(runCancelled));
+        statusLabel->setStyleSheet("color: #b35c00; padding: 12px; border-left: 4px solid #b35c00; border-radius: 4px; background-color: #fff8f0;");
+        if (runSucceeded == 0) {
+            resultImageLabel->setText("Analysis cancelled. Resume it from the Job Queue tab.");
+        }
+    } else if (runFailed == 0) {
+        statusLabel->setText(total <= 1
+            ? QString("✓ Analysis completed successfully")
+            : QString("✓ %1 analyses completed successfully").arg(total));
+        statusLabel->setStyleSheet("color: #28a745; padding: 12px; border-left: 4px solid #28a745; border-radius: 4px; background-color: #f0fff4;");
+    } else {
+        statusLabel->setText(total <= 1
+            ? QString("✗ Error: Analysis failed")
+            : QString("✗ Error: %1 of %2 analyses failed").arg(runFailed).arg(total));
         statusLabel->setStyleSheet("color: #dc3545; padding: 12px; border-left: 4px solid #dc3545; border-radius: 4px; background-color: #fff5f5;");
-        QMessageBox::critical(this, "Process Crashed", "The Python process crashed unexpectedly.");
-        return;
+        if (runSucceeded == 0) {
+            resultImageLabel->setText("Analysis failed. Check the log for error details.");
+        }
     }
+}
+
+/******************************************************************************
+ * 结果加载：加载任务结果
+ * 
+ * 从任务的输出目录（或工作进程报告的输出路径）加载：
+ * - 将CSV数据加载到数据表（或将JSON作为备用）
+ * - 将输出视频加载到媒体播放器
+ * - 将性能记录（performance.json）加载到性能选项卡
+ * - 更新摘要选项卡
+ ******************************************************************************/
+void MainWindow::loadJobResults(const AnalysisJob &job)
+{
+    // 输出文件：工作进程报告的路径或输出目录中的默认文件名
+    const AnalysisResults results = AnalysisResults::locate(job);
+    
+    // 数据文件：球员摘要（CSV，JSON作为备用）和逐帧数据
+    dataSummaryPath = results.summaryCsvPath;
+    dataJsonPath = results.summaryJsonPath;
+    dataFramePath = results.frameDataPath;
+    const bool hasFrameData = QFileInfo::exists(dataFramePath);
+    dataSourceComboBox->setEnabled(hasFrameData);
+    if (!hasFrameData) {
+        QSignalBlocker blocker(dataSourceComboBox);
+        dataSourceComboBox->setCurrentIndex(0);
+    }
+    loadDataTable();
     
-    if (exitCode == 0) {
-        statusLabel->setText("✓ Analysis completed successfully");
-        statusLabel->setStyleSheet("color: #28a745; padding: 12px; border-left: 4px solid #28a745; border-radius: 4px; background-color: #f0fff4;");
-        
-        // 从项目根目录获取输出目录
-        QString projectRoot = getProjectRootPath();
-        QString outputDirPath = QDir(projectRoot).absoluteFilePath("foot-Function/output_videos");
-        
-        // 加载CSV数据
-        QString csvPath = QDir(outputDirPath).absoluteFilePath("data_output.csv");
-        if (QFileInfo::exists(csvPath)) {
-            loadAndDisplayCSV(csvPath);
-            outputTextEdit->append(QString("Loaded CSV data from: %1").arg(csvPath));
-        }
-        
-        // 加载JSON数据（如果CSV失败则作为备用）
-        QString jsonPath = QDir(outputDirPath).absoluteFilePath("data_output.json");
-        if (QFileInfo::exists(jsonPath) && dataTableWidget->rowCount() == 0) {
-            loadAndDisplayJSON(jsonPath);
-            outputTextEdit->append(QString("Loaded JSON data from: %1").arg(jsonPath));
-        }
-        
-        // 加载并播放视频
-        QString videoPath = QDir(outputDirPath).absoluteFilePath("output_video.avi");
-        if (QFileInfo::exists(videoPath)) {
-            loadAndPlayVideo(videoPath);
-            outputTextEdit->append(QString("Loaded video from: %1").arg(videoPath));
-        }
-        
-        // 尝试查找并显示摘要选项卡的输出
-        QString outputPath = findOutputVideo();
-        if (!outputPath.isEmpty()) {
-            displayResultMedia(outputPath);
+    // 视频：标注视频（未渲染时不存在）和用于叠加层的输入视频
+    annotatedVideoPath = QFileInfo::exists(results.videoPath) ? results.videoPath : QString();
+    overlayVideoPath.clear();
+    
+    // 追踪遥测：叠加层的数据来源
+    if (QFileInfo::exists(results.telemetryPath) && QFileInfo::exists(job.inputPath)) {
+        if (overlayWidget->setTelemetry(results.telemetryPath)) {
+            overlayVideoPath = job.inputPath;
         } else {
-            resultImageLabel->setText("Analysis complete!\n\nCheck the Data Table and Video Output tabs to view results.");
+            logConsole->appendMessage(QString("Live overlay unavailable: %1").arg(overlayWidget->telemetryError()));
         }
     } else {
-        statusLabel->setText(QString("✗ Error: Analysis failed (exit code %1)").arg(exitCode));
-        statusLabel->setStyleSheet("color: #dc3545; padding: 12px; border-left: 4px solid #dc3545; border-radius: 4px; background-color: #fff5f5;");
-        resultImageLabel->setText("Analysis failed. Check the log for error details.");
+        overlayWidget->clearTelemetry();
+    }
+    
+    // 两者都有时才能切换；没有标注视频时直接显示叠加层
+    videoModeComboBox->setEnabled(!annotatedVideoPath.isEmpty() && !overlayVideoPath.isEmpty());
+    {
+        QSignalBlocker blocker(videoModeComboBox);
+        videoModeComboBox->setCurrentIndex(annotatedVideoPath.isEmpty() && !overlayVideoPath.isEmpty() ? 1 : 0);
+    }
+    if (!annotatedVideoPath.isEmpty() || !overlayVideoPath.isEmpty()) {
+        mediaPlayer->stop();  // 新任务从头播放
+        onVideoModeChanged(videoModeComboBox->currentIndex());
+        logConsole->appendMessage(QString("Loaded video from: %1")
+            .arg(videoModeComboBox->currentIndex() == 1 ? overlayVideoPath : annotatedVideoPath));
+    }
+    
+    // 性能记录：正在显示另一个运行中任务的实时记录时不替换
+    const AnalysisJob *shownJob = scheduler->job(performanceJobId);
+    if (!shownJob || shownJob->status != AnalysisJob::Running || performanceJobId == job.id) {
+        if (performanceView->loadReport(results.performancePath)) {
+            performanceJobId = job.id;
+        }
+    }
+    
+    // 尝试查找并显示摘要选项卡的输出
+    QString outputPath = findOutputVideo(results.outputDir);
+    if (!outputPath.isEmpty()) {
+        displayResultMedia(outputPath);
+    } else {
+        resultImageLabel->setText("Analysis complete!\n\nCheck the Data Table and Video Output tabs to view results.");
+    }
+    
+    // 在摘要中附加控球统计（与视频叠加层和数据导出同一来源）
+    const QString possessionText = AnalysisResults::possessionSummaryText(AnalysisResults::readJson(dataJsonPath));
+    if (!possessionText.isEmpty() && resultImageLabel->pixmap().isNull()) {
+        resultImageLabel->setText(resultImageLabel->text() + "\n\n" + possessionText);
     }
 }
 
-QString MainWindow::findOutputVideo()
+QString MainWindow::findOutputVideo(const QString &outputDirPath)
 {
-    // 在foot-Function/output_videos目录中查找输出
-    QString projectRoot = getProjectRootPath();
-    QString outputDirPath = QDir(projectRoot).absoluteFilePath("foot-Function/output_videos");
+    // 在任务的输出目录中查找输出
     QDir outputDir(outputDirPath);
     
     if (!outputDir.exists()) {
@@ -840,66 +1670,35 @@ void MainWindow::displayResultMedia(const QString &mediaPath)
 /******************************************************************************
  * 数据加载方法：加载并显示CSV
  * 
- * 解析CSV输出文件并在表格部件中显示数据。
+ * 在数据表中显示CSV输出文件（球员摘要或逐帧数据）。
  * 
  * 预期CSV格式：
  * - 带列名的标题行
  * - 带球员统计数据和球队控球率的数据行
  * 
- * 解析逻辑：
- * - 逐行读取CSV
- * - 按逗号分割以提取单元格值
- * - 处理引号字段（用于值内的逗号）
- * - 使用解析的数据填充QTableWidget
+ * 文件不在此处读入内存：ResultTableModel只建立页偏移索引，视图滚动到的
+ * 行才按页解析（逐帧数据可达数百万行）。
  * 
  * UI更新：
- * - 根据CSV标题配置表格列
- * - 用球员/球队数据填充行
+ * - 根据CSV标题配置表格列和过滤列列表
+ * - 根据前几页内容调整列宽
  * - 启用排序和选择
  ******************************************************************************/
 void MainWindow::loadAndDisplayCSV(const QString &csvPath)
 {
-    QFile file(csvPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!dataModel->openCsv(csvPath)) {
         qDebug() << "Failed to open CSV file:" << csvPath;
         return;
     }
-    
-    QTextStream in(&file);
-    QStringList rows;
-    
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        if (!line.trimmed().isEmpty()) {
-            rows.append(line);
-        }
-    }
-    file.close();
-    
-    if (rows.isEmpty()) {
+    if (dataModel->rowCount() == 0) {
         qDebug() << "CSV file is empty";
-        return;
     }
     
-    // 解析CSV - 处理基本的逗号分隔
-    // 注意：这期望简单的CSV，不带引号字段（由Python脚本生成）
-    QStringList headers = rows[0].split(',');
-    dataTableWidget->setColumnCount(headers.size());
-    dataTableWidget->setHorizontalHeaderLabels(headers);
-    
-    // 设置行
-    dataTableWidget->setRowCount(rows.size() - 1);
-    
-    for (int i = 1; i < rows.size(); ++i) {
-        QStringList columns = rows[i].split(',');
-        for (int j = 0; j < columns.size() && j < headers.size(); ++j) {
-            QTableWidgetItem *item = new QTableWidgetItem(columns[j].trimmed());
-            dataTableWidget->setItem(i - 1, j, item);
-        }
-    }
+    updateDataFilterColumns();
+    updateDataRowCount();
     
-    // 调整列大小以适应内容
-    dataTableWidget->resizeColumnsToContents();
+    // 调整列大小以适应内容（只检查前kRowsPerPage行）
+    dataTableView->resizeColumnsToContents();
     
     // 切换到数据选项卡
     resultsTabWidget->setCurrentWidget(dataTab);
@@ -908,7 +1707,7 @@ void MainWindow::loadAndDisplayCSV(const QString &csvPath)
 /******************************************************************************
  * 数据加载方法：加载并显示JSON
  * 
- * 解析JSON输出文件并在表格部件中显示数据。
+ * 解析JSON输出文件并在表格中显示数据。
  * 当CSV不可用时用作备用方案。
  * 
  * 预期JSON格式：
@@ -918,7 +1717,7 @@ void MainWindow::loadAndDisplayCSV(const QString &csvPath)
  * 解析逻辑：
  * - 使用QJsonDocument解析JSON
  * - 提取球员统计数据和球队控球数据
- * - 将JSON结构转换为表格格式
+ * - 将JSON结构转换为行（数据量小，直接保存在模型内存中）
  * 
  * 当CSV解析失败时，此方法提供替代数据视图。
  ******************************************************************************/
@@ -939,77 +1738,104 @@ void MainWindow::loadAndDisplayJSON(const QString &jsonPath)
         return;
     }
     
-    QJsonObject root = doc.object();
+    displayJsonData(doc.object());
+}
+
+/******************************************************************************
+ * 数据表：显示JSON数据
+ * 
+ * data_output.json结构的数据（文件或部分结果快照）由模型转换为行
+ * （见ResultTableModel::setSummary）。
+ ******************************************************************************/
+void MainWindow::displayJsonData(const QJsonObject &root)
+{
+    dataModel->setSummary(root);
+    updateDataFilterColumns();
+    updateDataRowCount();
     
-    // 设置表格标题
-    dataTableWidget->setColumnCount(3);
-    dataTableWidget->setHorizontalHeaderLabels(QStringList() << "Team" << "Player ID" << "Distance (m)");
+    // 调整列大小以适应内容
+    dataTableView->resizeColumnsToContents();
     
-    int row = 0;
+    // 切换到数据选项卡
+    resultsTabWidget->setCurrentWidget(dataTab);
+}
+
+/******************************************************************************
+ * 数据表：加载所选数据源
+ * 
+ * - 球员摘要：data_output.csv，不存在或为空时使用data_output.json
+ * - 逐帧数据：frame_data.csv（每帧每名球员一行）
+ ******************************************************************************/
+void MainWindow::loadDataTable()
+{
+    dataModel->clear();
     
-    // 处理每个球队
-    for (const QString &key : root.keys()) {
-        if (key == "summary") {
-            continue;
-        }
-        
-        QJsonObject teamData = root[key].toObject();
-        for (const QString &playerId : teamData.keys()) {
-            QJsonObject playerData = teamData[playerId].toObject();
-            double distanceM = playerData["distance_m"].toDouble();
-            
-            dataTableWidget->insertRow(row);
-            dataTableWidget->setItem(row, 0, new QTableWidgetItem(key));
-            dataTableWidget->setItem(row, 1, new QTableWidgetItem(playerId));
-            dataTableWidget->setItem(row, 2, new QTableWidgetItem(
-                distanceM == 0 ? "Not Detected" : QString::number(distanceM, 'f', 2)
-            ));
-            row++;
-        }
+    if (dataSourceComboBox->currentIndex() == 1 && QFileInfo::exists(dataFramePath)) {
+        loadAndDisplayCSV(dataFramePath);
+        logConsole->appendMessage(QString("Loaded per-frame data from: %1 (%2 rows)")
+            .arg(dataFramePath, QLocale().toString(dataModel->rowCount())));
+        return;
     }
     
-    // 添加摘要行
-    if (root.contains("summary")) {
-        QJsonObject summary = root["summary"].toObject();
-        
-        // 添加空行以分隔
-        dataTableWidget->insertRow(row);
-        row++;
-        
-        // 添加摘要标题
-        dataTableWidget->insertRow(row);
-        QTableWidgetItem *headerItem = new QTableWidgetItem("Summary - Team Possession Percentage");
-        QFont boldFont;
-        boldFont.setBold(true);
-        headerItem->setFont(boldFont);
-        dataTableWidget->setItem(row, 0, headerItem);
-        row++;
-        
-        // 添加控球百分比
-        if (summary.contains("team_1_possession_percent")) {
-            dataTableWidget->insertRow(row);
-            dataTableWidget->setItem(row, 0, new QTableWidgetItem("Team 1 Possession"));
-            dataTableWidget->setItem(row, 2, new QTableWidgetItem(
-                QString::number(summary["team_1_possession_percent"].toDouble(), 'f', 2) + "%"
-            ));
-            row++;
-        }
-        
-        if (summary.contains("team_2_possession_percent")) {
-            dataTableWidget->insertRow(row);
-            dataTableWidget->setItem(row, 0, new QTableWidgetItem("Team 2 Possession"));
-            dataTableWidget->setItem(row, 2, new QTableWidgetItem(
-                QString::number(summary["team_2_possession_percent"].toDouble(), 'f', 2) + "%"
-            ));
-            row++;
-        }
+    // 加载CSV数据
+    if (QFileInfo::exists(dataSummaryPath)) {
+        loadAndDisplayCSV(dataSummaryPath);
+        logConsole->appendMessage(QString("Loaded CSV data from: %1").arg(dataSummaryPath));
     }
     
-    // 调整列大小以适应内容
-    dataTableWidget->resizeColumnsToContents();
-    
-    // 切换到数据选项卡
-    resultsTabWidget->setCurrentWidget(dataTab);
+    // 加载JSON数据（如果CSV失败则作为备用）
+    if (QFileInfo::exists(dataJsonPath) && dataModel->rowCount() == 0) {
+        loadAndDisplayJSON(dataJsonPath);
+        logConsole->appendMessage(QString("Loaded JSON data from: %1").arg(dataJsonPath));
+    }
+}
+
+/******************************************************************************
+ * 数据表：过滤列列表
+ * 
+ * "All columns"加上当前表格的列名；列名仍存在时保留之前的选择。
+ ******************************************************************************/
+void MainWindow::updateDataFilterColumns()
+{
+    const QString previous = dataFilterColumnComboBox->currentText();
+    {
+        QSignalBlocker blocker(dataFilterColumnComboBox);
+        dataFilterColumnComboBox->clear();
+        dataFilterColumnComboBox->addItem("All columns");
+        dataFilterColumnComboBox->addItems(dataModel->headers());
+        dataFilterColumnComboBox->setCurrentIndex(qMax(dataFilterColumnComboBox->findText(previous), 0));
+    }
+    onDataFilterChanged();
+}
+
+void MainWindow::updateDataRowCount()
+{
+    const int total = dataModel->rowCount();
+    const int shown = dataProxyModel->rowCount();
+    if (total == 0) {
+        dataRowCountLabel->clear();
+    } else if (shown == total) {
+        dataRowCountLabel->setText(QString("%1 rows").arg(QLocale().toString(total)));
+    } else {
+        dataRowCountLabel->setText(QString("%1 of %2 rows")
+            .arg(QLocale().toString(shown), QLocale().toString(total)));
+    }
+}
+
+/******************************************************************************
+ * 事件处理：数据表
+ ******************************************************************************/
+void MainWindow::onDataSourceChanged(int index)
+{
+    Q_UNUSED(index);
+    loadDataTable();
+}
+
+void MainWindow::onDataFilterChanged()
+{
+    dataFilterTimer->stop();
+    dataProxyModel->setFilter(dataFilterColumnComboBox->currentIndex() - 1, dataFilterEdit->text());
+    updateDataRowCount();
 }
 
 /******************************************************************************
@@ -1039,11 +1865,50 @@ void MainWindow::loadAndPlayVideo(const QString &videoPath)
     mediaPlayer->setSource(QUrl::fromLocalFile(videoPath));
     playPauseButton->setEnabled(true);
     stopButton->setEnabled(true);
+    positionSlider->setEnabled(true);
     
     // 切换到视频选项卡
     resultsTabWidget->setCurrentWidget(videoTab);
 }
 
+/******************************************************************************
+ * 事件处理程序：切换视频显示方式
+ * 
+ * - 标注视频：QVideoWidget播放流程渲染的视频
+ * - 叠加层：OverlayVideoWidget播放输入视频并根据追踪遥测绘制标注
+ * 
+ * 切换时保留播放位置；两个视频帧数相同，位置对应同一帧。
+ ******************************************************************************/
+void MainWindow::onVideoModeChanged(int index)
+{
+    const bool overlay = index == 1;
+    const qint64 position = mediaPlayer->position();
+    mediaPlayer->stop();
+    
+    if (overlay) {
+        overlayWidget->attachPlayer(mediaPlayer);
+        videoStack->setCurrentWidget(overlayWidget);
+    } else {
+        mediaPlayer->setVideoOutput(videoWidget);
+        videoStack->setCurrentWidget(videoWidget);
+    }
+    overlayOptions->setVisible(overlay);
+    
+    loadAndPlayVideo(overlay ? overlayVideoPath : annotatedVideoPath);
+    mediaPlayer->setPosition(position);
+    playPauseButton->setText("Play");
+}
+
+/******************************************************************************
+ * 播放位置标签："当前 / 总时长"
+ ******************************************************************************/
+void MainWindow::updateVideoPositionLabel()
+{
+    positionLabel->setText(QString("%1 / %2")
+        .arg(formatDuration(mediaPlayer->position() / 1000.0))
+        .arg(formatDuration(mediaPlayer->duration() / 1000.0)));
+}
+
 /******************************************************************************
  * 事件处理程序：播放/暂停视频
  * 
@@ -1082,17 +1947,25 @@ void MainWindow::onStopVideo()
  ******************************************************************************/
 void MainWindow::updateElapsedTime()
 {
+    // 暂停前累计的时间加上本次继续以来的时间
+    qint64 elapsed = activeElapsedMs;  // 毫秒
     if (elapsedTimer->isValid()) {
-        qint64 elapsed = elapsedTimer->elapsed();  // 毫秒
-        int seconds = elapsed / 1000;
-        int minutes = seconds / 60;
-        seconds = seconds % 60;
-        
-        QString timeText = QString("Elapsed: %1:%2")
-            .arg(minutes)
-            .arg(seconds, 2, 10, QChar('0'));
-        elapsedTimeLabel->setText(timeText);
+        elapsed += elapsedTimer->elapsed();
     }
+    elapsedTimeLabel->setText(QString("Elapsed: %1").arg(formatDuration(static_cast<double>(elapsed / 1000))));
+}
+
+/******************************************************************************
+ * 实用方法：格式化时长
+ * 
+ * 将秒数格式化为"M:SS"（用于已用时间和预计剩余时间）。
+ ******************************************************************************/
+QString MainWindow::formatDuration(double seconds)
+{
+    int totalSeconds = qMax(0, qRound(seconds));
+    int minutes = totalSeconds / 60;
+    int secs = totalSeconds % 60;
+    return QString("%1:%2").arg(minutes).arg(secs, 2, 10, QChar('0'));
 }
 
 /******************************************************************************
@@ -7,14 +7,21 @@
  * 
  * KEY RESPONSIBILITIES:
  * - User interface for selecting input video and YOLO model
- * - Asynchronous execution of Python analysis pipeline via QProcess
- * - Real-time display of analysis progress and log output
- * - Automatic loading and visualization of analysis results (CSV/JSON tables)
+ * - Queue of analysis jobs run concurrently on a pool of persistent workers
+ * - Real-time display of analysis progress and log output, and of partial
+ *   results (result snapshots sent by the pipeline as stages complete)
+ * - Automatic loading and visualization of analysis results (CSV/JSON tables,
+ *   per-frame data paged from disk, see ResultTableModel.h)
  * - Embedded video player for viewing annotated output videos
+ * - Per-stage timings of each run (Performance tab, see PerformanceView.h)
  * 
  * ARCHITECTURE:
  * The MainWindow acts as a bridge between the Qt GUI and Python backend:
- *   User Input → Qt GUI → QProcess → Python main.py → Output Files → Qt Display
+ *   User Input → Qt GUI → AnalysisScheduler → AnalysisWorker pool
+ *              → Python worker.py → Per-job Output Files → Qt Display
+ * Worker processes stay alive between analyses so the YOLO model is only
+ * loaded once (see AnalysisWorker.h); the scheduler sizes the pool from the
+ * core count and available memory (see AnalysisScheduler.h).
  * 
  * INCLUDES:
  * - Qt Core: Main window framework, process management, timers
@@ -28,7 +35,6 @@
 #include <QMainWindow>
 #include <QProcess>
 #include <QPushButton>
-#include <QTextEdit>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -41,6 +47,7 @@
 #include <QPixmap>
 #include <QGroupBox>
 #include <QTableWidget>
+#include <QTableView>
 #include <QTabWidget>
 #include <QHeaderView>
 #include <QtMultimedia/QMediaPlayer>
@@ -52,6 +59,17 @@
 #include <QProgressBar>
 #include <QElapsedTimer>
 #include <QTimer>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QSlider>
+#include <QStackedWidget>
+#include <QJsonObject>
+#include "AnalysisScheduler.h"
+#include "AnalysisResults.h"
+#include "ResultTableModel.h"
+#include "LogConsole.h"
+#include "OverlayVideoWidget.h"
+#include "PerformanceView.h"
 
 /**
  * @class MainWindow
@@ -59,9 +77,9 @@
  * 
  * Provides a complete interface for:
  * - Configuring analysis parameters (video input, model selection)
- * - Running Python-based video analysis asynchronously
+ * - Queueing Python-based video analyses and running them concurrently
  * - Monitoring analysis progress in real-time
- * - Displaying results in tabbed interface (summary, data table, video player)
+ * - Displaying results in tabbed interface (summary, job queue, data table, video player)
  */
 class MainWindow : public QMainWindow
 {
@@ -75,16 +93,41 @@ private slots:
     // ===== EVENT HANDLERS: User Interactions =====
     void onBrowseInputVideo();     // Open file dialog to select input video
     void onBrowseModel();          // Open file dialog to select YOLO model
-    void onStartAnalysis();        // Launch Python analysis process
+    void onStartAnalysis();        // Queue the selected video for analysis
+    void onAddVideosToQueue();     // Select several videos and queue them all
+    void onPauseQueue();           // Pause or resume all running jobs
+    void onCancelQueue();          // Cancel all queued and running jobs
     
-    // ===== EVENT HANDLERS: Process Communication =====
-    void onProcessReadyReadStandardOutput();  // Capture Python stdout in real-time
-    void onProcessReadyReadStandardError();   // Capture Python stderr in real-time
-    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);  // Handle completion, load results
+    // ===== EVENT HANDLERS: Job Queue =====
+    void onSchedulerJobAdded(const QString &jobId);    // Add a row to the queue table
+    void onSchedulerJobChanged(const QString &jobId);  // Refresh a queue row (status, progress)
+    void onSchedulerJobRemoved(const QString &jobId);  // Remove a row from the queue table
+    void onRemoveSelectedJobs();   // Remove selected queued/finished jobs
+    void onCancelSelectedJobs();   // Cancel selected queued/running jobs
+    void onResumeSelectedJobs();   // Queue selected cancelled/failed jobs again
+    void onClearFinishedJobs();    // Remove all finished jobs from the queue
+    void onQueueItemDoubleClicked(int row, int column);  // Show results of a finished job
+    void onConcurrencyChanged(int jobs);  // Change the number of parallel jobs
+    void onVideoCodecChanged(int index);  // Change the output codec of new jobs
+    void onDetectionBackendChanged(int index);  // Change the detection backend of new jobs
+    
+    // ===== EVENT HANDLERS: Data Table =====
+    void onDataSourceChanged(int index);  // Switch between player summary and per-frame data
+    void onDataFilterChanged();    // Apply the filter column and text
+    
+    // ===== EVENT HANDLERS: Worker Communication =====
+    void onWorkerLogOutput(const QString &text, bool isError);  // Show worker stdout/stderr in real-time
+    void onWorkerJobEvent(const QString &jobId, const QJsonObject &event);  // Route job events to the UI
+    void onWorkerModelLoaded(const QString &modelPath, double seconds);  // Report a (re)loaded model
+    void onJobFinished(const QString &jobId, bool success);  // Handle completion, load results
+    void onQueueIdle();            // Last queued job finished: show run summary
+    void handleProgressEvent(const QJsonObject &event);  // Update progress bar from a structured progress event
+    void showPartialResults(const AnalysisJob &job);     // Show the latest result snapshot of a running job
     
     // ===== EVENT HANDLERS: Video Playback =====
     void onPlayPauseVideo();       // Toggle video play/pause
     void onStopVideo();            // Stop video and reset to beginning
+    void onVideoModeChanged(int index);  // Annotated video or live overlay on the input video
     void updateElapsedTime();      // Update elapsed time display (timer callback)
 
 private:
@@ -94,13 +137,28 @@ private:
     
     // ===== RESULT LOADING METHODS =====
     void displayResultMedia(const QString &mediaPath);      // Legacy method for displaying results
-    QString findOutputVideo();                              // Locate output video file
+    QString findOutputVideo(const QString &outputDirPath);  // Locate output video file
     void loadAndDisplayCSV(const QString &csvPath);         // Parse and display CSV data in table
     void loadAndDisplayJSON(const QString &jsonPath);       // Parse and display JSON data in table
+    void displayJsonData(const QJsonObject &root);          // Show data_output.json-shaped data in table
+    void loadDataTable();                                   // Load the selected data source of the shown job
+    void updateDataFilterColumns();                         // Fill the filter column list from the headers
+    void updateDataRowCount();                              // "N of M rows"
     void loadAndPlayVideo(const QString &videoPath);        // Load video into media player
+    void updateVideoPositionLabel();                        // "m:ss / m:ss"
+    void loadJobResults(const AnalysisJob &job);            // Load table, video and summary of a job
+    
+    // ===== JOB QUEUE METHODS =====
+    void enqueueVideo(const QString &inputVideo, const QString &modelPath);  // Queue one video
+    void beginQueueRun();                                   // Reset progress UI when the queue starts
+    int findJobRow(const QString &jobId) const;             // Queue table row of a job (-1 if none)
+    QStringList selectedJobIds() const;                     // Jobs of the selected queue rows
+    void updateRunControls();                               // Pause/cancel buttons for the queue state
+    QString queueSummaryText() const;                       // "N running, M queued"
+    void updateResourcePlanLabel();                         // Show threads per job and resources
     
     // ===== UTILITY METHODS =====
-    QString getProjectRootPath() const;  // Get absolute path to project root
+    static QString formatDuration(double seconds);  // Format seconds as "M:SS"
     
     // ===== UI COMPONENTS: Layout =====
     QWidget *centralWidget;
@@ -111,14 +169,24 @@ private:
     QToolButton *browseInputButton;     // Button to browse for input video
     QLineEdit *modelPathEdit;           // Text field showing selected model path
     QToolButton *browseModelButton;     // Button to browse for YOLO model
-    QPushButton *startButton;           // Button to start analysis
+    QPushButton *startButton;           // Button to queue the selected video
+    QPushButton *addVideosButton;       // Button to queue several videos at once
+    QPushButton *pauseButton;           // Pause/resume the running jobs (visible during a run)
+    QPushButton *cancelButton;          // Cancel all jobs of the run (visible during a run)
+    QSpinBox *concurrencySpinBox;       // Number of analyses run in parallel
+    QComboBox *videoCodecComboBox;      // Output video codec of new jobs
+    QComboBox *backendComboBox;         // Detection backend of new jobs
+    QLabel *resourcePlanLabel;          // Thread budget per job and machine resources
     
     // ===== UI COMPONENTS: Progress Display =====
-    QTextEdit *outputTextEdit;          // Log output from Python process (stdout/stderr)
+    LogConsole *logConsole;             // Log output from Python process (stdout/stderr)
+    QComboBox *logLevelComboBox;        // Minimum level shown in the log
     QLabel *statusLabel;                // Current status message
-    QProgressBar *progressBar;          // Visual progress indicator
+    QProgressBar *progressBar;          // Visual progress indicator (determinate per stage)
+    QLabel *progressDetailLabel;        // Stage frames, throughput and remaining time
     QLabel *elapsedTimeLabel;           // Elapsed time counter
-    QElapsedTimer *elapsedTimer;        // Timer for measuring elapsed time
+    QElapsedTimer *elapsedTimer;        // Timer for measuring elapsed time (invalid while paused)
+    qint64 activeElapsedMs;             // Elapsed time before the last pause
     QTimer *updateTimer;                // Timer for periodic UI updates
     
     // ===== UI COMPONENTS: Results Tabs =====
@@ -126,24 +194,58 @@ private:
     QLabel *resultImageLabel;           // Label for displaying result images (legacy)
     QScrollArea *resultScrollArea;      // Scroll area for large content
     
+    // ===== UI COMPONENTS: Job Queue =====
+    QTableWidget *jobQueueTable;        // Queued, running and finished jobs
+    QPushButton *removeJobButton;       // Remove selected jobs
+    QPushButton *cancelJobButton;       // Cancel selected jobs
+    QPushButton *resumeJobButton;       // Resume selected cancelled/failed jobs from their checkpoint
+    QPushButton *clearFinishedButton;   // Remove finished jobs
+    QWidget *queueTab;                  // Container widget for job queue tab
+    
     // ===== UI COMPONENTS: Data Display (CSV/JSON) =====
-    QTableWidget *dataTableWidget;      // Table widget for displaying player statistics
+    QTableView *dataTableView;          // Table view for player statistics and per-frame data
+    ResultTableModel *dataModel;        // Rows paged from the CSV file on disk
+    ResultFilterProxyModel *dataProxyModel;  // Sorting and filtering of dataModel
+    QComboBox *dataSourceComboBox;      // Player summary or per-frame data
+    QComboBox *dataFilterColumnComboBox;  // Column the filter applies to (or all columns)
+    QLineEdit *dataFilterEdit;          // Filter text
+    QTimer *dataFilterTimer;            // Applies the filter shortly after typing stops
+    QLabel *dataRowCountLabel;          // Shown and total rows
     QWidget *dataTab;                   // Container widget for data table tab
+    QString dataSummaryPath;            // data_output.csv of the shown job
+    QString dataJsonPath;               // data_output.json of the shown job
+    QString dataFramePath;              // frame_data.csv of the shown job
     
     // ===== UI COMPONENTS: Video Playback =====
     QMediaPlayer *mediaPlayer;          // Qt Multimedia player for video playback
     QAudioOutput *audioOutput;          // Audio output device (attached to media player)
-    QVideoWidget *videoWidget;          // Video rendering widget
+    QVideoWidget *videoWidget;          // Video rendering widget (annotated video)
+    OverlayVideoWidget *overlayWidget;  // Input video with overlays painted from track telemetry
+    QStackedWidget *videoStack;         // Shows videoWidget or overlayWidget
+    QComboBox *videoModeComboBox;       // Annotated video / live overlay
+    QWidget *overlayOptions;            // Overlay toggles (live overlay mode only)
+    QSlider *positionSlider;            // Seek bar
+    QLabel *positionLabel;              // Position and duration
+    QString annotatedVideoPath;         // Rendered output video of the shown job (empty if none)
+    QString overlayVideoPath;           // Input video of the shown job
     QPushButton *playPauseButton;       // Play/pause toggle button
     QPushButton *stopButton;            // Stop button
     QWidget *videoTab;                  // Container widget for video playback tab
     
+    // ===== UI COMPONENTS: Performance =====
+    PerformanceView *performanceView;   // Per-stage timings of a run compared with the previous run
+    QString performanceJobId;           // Job whose stage records are shown live
+    
     // ===== PROCESS MANAGEMENT =====
-    QProcess *pythonProcess;            // QProcess for running Python analysis asynchronously
+    AnalysisScheduler *scheduler;       // Job queue and persistent worker pool
+    QString focusedJobId;               // Job whose progress drives the progress bar
     
     // ===== APPLICATION STATE =====
     QString lastOutputPath;             // Path to most recent output directory
-    bool analysisRunning;               // Flag indicating if analysis is currently running
+    bool analysisRunning;               // Flag indicating if any job is queued or running
+    int runSucceeded;                   // Jobs succeeded since the queue last became active
+    int runFailed;                      // Jobs failed since the queue last became active
+    int runCancelled;                   // Jobs cancelled since the queue last became active
 };
 
 #endif // MAINWINDOW_H
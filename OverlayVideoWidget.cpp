@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * 叠加层视频部件实现
+ *
+ * 播放原始输入视频，并在每一帧上根据追踪遥测数据绘制标注
+ * （外观与流程渲染的视频相同，见annotation_renderer.py）。
+ ******************************************************************************/
+
+#include "OverlayVideoWidget.h"
+#include <QMediaMetaData>
+#include <QMediaPlayer>
+#include <QPainter>
+#include <QPainterPath>
+#include <QVideoSink>
+#include <cmath>
+
+// 颜色（与annotation_renderer.py一致）
+static const QColor kDefaultPlayerColor(255, 0, 0);
+static const QColor kRefereeColor(255, 255, 0);
+static const QColor kBallColor(0, 255, 0);
+static const QColor kPossessionColor(255, 0, 0);
+static const QColor kTextColor(0, 0, 0);
+
+// 遥测文件没有帧率且媒体元数据也没有时使用
+static const double kDefaultFrameRate = 24.0;
+
+/******************************************************************************
+ * 构造函数
+ ******************************************************************************/
+OverlayVideoWidget::OverlayVideoWidget(QWidget *parent)
+    : QWidget(parent)
+    , sink(new QVideoSink(this))
+    , player(nullptr)
+    , currentFrame(-1)
+    , enabledOverlays(AllOverlays)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    connect(sink, &QVideoSink::videoFrameChanged, this, &OverlayVideoWidget::onVideoFrameChanged);
+}
+
+void OverlayVideoWidget::attachPlayer(QMediaPlayer *mediaPlayer)
+{
+    player = mediaPlayer;
+    player->setVideoOutput(sink);
+}
+
+/******************************************************************************
+ * 遥测数据
+ *
+ * 加载时从has_ball列计算每帧的控球球队（与PlayerBallAssigner相同：
+ * 没有球员控球的帧沿用上一帧的球队）以及前缀和，
+ * 绘制时每帧的控球百分比为O(1)。
+ ******************************************************************************/
+bool OverlayVideoWidget::setTelemetry(const QString &path)
+{
+    const bool ok = telemetry.open(path);
+    buildPossession();
+    update();
+    return ok;
+}
+
+void OverlayVideoWidget::clearTelemetry()
+{
+    telemetry.close();
+    buildPossession();
+    update();
+}
+
+QString OverlayVideoWidget::telemetryError() const
+{
+    return telemetry.errorString();
+}
+
+void OverlayVideoWidget::buildPossession()
+{
+    const int frames = telemetry.frameCount();
+    const qint8 *cls = telemetry.column<qint8>("cls");
+    const qint8 *team = telemetry.column<qint8>("team");
+    const quint8 *hasBall = telemetry.column<quint8>("has_ball");
+    const qint32 *frameColumn = telemetry.column<qint32>("frame");
+
+    for (QVector<int> &prefix : teamPrefix) {
+        prefix.fill(0, frames + 1);
+    }
+    if (!cls || !team || !hasBall || !frameColumn) {
+        return;
+    }
+
+    QVector<qint8> control(frames, -1);
+    for (qint64 row = 0; row < telemetry.rowCount(); ++row) {
+        if (hasBall[row] && cls[row] == TrackTelemetry::Player && frameColumn[row] < frames) {
+            control[frameColumn[row]] = team[row];
+        }
+    }
+    qint8 last = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        if (control[frame] >= 0) {
+            last = control[frame];
+        }
+        teamPrefix[0][frame + 1] = teamPrefix[0][frame] + (last == 1);
+        teamPrefix[1][frame + 1] = teamPrefix[1][frame] + (last == 2);
+    }
+}
+
+/******************************************************************************
+ * 叠加层开关
+ ******************************************************************************/
+void OverlayVideoWidget::setOverlayEnabled(Overlay overlay, bool enabled)
+{
+    enabledOverlays = enabled ? (enabledOverlays | overlay) : (enabledOverlays & ~overlay);
+    update();
+}
+
+int OverlayVideoWidget::overlays() const
+{
+    return enabledOverlays;
+}
+
+/******************************************************************************
+ * 视频帧
+ *
+ * 帧号 = 帧开始时间 × 帧率。没有时间戳的帧使用播放器位置。
+ ******************************************************************************/
+void OverlayVideoWidget::onVideoFrameChanged(const QVideoFrame &frame)
+{
+    if (!frame.isValid()) {
+        image = QImage();
+        currentFrame = -1;
+        update();
+        return;
+    }
+    image = frame.toImage();
+    currentFrame = frameNumber(frame);
+    update();
+}
+
+int OverlayVideoWidget::frameNumber(const QVideoFrame &frame) const
+{
+    double fps = telemetry.fps();
+    if (fps <= 0 && player) {
+        fps = player->metaData().value(QMediaMetaData::VideoFrameRate).toDouble();
+    }
+    if (fps <= 0) {
+        fps = kDefaultFrameRate;
+    }
+
+    qint64 micros = frame.startTime();
+    if (micros < 0 && player) {
+        micros = player->position() * 1000;
+    }
+    if (micros < 0) {
+        return -1;
+    }
+    return int(std::floor(micros * fps / 1e6 + 0.5));
+}
+
+/******************************************************************************
+ * 绘制
+ *
+ * 帧按比例缩放并居中；画笔变换为视频像素坐标，叠加层坐标与遥测数据相同。
+ ******************************************************************************/
+void OverlayVideoWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    if (image.isNull()) {
+        return;
+    }
+
+    const QSize scaled = image.size().scaled(size(), Qt::KeepAspectRatio);
+    const QRect target(QPoint((width() - scaled.width()) / 2, (height() - scaled.height()) / 2), scaled);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(target, image);
+
+    if (!telemetry.isOpen() || currentFrame < 0 || currentFrame >= telemetry.frameCount()) {
+        return;
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(target.topLeft());
+    painter.scale(double(target.width()) / image.width(), double(target.height()) / image.height());
+
+    drawTracks(painter, currentFrame);
+    if (enabledOverlays & Possession) {
+        drawPossession(painter, currentFrame);
+    }
+}
+
+void OverlayVideoWidget::drawTracks(QPainter &painter, int frame) const
+{
+    const float *bbox = telemetry.column<float>("bbox");
+    const qint8 *cls = telemetry.column<qint8>("cls");
+    const qint32 *trackId = telemetry.column<qint32>("track_id");
+    const qint8 *team = telemetry.column<qint8>("team");
+    const quint8 *hasBall = telemetry.column<quint8>("has_ball");
+    const float *speed = telemetry.column<float>("speed");
+    const float *distance = telemetry.column<float>("distance");
+    if (!bbox || !cls || !trackId) {
+        return;
+    }
+
+    QFont labelFont = painter.font();
+    labelFont.setPixelSize(16);
+    labelFont.setBold(true);
+    painter.setFont(labelFont);
+
+    auto triangle = [&painter](const float *box, const QColor &color) {
+        const QPointF tip((box[0] + box[2]) / 2, box[1]);
+        QPainterPath path;
+        path.moveTo(tip);
+        path.lineTo(tip + QPointF(-10, -20));
+        path.lineTo(tip + QPointF(10, -20));
+        path.closeSubpath();
+        painter.setPen(QPen(Qt::black, 2));
+        painter.setBrush(color);
+        painter.drawPath(path);
+    };
+
+    auto ellipse = [&painter](const float *box, const QColor &color) {
+        const double width = box[2] - box[0];
+        const QRectF bounds(QPointF((box[0] + box[2]) / 2 - width, box[3] - 0.35 * width),
+                            QSizeF(2 * width, 0.7 * width));
+        painter.setPen(QPen(color, 2));
+        painter.setBrush(Qt::NoBrush);
+        // annotation_renderer.py: startAngle=-45, endAngle=235（OpenCV角度顺时针）
+        painter.drawArc(bounds, 45 * 16, -280 * 16);
+    };
+
+    const QPair<qint64, qint64> rows = telemetry.frameRows(frame);
+    for (qint64 row = rows.first; row < rows.second; ++row) {
+        const float *box = bbox + row * 4;
+        if (std::isnan(box[0])) {
+            continue;
+        }
+
+        if (cls[row] == TrackTelemetry::Player && (enabledOverlays & Players)) {
+            QColor color = team ? telemetry.teamColor(team[row]) : QColor();
+            if (!color.isValid()) {
+                color = kDefaultPlayerColor;
+            }
+            ellipse(box, color);
+
+            // 脚下的ID标签
+            const QRectF label((box[0] + box[2]) / 2 - 20, box[3] + 5, 40, 20);
+            painter.fillRect(label, color);
+            painter.setPen(kTextColor);
+            painter.drawText(label, Qt::AlignCenter, QString::number(trackId[row]));
+
+            if (hasBall && hasBall[row]) {
+                triangle(box, kPossessionColor);
+            }
+        } else if (cls[row] == TrackTelemetry::Referee && (enabledOverlays & Referees)) {
+            ellipse(box, kRefereeColor);
+        } else if (cls[row] == TrackTelemetry::Ball && (enabledOverlays & Ball)) {
+            triangle(box, kBallColor);
+        }
+
+        // 速度和距离（NaN表示未测量）
+        if (cls[row] == TrackTelemetry::Player && (enabledOverlays & Speed)
+            && speed && distance && !std::isnan(speed[row])) {
+            const QPointF anchor((box[0] + box[2]) / 2, box[3] + 40);
+            painter.setPen(kTextColor);
+            painter.drawText(anchor, QString("%1 km/h").arg(speed[row], 0, 'f', 2));
+            painter.drawText(anchor + QPointF(0, 20), QString("%1 m").arg(distance[row], 0, 'f', 2));
+        }
+    }
+}
+
+/******************************************************************************
+ * 控球叠加层
+ *
+ * 渲染视频中控球框的位置按1920×1080设计（右下角），这里相对右下角放置，
+ * 其他分辨率下也在画面内。
+ ******************************************************************************/
+void OverlayVideoWidget::drawPossession(QPainter &painter, int frame) const
+{
+    const int team1 = teamPrefix[0].value(frame + 1);
+    const int team2 = teamPrefix[1].value(frame + 1);
+    const int total = team1 + team2;
+    const double percent1 = total > 0 ? 100.0 * team1 / total : 0.0;
+    const double percent2 = total > 0 ? 100.0 * team2 / total : 0.0;
+
+    const QRectF box(image.width() - 570, image.height() - 230, 550, 120);
+    painter.fillRect(box, QColor(255, 255, 255, 102));
+
+    QFont font = painter.font();
+    font.setPixelSize(30);
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(kTextColor);
+    painter.drawText(box.topLeft() + QPointF(50, 50), QString("Team 1 Ball Control: %1%").arg(percent1, 0, 'f', 2));
+    painter.drawText(box.topLeft() + QPointF(50, 100), QString("Team 2 Ball Control: %1%").arg(percent2, 0, 'f', 2));
+}
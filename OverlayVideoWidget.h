@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * OVERLAY VIDEO WIDGET HEADER
+ *
+ * This header defines OverlayVideoWidget, which plays the original input
+ * video and paints the annotations on each displayed frame from the track
+ * telemetry (tracks.ftrk, see TrackTelemetry.h) instead of showing the
+ * annotated video rendered by the pipeline.
+ *
+ * WHY:
+ * The annotated video is only available after the pipeline has drawn and
+ * encoded every frame. The overlay needs nothing but the track data, so a
+ * review session can skip rendering and encoding altogether ("Output video:
+ * None"), toggle overlays on and off and scrub without re-rendering.
+ *
+ * HOW:
+ * - attachPlayer() routes a QMediaPlayer's frames into this widget's
+ *   QVideoSink
+ * - The frame number is the frame's start time times the telemetry frame
+ *   rate; the rows of that frame are looked up in the telemetry
+ * - paintEvent() draws the frame letterboxed and the overlays with QPainter
+ *   in video pixel coordinates (the painter is scaled), so they line up at
+ *   any widget size
+ *
+ * OVERLAYS (same look as the rendered video):
+ * - Players: ellipse at the feet in the team color with the track ID,
+ *   red triangle above the player with the ball
+ * - Referees: yellow ellipse
+ * - Ball: green triangle
+ * - Possession: team ball control up to the current frame (bottom right)
+ * - Speed: speed and distance below each player
+ ******************************************************************************/
+
+#ifndef OVERLAYVIDEOWIDGET_H
+#define OVERLAYVIDEOWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+#include <QVideoFrame>
+#include <QVector>
+#include "TrackTelemetry.h"
+
+class QMediaPlayer;
+class QVideoSink;
+
+/**
+ * @class OverlayVideoWidget
+ * @brief Video output painting track overlays from telemetry on every frame
+ */
+class OverlayVideoWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Overlay {
+        Players = 0x01,
+        Referees = 0x02,
+        Ball = 0x04,
+        Possession = 0x08,
+        Speed = 0x10,
+        AllOverlays = Players | Referees | Ball | Possession | Speed
+    };
+
+    explicit OverlayVideoWidget(QWidget *parent = nullptr);
+
+    void attachPlayer(QMediaPlayer *player);        // Send the player's frames to this widget
+    bool setTelemetry(const QString &path);         // Track data of the video; false if unreadable
+    void clearTelemetry();
+    QString telemetryError() const;
+
+    void setOverlayEnabled(Overlay overlay, bool enabled);
+    int overlays() const;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void onVideoFrameChanged(const QVideoFrame &frame);
+
+private:
+    int frameNumber(const QVideoFrame &frame) const;
+    void buildPossession();
+    void drawTracks(QPainter &painter, int frame) const;
+    void drawPossession(QPainter &painter, int frame) const;
+
+    QVideoSink *sink;
+    QMediaPlayer *player;
+    QImage image;                       // Current frame
+    int currentFrame;                   // Frame number of image (-1 if unknown)
+    int enabledOverlays;
+
+    TrackTelemetry telemetry;
+    QVector<int> teamPrefix[2];         // Frames with team 1/2 in control before frame n
+};
+
+#endif // OVERLAYVIDEOWIDGET_H
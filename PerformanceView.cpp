@@ -0,0 +1,431 @@
+/*******************************************************************************
+ * 性能视图实现
+ *
+ * 各阶段的时间线和吞吐量表，并与同一视频的上一次运行比较（见PerformanceView.h）。
+ ******************************************************************************/
+
+#include "PerformanceView.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QHeaderView>
+#include <QJsonDocument>
+#include <QLabel>
+#include <QPainter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <cmath>
+
+namespace {
+
+enum Column {
+    StageColumn,
+    StartColumn,
+    WallColumn,
+    CpuColumn,
+    PeakRssColumn,
+    FramesColumn,
+    FpsColumn,
+    PreviousWallColumn,
+    ChangeColumn,
+    ColumnCount
+};
+
+// 与上一次相比变化超过此比例时着色
+const double kChangeHighlight = 0.05;
+
+QString seconds(const QJsonValue &value)
+{
+    return value.isDouble() ? QString::number(value.toDouble(), 'f', 2) : QString("-");
+}
+
+QString megabytes(const QJsonValue &value)
+{
+    return value.isDouble() ? QString::number(value.toDouble() / (1024.0 * 1024.0), 'f', 1) : QString("-");
+}
+
+QString count(const QJsonValue &value)
+{
+    return value.isDouble() ? QString::number(value.toInteger()) : QString("-");
+}
+
+QString rate(const QJsonValue &value)
+{
+    return value.isDouble() ? QString::number(value.toDouble(), 'f', 1) : QString("-");
+}
+
+QString change(double current, double previous)
+{
+    if (previous <= 0) {
+        return QString("-");
+    }
+    const double percent = (current - previous) / previous * 100.0;
+    return QString("%1%2%").arg(percent >= 0 ? "+" : "").arg(percent, 0, 'f', 1);
+}
+
+QString samePath(const QString &path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+} // namespace
+
+/******************************************************************************
+ * 时间线
+ *
+ * 每个阶段一行：从开始时间起画出墙钟时间的横条，上一次运行的同名阶段
+ * 以细灰条画在后面。时间轴按两次运行中较长的一次缩放。
+ ******************************************************************************/
+class PerformanceTimeline : public QWidget
+{
+public:
+    explicit PerformanceTimeline(QWidget *parent = nullptr)
+        : QWidget(parent)
+    {
+        setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    }
+
+    void setRuns(const QJsonArray &current, const QHash<QString, QJsonObject> &previous)
+    {
+        stages = current;
+        previousStages = previous;
+        setFixedHeight(kMargin * 2 + kAxisHeight + qMax<int>(1, stages.size()) * kRowHeight);
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        if (stages.isEmpty()) {
+            painter.setPen(palette().color(QPalette::PlaceholderText));
+            painter.drawText(rect(), Qt::AlignCenter, "No performance records yet");
+            return;
+        }
+
+        // 时间轴范围：两次运行中最晚结束的阶段
+        double end = 0;
+        for (const QJsonValue &value : stages) {
+            const QJsonObject stage = value.toObject();
+            end = qMax(end, stage.value("start").toDouble() + stage.value("wall").toDouble());
+        }
+        for (const QJsonObject &stage : previousStages) {
+            end = qMax(end, stage.value("start").toDouble() + stage.value("wall").toDouble());
+        }
+        end = qMax(end, 0.001);
+
+        const int left = kLabelWidth;
+        const int width = qMax(1, this->width() - left - kMargin);
+        auto x = [&](double seconds) { return left + int(seconds / end * width); };
+
+        const QColor barColor = palette().color(QPalette::Highlight);
+        const QColor previousColor = palette().color(QPalette::Mid);
+        const QColor textColor = palette().color(QPalette::WindowText);
+
+        for (int row = 0; row < stages.size(); ++row) {
+            const QJsonObject stage = stages.at(row).toObject();
+            const QString name = stage.value("stage").toString();
+            const int top = kMargin + row * kRowHeight;
+
+            painter.setPen(textColor);
+            painter.drawText(QRect(kMargin, top, left - kMargin * 2, kRowHeight),
+                             Qt::AlignVCenter | Qt::AlignRight, QString(name).replace('_', ' '));
+
+            const auto previous = previousStages.constFind(name);
+            if (previous != previousStages.constEnd()) {
+                const double start = previous->value("start").toDouble();
+                const double wall = previous->value("wall").toDouble();
+                painter.fillRect(QRect(x(start), top + kRowHeight - 6, qMax(1, x(start + wall) - x(start)), 3),
+                                 previousColor);
+            }
+
+            const double start = stage.value("start").toDouble();
+            const double wall = stage.value("wall").toDouble();
+            const QRect bar(x(start), top + 4, qMax(2, x(start + wall) - x(start)), kRowHeight - 12);
+            painter.fillRect(bar, barColor);
+
+            // 墙钟时间写在横条右侧，放不下时写在左侧
+            const QString label = QString("%1 s").arg(wall, 0, 'f', 2);
+            const int labelWidth = painter.fontMetrics().horizontalAdvance(label) + 6;
+            const QRect labelRect = bar.right() + labelWidth <= this->width() - kMargin
+                ? QRect(bar.right() + 4, top, labelWidth, kRowHeight - 4)
+                : QRect(bar.left() - labelWidth - 2, top, labelWidth, kRowHeight - 4);
+            painter.drawText(labelRect, Qt::AlignVCenter | Qt::AlignLeft, label);
+        }
+
+        // 时间轴：1、2、5×10^n秒的刻度，约每80像素一个
+        const int axisTop = kMargin + stages.size() * kRowHeight + 2;
+        painter.setPen(previousColor);
+        painter.drawLine(left, axisTop, left + width, axisTop);
+        const double rough = end / qMax(1, width / 80);
+        const double magnitude = std::pow(10.0, std::floor(std::log10(rough)));
+        double step = magnitude;
+        for (double factor : {2.0, 5.0, 10.0}) {
+            if (step >= rough) {
+                break;
+            }
+            step = magnitude * factor;
+        }
+        painter.setPen(textColor);
+        for (double tick = 0; tick <= end + step * 1e-6; tick += step) {
+            painter.drawLine(x(tick), axisTop, x(tick), axisTop + 3);
+            painter.drawText(QRect(x(tick) - 40, axisTop + 4, 80, kAxisHeight - 4),
+                             Qt::AlignHCenter | Qt::AlignTop, QString("%1 s").arg(tick, 0, 'g', 4));
+        }
+    }
+
+private:
+    static constexpr int kMargin = 8;
+    static constexpr int kRowHeight = 24;
+    static constexpr int kAxisHeight = 22;
+    static constexpr int kLabelWidth = 150;
+
+    QJsonArray stages;
+    QHash<QString, QJsonObject> previousStages;
+};
+
+/******************************************************************************
+ * 构造函数
+ ******************************************************************************/
+PerformanceView::PerformanceView(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(12);
+
+    summaryLabel = new QLabel(this);
+    summaryLabel->setWordWrap(true);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(summaryLabel);
+
+    timeline = new PerformanceTimeline(this);
+    layout->addWidget(timeline);
+
+    stageTree = new QTreeWidget(this);
+    stageTree->setColumnCount(ColumnCount);
+    stageTree->setHeaderLabels({"Stage", "Start (s)", "Wall (s)", "CPU (s)", "Peak RSS Δ (MB)",
+                                "Frames", "FPS", "Previous wall (s)", "Change"});
+    stageTree->headerItem()->setToolTip(CpuColumn, "CPU time of all threads of the process; "
+                                                   "more than the wall time means the stage ran in parallel");
+    stageTree->headerItem()->setToolTip(PeakRssColumn, "Growth of the process' peak memory during the stage "
+                                                       "(0 when it stayed below an earlier peak)");
+    stageTree->headerItem()->setToolTip(ChangeColumn, "Wall time compared with the previous run of the same video");
+    stageTree->setRootIsDecorated(true);
+    stageTree->setAlternatingRowColors(true);
+    stageTree->setUniformRowHeights(true);
+    stageTree->header()->setStretchLastSection(false);
+    stageTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    stageTree->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    layout->addWidget(stageTree, 1);
+
+    clear();
+}
+
+/******************************************************************************
+ * 运行
+ ******************************************************************************/
+void PerformanceView::clear()
+{
+    stages = QJsonArray();
+    report = QJsonObject();
+    previousReport = QJsonObject();
+    previousPath.clear();
+    rebuild();
+}
+
+void PerformanceView::startRun(const QString &videoPath, const QString &outputDir)
+{
+    clear();
+    previousReport = findPreviousReport(videoPath, outputDir, QString());
+    rebuild();
+}
+
+void PerformanceView::addRecord(const QJsonObject &record)
+{
+    // 开始时间从运行开始计：比上一条更早表示新的一次运行（例如恢复的任务）
+    if (!stages.isEmpty()
+        && record.value("start").toDouble() < stages.last().toObject().value("start").toDouble()) {
+        stages = QJsonArray();
+    }
+    stages.append(record);
+    rebuild();
+}
+
+bool PerformanceView::loadReport(const QString &path)
+{
+    const QJsonObject loaded = readReport(path);
+    if (loaded.isEmpty()) {
+        return false;
+    }
+    report = loaded;
+    stages = report.value("stages").toArray();
+    previousReport = findPreviousReport(report.value("video").toString(), QFileInfo(path).absolutePath(),
+                                        report.value("finished").toString());
+    rebuild();
+    return true;
+}
+
+/******************************************************************************
+ * 上一次运行
+ *
+ * 在同级输出目录中查找同一输入视频、在当前运行之前完成的最新performance.json。
+ * finished为ISO格式时间，可以直接按字符串比较。
+ ******************************************************************************/
+QJsonObject PerformanceView::readReport(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QJsonObject();
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    return root.value("stages").isArray() ? root : QJsonObject();
+}
+
+QJsonObject PerformanceView::findPreviousReport(const QString &videoPath, const QString &outputDir,
+                                                const QString &finishedBefore)
+{
+    previousPath.clear();
+    if (videoPath.isEmpty() || outputDir.isEmpty()) {
+        return QJsonObject();
+    }
+    const QString video = samePath(videoPath);
+    const QString current = samePath(outputDir);
+    QDir parent(current);
+    if (!parent.cdUp()) {
+        return QJsonObject();
+    }
+
+    QJsonObject best;
+    QString bestFinished;
+    QString bestPath;
+    const QFileInfoList dirs = parent.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &dir : dirs) {
+        if (samePath(dir.absoluteFilePath()) == current) {
+            continue;
+        }
+        const QString path = QDir(dir.absoluteFilePath()).absoluteFilePath("performance.json");
+        if (!QFileInfo::exists(path)) {
+            continue;
+        }
+        const QJsonObject candidate = readReport(path);
+        const QString finished = candidate.value("finished").toString();
+        if (candidate.isEmpty() || samePath(candidate.value("video").toString()) != video
+            || (!finishedBefore.isEmpty() && finished >= finishedBefore) || finished < bestFinished) {
+            continue;
+        }
+        best = candidate;
+        bestFinished = finished;
+        bestPath = path;
+    }
+    previousPath = bestPath;
+    return best;
+}
+
+/******************************************************************************
+ * 显示
+ ******************************************************************************/
+void PerformanceView::rebuild()
+{
+    QHash<QString, QJsonObject> previousStages;
+    for (const QJsonValue &value : previousReport.value("stages").toArray()) {
+        previousStages.insert(value.toObject().value("stage").toString(), value.toObject());
+    }
+    timeline->setRuns(stages, previousStages);
+
+    stageTree->clear();
+    for (const QJsonValue &value : std::as_const(stages)) {
+        const QJsonObject stage = value.toObject();
+        const QString name = stage.value("stage").toString();
+        const QJsonObject previous = previousStages.value(name);
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(stageTree);
+        item->setText(StageColumn, QString(name).replace('_', ' '));
+        item->setText(StartColumn, seconds(stage.value("start")));
+        item->setText(WallColumn, seconds(stage.value("wall")));
+        item->setText(CpuColumn, seconds(stage.value("cpu")));
+        item->setText(PeakRssColumn, megabytes(stage.value("peak_rss_delta")));
+        item->setText(FramesColumn, count(stage.value("frames")));
+        item->setText(FpsColumn, rate(stage.value("fps")));
+        item->setText(PreviousWallColumn, seconds(previous.value("wall")));
+
+        const double wall = stage.value("wall").toDouble();
+        const double previousWall = previous.value("wall").toDouble();
+        item->setText(ChangeColumn, change(wall, previousWall));
+        if (previousWall > 0 && std::abs(wall - previousWall) > previousWall * kChangeHighlight) {
+            item->setForeground(ChangeColumn, wall > previousWall ? QColor("#dc3545") : QColor("#28a745"));
+        }
+
+        // 阶段的各部分（解码 / 推理 / 追踪等）
+        const QJsonObject parts = stage.value("parts").toObject();
+        const QJsonObject previousParts = previous.value("parts").toObject();
+        for (auto it = parts.constBegin(); it != parts.constEnd(); ++it) {
+            const QJsonObject part = it.value().toObject();
+            const QJsonObject previousPart = previousParts.value(it.key()).toObject();
+            QTreeWidgetItem *child = new QTreeWidgetItem(item);
+            child->setText(StageColumn, it.key());
+            child->setText(WallColumn, seconds(part.value("wall")));
+            child->setText(FramesColumn, count(part.value("frames")));
+            child->setText(FpsColumn, rate(part.value("fps")));
+            child->setText(PreviousWallColumn, seconds(previousPart.value("wall")));
+            child->setText(ChangeColumn, change(part.value("wall").toDouble(),
+                                                previousPart.value("wall").toDouble()));
+        }
+        item->setExpanded(true);
+    }
+    for (int column = StartColumn; column < ColumnCount; ++column) {
+        for (int i = 0; i < stageTree->topLevelItemCount(); ++i) {
+            QTreeWidgetItem *item = stageTree->topLevelItem(i);
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+            for (int j = 0; j < item->childCount(); ++j) {
+                item->child(j)->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+            }
+        }
+    }
+
+    updateSummary();
+}
+
+void PerformanceView::updateSummary()
+{
+    if (stages.isEmpty() && report.isEmpty()) {
+        summaryLabel->setText("Stage timings appear here while an analysis runs "
+                              "(saved as performance.json in the output directory).");
+        return;
+    }
+
+    QStringList parts;
+    double total = 0;
+    if (!report.isEmpty()) {
+        total = report.value("total_wall").toDouble();
+        QString setup = QString("%1, %2").arg(report.value("mode").toString().replace('_', ' '),
+                                               report.value("backend").toString());
+        if (report.value("int8").toBool()) {
+            setup += " (int8)";
+        }
+        setup += QString(", batch %1").arg(report.value("batch_size").toInt());
+        parts << QString("Total %1 s").arg(total, 0, 'f', 1) << setup;
+    } else {
+        const QJsonObject last = stages.last().toObject();
+        total = last.value("start").toDouble() + last.value("wall").toDouble();
+        parts << QString("Running · %1 stages, %2 s so far").arg(stages.size()).arg(total, 0, 'f', 1);
+    }
+
+    if (previousReport.isEmpty()) {
+        parts << "no previous run of this video";
+    } else {
+        const double previousTotal = previousReport.value("total_wall").toDouble();
+        QString previous = QString("previous run %1 (%2 s")
+            .arg(previousReport.value("finished").toString().replace('T', ' '))
+            .arg(previousTotal, 0, 'f', 1);
+        if (!report.isEmpty()) {
+            previous += ", " + change(total, previousTotal);
+        }
+        parts << previous + ")";
+    }
+    summaryLabel->setText(parts.join(" · "));
+    summaryLabel->setToolTip(previousPath);
+}
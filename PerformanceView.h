@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * PERFORMANCE VIEW HEADER
+ *
+ * This header defines PerformanceView, the Performance tab: where the time
+ * of an analysis run went, stage by stage, compared with the previous run
+ * of the same video.
+ *
+ * DATA:
+ * The pipeline records every stage (see foot-Function/utils/
+ * stage_metrics.py): start, wall and CPU seconds, peak RSS growth, frames
+ * and frames per second, plus parts of a stage (decode / inference /
+ * tracking in detection, decode / draw / encode in render).
+ * - While a job runs, each record arrives as a stage_metrics event and is
+ *   added with addRecord()
+ * - When it finishes, loadReport() replaces them with its performance.json
+ *
+ * PREVIOUS RUN:
+ * The newest other performance.json of the same input video among the
+ * sibling output directories (output_videos/<video>_<timestamp>/) that
+ * finished before the current run. Stages are matched by name.
+ *
+ * DISPLAY:
+ * - Summary line: total time, mode and backend, previous run
+ * - Timeline: one bar per stage from its start for its wall time, the
+ *   previous run's bar thin behind it
+ * - Table: one row per stage with its parts as children; the last columns
+ *   compare the wall time with the previous run
+ ******************************************************************************/
+
+#ifndef PERFORMANCEVIEW_H
+#define PERFORMANCEVIEW_H
+
+#include <QWidget>
+#include <QJsonArray>
+#include <QJsonObject>
+
+class QLabel;
+class QTreeWidget;
+class PerformanceTimeline;
+
+/**
+ * @class PerformanceView
+ * @brief Per-stage timeline and throughput of a run, compared with the previous run
+ */
+class PerformanceView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceView(QWidget *parent = nullptr);
+
+    // A run of videoPath writing to outputDir starts; records follow with addRecord()
+    void startRun(const QString &videoPath, const QString &outputDir);
+    void addRecord(const QJsonObject &record);      // stage_metrics event
+    bool loadReport(const QString &path);           // performance.json of a finished run
+    void clear();
+
+private:
+    static QJsonObject readReport(const QString &path);
+    QJsonObject findPreviousReport(const QString &videoPath, const QString &outputDir,
+                                   const QString &finishedBefore);
+    void rebuild();
+    void updateSummary();
+
+    QLabel *summaryLabel;
+    PerformanceTimeline *timeline;
+    QTreeWidget *stageTree;
+
+    QJsonArray stages;                  // Records of the current run
+    QJsonObject report;                 // performance.json of the current run (empty while live)
+    QJsonObject previousReport;         // Previous run of the same video (empty if none)
+    QString previousPath;               // File of previousReport
+};
+
+#endif // PERFORMANCEVIEW_H
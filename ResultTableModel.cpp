@@ -0,0 +1,480 @@
+/*******************************************************************************
+ * 结果表格模型实现
+ *
+ * 数据表选项卡的模型：
+ * - ResultTableModel：按页从磁盘读取CSV结果文件（内存占用固定）
+ * - ResultFilterProxyModel：按顺序读取一次列值作为键，再排序和过滤
+ ******************************************************************************/
+
+#include "ResultTableModel.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// 建立索引时每次读取的块大小
+static const qint64 kIndexBlockSize = 1 << 20;
+
+/******************************************************************************
+ * 构造函数
+ ******************************************************************************/
+ResultTableModel::ResultTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , totalRows(0)
+    , inMemory(false)
+{
+}
+
+/******************************************************************************
+ * 数据源：打开CSV文件
+ *
+ * 顺序扫描一次文件（按块读取并用memchr查找换行），记录每页第一行的
+ * 文件偏移量。第一行是标题行。之后的行在视图请求时才按页解析。
+ ******************************************************************************/
+bool ResultTableModel::openCsv(const QString &csvPath)
+{
+    beginResetModel();
+    resetState();
+
+    file.setFileName(csvPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        endResetModel();
+        return false;
+    }
+
+    columnHeaders = splitLine(file.readLine());
+
+    qint64 offset = file.pos();
+    bool lineOpen = false;      // 上一个换行之后已有字节
+    int rows = 0;
+    while (!file.atEnd()) {
+        const QByteArray block = file.read(kIndexBlockSize);
+        if (block.isEmpty()) {
+            break;
+        }
+        const char *begin = block.constData();
+        const char *end = begin + block.size();
+        const char *p = begin;
+        while (p < end) {
+            if (!lineOpen) {
+                if (rows % kRowsPerPage == 0) {
+                    pageOffsets.append(offset + (p - begin));
+                }
+                lineOpen = true;
+            }
+            const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (!newline) {
+                break;
+            }
+            ++rows;
+            lineOpen = false;
+            p = newline + 1;
+        }
+        offset += block.size();
+    }
+    if (lineOpen) {
+        ++rows;     // 最后一行没有换行符
+    }
+    totalRows = rows;
+
+    detectNumericColumns();
+    endResetModel();
+    return true;
+}
+
+void ResultTableModel::setRows(const QStringList &headers, const QList<QStringList> &rows)
+{
+    beginResetModel();
+    resetState();
+    columnHeaders = headers;
+    memoryRows = rows;
+    totalRows = rows.size();
+    inMemory = true;
+    detectNumericColumns();
+    endResetModel();
+}
+
+/******************************************************************************
+ * 数据源：球员摘要（data_output.json结构）
+ *
+ * 每名球员一行（与data_output.csv相同的列），之后是球队控球率摘要行。
+ * 数据量小，直接保存在内存中。
+ ******************************************************************************/
+void ResultTableModel::setSummary(const QJsonObject &root)
+{
+    const QStringList headers = QStringList() << "Team" << "Player ID" << "Distance (m)" << "Possession (%)";
+    QList<QStringList> rows;
+    
+    // 处理每个球队
+    for (const QString &key : root.keys()) {
+        if (key == "summary") {
+            continue;
+        }
+        
+        QJsonObject teamData = root[key].toObject();
+        for (const QString &playerId : teamData.keys()) {
+            QJsonObject playerData = teamData[playerId].toObject();
+            double distanceM = playerData["distance_m"].toDouble();
+            
+            QStringList row;
+            row << key << playerId
+                << (distanceM == 0 ? "Not Detected" : QString::number(distanceM, 'f', 2));
+            if (playerData.contains("possession_percent")) {
+                row << QString::number(playerData["possession_percent"].toDouble(), 'f', 2);
+            }
+            rows.append(row);
+        }
+    }
+    
+    // 添加摘要行
+    if (root.contains("summary")) {
+        QJsonObject summary = root["summary"].toObject();
+        
+        // 添加空行和摘要标题以分隔
+        rows.append(QStringList());
+        rows.append(QStringList() << "Summary - Team Possession Percentage");
+        
+        // 添加控球百分比
+        if (summary.contains("team_1_possession_percent")) {
+            rows.append(QStringList() << "Team 1 Possession" << QString()
+                << QString::number(summary["team_1_possession_percent"].toDouble(), 'f', 2) + "%");
+        }
+        
+        if (summary.contains("team_2_possession_percent")) {
+            rows.append(QStringList() << "Team 2 Possession" << QString()
+                << QString::number(summary["team_2_possession_percent"].toDouble(), 'f', 2) + "%");
+        }
+    }
+    
+    setRows(headers, rows);
+}
+
+void ResultTableModel::clear()
+{
+    beginResetModel();
+    resetState();
+    endResetModel();
+}
+
+void ResultTableModel::resetState()
+{
+    if (file.isOpen()) {
+        file.close();
+    }
+    columnHeaders.clear();
+    pageOffsets.clear();
+    totalRows = 0;
+    inMemory = false;
+    memoryRows.clear();
+    numericColumns.clear();
+    pageCache.clear();
+    pageLru.clear();
+}
+
+QString ResultTableModel::filePath() const
+{
+    return inMemory ? QString() : file.fileName();
+}
+
+QStringList ResultTableModel::headers() const
+{
+    return columnHeaders;
+}
+
+/******************************************************************************
+ * 数值列检测
+ *
+ * 第一页中所有非空值都是数字的列视为数值列（右对齐，按数值排序）。
+ ******************************************************************************/
+void ResultTableModel::detectNumericColumns()
+{
+    numericColumns = QVector<bool>(columnHeaders.size(), false);
+    if (totalRows == 0) {
+        return;
+    }
+    const QList<QStringList> &rows = inMemory ? memoryRows : page(0);
+    for (int column = 0; column < columnHeaders.size(); ++column) {
+        bool numeric = false;
+        for (const QStringList &row : rows) {
+            const QString value = row.value(column);
+            if (value.isEmpty()) {
+                continue;
+            }
+            if (std::isnan(toNumber(value))) {
+                numeric = false;
+                break;
+            }
+            numeric = true;
+        }
+        numericColumns[column] = numeric;
+    }
+}
+
+bool ResultTableModel::isNumericColumn(int column) const
+{
+    return numericColumns.value(column, false);
+}
+
+/******************************************************************************
+ * 整列数值
+ *
+ * 从头到尾顺序读取一次文件（不经过页缓存），供代理模型排序和过滤。
+ * 非数字或空单元格为NaN。
+ ******************************************************************************/
+QVector<double> ResultTableModel::columnValues(int column) const
+{
+    QVector<double> values;
+    values.reserve(totalRows);
+
+    if (inMemory) {
+        for (const QStringList &row : memoryRows) {
+            values.append(toNumber(row.value(column)));
+        }
+        return values;
+    }
+
+    if (pageOffsets.isEmpty() || !file.seek(pageOffsets.first())) {
+        return values;
+    }
+    for (int row = 0; row < totalRows; ++row) {
+        values.append(toNumber(splitLine(file.readLine()).value(column)));
+    }
+    return values;
+}
+
+/******************************************************************************
+ * 页缓存
+ *
+ * 最多保留kMaxCachedPages页；超出时丢弃最久未使用的页。
+ ******************************************************************************/
+const QList<QStringList> &ResultTableModel::page(int pageIndex) const
+{
+    auto cached = pageCache.find(pageIndex);
+    if (cached != pageCache.end()) {
+        if (pageLru.first() != pageIndex) {
+            pageLru.removeOne(pageIndex);
+            pageLru.prepend(pageIndex);
+        }
+        return cached.value();
+    }
+
+    if (pageCache.size() >= kMaxCachedPages) {
+        pageCache.remove(pageLru.takeLast());
+    }
+    pageLru.prepend(pageIndex);
+    return pageCache.insert(pageIndex, readPage(pageIndex)).value();
+}
+
+QList<QStringList> ResultTableModel::readPage(int pageIndex) const
+{
+    QList<QStringList> rows;
+    if (pageIndex < 0 || pageIndex >= pageOffsets.size() || !file.seek(pageOffsets.at(pageIndex))) {
+        return rows;
+    }
+    const int count = qMin(kRowsPerPage, totalRows - pageIndex * kRowsPerPage);
+    rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        rows.append(splitLine(file.readLine()));
+    }
+    return rows;
+}
+
+/******************************************************************************
+ * CSV解析
+ *
+ * 支持引号字段（Python csv模块在值中含逗号时使用）；去掉行尾的\r\n。
+ ******************************************************************************/
+QStringList ResultTableModel::splitLine(const QByteArray &line)
+{
+    QByteArray trimmed = line;
+    while (trimmed.endsWith('\n') || trimmed.endsWith('\r')) {
+        trimmed.chop(1);
+    }
+
+    QStringList fields;
+    if (!trimmed.contains('"')) {
+        for (const QByteArray &field : trimmed.split(',')) {
+            fields.append(QString::fromUtf8(field).trimmed());
+        }
+        return fields;
+    }
+
+    QByteArray field;
+    bool quoted = false;
+    for (int i = 0; i < trimmed.size(); ++i) {
+        const char c = trimmed.at(i);
+        if (quoted) {
+            if (c == '"' && i + 1 < trimmed.size() && trimmed.at(i + 1) == '"') {
+                field.append('"');
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field.append(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.append(QString::fromUtf8(field).trimmed());
+            field.clear();
+        } else {
+            field.append(c);
+        }
+    }
+    fields.append(QString::fromUtf8(field).trimmed());
+    return fields;
+}
+
+double ResultTableModel::toNumber(const QString &text)
+{
+    bool ok = false;
+    const double value = text.toDouble(&ok);
+    return ok ? value : std::numeric_limits<double>::quiet_NaN();
+}
+
+/******************************************************************************
+ * QAbstractTableModel接口
+ ******************************************************************************/
+int ResultTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : totalRows;
+}
+
+int ResultTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : columnHeaders.size();
+}
+
+QVariant ResultTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= totalRows) {
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return isNumericColumn(index.column())
+            ? int(Qt::AlignRight | Qt::AlignVCenter)
+            : int(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    if (inMemory) {
+        return memoryRows.at(index.row()).value(index.column());
+    }
+    const QList<QStringList> &rows = page(index.row() / kRowsPerPage);
+    return rows.value(index.row() % kRowsPerPage).value(index.column());
+}
+
+QVariant ResultTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Horizontal) {
+        return columnHeaders.value(section);
+    }
+    return section + 1;
+}
+
+/******************************************************************************
+ * 排序/过滤代理模型
+ ******************************************************************************/
+ResultFilterProxyModel::ResultFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , resultModel(nullptr)
+    , filterColumn(-1)
+    , sortKeyColumn(-1)
+    , filterKeyColumn(-1)
+{
+    setFilterCaseSensitivity(Qt::CaseInsensitive);
+}
+
+void ResultFilterProxyModel::setResultModel(ResultTableModel *model)
+{
+    if (resultModel) {
+        disconnect(resultModel, nullptr, this, nullptr);
+    }
+    resultModel = model;
+    dropKeys();
+    // 源模型重置时丢弃旧键（下次排序/过滤时重新读取）
+    connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &ResultFilterProxyModel::dropKeys);
+    setSourceModel(model);
+}
+
+void ResultFilterProxyModel::setFilter(int column, const QString &text)
+{
+    filterColumn = column;
+    filterText = text.trimmed();
+    // invalidate()只发出一次layoutChanged；invalidateFilter()对每段连续的
+    // 被过滤行各发出一次插入/删除信号，在数百万行上很慢
+    invalidate();
+}
+
+void ResultFilterProxyModel::dropKeys()
+{
+    sortKeys.clear();
+    sortKeyColumn = -1;
+    filterKeys.clear();
+    filterKeyColumn = -1;
+}
+
+/******************************************************************************
+ * 列键
+ *
+ * 数值列的键在第一次需要时顺序读取一次并缓存（每行8字节）。
+ ******************************************************************************/
+const QVector<double> &ResultFilterProxyModel::keys(int column, QVector<double> &cache,
+                                                     int &cacheColumn) const
+{
+    if (cacheColumn != column) {
+        cache = resultModel->columnValues(column);
+        cacheColumn = column;
+    }
+    return cache;
+}
+
+bool ResultFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const int column = left.column();
+    if (!resultModel || !resultModel->isNumericColumn(column)) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    const QVector<double> &values = keys(column, sortKeys, sortKeyColumn);
+    const double a = values.value(left.row(), std::numeric_limits<double>::quiet_NaN());
+    const double b = values.value(right.row(), std::numeric_limits<double>::quiet_NaN());
+    // 空单元格排在最后
+    if (std::isnan(a)) {
+        return false;
+    }
+    if (std::isnan(b)) {
+        return true;
+    }
+    return a < b;
+}
+
+bool ResultFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (filterText.isEmpty() || !resultModel) {
+        return true;
+    }
+
+    // 数值列 + 数字过滤文本：精确匹配
+    bool isNumber = false;
+    const double number = filterText.toDouble(&isNumber);
+    if (isNumber && filterColumn >= 0 && resultModel->isNumericColumn(filterColumn)) {
+        const QVector<double> &values = keys(filterColumn, filterKeys, filterKeyColumn);
+        return values.value(sourceRow) == number;
+    }
+
+    const int first = filterColumn >= 0 ? filterColumn : 0;
+    const int last = filterColumn >= 0 ? filterColumn : resultModel->columnCount() - 1;
+    for (int column = first; column <= last; ++column) {
+        const QString value = resultModel->index(sourceRow, column, sourceParent).data().toString();
+        if (value.contains(filterText, filterCaseSensitivity())) {
+            return true;
+        }
+    }
+    return false;
+}
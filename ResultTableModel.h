@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * RESULT TABLE MODEL HEADER
+ *
+ * This header defines the models behind the Data Table tab:
+ * - ResultTableModel: read-only table model over a CSV result file
+ * - ResultFilterProxyModel: sorting and filtering proxy on top of it
+ *
+ * WHY NOT QTableWidget:
+ * A QTableWidget keeps one heap-allocated QTableWidgetItem per cell. The
+ * per-frame output (frame_data.csv: one row per player per frame) has
+ * millions of rows for a full match, far too many to hold as items.
+ *
+ * PAGING:
+ * openCsv() scans the file once and remembers the file offset of every
+ * kRowsPerPage-th row (8 bytes per page). Rows are parsed only when the
+ * view asks for them, one page at a time, and at most kMaxCachedPages pages
+ * are kept (least recently used pages are dropped), so memory stays the
+ * same however large the file is and scrolling only touches visible pages.
+ *
+ * SORTING AND FILTERING:
+ * QSortFilterProxyModel would read every cell of the sort column in random
+ * order through data(). ResultFilterProxyModel instead reads a numeric
+ * column once, front to back (columnValues()), and sorts and filters on
+ * those keys. The proxy itself needs one index per row while sorted or
+ * filtered; the row data stays on disk.
+ *
+ * Small tables can be set directly with setRows(); setSummary() builds the
+ * player summary table from data_output.json-shaped data (the JSON fallback
+ * and the partial result snapshots).
+ ******************************************************************************/
+
+#ifndef RESULTTABLEMODEL_H
+#define RESULTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @class ResultTableModel
+ * @brief Read-only table model paging rows of a CSV file from disk
+ */
+class ResultTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kRowsPerPage = 512;        // Rows parsed per disk read
+    static constexpr int kMaxCachedPages = 64;      // Pages kept in memory (32k rows)
+
+    explicit ResultTableModel(QObject *parent = nullptr);
+
+    // ===== DATA SOURCES =====
+    bool openCsv(const QString &csvPath);           // Index a CSV file; rows are read on demand
+    void setRows(const QStringList &headers,        // Small table held in memory
+                 const QList<QStringList> &rows);
+    void setSummary(const QJsonObject &root);       // data_output.json: team → player → stats
+    void clear();
+
+    QString filePath() const;                       // Open CSV file (empty for setRows tables)
+    QStringList headers() const;
+    bool isNumericColumn(int column) const;         // Every value of the first page is a number
+    QVector<double> columnValues(int column) const; // Whole column as numbers (NaN if not a number)
+
+    // ===== QAbstractTableModel =====
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    void resetState();
+    void detectNumericColumns();
+    const QList<QStringList> &page(int pageIndex) const;    // Cached page, loaded if needed
+    QList<QStringList> readPage(int pageIndex) const;
+    static QStringList splitLine(const QByteArray &line);
+    static double toNumber(const QString &text);
+
+    mutable QFile file;                             // Open CSV file
+    QStringList columnHeaders;
+    QVector<qint64> pageOffsets;                    // File offset of the first row of every page
+    int totalRows;
+    bool inMemory;                                  // Rows come from setRows()
+    QList<QStringList> memoryRows;
+    QVector<bool> numericColumns;
+
+    mutable QHash<int, QList<QStringList>> pageCache;   // Page index → parsed rows
+    mutable QList<int> pageLru;                         // Cached pages, most recently used first
+};
+
+/**
+ * @class ResultFilterProxyModel
+ * @brief Sorts and filters a ResultTableModel using column keys read in one pass
+ *
+ * Filter text that is a number matches a numeric column exactly (e.g. player
+ * ID 7 does not match 17); any other text matches cells containing it.
+ */
+class ResultFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ResultFilterProxyModel(QObject *parent = nullptr);
+
+    void setResultModel(ResultTableModel *model);
+    void setFilter(int column, const QString &text);    // column -1 = all columns
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    const QVector<double> &keys(int column, QVector<double> &cache, int &cacheColumn) const;
+    void dropKeys();
+
+    ResultTableModel *resultModel;
+    int filterColumn;
+    QString filterText;
+
+    mutable QVector<double> sortKeys;               // Numeric keys of the sort column
+    mutable int sortKeyColumn;
+    mutable QVector<double> filterKeys;             // Numeric keys of the filter column
+    mutable int filterKeyColumn;
+};
+
+#endif // RESULTTABLEMODEL_H
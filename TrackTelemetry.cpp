@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * 追踪遥测文件读取实现
+ *
+ * 映射tracks.ftrk并检查文件头和列目录（格式见
+ * foot-Function/track_store/telemetry.py）。所有值为小端序，
+ * 与GUI支持的平台（x86-64、ARM64）的字节序相同，因此列可以直接使用。
+ ******************************************************************************/
+
+#include "TrackTelemetry.h"
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+// 文件格式常量（与telemetry.py一致）
+static const char kMagic[8] = {'F', 'O', 'O', 'T', 'T', 'R', 'K', '\0'};
+static const int kFormatVersion = 1;
+static const qint64 kFixedHeaderSize = 64;
+static const qint64 kDirectoryEntrySize = 32;
+
+/******************************************************************************
+ * 构造函数和析构函数
+ ******************************************************************************/
+TrackTelemetry::TrackTelemetry()
+    : mapped(nullptr)
+    , rows(0)
+    , frames(0)
+    , frameRate(0.0)
+{
+}
+
+TrackTelemetry::~TrackTelemetry()
+{
+    close();
+}
+
+/******************************************************************************
+ * 打开文件
+ *
+ * 检查：
+ * - 魔数和格式版本
+ * - 列目录在文件头范围内
+ * - 每列的数据都在文件范围内（截断的文件被拒绝）
+ * 最后从frame列建立每帧第一行的索引。
+ ******************************************************************************/
+bool TrackTelemetry::open(const QString &path)
+{
+    close();
+    error.clear();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("Cannot open %1: %2").arg(path, file.errorString()));
+    }
+    const qint64 size = file.size();
+    if (size < kFixedHeaderSize) {
+        return fail(QString("Not a track telemetry file: %1").arg(path));
+    }
+    mapped = file.map(0, size);
+    if (!mapped) {
+        return fail(QString("Cannot map %1: %2").arg(path, file.errorString()));
+    }
+
+    // 固定文件头
+    if (std::memcmp(mapped, kMagic, sizeof(kMagic)) != 0) {
+        return fail(QString("Not a track telemetry file: %1").arg(path));
+    }
+    const int version = qFromLittleEndian<quint16>(mapped + 8);
+    if (version != kFormatVersion) {
+        return fail(QString("Unsupported track telemetry version %1: %2").arg(version).arg(path));
+    }
+    const int columnCount = qFromLittleEndian<quint16>(mapped + 10);
+    const qint64 headerSize = qFromLittleEndian<quint32>(mapped + 12);
+    rows = qint64(qFromLittleEndian<quint64>(mapped + 16));
+    frames = int(qFromLittleEndian<quint32>(mapped + 24));
+    frameRate = qFromLittleEndian<float>(mapped + 28);
+    for (int team = 0; team < 2; ++team) {
+        const uchar *color = mapped + 32 + team * 12;
+        const float b = qFromLittleEndian<float>(color);
+        const float g = qFromLittleEndian<float>(color + 4);
+        const float r = qFromLittleEndian<float>(color + 8);
+        if (!std::isnan(b)) {
+            teamColors[team] = QColor(qBound(0, int(r), 255), qBound(0, int(g), 255),
+                                      qBound(0, int(b), 255));
+        }
+    }
+
+    if (headerSize > size || kFixedHeaderSize + columnCount * kDirectoryEntrySize > headerSize) {
+        return fail(QString("Truncated track telemetry file: %1").arg(path));
+    }
+
+    // 列目录
+    for (int i = 0; i < columnCount; ++i) {
+        const uchar *entry = mapped + kFixedHeaderSize + i * kDirectoryEntrySize;
+        const QString name = QString::fromLatin1(
+            reinterpret_cast<const char *>(entry), int(qstrnlen(reinterpret_cast<const char *>(entry), 16)));
+        Column info;
+        info.type = QByteArray(reinterpret_cast<const char *>(entry + 16),
+                               int(qstrnlen(reinterpret_cast<const char *>(entry + 16), 4)));
+        info.components = int(qFromLittleEndian<quint32>(entry + 20));
+        info.offset = qint64(qFromLittleEndian<quint64>(entry + 24));
+
+        const int itemSize = info.type.right(1).toInt();
+        if (itemSize <= 0 || info.offset + rows * info.components * itemSize > size) {
+            return fail(QString("Truncated track telemetry file: %1 (column %2)").arg(path, name));
+        }
+        columns.insert(name, info);
+    }
+
+    // 每帧的行范围（行按帧排序）
+    const qint32 *frameColumn = column<qint32>("frame");
+    if (!frameColumn) {
+        return fail(QString("Track telemetry file has no frame column: %1").arg(path));
+    }
+    frameOffsets.resize(frames + 1);
+    qint64 row = 0;
+    for (int frame = 0; frame <= frames; ++frame) {
+        while (row < rows && frameColumn[row] < frame) {
+            ++row;
+        }
+        frameOffsets[frame] = row;
+    }
+    frameOffsets[frames] = rows;
+    return true;
+}
+
+void TrackTelemetry::close()
+{
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    rows = 0;
+    frames = 0;
+    frameRate = 0.0;
+    teamColors[0] = QColor();
+    teamColors[1] = QColor();
+    columns.clear();
+    frameOffsets.clear();
+}
+
+bool TrackTelemetry::fail(const QString &message)
+{
+    close();
+    error = message;
+    return false;
+}
+
+/******************************************************************************
+ * 访问器
+ ******************************************************************************/
+bool TrackTelemetry::isOpen() const
+{
+    return mapped != nullptr;
+}
+
+QString TrackTelemetry::errorString() const
+{
+    return error;
+}
+
+qint64 TrackTelemetry::rowCount() const
+{
+    return rows;
+}
+
+int TrackTelemetry::frameCount() const
+{
+    return frames;
+}
+
+double TrackTelemetry::fps() const
+{
+    return frameRate;
+}
+
+QColor TrackTelemetry::teamColor(int team) const
+{
+    return (team == 1 || team == 2) ? teamColors[team - 1] : QColor();
+}
+
+bool TrackTelemetry::hasColumn(const QString &name) const
+{
+    return columns.contains(name);
+}
+
+int TrackTelemetry::components(const QString &name) const
+{
+    return columns.value(name).components;
+}
+
+QPair<qint64, qint64> TrackTelemetry::frameRows(int frame) const
+{
+    if (frame < 0 || frame >= frames) {
+        return qMakePair(qint64(0), qint64(0));
+    }
+    return qMakePair(frameOffsets.at(frame), frameOffsets.at(frame + 1));
+}
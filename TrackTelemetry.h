@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * TRACK TELEMETRY HEADER
+ *
+ * Read-only access to the binary track telemetry file (tracks.ftrk) written
+ * by the analysis pipeline: every tracked object in every frame, stored as
+ * columns (frame, track id, class, team, possession, bounding box, positions,
+ * speed, distance).
+ *
+ * The file layout is documented in foot-Function/track_store/telemetry.py.
+ * open() maps the file with QFile::map and validates the header and column
+ * directory; column() then returns pointers straight into the mapping, so
+ * nothing is parsed or copied and only the pages that are touched are read.
+ *
+ * USAGE:
+ *     TrackTelemetry telemetry;
+ *     if (telemetry.open(path)) {
+ *         const float *speed = telemetry.column<float>("speed");
+ *         const auto rows = telemetry.frameRows(100);  // [first, last)
+ *     }
+ ******************************************************************************/
+
+#ifndef TRACKTELEMETRY_H
+#define TRACKTELEMETRY_H
+
+#include <QColor>
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class TrackTelemetry
+ * @brief Memory-mapped columns of a tracks.ftrk file
+ */
+class TrackTelemetry
+{
+public:
+    // Object classes (values of the "cls" column)
+    enum ObjectClass { Player = 0, Referee = 1, Ball = 2 };
+
+    TrackTelemetry();
+    ~TrackTelemetry();
+
+    bool open(const QString &path);     // Map and validate; see errorString() on failure
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    qint64 rowCount() const;
+    int frameCount() const;             // Frames in the video (frames may have no rows)
+    double fps() const;                 // 0 when unknown
+    QColor teamColor(int team) const;   // Invalid when the team was not assigned
+
+    bool hasColumn(const QString &name) const;
+    int components(const QString &name) const;     // Values per row (bbox: 4)
+
+    // Rows of one frame as [first, last); rows are sorted by frame
+    QPair<qint64, qint64> frameRows(int frame) const;
+
+    /**
+     * Pointer to the first value of a column, or nullptr when the column is
+     * missing or its stored type is not T (qint32, qint8, quint8 or float).
+     * Row r of a column with n components starts at index r * n.
+     */
+    template <typename T>
+    const T *column(const QString &name) const
+    {
+        const auto it = columns.constFind(name);
+        if (it == columns.constEnd() || it->type != typeCode<T>()) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T *>(mapped + it->offset);
+    }
+
+private:
+    struct Column {
+        QByteArray type;                // numpy dtype string, e.g. "<f4"
+        int components = 0;
+        qint64 offset = 0;
+    };
+
+    template <typename T> static QByteArray typeCode();
+    bool fail(const QString &message);
+
+    QFile file;
+    uchar *mapped;
+    QString error;
+    qint64 rows;
+    int frames;
+    double frameRate;
+    QColor teamColors[2];
+    QHash<QString, Column> columns;
+    QVector<qint64> frameOffsets;       // First row of every frame, plus the row count
+};
+
+template <> inline QByteArray TrackTelemetry::typeCode<qint32>() { return "<i4"; }
+template <> inline QByteArray TrackTelemetry::typeCode<qint8>() { return "|i1"; }
+template <> inline QByteArray TrackTelemetry::typeCode<quint8>() { return "|u1"; }
+template <> inline QByteArray TrackTelemetry::typeCode<float>() { return "<f4"; }
+
+#endif // TRACKTELEMETRY_H
@@ -0,0 +1,280 @@
+/*******************************************************************************
+ * 结果加载基准测试
+ *
+ * 在大型合成结果文件上测量数据表选项卡的加载路径，使用与GUI相同的
+ * ResultTableModel / ResultFilterProxyModel：
+ *
+ * - loadAndDisplayCSV：frame_data.csv结构的文件（--rows行）
+ *   - csv_index：openCsv()（扫描文件，建立页偏移索引）
+ *   - csv_resize_columns：resizeColumnsToContents()（解析第一页）
+ *   - csv_load_and_display：以上两步之和，即MainWindow中的完整路径
+ *   - csv_scroll：在整个文件上均匀访问kScrollPages页（超过页缓存，每页都要从磁盘解析）
+ *   - csv_sort：按Speed列排序（按顺序读取整列作为键）
+ * - loadAndDisplayJSON：data_output.json结构的文件（每队--players名球员）
+ *   - json_read_parse：读取文件并用QJsonDocument解析
+ *   - json_set_summary：ResultTableModel::setSummary()（转换为行）
+ *   - json_resize_columns：resizeColumnsToContents()
+ *   - json_load_and_display：以上三步之和
+ *
+ * 每项先运行一次预热（文件进入系统缓存），再重复--repeat次，报告最小值
+ * 和中位数（毫秒）。JSON报告输出到stdout，可选写入--output。
+ *
+ * 用法：
+ *   qmake benchmarks/ResultLoadingBenchmark.pro && make
+ *   QT_QPA_PLATFORM=offscreen ./ResultLoadingBenchmark --rows 2000000 --players 5000
+ ******************************************************************************/
+
+#include "ResultTableModel.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTableView>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+
+// csv_scroll访问的页数（大于ResultTableModel::kMaxCachedPages）
+static const int kScrollPages = 256;
+
+/******************************************************************************
+ * 合成数据
+ *
+ * 固定随机种子，每次运行生成相同的文件。
+ ******************************************************************************/
+static bool writeFrameData(const QString &path, qint64 rows)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    // 每帧22名球员（与frame_data.csv相同：每帧每名球员一行）
+    const int playersPerFrame = 22;
+    QRandomGenerator random(42);
+    QByteArray chunk;
+    chunk.reserve(1 << 20);
+    chunk += "Frame,Player ID,Team,Speed (km/h),Distance (m),Has Ball\n";
+    for (qint64 row = 0; row < rows; ++row) {
+        const qint64 frame = row / playersPerFrame;
+        const int player = int(row % playersPerFrame) + 1;
+        const bool measured = frame >= 5;
+        chunk += QByteArray::number(frame) + ','
+               + QByteArray::number(player) + ','
+               + QByteArray::number(player % 2 + 1) + ','
+               + (measured ? QByteArray::number(random.bounded(35.0), 'f', 2) : QByteArray()) + ','
+               + (measured ? QByteArray::number(frame * 0.3, 'f', 2) : QByteArray()) + ','
+               + (random.bounded(playersPerFrame) == 0 ? '1' : '0') + '\n';
+        if (chunk.size() >= (1 << 20)) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+    return file.error() == QFile::NoError;
+}
+
+static bool writeSummary(const QString &path, int playersPerTeam)
+{
+    QRandomGenerator random(7);
+    QJsonObject root;
+    for (int team = 1; team <= 2; ++team) {
+        QJsonObject players;
+        for (int i = 0; i < playersPerTeam; ++i) {
+            const double distanceM = random.bounded(12000.0);
+            QJsonObject player;
+            player["distance_km"] = distanceM / 1000;
+            player["distance_m"] = distanceM;
+            player["possession_frames"] = random.bounded(2000);
+            player["possession_percent"] = random.bounded(10.0);
+            players[QString::number(team * 1000000 + i)] = player;
+        }
+        root[QString("team_%1").arg(team)] = players;
+    }
+    QJsonObject summary;
+    summary["team_1_possession_percent"] = 52.4;
+    summary["team_2_possession_percent"] = 47.6;
+    root["summary"] = summary;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return file.error() == QFile::NoError;
+}
+
+/******************************************************************************
+ * 计时
+ *
+ * setup不计时（例如重新打开文件，使页缓存为空）。
+ ******************************************************************************/
+static QJsonObject measure(int repeat, const std::function<void()> &setup,
+                           const std::function<void()> &run)
+{
+    QVector<double> samples;
+    for (int i = 0; i <= repeat; ++i) {
+        setup();
+        QElapsedTimer timer;
+        timer.start();
+        run();
+        const double ms = timer.nsecsElapsed() / 1e6;
+        if (i > 0) {    // 第一次为预热
+            samples.append(ms);
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+
+    QJsonObject result;
+    result["min_ms"] = samples.isEmpty() ? 0.0 : samples.first();
+    result["median_ms"] = samples.isEmpty() ? 0.0 : samples.at(samples.size() / 2);
+    return result;
+}
+
+static QJsonObject sum(const QList<QJsonObject> &parts)
+{
+    double minMs = 0;
+    double medianMs = 0;
+    for (const QJsonObject &part : parts) {
+        minMs += part["min_ms"].toDouble();
+        medianMs += part["median_ms"].toDouble();
+    }
+    QJsonObject result;
+    result["min_ms"] = minMs;
+    result["median_ms"] = medianMs;
+    return result;
+}
+
+/******************************************************************************
+ * CSV（loadAndDisplayCSV）
+ ******************************************************************************/
+static QJsonObject benchmarkCsv(const QString &path, int repeat)
+{
+    ResultTableModel model;
+    QTableView view;
+    view.setModel(&model);
+    view.horizontalHeader()->setResizeContentsPrecision(ResultTableModel::kRowsPerPage);
+
+    const auto reopen = [&] { model.openCsv(path); };
+    const auto nothing = [] {};
+
+    QJsonObject results;
+    const QJsonObject index = measure(repeat, nothing, reopen);
+    const QJsonObject resize = measure(repeat, reopen, [&] { view.resizeColumnsToContents(); });
+    results["csv_index"] = index;
+    results["csv_resize_columns"] = resize;
+    results["csv_load_and_display"] = sum({index, resize});
+
+    results["csv_scroll"] = measure(repeat, reopen, [&] {
+        const int rows = model.rowCount();
+        for (int i = 0; i < kScrollPages && rows > 0; ++i) {
+            const int row = int(qint64(rows - 1) * i / qMax(1, kScrollPages - 1));
+            model.data(model.index(row, 0));
+        }
+    });
+
+    ResultFilterProxyModel proxy;
+    proxy.setResultModel(&model);
+    results["csv_sort"] = measure(repeat, [&] {
+        reopen();
+        proxy.sort(-1);
+    }, [&] { proxy.sort(3); });
+
+    results["rows"] = model.rowCount();
+    results["file_bytes"] = QFileInfo(path).size();
+    return results;
+}
+
+/******************************************************************************
+ * JSON（loadAndDisplayJSON）
+ ******************************************************************************/
+static QJsonObject benchmarkJson(const QString &path, int repeat)
+{
+    ResultTableModel model;
+    QTableView view;
+    view.setModel(&model);
+    view.horizontalHeader()->setResizeContentsPrecision(ResultTableModel::kRowsPerPage);
+
+    QJsonObject root;
+    const auto readParse = [&] {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            root = QJsonDocument::fromJson(file.readAll()).object();
+        }
+    };
+    const auto nothing = [] {};
+
+    QJsonObject results;
+    const QJsonObject parse = measure(repeat, nothing, readParse);
+    const QJsonObject summary = measure(repeat, nothing, [&] { model.setSummary(root); });
+    const QJsonObject resize = measure(repeat, [&] { model.setSummary(root); },
+                                       [&] { view.resizeColumnsToContents(); });
+    results["json_read_parse"] = parse;
+    results["json_set_summary"] = summary;
+    results["json_resize_columns"] = resize;
+    results["json_load_and_display"] = sum({parse, summary, resize});
+
+    results["rows"] = model.rowCount();
+    results["file_bytes"] = QFileInfo(path).size();
+    return results;
+}
+
+/******************************************************************************
+ * 主函数
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ResultLoadingBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark the Data Table loading paths on synthetic result files");
+    parser.addHelpOption();
+    const QCommandLineOption rowsOption("rows", "Rows of the synthetic frame_data.csv (default 1000000)", "n", "1000000");
+    const QCommandLineOption playersOption("players", "Players per team in the synthetic data_output.json (default 2000)", "n", "2000");
+    const QCommandLineOption repeatOption("repeat", "Timed runs per measurement after one warm-up (default 5)", "n", "5");
+    const QCommandLineOption dirOption("dir", "Directory for the synthetic files (default: temporary)", "path");
+    const QCommandLineOption outputOption("output", "Also write the JSON report to this file", "path");
+    parser.addOptions({rowsOption, playersOption, repeatOption, dirOption, outputOption});
+    parser.process(app);
+
+    const qint64 rows = qMax<qint64>(0, parser.value(rowsOption).toLongLong());
+    const int players = qMax(0, parser.value(playersOption).toInt());
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    QTemporaryDir temporaryDir;
+    const QString dir = parser.isSet(dirOption) ? parser.value(dirOption) : temporaryDir.path();
+    const QString csvPath = dir + "/frame_data.csv";
+    const QString jsonPath = dir + "/data_output.json";
+
+    QTextStream err(stderr);
+    err << "Writing synthetic files to " << dir << "..." << Qt::endl;
+    if (!writeFrameData(csvPath, rows) || !writeSummary(jsonPath, players)) {
+        err << "Failed to write the synthetic files" << Qt::endl;
+        return 1;
+    }
+
+    QJsonObject report;
+    report["repeat"] = repeat;
+    err << "Benchmarking CSV loading..." << Qt::endl;
+    report["csv"] = benchmarkCsv(csvPath, repeat);
+    err << "Benchmarking JSON loading..." << Qt::endl;
+    report["json"] = benchmarkJson(jsonPath, repeat);
+
+    const QByteArray text = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    QTextStream(stdout) << text;
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || output.write(text) < 0) {
+            err << "Failed to write " << parser.value(outputOption) << Qt::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+# Result loading benchmark (not part of the application build)
+#
+# Times the Data Table loading paths of MainWindow (loadAndDisplayCSV and
+# loadAndDisplayJSON) on large synthetic result files, using the same
+# ResultTableModel as the GUI. See ResultLoadingBenchmark.cpp for the
+# measurements.
+#
+# Build and run:
+#   qmake benchmarks/ResultLoadingBenchmark.pro && make
+#   QT_QPA_PLATFORM=offscreen ./ResultLoadingBenchmark --rows 2000000 --output result_loading.json
+
+QT += core gui widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ResultLoadingBenchmark
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ResultLoadingBenchmark.cpp \
+    ../ResultTableModel.cpp
+
+HEADERS += \
+    ../ResultTableModel.h
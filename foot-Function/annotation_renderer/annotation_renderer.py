@@ -0,0 +1,253 @@
+"""
+===============================================================================
+FUSED ANNOTATION RENDERER
+===============================================================================
+
+This module draws every annotation of the output video in a single pass
+per frame, directly from the TrackStore columns.
+
+RENDERING:
+- One pass, frames are annotated in place (no copies)
+- The semi-transparent boxes are blended only inside their rectangles
+- Possession percentages come from PossessionStats (O(1) per frame)
+- Frames are spread over a thread pool; OpenCV releases the GIL while
+  drawing, so several frames are annotated at the same time
+
+The annotations match Tracker.draw_annotations,
+CameraMovementEstimator.draw_camera_movement and
+SpeedAndDistance_Estimator.draw_speed_and_distance:
+- Players: ellipse at the feet in the team color with the track ID,
+  red triangle above the player with the ball
+- Referees: yellow ellipse
+- Ball: green triangle
+- Speed (km/h) and distance (m) below each player
+- Camera movement box (top left), team ball control box (bottom right)
+
+USAGE:
+    renderer = AnnotationRenderer(store, possession, camera_movement)
+    renderer.render_frames(frames)             # list, annotated in place
+    for frame in renderer.render_stream(decoder):
+        writer.write(frame)                    # streaming, frame order kept
+===============================================================================
+"""
+
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+
+import cv2
+import numpy as np
+import sys
+sys.path.append('../')
+from track_store import PLAYER, REFEREE, BALL
+
+
+# Colors (BGR)
+DEFAULT_PLAYER_COLOR = (0, 0, 255)
+REFEREE_COLOR = (0, 255, 255)
+BALL_COLOR = (0, 255, 0)
+POSSESSION_COLOR = (0, 0, 255)
+TEXT_COLOR = (0, 0, 0)
+
+# Semi-transparent overlay boxes: (x1, y1, x2, y2), opacity of the white box
+CAMERA_BOX = ((0, 0, 500, 100), 0.6)
+BALL_CONTROL_BOX = ((1350, 850, 1900, 970), 0.4)
+
+
+################################################################################
+# ANNOTATION RENDERER CLASS
+################################################################################
+
+class AnnotationRenderer:
+    """
+    Draws tracks, possession, camera movement and speed labels in one pass.
+    """
+
+    def __init__(self, store, possession, camera_movement, workers=0):
+        """
+        Args:
+            store: TrackStore with teams, possession, speed and distance
+            possession: PossessionStats of the video
+            camera_movement: [dx, dy] camera movement per frame
+            workers: Rendering threads (0 = OpenCV's thread count, which
+                     follows the worker's thread budget)
+        """
+        self.store = store
+        self.possession = possession
+        self.camera_movement = camera_movement
+        self.workers = workers if workers > 0 else max(cv2.getNumThreads(), 1)
+
+        self.team_colors = {team: tuple(float(c) for c in color)
+                            for team, color in store.team_colors.items()}
+
+    # =========================================================================
+    # RENDERING
+    # =========================================================================
+
+    def render_frames(self, frames, progress=None):
+        """
+        Annotate a list of frames in place on the thread pool.
+
+        Args:
+            frames: List of video frames (modified in place)
+            progress: Optional callable receiving the number of frames completed
+
+        Returns:
+            The same list of frames
+        """
+        frame_count = min(len(frames), self.store.frame_count)
+        with ThreadPoolExecutor(max_workers=self.workers) as pool:
+            for _ in pool.map(lambda frame_num: self.draw_frame(frames[frame_num], frame_num),
+                              range(frame_count)):
+                if progress is not None:
+                    progress(1)
+        return frames
+
+    def render_stream(self, frames):
+        """
+        Annotate frames from an iterable, yielding them in order.
+
+        At most two frames per worker are in flight, so memory stays
+        bounded for streaming decoders.
+
+        Args:
+            frames: Iterable of video frames (annotated in place)
+
+        Yields:
+            Annotated frames in frame order
+        """
+        pending = deque()
+        with ThreadPoolExecutor(max_workers=self.workers) as pool:
+            for frame_num, frame in enumerate(frames):
+                if frame_num >= self.store.frame_count:
+                    break
+                pending.append(pool.submit(self.draw_frame, frame, frame_num))
+                if len(pending) >= 2 * self.workers:
+                    yield pending.popleft().result()
+            while pending:
+                yield pending.popleft().result()
+
+    def draw_frame(self, frame, frame_num):
+        """
+        Draw every annotation of one frame in place.
+
+        Args:
+            frame: Video frame (modified in place)
+            frame_num: Index of the frame in the video
+
+        Returns:
+            The annotated frame
+        """
+        store = self.store
+        rows = store.frame_slice(frame_num)
+        cls = store.cls[rows]
+        bbox = store.bbox[rows].tolist()
+        track_id = store.track_id[rows].tolist()
+        team = store.team[rows].tolist()
+        has_ball = store.has_ball[rows].tolist()
+        speed = store.speed[rows].tolist()
+        distance = store.distance[rows].tolist()
+
+        players = np.flatnonzero(cls == PLAYER).tolist()
+
+        # Players
+        for i in players:
+            color = self.team_colors.get(team[i], DEFAULT_PLAYER_COLOR)
+            self._draw_ellipse(frame, bbox[i], color, track_id[i])
+            if has_ball[i]:
+                self._draw_triangle(frame, bbox[i], POSSESSION_COLOR)
+
+        # Referees
+        for i in np.flatnonzero(cls == REFEREE).tolist():
+            self._draw_ellipse(frame, bbox[i], REFEREE_COLOR)
+
+        # Ball
+        for i in np.flatnonzero(cls == BALL).tolist():
+            self._draw_triangle(frame, bbox[i], BALL_COLOR)
+
+        self._draw_ball_control(frame, frame_num)
+        self._draw_camera_movement(frame, self.camera_movement[frame_num])
+
+        # Speed and distance (NaN speed: not measured)
+        for i in players:
+            if speed[i] != speed[i]:
+                continue
+            x = int((bbox[i][0] + bbox[i][2]) / 2)
+            y = int(bbox[i][3]) + 40
+            cv2.putText(frame, f"{speed[i]:.2f} km/h", (x, y), cv2.FONT_HERSHEY_SIMPLEX, 0.5, TEXT_COLOR, 2)
+            cv2.putText(frame, f"{distance[i]:.2f} m", (x, y + 20), cv2.FONT_HERSHEY_SIMPLEX, 0.5, TEXT_COLOR, 2)
+
+        return frame
+
+    # =========================================================================
+    # SHAPES
+    # =========================================================================
+
+    @staticmethod
+    def _draw_ellipse(frame, bbox, color, track_id=None):
+        """Ground ellipse at the feet with an optional track ID label."""
+        y2 = int(bbox[3])
+        x_center = int((bbox[0] + bbox[2]) / 2)
+        width = bbox[2] - bbox[0]
+
+        cv2.ellipse(frame, center=(x_center, y2), axes=(int(width), int(0.35 * width)),
+                    angle=0.0, startAngle=-45, endAngle=235, color=color,
+                    thickness=2, lineType=cv2.LINE_4)
+
+        if track_id is None:
+            return
+
+        x1_rect, x2_rect = x_center - 20, x_center + 20
+        y1_rect, y2_rect = y2 + 5, y2 + 25
+        cv2.rectangle(frame, (x1_rect, y1_rect), (x2_rect, y2_rect), color, cv2.FILLED)
+
+        x1_text = x1_rect + 12
+        if track_id > 99:
+            x1_text -= 10
+        cv2.putText(frame, f"{track_id}", (x1_text, y1_rect + 15),
+                    cv2.FONT_HERSHEY_SIMPLEX, 0.6, TEXT_COLOR, 2)
+
+    @staticmethod
+    def _draw_triangle(frame, bbox, color):
+        """Downward triangle above a bounding box."""
+        y = int(bbox[1])
+        x = int((bbox[0] + bbox[2]) / 2)
+        triangle_points = np.array([[x, y], [x - 10, y - 20], [x + 10, y - 20]])
+        cv2.drawContours(frame, [triangle_points], 0, color, cv2.FILLED)
+        cv2.drawContours(frame, [triangle_points], 0, (0, 0, 0), 2)
+
+    @staticmethod
+    def _blend_box(frame, box):
+        """
+        Blend a white box into the frame, touching only its pixels.
+
+        The corners are inclusive, like a filled cv2.rectangle.
+        """
+        (x1, y1, x2, y2), alpha = box
+        height, width = frame.shape[:2]
+        roi = frame[max(y1, 0):min(y2 + 1, height), max(x1, 0):min(x2 + 1, width)]
+        if roi.size:
+            roi[:] = cv2.addWeighted(roi, 1 - alpha, roi, 0, 255 * alpha)
+
+    # =========================================================================
+    # OVERLAYS
+    # =========================================================================
+
+    def _draw_ball_control(self, frame, frame_num):
+        """Team ball control percentages up to this frame."""
+        self._blend_box(frame, BALL_CONTROL_BOX)
+
+        percentages = self.possession.team_percentages(frame_num)
+        cv2.putText(frame, f"Team 1 Ball Control: {percentages[1]:.2f}%", (1400, 900),
+                    cv2.FONT_HERSHEY_SIMPLEX, 1, TEXT_COLOR, 3)
+        cv2.putText(frame, f"Team 2 Ball Control: {percentages[2]:.2f}%", (1400, 950),
+                    cv2.FONT_HERSHEY_SIMPLEX, 1, TEXT_COLOR, 3)
+
+    def _draw_camera_movement(self, frame, camera_movement):
+        """Camera movement of this frame."""
+        self._blend_box(frame, CAMERA_BOX)
+
+        x_movement, y_movement = camera_movement
+        cv2.putText(frame, f"Camera Movement X: {x_movement:.2f}", (10, 30),
+                    cv2.FONT_HERSHEY_SIMPLEX, 1, TEXT_COLOR, 3)
+        cv2.putText(frame, f"Camera Movement Y: {y_movement:.2f}", (10, 60),
+                    cv2.FONT_HERSHEY_SIMPLEX, 1, TEXT_COLOR, 3)
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+===============================================================================
+DETECTION BACKEND BENCHMARK
+===============================================================================
+
+Compares the ultralytics (PyTorch) detection path with the ONNX Runtime CPU
+backend, FP32 and INT8, on the first frames of a video.
+
+MEASURED PER BACKEND:
+- Model load time (includes the one-time ONNX export/quantization when the
+  exported files do not exist yet; run twice to see the warm load time)
+- Detection throughput in frames per second, decoding included, after one
+  warm-up batch
+- Agreement with the ultralytics detections: a detection matches when a
+  detection of the same class overlaps it with IoU >= 0.5; precision and
+  recall are reported per class
+
+USAGE:
+    cd foot-Function
+    python benchmarks/detection_backends.py --input input_videos/match.mp4 \\
+        --model models/best.pt --frames 300 --output benchmark.json
+
+The JSON report is printed to stdout and optionally written to --output.
+===============================================================================
+"""
+
+import os
+import sys
+import json
+import time
+import argparse
+import platform
+from itertools import islice
+
+import cv2
+import numpy as np
+import supervision as sv
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from utils import iter_video
+from trackers import Tracker
+from trackers.onnx_detector import OnnxDetection
+
+# Backend configurations: name -> Tracker arguments
+CONFIGURATIONS = {
+    'ultralytics': {'backend': 'ultralytics', 'int8': False},
+    'onnx': {'backend': 'onnx', 'int8': False},
+    'onnx-int8': {'backend': 'onnx', 'int8': True},
+}
+MATCH_IOU = 0.5
+
+
+def _to_supervision(detection):
+    if isinstance(detection, OnnxDetection):
+        return detection.detections
+    return sv.Detections.from_ultralytics(detection)
+
+
+def run_backend(name, model_path, video_path, frame_limit, batch_size):
+    """
+    Load one backend and detect objects on the first frames of the video.
+
+    Returns:
+        (report dict, per-frame sv.Detections, class names)
+    """
+    start = time.perf_counter()
+    tracker = Tracker(model_path, batch_size=batch_size, **CONFIGURATIONS[name])
+    load_seconds = time.perf_counter() - start
+
+    # Warm-up: first batch pays for lazy initialization and allocations
+    for _ in tracker.iter_detections(islice(iter_video(video_path), batch_size)):
+        pass
+
+    detections = []
+    names = {}
+    start = time.perf_counter()
+    for _, detection in tracker.iter_detections(islice(iter_video(video_path), frame_limit)):
+        detections.append(_to_supervision(detection))
+        names = detection.names
+    seconds = time.perf_counter() - start
+
+    report = {
+        'load_seconds': round(load_seconds, 3),
+        'frames': len(detections),
+        'seconds': round(seconds, 3),
+        'fps': round(len(detections) / seconds, 2) if seconds > 0 else None,
+        'detections_per_frame': round(sum(len(d) for d in detections) / max(len(detections), 1), 2),
+    }
+    return report, detections, names
+
+
+def _iou_matrix(a, b):
+    top_left = np.maximum(a[:, None, :2], b[None, :, :2])
+    bottom_right = np.minimum(a[:, None, 2:], b[None, :, 2:])
+    intersection = np.prod(np.clip(bottom_right - top_left, 0, None), axis=2)
+    area_a = np.prod(a[:, 2:] - a[:, :2], axis=1)
+    area_b = np.prod(b[:, 2:] - b[:, :2], axis=1)
+    return intersection / np.maximum(area_a[:, None] + area_b[None, :] - intersection, 1e-9)
+
+
+def agreement(reference, candidate, names):
+    """
+    Per-class precision and recall of candidate detections against reference.
+
+    Matching is greedy by IoU within each class and frame.
+    """
+    counts = {}
+    for ref, cand in zip(reference, candidate):
+        for class_id in set(ref.class_id.tolist()) | set(cand.class_id.tolist()):
+            ref_boxes = ref.xyxy[ref.class_id == class_id]
+            cand_boxes = cand.xyxy[cand.class_id == class_id]
+            matched = 0
+            if len(ref_boxes) and len(cand_boxes):
+                iou = _iou_matrix(ref_boxes, cand_boxes)
+                while iou.size and iou.max() >= MATCH_IOU:
+                    i, j = np.unravel_index(iou.argmax(), iou.shape)
+                    iou[i, :] = -1
+                    iou[:, j] = -1
+                    matched += 1
+            total = counts.setdefault(names.get(class_id, str(class_id)), [0, 0, 0])
+            total[0] += matched
+            total[1] += len(ref_boxes)
+            total[2] += len(cand_boxes)
+
+    return {
+        name: {
+            'recall': round(matched / reference_count, 4) if reference_count else None,
+            'precision': round(matched / candidate_count, 4) if candidate_count else None,
+        }
+        for name, (matched, reference_count, candidate_count) in sorted(counts.items())
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark the detection backends')
+    parser.add_argument('--input', required=True, help='Input video')
+    parser.add_argument('--model', default='models/best.pt', help='YOLO model (.pt)')
+    parser.add_argument('--frames', type=int, default=300, help='Frames to detect (default 300)')
+    parser.add_argument('--batch-size', type=int, default=20, help='Frames per batch (default 20)')
+    parser.add_argument('--backends', nargs='+', choices=sorted(CONFIGURATIONS),
+                        default=['ultralytics', 'onnx', 'onnx-int8'], help='Backends to compare')
+    parser.add_argument('--threads', type=int, default=0,
+                        help='CPU threads for OpenCV/ONNX Runtime/torch (0 = library default)')
+    parser.add_argument('--output', default=None, help='Also write the JSON report to this file')
+    args = parser.parse_args()
+
+    if args.threads > 0:
+        cv2.setNumThreads(args.threads)
+        try:
+            import torch
+            torch.set_num_threads(args.threads)
+        except ImportError:
+            pass
+
+    report = {
+        'video': os.path.abspath(args.input),
+        'model': os.path.abspath(args.model),
+        'batch_size': args.batch_size,
+        'threads': cv2.getNumThreads(),
+        'machine': {'platform': platform.platform(), 'processor': platform.processor(),
+                    'cpu_count': os.cpu_count()},
+        'backends': {},
+    }
+
+    results = {}
+    for name in args.backends:
+        print(f"Running {name}...", file=sys.stderr)
+        backend_report, detections, names = run_backend(
+            name, args.model, args.input, args.frames, args.batch_size
+        )
+        results[name] = (detections, names)
+        report['backends'][name] = backend_report
+
+    if 'ultralytics' in results:
+        reference, names = results['ultralytics']
+        baseline_fps = report['backends']['ultralytics']['fps']
+        for name, (detections, _) in results.items():
+            if name == 'ultralytics':
+                continue
+            backend_report = report['backends'][name]
+            backend_report['agreement'] = agreement(reference, detections, names)
+            if baseline_fps and backend_report['fps']:
+                backend_report['speedup'] = round(backend_report['fps'] / baseline_fps, 2)
+
+    text = json.dumps(report, indent=2)
+    print(text)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+===============================================================================
+JERSEY COLOR PARITY CHECK
+===============================================================================
+
+Runs the native jersey color kernel (team_assigner/_jersey_color) and its
+NumPy fallback on the same random crops and compares the results, so a
+change to either implementation can be checked against the other.
+
+CROPS:
+- Synthetic players: a jersey color on a background color, both with
+  noise, so the clustering has a clear answer
+- Pure noise: random pixels, where near-ties between the two centers are
+  common
+- Random box sizes, including empty, one-pixel and out-of-frame boxes
+
+Colors must match exactly (NaN for empty crops) and team predictions must
+be equal. The native module must be built first:
+    python setup.py build_ext --inplace
+
+USAGE:
+    cd foot-Function
+    python benchmarks/jersey_color_parity.py --frames 50 --players 20 --seed 0
+
+Prints a JSON report to stdout; the exit status is 1 if any crop differs.
+===============================================================================
+"""
+
+import os
+import sys
+import json
+import argparse
+
+import numpy as np
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from team_assigner import jersey_color
+
+
+def random_frame(rng, height, width, players):
+    """Noise frame with synthetic players; returns (frame, bboxes)."""
+    frame = rng.integers(0, 256, size=(height, width, 3), dtype=np.uint8)
+    bboxes = []
+    for n in range(players):
+        box_width = int(rng.integers(0, 60))
+        box_height = int(rng.integers(0, 120))
+        x1 = int(rng.integers(-20, width))
+        y1 = int(rng.integers(-20, height))
+        bboxes.append([x1, y1, x1 + box_width, y1 + box_height])
+
+        # Every other box is a player: background with a jersey in the middle
+        if n % 2 == 0:
+            x_start, y_start, x_stop, y_stop = jersey_color.crop_boxes([bboxes[-1]], height, width)[0]
+            region = frame[y_start:y_stop, x_start:x_stop]
+            if region.size == 0:
+                continue
+            background = rng.integers(0, 256, size=3)
+            jersey = rng.integers(0, 256, size=3)
+            noise = rng.normal(0, 12, size=region.shape)
+            colors = np.broadcast_to(background, region.shape).astype(np.float64)
+            rows, columns = region.shape[:2]
+            colors[rows // 4:, columns // 4:columns - columns // 4] = jersey
+            region[:] = np.clip(colors + noise, 0, 255).astype(np.uint8)
+    return frame, np.array(bboxes, dtype=np.float64).reshape(-1, 4)
+
+
+def numpy_reference(frame, bboxes, team_centers):
+    """The NumPy fallback of jersey_colors, regardless of the native module."""
+    native = jersey_color._native
+    jersey_color._native = None
+    try:
+        return jersey_color.jersey_colors(frame, bboxes, team_centers)
+    finally:
+        jersey_color._native = native
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare the native and NumPy jersey color kernels')
+    parser.add_argument('--frames', type=int, default=50, help='Random frames')
+    parser.add_argument('--players', type=int, default=20, help='Boxes per frame')
+    parser.add_argument('--height', type=int, default=360)
+    parser.add_argument('--width', type=int, default=640)
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    if not jersey_color.native_available():
+        print("Native module not built (python setup.py build_ext --inplace)", file=sys.stderr)
+        return 2
+
+    rng = np.random.default_rng(args.seed)
+    crops = 0
+    mismatches = []
+    for frame_num in range(args.frames):
+        frame, bboxes = random_frame(rng, args.height, args.width, args.players)
+        team_centers = rng.integers(0, 256, size=(2, 3)).astype(np.float64)
+
+        native_colors, native_teams = jersey_color.jersey_colors(frame, bboxes, team_centers)
+        numpy_colors, numpy_teams = numpy_reference(frame, bboxes, team_centers)
+        crops += len(bboxes)
+
+        for n in range(len(bboxes)):
+            same_color = np.array_equal(native_colors[n], numpy_colors[n], equal_nan=True)
+            if not same_color or native_teams[n] != numpy_teams[n]:
+                mismatches.append({
+                    'frame': frame_num,
+                    'bbox': bboxes[n].tolist(),
+                    'native': [native_colors[n].tolist(), int(native_teams[n])],
+                    'numpy': [numpy_colors[n].tolist(), int(numpy_teams[n])],
+                })
+
+    report = {
+        'implementation': jersey_color.implementation(),
+        'seed': args.seed,
+        'crops': crops,
+        'mismatches': len(mismatches),
+        'examples': mismatches[:10],
+    }
+    print(json.dumps(report, indent=2))
+    return 1 if mismatches else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+===============================================================================
+KEYFRAME STRIDE BENCHMARK
+===============================================================================
+
+Measures the speed/accuracy tradeoff of keyframe detection
+(Tracker(keyframe_stride=K)) against detecting every frame.
+
+MEASURED PER STRIDE:
+- Detection + tracking time and frames per second on frames held in memory
+  (decoding excluded), and the speedup over stride 1
+- Keyframe statistics: frames detected and why (stride, camera motion,
+  track loss)
+- Agreement of the filled tracks with the stride 1 tracks after ball
+  interpolation: a box matches when a box of the same class overlaps it
+  with IoU >= 0.5; precision and recall per class, over all frames and
+  over the frames that were not detected
+
+USAGE:
+    cd foot-Function
+    python benchmarks/keyframe_stride.py --input input_videos/match.mp4 \\
+        --model models/best.pt --frames 500 --strides 2 3 4 5
+
+The JSON report is printed to stdout and optionally written to --output.
+===============================================================================
+"""
+
+import os
+import sys
+import json
+import time
+import argparse
+from itertools import islice
+
+import numpy as np
+import supervision as sv
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from utils import iter_video
+from trackers import Tracker, DETECTION_BACKENDS
+from track_store import TrackStoreBuilder, PLAYER, REFEREE, BALL
+from detection_backends import agreement
+
+CLASS_NAMES = {PLAYER: 'player', REFEREE: 'referee', BALL: 'ball'}
+
+
+def run_stride(tracker, frames, stride):
+    """
+    Detect and track the frames with one stride.
+
+    Returns:
+        (report dict, TrackStore with gaps and ball filled, detected frame flags)
+    """
+    tracker.keyframe_stride = stride
+    tracker.reset_tracking()
+
+    builder = TrackStoreBuilder()
+    detected = np.zeros(len(frames), dtype=bool)
+    start = time.perf_counter()
+    for frame_num, (_, detection) in enumerate(tracker.iter_detections(frames)):
+        builder.append_frame(tracker.track_detection(detection))
+        detected[frame_num] = detection is not None
+    seconds = time.perf_counter() - start
+
+    store = builder.build()
+    added = tracker.fill_keyframe_gaps_in_store(store)
+    tracker.interpolate_ball_positions_in_store(store)
+
+    report = {
+        'seconds': round(seconds, 3),
+        'fps': round(len(frames) / seconds, 2) if seconds > 0 else None,
+        'keyframes': dict(tracker.keyframe_stats) if stride > 1 else None,
+        'interpolated_boxes': added,
+    }
+    return report, store, detected
+
+
+def frame_detections(store):
+    """Per-frame sv.Detections of a store (class ids are track store classes)."""
+    detections = []
+    for frame_num in range(store.frame_count):
+        rows = store.frame_slice(frame_num)
+        detections.append(sv.Detections(
+            xyxy=store.bbox[rows].astype(np.float32),
+            class_id=store.cls[rows].astype(int),
+        ))
+    return detections
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark keyframe-stride detection')
+    parser.add_argument('--input', required=True, help='Input video')
+    parser.add_argument('--model', default='models/best.pt', help='YOLO model')
+    parser.add_argument('--frames', type=int, default=500, help='Frames to analyze (default 500)')
+    parser.add_argument('--strides', type=int, nargs='+', default=[2, 3, 4, 5],
+                        help='Keyframe strides to compare with stride 1')
+    parser.add_argument('--backend', choices=DETECTION_BACKENDS, default='ultralytics',
+                        help='Detection backend')
+    parser.add_argument('--batch-size', type=int, default=20, help='Frames per batch (default 20)')
+    parser.add_argument('--output', default=None, help='Also write the JSON report to this file')
+    args = parser.parse_args()
+
+    frames = list(islice(iter_video(args.input), args.frames))
+    if not frames:
+        print(f"No frames read from {args.input}", file=sys.stderr)
+        return 1
+
+    tracker = Tracker(args.model, backend=args.backend, batch_size=args.batch_size)
+    # Warm-up: first batch pays for lazy initialization and allocations
+    for _ in tracker.iter_detections(frames[:args.batch_size]):
+        pass
+
+    print("Running stride 1...", file=sys.stderr)
+    baseline_report, baseline_store, _ = run_stride(tracker, frames, 1)
+    reference = frame_detections(baseline_store)
+
+    report = {
+        'video': os.path.abspath(args.input),
+        'model': os.path.abspath(args.model),
+        'backend': args.backend,
+        'frames': len(frames),
+        'strides': {'1': baseline_report},
+    }
+
+    for stride in args.strides:
+        print(f"Running stride {stride}...", file=sys.stderr)
+        stride_report, store, detected = run_stride(tracker, frames, stride)
+        candidate = frame_detections(store)
+        between = np.flatnonzero(~detected).tolist()
+
+        if baseline_report['seconds'] and stride_report['seconds']:
+            stride_report['speedup'] = round(baseline_report['seconds'] / stride_report['seconds'], 2)
+        stride_report['agreement'] = agreement(reference, candidate, CLASS_NAMES)
+        stride_report['agreement_between_keyframes'] = agreement(
+            [reference[i] for i in between], [candidate[i] for i in between], CLASS_NAMES
+        )
+        report['strides'][str(stride)] = stride_report
+
+    text = json.dumps(report, indent=2)
+    print(text)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
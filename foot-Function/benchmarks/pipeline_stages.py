@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""
+===============================================================================
+PIPELINE STAGE BENCHMARK
+===============================================================================
+
+Times each post-detection stage of the pipeline in isolation on the stub
+fixtures (stubs/track_stubs.pkl and stubs/camera_movement_stub.pkl), so a
+change to one stage can be measured without a video, a model or the stages
+around it.
+
+MEASURED PER STAGE:
+- dict: the nested tracks dictionary implementation (add_position_to_tracks,
+  add_adjust_positions_to_tracks, add_transformed_position_to_tracks,
+  interpolate_ball_positions, add_speed_and_distance_to_tracks, the
+  per-frame assign_ball_to_player loop, output_data)
+- store: the TrackStore implementation the pipeline runs
+  (add_position_to_store, ..., assign_ball_possession as in
+  _assign_ball_possession, the outputs of _save_output_data)
+- Minimum and median seconds over --repeat runs after one warm-up run, rows
+  per second (median) and the speedup of store over dict
+
+Every run starts from a fresh copy of the stage's input, which is produced
+once by running the stages before it (untimed). The fixtures have no video
+frames, so team assignment is not benchmarked: players get a fixed team
+(track id parity) before ball possession. --scale repeats the fixture frames
+to benchmark longer videos.
+
+USAGE:
+    cd foot-Function
+    python benchmarks/pipeline_stages.py --repeat 5 --scale 10 \\
+        --output stage_benchmark.json
+
+The JSON report is printed to stdout and optionally written to --output.
+===============================================================================
+"""
+
+import os
+import sys
+import copy
+import json
+import time
+import pickle
+import argparse
+import tempfile
+import contextlib
+import statistics
+
+import numpy as np
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from utils import output_data, output_frame_data
+from trackers import Tracker
+from player_ball_assigner import PlayerBallAssigner, PossessionStats
+from camera_movement_estimator import CameraMovementEstimator
+from view_transformer import ViewTransformer
+from speed_and_distance_estimator import SpeedAndDistance_Estimator, SPEED_MODES, DEFAULT_FRAME_RATE
+from track_store import TrackStore, PLAYER, write_telemetry
+
+
+################################################################################
+# FIXTURE
+################################################################################
+
+class Fixture:
+    """Stage objects shared by all runs, and a directory for the outputs."""
+
+    def __init__(self, camera_movement, frame_rate, speed_mode, output_dir):
+        # The position and interpolation methods do not use the model
+        self.tracker = Tracker.__new__(Tracker)
+        # Only the feature mask is built from the first frame
+        self.camera_estimator = CameraMovementEstimator(np.zeros((1080, 1920, 3), dtype=np.uint8))
+        self.view_transformer = ViewTransformer()
+        self.speed_estimator = SpeedAndDistance_Estimator(frame_rate=frame_rate, mode=speed_mode)
+        self.ball_assigner = PlayerBallAssigner()
+        self.camera_movement = camera_movement
+        self.frame_rate = frame_rate
+        self.output_dir = output_dir
+
+
+def load_fixture(tracks_path, camera_path, scale):
+    """
+    Load the stub fixtures, repeated scale times.
+
+    Returns:
+        (tracks dictionary, camera movement per frame)
+    """
+    with open(tracks_path, 'rb') as f:
+        tracks = pickle.load(f)
+    with open(camera_path, 'rb') as f:
+        camera_movement = [list(movement) for movement in pickle.load(f)]
+
+    frame_count = len(tracks['players'])
+    if len(camera_movement) != frame_count:
+        raise ValueError(f"{camera_path} has {len(camera_movement)} frames, "
+                         f"{tracks_path} has {frame_count}")
+
+    # Deep copies, so the repeated frames do not share their dictionaries
+    tracks = {name: [copy.deepcopy(track) for _ in range(scale) for track in object_tracks]
+              for name, object_tracks in tracks.items()}
+    return tracks, camera_movement * scale
+
+
+def assign_fixture_teams(state):
+    """Fixed teams (track id parity) in place of team assignment, which needs frames."""
+    if 'tracks' in state:
+        for player_track in state['tracks']['players']:
+            for player_id, player in player_track.items():
+                player['team'] = player_id % 2 + 1
+    else:
+        store = state['store']
+        rows = store.class_rows(PLAYER)
+        store.team[rows] = store.track_id[rows] % 2 + 1
+
+
+################################################################################
+# STAGES
+################################################################################
+
+def dict_ball_interpolation(fixture, state):
+    tracks = state['tracks']
+    tracks['ball'] = fixture.tracker.interpolate_ball_positions(tracks['ball'])
+
+
+def dict_ball_possession(fixture, state):
+    """The per-frame possession loop the pipeline ran on the tracks dictionary."""
+    tracks = state['tracks']
+    team_ball_control = []
+    for frame_num, player_track in enumerate(tracks['players']):
+        ball_bbox = tracks['ball'][frame_num][1]['bbox']
+        assigned_player = fixture.ball_assigner.assign_ball_to_player(player_track, ball_bbox)
+        if assigned_player != -1:
+            player_track[assigned_player]['has_ball'] = True
+            team_ball_control.append(player_track[assigned_player]['team'])
+        else:
+            team_ball_control.append(team_ball_control[-1] if team_ball_control else 0)
+    state['team_ball_control'] = np.array(team_ball_control)
+
+
+def store_ball_possession(fixture, state):
+    team_ball_control = fixture.ball_assigner.assign_ball_possession(state['store'])
+    state['possession'] = PossessionStats(team_ball_control, state['store'])
+
+
+def dict_output_data(fixture, state):
+    output_data(state['tracks'], os.path.join(fixture.output_dir, 'dict_data_output.json'),
+                team_ball_control=state['team_ball_control'])
+
+
+def store_output_data(fixture, state):
+    output_data(state['store'], os.path.join(fixture.output_dir, 'data_output.json'),
+                possession=state['possession'])
+
+
+# (name, dict implementation, store implementation) in pipeline order;
+# None where one representation has no such stage
+STAGES = [
+    ('positions',
+     lambda fx, s: fx.tracker.add_position_to_tracks(s['tracks']),
+     lambda fx, s: fx.tracker.add_position_to_store(s['store'])),
+    ('camera_adjustment',
+     lambda fx, s: fx.camera_estimator.add_adjust_positions_to_tracks(s['tracks'], fx.camera_movement),
+     lambda fx, s: fx.camera_estimator.add_adjust_positions_to_store(s['store'], fx.camera_movement)),
+    ('view_transform',
+     lambda fx, s: fx.view_transformer.add_transformed_position_to_tracks(s['tracks']),
+     lambda fx, s: fx.view_transformer.add_transformed_position_to_store(s['store'])),
+    ('ball_interpolation', dict_ball_interpolation,
+     lambda fx, s: fx.tracker.interpolate_ball_positions_in_store(s['store'])),
+    ('speed_and_distance',
+     lambda fx, s: fx.speed_estimator.add_speed_and_distance_to_tracks(s['tracks']),
+     lambda fx, s: fx.speed_estimator.add_speed_and_distance_to_store(s['store'])),
+    ('ball_possession', dict_ball_possession, store_ball_possession),
+    ('output_data', dict_output_data, store_output_data),
+    ('frame_data', None,
+     lambda fx, s: output_frame_data(s['store'], os.path.join(fx.output_dir, 'frame_data.csv'))),
+    ('telemetry', None,
+     lambda fx, s: write_telemetry(s['store'], os.path.join(fx.output_dir, 'tracks.ftrk'),
+                                   fps=fx.frame_rate)),
+]
+
+
+################################################################################
+# TIMING
+################################################################################
+
+def stage_inputs(fixture, state, implementation):
+    """
+    Run every stage once and keep a copy of its input.
+
+    Returns:
+        {stage name: state before the stage}
+    """
+    inputs = {}
+    for name, dict_stage, store_stage in STAGES:
+        stage = dict_stage if implementation == 'dict' else store_stage
+        if stage is None:
+            continue
+        if name == 'ball_possession':
+            assign_fixture_teams(state)
+        inputs[name] = copy.deepcopy(state)
+        stage(fixture, state)
+    return inputs
+
+
+def time_stage(fixture, stage, stage_input, repeat, rows):
+    """Time one stage on fresh copies of its input (the first run is a warm-up)."""
+    samples = []
+    for run in range(repeat + 1):
+        state = copy.deepcopy(stage_input)
+        start = time.perf_counter()
+        stage(fixture, state)
+        seconds = time.perf_counter() - start
+        if run > 0:
+            samples.append(seconds)
+
+    median = statistics.median(samples)
+    return {
+        'min_seconds': round(min(samples), 6),
+        'median_seconds': round(median, 6),
+        'rows_per_second': round(rows / median) if median > 0 else None,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark the post-detection pipeline stages')
+    parser.add_argument('--tracks', default='stubs/track_stubs.pkl', help='Tracks fixture')
+    parser.add_argument('--camera-movement', default='stubs/camera_movement_stub.pkl',
+                        help='Camera movement fixture')
+    parser.add_argument('--scale', type=int, default=1,
+                        help='Repeat the fixture frames this many times (default 1)')
+    parser.add_argument('--repeat', type=int, default=5,
+                        help='Timed runs per stage after one warm-up (default 5)')
+    parser.add_argument('--stages', nargs='+', choices=[stage[0] for stage in STAGES],
+                        help='Stages to time (default all)')
+    parser.add_argument('--fps', type=float, default=DEFAULT_FRAME_RATE,
+                        help=f'Frame rate for speed and telemetry (default {DEFAULT_FRAME_RATE})')
+    parser.add_argument('--speed-mode', choices=SPEED_MODES, default='window',
+                        help='Speed mode of the store implementation (default window)')
+    parser.add_argument('--output', default=None, help='Also write the JSON report to this file')
+    args = parser.parse_args()
+
+    if args.scale < 1 or args.repeat < 1:
+        print("--scale and --repeat must be at least 1", file=sys.stderr)
+        return 1
+
+    tracks, camera_movement = load_fixture(args.tracks, args.camera_movement, args.scale)
+    store = TrackStore.from_tracks(tracks)
+    rows = len(store)
+    selected = set(args.stages or [stage[0] for stage in STAGES])
+
+    report = {
+        'fixture': {
+            'tracks': os.path.abspath(args.tracks),
+            'camera_movement': os.path.abspath(args.camera_movement),
+            'scale': args.scale,
+            'frames': store.frame_count,
+            'rows': rows,
+        },
+        'repeat': args.repeat,
+        'speed_mode': args.speed_mode,
+        'stages': {},
+    }
+
+    with tempfile.TemporaryDirectory() as output_dir, contextlib.redirect_stdout(sys.stderr):
+        fixture = Fixture(camera_movement, args.fps, args.speed_mode, output_dir)
+        inputs = {
+            'dict': stage_inputs(fixture, {'tracks': tracks}, 'dict'),
+            'store': stage_inputs(fixture, {'store': store}, 'store'),
+        }
+
+        for name, dict_stage, store_stage in STAGES:
+            if name not in selected:
+                continue
+            print(f"Timing {name}...", file=sys.stderr)
+            result = {}
+            for implementation, stage in (('dict', dict_stage), ('store', store_stage)):
+                if stage is not None:
+                    result[implementation] = time_stage(
+                        fixture, stage, inputs[implementation][name], args.repeat, rows
+                    )
+            if 'dict' in result and 'store' in result and result['store']['median_seconds'] > 0:
+                result['speedup'] = round(
+                    result['dict']['median_seconds'] / result['store']['median_seconds'], 2
+                )
+            report['stages'][name] = result
+
+    text = json.dumps(report, indent=2)
+    print(text)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
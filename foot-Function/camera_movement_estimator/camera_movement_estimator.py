@@ -26,7 +26,22 @@ FEATURE SELECTION:
 Features are detected in specific regions likely to contain static elements:
 - Left edge (x: 0-20): Stadium/crowd
 - Right edge (x: 900-1050): Stadium/crowd
-These regions typically don't contain moving players/ball.
+These regions typically don't contain moving players/ball. The columns are
+given for a 1920 pixel wide frame and scale with the actual frame width.
+
+PERFORMANCE:
+- The grayscale proxy of each frame is computed once and used both as the
+  "next" image for its own frame and the "prev" image for the following
+  frame (OpenCV's Python bindings do not accept prebuilt flow pyramids)
+- Optionally the flow runs on a downscaled grayscale proxy (proxy_scale);
+  movements are scaled back to full resolution pixels
+- For in-memory videos the frames are split into chunks processed in
+  parallel. Each chunk starts its feature chain a few frames early (overlap).
+  The estimator state only depends on the frame where features were last
+  detected, so once a chunk and its predecessor re-detect features on the
+  same frame they agree from then on. Chunks that do not synchronize within
+  the overlap are repaired by continuing the predecessor's chain until they
+  do, so the result equals the sequential one.
 
 OUTPUT:
 Camera movement per frame as [dx, dy] arrays, where:
@@ -35,13 +50,11 @@ Camera movement per frame as [dx, dy] arrays, where:
 ===============================================================================
 """
 
+import os
 import pickle
+from concurrent.futures import ThreadPoolExecutor
 import cv2
 import numpy as np
-import os
-import sys 
-sys.path.append('../')
-from utils import measure_distance,measure_xy_distance
 
 
 ################################################################################
@@ -52,8 +65,20 @@ class CameraMovementEstimator():
     """
     Estimates camera motion using optical flow on background features.
     """
+
+    # Stub cache format version: bump when the estimation parameters or
+    # algorithm change so cached camera movement is recomputed
+    CACHE_VERSION = 2
+
+    # Feature regions as (start, stop) columns of a REFERENCE_WIDTH wide frame
+    FEATURE_REGIONS = ((0, 20), (900, 1050))
+    REFERENCE_WIDTH = 1920
+
+    DEFAULT_CHUNK_SIZE = 150   # Frames per parallel chunk
+    DEFAULT_OVERLAP = 25       # Frames each chunk starts early to synchronize
     
-    def __init__(self,frame):
+    def __init__(self,frame, proxy_scale=1.0, workers=0,
+                 chunk_size=DEFAULT_CHUNK_SIZE, overlap=DEFAULT_OVERLAP):
         """
         Initialize camera movement estimator with first frame.
         
@@ -61,8 +86,22 @@ class CameraMovementEstimator():
         
         Args:
             frame: First video frame for initialization
+            proxy_scale: Scale of the grayscale proxy the flow runs on (0 < s <= 1)
+            workers: Threads for chunked estimation (0 = OpenCV's thread
+                     count, which follows the worker's thread budget)
+            chunk_size: Frames per chunk in chunked estimation
+            overlap: Frames a chunk starts early to synchronize with its predecessor
         """
-        self.minimum_distance = 5  # Minimum movement threshold (pixels)
+        if not 0 < proxy_scale <= 1:
+            raise ValueError(f"proxy_scale must be in (0, 1]: {proxy_scale}")
+        if chunk_size < 1 or overlap < 0:
+            raise ValueError(f"Invalid chunk size {chunk_size} or overlap {overlap}")
+
+        self.minimum_distance = 5  # Minimum movement threshold (full resolution pixels)
+        self.proxy_scale = proxy_scale
+        self.workers = workers if workers > 0 else max(cv2.getNumThreads(), 1)
+        self.chunk_size = chunk_size
+        self.overlap = overlap
 
         # Lucas-Kanade optical flow parameters
         self.lk_params = dict(
@@ -72,10 +111,11 @@ class CameraMovementEstimator():
         )
 
         # Prepare feature mask to detect only in specific regions
-        first_frame_grayscale = cv2.cvtColor(frame,cv2.COLOR_BGR2GRAY)
+        first_frame_grayscale = self._gray_proxy(frame)
         mask_features = np.zeros_like(first_frame_grayscale)
-        mask_features[:,0:20] = 1      # Left edge region
-        mask_features[:,900:1050] = 1  # Right edge region (adjust based on video resolution)
+        column_scale = mask_features.shape[1] / self.REFERENCE_WIDTH
+        for start, stop in self.FEATURE_REGIONS:
+            mask_features[:,int(round(start*column_scale)):int(round(stop*column_scale))] = 1
 
         # Good features to track parameters
         self.features = dict(
@@ -86,6 +126,9 @@ class CameraMovementEstimator():
             mask = mask_features   # Only detect in masked regions
         )
 
+        # Streaming state (see update())
+        self.state = None
+
     # =========================================================================
     # POSITION ADJUSTMENT
     # =========================================================================
@@ -108,13 +151,24 @@ class CameraMovementEstimator():
                     camera_movement = camera_movement_per_frame[frame_num]
                     position_adjusted = (position[0]-camera_movement[0],position[1]-camera_movement[1])
                     tracks[object][frame_num][track_id]['position_adjusted'] = position_adjusted
+
+    def add_adjust_positions_to_store(self, store, camera_movement_per_frame):
+        """
+        Columnar version of add_adjust_positions_to_tracks for a TrackStore.
+        
+        Args:
+            store: TrackStore with positions
+            camera_movement_per_frame: List of [dx, dy] camera movement per frame
+        """
+        camera_movement = np.asarray(camera_movement_per_frame, dtype=np.float64).reshape(-1, 2)
+        store.position_adjusted[:] = store.position - camera_movement[store.frame]
                     
 
     # =========================================================================
     # CAMERA MOVEMENT ESTIMATION
     # =========================================================================
 
-    def get_camera_movement(self,frames,read_from_stub=False, stub_path=None):
+    def get_camera_movement(self,frames,read_from_stub=False, stub_path=None, progress=None):
         """
         Calculate camera movement for all frames using optical flow.
         
@@ -124,18 +178,18 @@ class CameraMovementEstimator():
         3. For each subsequent frame:
            - Track features using Lucas-Kanade optical flow
            - Calculate movement of each feature
-           - Use median movement as camera motion (robust to outliers)
+           - Use the largest feature movement as camera motion
+           - Re-detect features after a movement above the threshold
         4. Save results to cache for future runs
         
-        ROBUSTNESS:
-        - Uses median instead of mean to handle outliers (moving objects)
-        - Only tracks features in specific regions (background)
-        - Filters out large movements (likely not camera motion)
+        A list of frames is split into chunks estimated in parallel (see
+        _estimate_chunked); any other iterable is processed frame by frame.
         
         Args:
-            frames: List of all video frames
+            frames: Iterable of video frames (list or streaming decoder)
             read_from_stub: If True, load from cached file
             stub_path: Path to cache file
+            progress: Optional callable receiving the number of frames completed
             
         Returns:
             List of [dx, dy] camera movement vectors per frame
@@ -145,36 +199,169 @@ class CameraMovementEstimator():
             with open(stub_path,'rb') as f:
                 return pickle.load(f)
 
-        camera_movement = [[0,0]]*len(frames)
+        if isinstance(frames, (list, tuple)) and self.workers > 1 and len(frames) > self.chunk_size:
+            camera_movement = self._estimate_chunked(frames, progress)
+        else:
+            camera_movement = []
+            self.state = None
+            for frame in frames:
+                camera_movement.append(self.update(frame))
+                if progress is not None:
+                    progress(1)
+        
+        if stub_path is not None:
+            with open(stub_path,'wb') as f:
+                pickle.dump(camera_movement,f)
 
-        old_gray = cv2.cvtColor(frames[0],cv2.COLOR_BGR2GRAY)
-        old_features = cv2.goodFeaturesToTrack(old_gray,**self.features)
+        return camera_movement
+    
+    def update(self, frame):
+        """
+        Estimate camera movement for the next frame in a stream.
+        
+        Keeps the previous grayscale frame and tracked features between
+        calls, so frames can be fed one at a time without holding the video
+        in memory. The first frame after construction (or after a reset via
+        get_camera_movement) initializes the state and returns [0, 0].
+        
+        Args:
+            frame: Next video frame (BGR)
+            
+        Returns:
+            [dx, dy] camera movement for this frame
+        """
+        movement, _, self.state = self._step(self.state, frame)
+        return movement
 
-        for frame_num in range(1,len(frames)):
-            frame_gray = cv2.cvtColor(frames[frame_num],cv2.COLOR_BGR2GRAY)
-            new_features, _,_ = cv2.calcOpticalFlowPyrLK(old_gray,frame_gray,old_features,None,**self.lk_params)
+    # =========================================================================
+    # SINGLE FRAME STEP
+    # =========================================================================
 
-            max_distance = 0
-            camera_movement_x, camera_movement_y = 0,0
+    def _gray_proxy(self, frame):
+        """Grayscale frame, downscaled by proxy_scale."""
+        frame_gray = cv2.cvtColor(frame,cv2.COLOR_BGR2GRAY)
+        if self.proxy_scale != 1:
+            frame_gray = cv2.resize(frame_gray, None, fx=self.proxy_scale, fy=self.proxy_scale,
+                                    interpolation=cv2.INTER_AREA)
+        return frame_gray
 
-            for i, (new,old) in enumerate(zip(new_features,old_features)):
-                new_features_point = new.ravel()
-                old_features_point = old.ravel()
+    def _detect_features(self, frame_gray):
+        return cv2.goodFeaturesToTrack(frame_gray,**self.features)
 
-                distance = measure_distance(new_features_point,old_features_point)
-                if distance>max_distance:
-                    max_distance = distance
-                    camera_movement_x,camera_movement_y = measure_xy_distance(old_features_point, new_features_point ) 
+    def _step(self, state, frame):
+        """
+        Advance the estimator by one frame.
+        
+        The state is (previous grayscale proxy, tracked features) or
+        None before the first frame. It only depends on the last frame on
+        which features were detected and on the previous frame.
+        
+        Args:
+            state: State after the previous frame
+            frame: Next video frame (BGR)
             
-            if max_distance > self.minimum_distance:
-                camera_movement[frame_num] = [camera_movement_x,camera_movement_y]
-                old_features = cv2.goodFeaturesToTrack(frame_gray,**self.features)
+        Returns:
+            (movement, redetected, new_state); redetected is True when the
+            features were detected on this frame (always for the first frame)
+        """
+        frame_gray = self._gray_proxy(frame)
+
+        if state is None:
+            return [0,0], True, (frame_gray, self._detect_features(frame_gray))
+
+        old_gray, old_features = state
+        if old_features is None:
+            return [0,0], False, (frame_gray, old_features)
 
-            old_gray = frame_gray.copy()
+        new_features, _,_ = cv2.calcOpticalFlowPyrLK(old_gray,frame_gray,old_features,None,**self.lk_params)
+
+        # Largest feature movement (first one on ties), in full resolution pixels
+        offsets = (old_features - new_features).reshape(-1, 2).astype(np.float64) / self.proxy_scale
+        distances = np.sqrt((offsets ** 2).sum(axis=1))
+        largest = int(np.argmax(distances))
+
+        if distances[largest] > self.minimum_distance:
+            movement = [float(offsets[largest, 0]), float(offsets[largest, 1])]
+            return movement, True, (frame_gray, self._detect_features(frame_gray))
+
+        return [0,0], False, (frame_gray, old_features)
+
+    # =========================================================================
+    # CHUNKED PARALLEL ESTIMATION
+    # =========================================================================
+
+    def _run_chain(self, frames, start, stop, state=None):
+        """
+        Run the estimator over frames[start:stop].
         
-        if stub_path is not None:
-            with open(stub_path,'wb') as f:
-                pickle.dump(camera_movement,f)
+        Returns:
+            (movements, redetected flags, final state)
+        """
+        movements, redetected = [], []
+        for frame_num in range(start, stop):
+            movement, detected, state = self._step(state, frames[frame_num])
+            movements.append(movement)
+            redetected.append(detected)
+        return movements, redetected, state
+
+    def _estimate_chunked(self, frames, progress=None):
+        """
+        Estimate camera movement with overlapping chunks in parallel.
+        
+        Chunk i covers frames [s, e) but starts its chain at s - overlap.
+        Chunks are then stitched in order: if the final chain and chunk i
+        re-detected features on the same frame k, both are in the same
+        state after k and chunk i's results are used from there on.
+        Otherwise the final chain is continued into the chunk until it
+        synchronizes (at worst through the whole chunk).
+        
+        Args:
+            frames: List of video frames
+            progress: Optional callable receiving the number of frames completed
+            
+        Returns:
+            List of [dx, dy] camera movement vectors per frame
+        """
+        frame_count = len(frames)
+        bounds = [(start, min(start + self.chunk_size, frame_count))
+                  for start in range(0, frame_count, self.chunk_size)]
+
+        with ThreadPoolExecutor(max_workers=min(self.workers, len(bounds))) as pool:
+            futures = [pool.submit(self._run_chain, frames, max(start - self.overlap, 0), stop)
+                       for start, stop in bounds]
+
+            camera_movement = []
+            redetected = []
+            state = None
+            for (start, stop), future in zip(bounds, futures):
+                movements, chunk_redetected, chunk_state = future.result()
+                warm_start = max(start - self.overlap, 0)
+                offset = start - warm_start
+
+                synchronized = start == 0 or any(
+                    redetected[frame_num] and chunk_redetected[frame_num - warm_start]
+                    for frame_num in range(warm_start, start)
+                )
+
+                frame_num = start
+                if not synchronized:
+                    # Continue the final chain until both re-detect on the same frame
+                    while frame_num < stop:
+                        movement, detected, state = self._step(state, frames[frame_num])
+                        camera_movement.append(movement)
+                        redetected.append(detected)
+                        frame_num += 1
+                        if detected and chunk_redetected[frame_num - 1 - warm_start]:
+                            synchronized = True
+                            break
+
+                if synchronized:
+                    camera_movement.extend(movements[frame_num - start + offset:])
+                    redetected.extend(chunk_redetected[frame_num - start + offset:])
+                    state = chunk_state
+
+                if progress is not None:
+                    progress(stop - start)
 
         return camera_movement
     
@@ -183,16 +370,29 @@ class CameraMovementEstimator():
 
         for frame_num, frame in enumerate(frames):
             frame= frame.copy()
+            frame = self.draw_frame_camera_movement(frame, camera_movement_per_frame[frame_num])
+            output_frames.append(frame) 
 
-            overlay = frame.copy()
-            cv2.rectangle(overlay,(0,0),(500,100),(255,255,255),-1)
-            alpha =0.6
-            cv2.addWeighted(overlay,alpha,frame,1-alpha,0,frame)
+        return output_frames
 
-            x_movement, y_movement = camera_movement_per_frame[frame_num]
-            frame = cv2.putText(frame,f"Camera Movement X: {x_movement:.2f}",(10,30), cv2.FONT_HERSHEY_SIMPLEX,1,(0,0,0),3)
-            frame = cv2.putText(frame,f"Camera Movement Y: {y_movement:.2f}",(10,60), cv2.FONT_HERSHEY_SIMPLEX,1,(0,0,0),3)
+    def draw_frame_camera_movement(self, frame, camera_movement):
+        """
+        Draw the camera movement overlay on a single frame in place.
+        
+        Args:
+            frame: Video frame to draw on (modified in place)
+            camera_movement: [dx, dy] movement for this frame
+            
+        Returns:
+            The annotated frame
+        """
+        overlay = frame.copy()
+        cv2.rectangle(overlay,(0,0),(500,100),(255,255,255),-1)
+        alpha =0.6
+        cv2.addWeighted(overlay,alpha,frame,1-alpha,0,frame)
 
-            output_frames.append(frame) 
+        x_movement, y_movement = camera_movement
+        frame = cv2.putText(frame,f"Camera Movement X: {x_movement:.2f}",(10,30), cv2.FONT_HERSHEY_SIMPLEX,1,(0,0,0),3)
+        frame = cv2.putText(frame,f"Camera Movement Y: {y_movement:.2f}",(10,60), cv2.FONT_HERSHEY_SIMPLEX,1,(0,0,0),3)
 
-        return output_frames
\ No newline at end of file
+        return frame
\ No newline at end of file
@@ -16,7 +16,7 @@
 6. 計算球員速度和移動距離
 7. 確定每個隊伍的控球權
 8. 用邊界框、標籤和統計數據標註影片
-9. 將結果匯出為影片（AVI）、CSV 和 JSON
+9. 將結果匯出為影片（預設 H.264 MP4）、CSV、JSON 和二進位追蹤遙測（tracks.ftrk）
 
 匯入模組：
 - utils: 影片輸入/輸出、邊界框工具、資料輸出
@@ -26,6 +26,19 @@
 - camera_movement_estimator: 相機運動的光流法
 - view_transformer: 透視轉換
 - speed_and_distance_estimator: 指標計算
+- track_store: 以欄位陣列儲存所有追蹤資料（偵測之後的各階段都在其上運算）
+- annotation_renderer: 單遍、多執行緒的影片標註繪製
+
+階段快取：
+偵測之後的階段組成相依圖（utils/stage_graph.py），每個階段的輸出以其輸入
+和參數為鍵存入存根快取。只改變下游參數（例如 PlayerBallAssigner 的
+max_player_ball_distance 或 ViewTransformer 的頂點）時，重新執行只計算
+失效的階段；哪些階段命中快取會記錄在日誌並以 stage_cache 事件回報。
+
+效能記錄：
+每個階段都有一筆效能記錄（牆鐘時間、CPU 時間、峰值記憶體增量、每秒幀數，
+見 utils/stage_metrics.py），階段完成時以 stage_metrics 事件送出；偵測另外
+分開計時解碼、推論和追蹤更新。執行結束時全部寫入輸出目錄的 performance.json。
 
 使用方式：
 由 Qt GUI 透過 QProcess 呼叫：
@@ -38,6 +51,8 @@
 
 import os
 import sys
+import json
+import time
 import logging
 import argparse
 from pathlib import Path
@@ -47,13 +62,19 @@ import cv2
 import numpy as np
 
 # 匯入影片分析管道的自訂模組
-from utils import read_video, save_video, output_data
-from trackers import Tracker
+from utils import (iter_video, get_video_properties, BackgroundVideoWriter,
+                   VIDEO_CODECS, DEFAULT_VIDEO_CODEC, video_extension,
+                   output_data, output_frame_data, summarize_data, ProgressReporter,
+                   StubCache, DEFAULT_CACHE_DIR, AnalysisCancelled, Stage, StageGraph)
+from trackers import Tracker, DETECTION_BACKENDS
 from team_assigner import TeamAssigner
-from player_ball_assigner import PlayerBallAssigner
+from player_ball_assigner import PlayerBallAssigner, PossessionStats
 from camera_movement_estimator import CameraMovementEstimator
 from view_transformer import ViewTransformer
-from speed_and_distance_estimator import SpeedAndDistance_Estimator
+from speed_and_distance_estimator import (SpeedAndDistance_Estimator, SPEED_MODES,
+                                          DEFAULT_FRAME_RATE)
+from track_store import TrackStore, TrackStoreBuilder, PLAYER, BALL, write_telemetry
+from annotation_renderer import AnnotationRenderer
 
 # 設定管道監控的日誌記錄
 logging.basicConfig(
@@ -62,6 +83,12 @@ logging.basicConfig(
 )
 logger = logging.getLogger(__name__)
 
+# 串流第一遍儲存檢查點的間隔（秒）
+CHECKPOINT_INTERVAL = 60.0
+
+# 串流第一遍送出部分結果快照的間隔（秒）
+SNAPSHOT_INTERVAL = 30.0
+
 
 ################################################################################
 # 影片分析管道類別
@@ -80,7 +107,21 @@ class VideoAnalysisPipeline:
                  input_video_path: str,
                  model_path: str,
                  output_dir: str = 'output_videos',
-                 use_stubs: bool = True):
+                 use_stubs: bool = True,
+                 streaming: bool = False,
+                 progress: Optional[ProgressReporter] = None,
+                 tracker: Optional[Tracker] = None,
+                 cache: Optional[StubCache] = None,
+                 speed_window: int = 5,
+                 speed_mode: str = 'window',
+                 camera_proxy_scale: float = 1.0,
+                 video_codec: str = DEFAULT_VIDEO_CODEC,
+                 detection_backend: str = 'ultralytics',
+                 int8: bool = False,
+                 batch_size: int = 20,
+                 keyframe_stride: int = 1,
+                 render_video: bool = True,
+                 threads: int = 0):
         """
         初始化影片分析管道。
         
@@ -88,12 +129,43 @@ class VideoAnalysisPipeline:
             input_video_path: 輸入影片檔案的路徑
             model_path: YOLO 模型檔案的路徑
             output_dir: 輸出檔案的目錄
-            use_stubs: 是否使用快取存根檔案以加快處理速度
+            use_stubs: 是否使用內容定址的存根快取（相同影片和模型時略過偵測）
+            streaming: 是否使用兩遍串流模式（影格不常駐記憶體）
+            progress: 進度事件回報器（None 表示不輸出進度事件）
+            tracker: 已載入模型的追蹤器（由常駐工作程序重複使用），None 表示自行載入
+            cache: 存根快取（None 表示使用預設目錄 stubs/cache）
+            speed_window: 速度計算的幀窗口大小
+            speed_mode: 速度計算模式（'window'、'sliding' 或 'smoothed'）
+            camera_proxy_scale: 相機移動光流所用灰階代理影像的縮放比例（0 < s <= 1）
+            video_codec: 輸出影片編碼器（VIDEO_CODECS 的鍵，例如 'h264'、'xvid'）
+            detection_backend: 偵測後端（'ultralytics' 或 'onnx'，即 ONNX Runtime CPU）
+            int8: 是否使用 INT8 量化模型（僅 onnx 後端）
+            batch_size: 每批偵測的影格數
+            keyframe_stride: 每 K 幀偵測一次，其間的邊界框以插值補齊（1 表示每幀偵測）
+            render_video: 是否繪製並編碼註解影片（False 時只輸出資料和追蹤遙測，
+                          由 GUI 在原始影片上即時繪製疊加層）
+            threads: 執行緒預算（GUI 同時執行多個工作時由排程器分配），用於相機移動
+                     分段估計和註解繪製；0 表示 OpenCV 的執行緒數
         """
         self.input_video_path = input_video_path
         self.model_path = model_path
         self.output_dir = output_dir
         self.use_stubs = use_stubs
+        self.streaming = streaming
+        self.progress = progress if progress is not None else ProgressReporter(enabled=False)
+        self.metrics = self.progress.metrics
+        self.tracker = tracker
+        self.stub_cache = (cache if cache is not None else StubCache()) if use_stubs else None
+        self.speed_window = speed_window
+        self.speed_mode = speed_mode
+        self.camera_proxy_scale = camera_proxy_scale
+        self.video_codec = video_codec
+        self.detection_backend = detection_backend
+        self.int8 = int8
+        self.batch_size = batch_size
+        self.keyframe_stride = keyframe_stride
+        self.render_video = render_video
+        self.threads = threads
         
         # 提早驗證輸入（快速失敗）
         self._validate_inputs()
@@ -109,6 +181,24 @@ class VideoAnalysisPipeline:
                 f"Input video not found: {self.input_video_path}"
             )
         
+        # 檢查速度計算設定
+        if self.speed_mode not in SPEED_MODES:
+            raise ValueError(f"Unknown speed mode: {self.speed_mode}")
+        if self.speed_window < 1:
+            raise ValueError(f"Speed window must be at least 1 frame: {self.speed_window}")
+        if not 0 < self.camera_proxy_scale <= 1:
+            raise ValueError(f"Camera proxy scale must be in (0, 1]: {self.camera_proxy_scale}")
+        if self.video_codec not in VIDEO_CODECS:
+            raise ValueError(f"Unknown video codec: {self.video_codec}")
+        if self.detection_backend not in DETECTION_BACKENDS:
+            raise ValueError(f"Unknown detection backend: {self.detection_backend}")
+        if self.int8 and self.detection_backend != 'onnx':
+            raise ValueError("INT8 inference requires the onnx backend")
+        if self.batch_size < 1:
+            raise ValueError(f"Batch size must be at least 1 frame: {self.batch_size}")
+        if self.keyframe_stride < 1:
+            raise ValueError(f"Keyframe stride must be at least 1 frame: {self.keyframe_stride}")
+        
         # 檢查模型檔案
         if not os.path.exists(self.model_path):
             raise FileNotFoundError(
@@ -139,7 +229,10 @@ class VideoAnalysisPipeline:
         """讀取影片幀並進行錯誤處理。"""
         try:
             logger.info(f"Reading video: {self.input_video_path}")
-            frames = read_video(self.input_video_path)
+            frame_count = get_video_properties(self.input_video_path)['frame_count']
+            frames = list(self.progress.track(
+                iter_video(self.input_video_path), 'read_video', frame_count
+            ))
             
             if not frames:
                 raise ValueError("No frames read from video")
@@ -160,9 +253,19 @@ class VideoAnalysisPipeline:
         載入 YOLO 模型並設定 ByteTrack 進行物件追蹤。
         追蹤器將偵測球員、裁判、守門員和球。
         """
+        if self.tracker is not None:
+            # 重複使用已載入的模型，只重設追蹤狀態
+            logger.info("Reusing loaded tracker")
+            self.tracker.keyframe_stride = self.keyframe_stride
+            self.tracker.reset_tracking()
+            return self.tracker
+        
         try:
-            logger.info("Initializing tracker")
-            tracker = Tracker(self.model_path)
+            logger.info(f"Initializing tracker ({self.detection_backend} backend)")
+            with self.progress.stage('load_model'):
+                tracker = Tracker(self.model_path, backend=self.detection_backend,
+                                  int8=self.int8, batch_size=self.batch_size,
+                                  keyframe_stride=self.keyframe_stride)
             return tracker
         except Exception as e:
             raise RuntimeError(f"Failed to initialize tracker: {e}")
@@ -173,63 +276,95 @@ class VideoAnalysisPipeline:
     
     def _get_object_tracks(self, 
                           tracker: Tracker, 
-                          frames: List[np.ndarray]) -> Dict[str, Any]:
+                          frames: List[np.ndarray],
+                          graph: StageGraph) -> TrackStore:
         """
         偵測並追蹤所有物件（球員、裁判、球）跨幀。
         
         使用 YOLO 進行偵測，使用 ByteTrack 進行多物件追蹤。
-        支援存根快取，以便在相同影片上更快地重複執行。
+        快取鍵包含影片內容、模型雜湊和偵測參數，
+        重新分析相同影片時完全略過偵測。
+        
+        推論和追蹤更新分開計時（detection 階段的 inference / tracking 部分）。
         
-        返回：包含鍵值 'players'、'referees'、'ball' 的字典
-             每個鍵包含逐幀的追蹤資料
+        返回：包含所有幀所有物件的 TrackStore（欄位陣列）
         """
         try:
-            stub_path = 'stubs/track_stubs.pkl' if self.use_stubs else None
             logger.info("Getting object tracks")
             
-            tracks = tracker.get_object_tracks(
-                frames,
-                read_from_stub=self.use_stubs,
-                stub_path=stub_path
-            )
-            
-            if not tracks or 'players' not in tracks:
-                raise ValueError("Invalid tracks data structure")
+            cache_key = self._tracks_cache_key(tracker)
+            columns = self._load_cached(cache_key)
+            graph.add_source('tracks', cache_key, hit=columns is not None)
+            if columns is not None:
+                store = TrackStore.from_columns(columns)
+            else:
+                builder = TrackStoreBuilder()
+                with self.progress.stage('detection', len(frames)):
+                    detections = self.metrics.timed(tracker.iter_detections(frames), 'inference')
+                    for _, detection in detections:
+                        with self.metrics.part('tracking'):
+                            builder.append_frame(tracker.track_detection(detection))
+                        self.progress.advance()
+                store = builder.build()
+                self._fill_keyframe_gaps(tracker, store)
+                self._save_cached(cache_key, store.detection_columns())
             
-            logger.info("Object tracking complete")
-            return tracks
+            logger.info(f"Object tracking complete ({len(store)} object observations)")
+            return store
         except Exception as e:
             raise RuntimeError(f"Failed to get object tracks: {e}")
     
+    def _fill_keyframe_gaps(self, tracker: Tracker, store: TrackStore) -> None:
+        """
+        關鍵幀模式：補齊關鍵幀之間的球員和裁判邊界框，並回報偵測了多少幀。
+        
+        準確度的代價可用 benchmarks/keyframe_stride.py 與逐幀偵測比較。
+        """
+        if tracker.keyframe_stride <= 1:
+            return
+        added = tracker.fill_keyframe_gaps_in_store(store)
+        stats = tracker.keyframe_stats
+        frames = max(stats['frames'], 1)
+        keyframes = max(stats['keyframes'], 1)
+        logger.info(
+            f"Keyframe detection: {stats['keyframes']} of {stats['frames']} frames detected "
+            f"({frames / keyframes:.1f}x fewer; stride {stats['stride']}, "
+            f"camera motion {stats['camera_motion']}, track loss {stats['track_loss']}), "
+            f"{added} boxes interpolated"
+        )
+    
     # =========================================================================
     # 相機移動補償
     # =========================================================================
     
     def _process_camera_movement(self,
                                  frames: List[np.ndarray],
-                                 tracks: Dict[str, Any]) -> List[np.ndarray]:
+                                 graph: StageGraph) -> List[np.ndarray]:
         """
-        使用光流估計和補償相機移動。
+        使用光流估計相機移動。
         
         追蹤影片中的特徵點以偵測相機的平移、傾斜和縮放。
-        調整所有物件位置以考慮相機移動，使得
-        能夠準確計算速度和距離。
+        物件位置的補償是相依圖中的 camera_adjustment 階段，
+        使得能夠準確計算速度和距離。
         
         返回：每幀的相機移動作為 [dx, dy] 陣列
         """
         try:
             logger.info("Processing camera movement")
             
-            estimator = CameraMovementEstimator(frames[0])
-            stub_path = 'stubs/camera_movement_stub.pkl' if self.use_stubs else None
-            
-            camera_movement = estimator.get_camera_movement(
-                frames,
-                read_from_stub=self.use_stubs,
-                stub_path=stub_path
-            )
+            cache_key = self._camera_cache_key()
+            camera_movement = self._load_cached(cache_key)
+            graph.add_source('camera_movement', cache_key, hit=camera_movement is not None)
+            if camera_movement is None:
+                estimator = CameraMovementEstimator(frames[0], proxy_scale=self.camera_proxy_scale,
+                                                    workers=self.threads)
+                # 傳入影格列表，讓估計器分段平行處理
+                with self.progress.stage('camera_movement', len(frames)) as progress:
+                    camera_movement = estimator.get_camera_movement(
+                        frames, progress=progress.advance
+                    )
+                self._save_cached(cache_key, camera_movement)
             
-            estimator.add_adjust_positions_to_tracks(tracks, camera_movement)
             logger.info("Camera movement processing complete")
             
             return camera_movement
@@ -240,7 +375,7 @@ class VideoAnalysisPipeline:
     # 透視轉換
     # =========================================================================
     
-    def _process_view_transformation(self, tracks: Dict[str, Any]) -> None:
+    def _process_view_transformation(self, transformer: ViewTransformer, store: TrackStore) -> None:
         """
         應用透視轉換將像素座標轉換為真實世界座標。
         
@@ -249,8 +384,8 @@ class VideoAnalysisPipeline:
         """
         try:
             logger.info("Applying view transformation")
-            transformer = ViewTransformer()
-            transformer.add_transformed_position_to_tracks(tracks)
+            with self.progress.stage('view_transform', store.frame_count):
+                transformer.add_transformed_position_to_store(store)
             logger.info("View transformation complete")
         except Exception as e:
             raise RuntimeError(f"Failed to apply view transformation: {e}")
@@ -261,7 +396,7 @@ class VideoAnalysisPipeline:
     
     def _interpolate_ball_positions(self, 
                                     tracker: Tracker,
-                                    tracks: Dict[str, Any]) -> None:
+                                    store: TrackStore) -> None:
         """
         使用插值填補缺失的球偵測。
         
@@ -271,7 +406,8 @@ class VideoAnalysisPipeline:
         """
         try:
             logger.info("Interpolating ball positions")
-            tracks["ball"] = tracker.interpolate_ball_positions(tracks["ball"])
+            with self.progress.stage('ball_interpolation', store.frame_count):
+                tracker.interpolate_ball_positions_in_store(store)
             logger.info("Ball position interpolation complete")
         except Exception as e:
             raise RuntimeError(f"Failed to interpolate ball positions: {e}")
@@ -280,7 +416,17 @@ class VideoAnalysisPipeline:
     # 效能指標
     # =========================================================================
     
-    def _estimate_speed_and_distance(self, tracks: Dict[str, Any]) -> None:
+    def _speed_estimator(self) -> SpeedAndDistance_Estimator:
+        """以影片幀率和 speed_window / speed_mode 建立速度估計器。"""
+        frame_rate = get_video_properties(self.input_video_path)['fps']
+        return SpeedAndDistance_Estimator(
+            frame_rate=frame_rate,
+            frame_window=self.speed_window,
+            mode=self.speed_mode
+        )
+    
+    def _estimate_speed_and_distance(self, estimator: SpeedAndDistance_Estimator,
+                                     store: TrackStore) -> None:
         """
         計算球員速度和移動距離。
         
@@ -288,12 +434,18 @@ class VideoAnalysisPipeline:
         - 每幀每個球員的速度（公里/小時）
         - 每個球員移動的總距離（公尺）
         
-        這些指標會新增到追蹤字典中並顯示在輸出中。
+        幀率取自影片容器（無法取得時使用 24 fps），
+        窗口大小和模式由 speed_window / speed_mode 設定。
+        
+        這些指標會寫入 TrackStore 的 speed / distance 欄位並顯示在輸出中。
         """
         try:
-            logger.info("Calculating speed and distance")
-            estimator = SpeedAndDistance_Estimator()
-            estimator.add_speed_and_distance_to_tracks(tracks)
+            logger.info(
+                f"Calculating speed and distance ({estimator.mode} mode, "
+                f"{estimator.frame_window}-frame window, {estimator.frame_rate:g} fps)"
+            )
+            with self.progress.stage('speed_and_distance', store.frame_count):
+                estimator.add_speed_and_distance_to_store(store)
             logger.info("Speed and distance calculation complete")
         except Exception as e:
             raise RuntimeError(f"Failed to calculate speed and distance: {e}")
@@ -304,7 +456,7 @@ class VideoAnalysisPipeline:
     
     def _assign_teams(self, 
                      frames: List[np.ndarray],
-                     tracks: Dict[str, Any]) -> TeamAssigner:
+                     store: TrackStore) -> TeamAssigner:
         """
         根據球衣顏色將球員分類到隊伍。
         
@@ -312,137 +464,130 @@ class VideoAnalysisPipeline:
         分析球員邊界框的上半部分（球衣可見的地方）
         以提取主要顏色並分配隊伍成員資格。
         
+        球員的隊伍在第一次出現時決定並快取，
+        因此只需處理每個球員第一次出現的那一列。
+        
         返回：具有隊伍顏色分配的 TeamAssigner 實例
         """
         try:
             logger.info("Assigning player teams")
             
-            if not tracks['players'] or not tracks['players'][0]:
+            first_frame_players = store.frame_dict(0, PLAYER) if store.frame_count else {}
+            if not first_frame_players:
                 raise ValueError("No players detected in first frame")
             
             assigner = TeamAssigner()
-            assigner.assign_team_color(frames[0], tracks['players'][0])
-            
-            for frame_num, player_track in enumerate(tracks['players']):
-                for player_id, track in player_track.items():
-                    team = assigner.get_player_team(
-                        frames[frame_num],
-                        track['bbox'],
-                        player_id
-                    )
-                    tracks['players'][frame_num][player_id]['team'] = team
-                    tracks['players'][frame_num][player_id]['team_color'] = \
-                        assigner.team_colors[team]
+            assigner.assign_team_color(frames[0], first_frame_players)
+            
+            # 依幀分組，每幀的新球員一次批次處理
+            first_rows = store.first_rows(PLAYER)
+            frame_numbers, starts = np.unique(store.frame[first_rows], return_index=True)
+            groups = np.split(first_rows, starts[1:])
+            for frame_num, rows in self.progress.track(
+                list(zip(frame_numbers, groups)), 'team_assignment'
+            ):
+                assigner.get_player_teams(
+                    frames[frame_num], store.bbox[rows], store.track_id[rows].tolist()
+                )
+            assigner.add_team_to_store(store)
             
             logger.info("Team assignment complete")
             return assigner
         except Exception as e:
             raise RuntimeError(f"Failed to assign teams: {e}")
     
-    def _assign_ball_possession(self, tracks: Dict[str, Any]) -> np.ndarray:
-        """確定每幀的控球權。"""
+    @staticmethod
+    def _assign_frame_teams(assigner: TeamAssigner,
+                            frame: np.ndarray,
+                            player_track: Dict[int, Any]) -> None:
+        """為單一幀中第一次出現的球員批次決定隊伍（結果快取在 assigner 中）。"""
+        new_ids = [player_id for player_id in player_track
+                   if player_id not in assigner.player_team_dict]
+        if new_ids:
+            assigner.get_player_teams(
+                frame, [player_track[player_id]['bbox'] for player_id in new_ids], new_ids
+            )
+    
+    def _assign_ball_possession(self, assigner: PlayerBallAssigner,
+                                store: TrackStore) -> np.ndarray:
+        """
+        確定每幀的控球權（所有幀一次計算），並寫入 has_ball 欄位。
+        
+        返回：每幀控球的隊伍（0 表示無）
+        """
         try:
             logger.info("Assigning ball possession")
             
-            assigner = PlayerBallAssigner()
-            team_ball_control = []
-            
-            for frame_num, player_track in enumerate(tracks['players']):
-                if 1 not in tracks['ball'][frame_num]:
-                    # 未偵測到球，使用先前的控球權
-                    if team_ball_control:
-                        team_ball_control.append(team_ball_control[-1])
-                    else:
-                        team_ball_control.append(0)
-                    continue
-                
-                ball_bbox = tracks['ball'][frame_num][1]['bbox']
-                assigned_player = assigner.assign_ball_to_player(
-                    player_track, 
-                    ball_bbox
-                )
-                
-                if assigned_player != -1:
-                    tracks['players'][frame_num][assigned_player]['has_ball'] = True
-                    team_ball_control.append(
-                        tracks['players'][frame_num][assigned_player]['team']
-                    )
-                else:
-                    # 無分配，使用先前的控球權
-                    if team_ball_control:
-                        team_ball_control.append(team_ball_control[-1])
-                    else:
-                        team_ball_control.append(0)
+            with self.progress.stage('ball_possession', store.frame_count):
+                team_ball_control = assigner.assign_ball_possession(store)
             
             logger.info("Ball possession assignment complete")
-            return np.array(team_ball_control)
+            return team_ball_control
         except Exception as e:
             raise RuntimeError(f"Failed to assign ball possession: {e}")
     
-    def _draw_annotations(self,
-                         tracker: Tracker,
-                         frames: List[np.ndarray],
-                         tracks: Dict[str, Any],
-                         team_ball_control: np.ndarray,
-                         camera_movement: List[np.ndarray]) -> List[np.ndarray]:
-        """在影片幀上繪製所有註解。"""
+    def _render_video(self,
+                      frames,
+                      frame_total: int,
+                      store: TrackStore,
+                      possession: PossessionStats,
+                      camera_movement: List[Any]) -> str:
+        """
+        繪製所有註解並在背景執行緒編碼輸出影片。
+        
+        標註器（執行緒池）產生的影格經有界佇列交給編碼執行緒，
+        繪製和編碼同時進行；輸出使用來源影片的幀率和所選編碼器。
+        等待編碼完成也計入 render 階段；解碼、繪製和交給編碼器
+        （佇列滿時等待）分開計時。
+        
+        參數：
+            frames: 影格列表（記憶體模式）或解碼器（串流模式），原地繪製
+            frame_total: 預期的幀數（進度回報用）
+        
+        返回：輸出影片路徑
+        """
         try:
-            logger.info("Drawing annotations")
-            
-            # 繪製物件追蹤
-            output_frames = tracker.draw_annotations(
-                frames, 
-                tracks, 
-                team_ball_control
-            )
-            
-            # 繪製相機移動
-            estimator = CameraMovementEstimator(frames[0])
-            output_frames = estimator.draw_camera_movement(
-                output_frames,
-                camera_movement
-            )
-            
-            # 繪製速度和距離
-            speed_estimator = SpeedAndDistance_Estimator()
-            speed_estimator.draw_speed_and_distance(output_frames, tracks)
+            output_path = os.path.join(self.output_dir,
+                                       'output_video' + video_extension(self.video_codec))
+            fps = self._output_frame_rate()
+            logger.info(f"Rendering to {output_path} ({self.video_codec}, {fps:g} fps)")
             
-            logger.info("Annotation drawing complete")
-            return output_frames
-        except Exception as e:
-            raise RuntimeError(f"Failed to draw annotations: {e}")
-    
-    def _save_output_video(self, frames: List[np.ndarray]) -> str:
-        """儲存輸出影片並進行健全的錯誤處理。"""
-        try:
-            output_path = os.path.join(self.output_dir, 'output_video.avi')
-            logger.info(f"Saving output video to: {output_path}")
-            
-            if not frames:
-                raise ValueError("No frames to save")
-            
-            save_video(frames, output_path)
-            
-            # 驗證輸出檔案是否已建立
-            if not os.path.exists(output_path):
-                raise IOError("Output video file was not created")
+            renderer = AnnotationRenderer(store, possession, camera_movement, workers=self.threads)
+            frames = self.metrics.timed(frames, 'decode')
+            with self.progress.stage('render', frame_total):
+                with BackgroundVideoWriter(output_path, fps=fps, codec=self.video_codec) as writer:
+                    for frame in self.metrics.timed(renderer.render_stream(frames), 'draw'):
+                        with self.metrics.part('encode'):
+                            writer.write(frame)
+                        self.progress.advance()
             
             file_size = os.path.getsize(output_path)
             logger.info(
-                f"Output video saved successfully ({file_size / 1024 / 1024:.2f} MB)"
+                f"Output video saved successfully ({writer.frames_written} frames, "
+                f"{file_size / 1024 / 1024:.2f} MB)"
             )
-            
             return output_path
         except Exception as e:
-            raise RuntimeError(f"Failed to save output video: {e}")
+            raise RuntimeError(f"Failed to render output video: {e}")
     
-    def _save_output_data(self, tracks: Dict[str, Any], team_ball_control: np.ndarray) -> str:
-        """儲存輸出資料並進行錯誤處理。"""
+    def _output_frame_rate(self) -> float:
+        """輸出影片的幀率：來源影片的幀率（無法取得時使用 24 fps）。"""
+        fps = get_video_properties(self.input_video_path)['fps']
+        return fps if fps > 0 else DEFAULT_FRAME_RATE
+    
+    def _save_output_data(self, store: TrackStore, possession: PossessionStats) -> str:
+        """儲存輸出資料（球員摘要、逐幀資料與二進位追蹤遙測）並進行錯誤處理。"""
         try:
             output_path = os.path.join(self.output_dir, 'data_output.json')
             logger.info(f"Saving output data to: {output_path}")
             
-            output_data(tracks, output_path, team_ball_control)
+            with self.progress.stage('save_data', store.frame_count):
+                output_data(store, output_path, possession=possession)
+                output_frame_data(store, self._frame_data_path())
+                telemetry_size = write_telemetry(store, self._telemetry_path(),
+                                                 fps=self._output_frame_rate())
+            logger.info(f"Track telemetry saved: {self._telemetry_path()} "
+                        f"({len(store)} rows, {telemetry_size / 1024 / 1024:.2f} MB)")
             
             # 驗證輸出檔案是否已建立
             if not os.path.exists(output_path):
@@ -457,62 +602,536 @@ class VideoAnalysisPipeline:
         except Exception as e:
             raise RuntimeError(f"Failed to save output data: {e}")
     
-    def run(self) -> None:
-        """執行完整的影片分析管道。"""
+    def _outputs(self, video_path: Optional[str], data_path: str) -> Dict[str, Optional[str]]:
+        """輸出檔案路徑（run() 的返回值，也隨部分結果快照送出）。"""
+        return {'video': video_path, 'data': data_path,
+                'frame_data': self._frame_data_path(),
+                'telemetry': self._telemetry_path()}
+    
+    def _emit_snapshot(self, stage: str,
+                       store: TrackStore,
+                       possession: Optional[PossessionStats] = None,
+                       outputs: Optional[Dict[str, Optional[str]]] = None) -> None:
+        """
+        送出部分結果快照（格式見 utils/progress.py），讓 GUI 在分析仍在執行時
+        顯示目前的球員距離和控球統計。
+        
+        資料與 data_output.json 相同（每名球員最後的累計距離，以欄位運算取得）。
+        快照失敗只記錄警告，不影響分析。
+        """
+        if not self.progress.enabled:
+            return
         try:
-            logger.info("="*60)
-            logger.info("Starting Football Analysis Pipeline")
-            logger.info("="*60)
+            data = summarize_data(store, possession)
+        except Exception as e:
+            logger.warning(f"Failed to build result snapshot: {e}")
+            return
+        self.progress.snapshot(stage, data, store.frame_count, outputs)
+    
+    def _emit_running_snapshot(self, tracker: Tracker,
+                               store: TrackStore,
+                               camera_estimator: CameraMovementEstimator,
+                               camera_movement: List[Any],
+                               team_assigner: TeamAssigner) -> None:
+        """
+        串流第一遍進行中的部分結果快照：在到目前為止的影格上執行後處理
+        （位置、相機補償、透視轉換、球插值、速度和距離、隊伍、控球），
+        讓 GUI 在偵測期間就顯示累計的距離和控球統計。
+        
+        直接呼叫各元件，不回報階段進度也不寫入階段快取；
+        計時記在 analysis 階段的 snapshot 部分。失敗只記錄警告。
+        """
+        try:
+            with self.metrics.part('snapshot', frames=0):
+                tracker.fill_keyframe_gaps_in_store(store)
+                tracker.add_position_to_store(store)
+                camera_estimator.add_adjust_positions_to_store(store, camera_movement)
+                ViewTransformer().add_transformed_position_to_store(store)
+                tracker.interpolate_ball_positions_in_store(store)
+                self._speed_estimator().add_speed_and_distance_to_store(store)
+                team_assigner.add_team_to_store(store)
+                team_ball_control = PlayerBallAssigner().assign_ball_possession(store)
+                possession = PossessionStats(team_ball_control, store)
+        except Exception as e:
+            logger.warning(f"Failed to build running snapshot: {e}")
+            return
+        self._emit_snapshot('analysis', store, possession)
+    
+    def _save_performance(self) -> Optional[str]:
+        """
+        將各階段的效能記錄寫入 performance.json（格式見 utils/stage_metrics.py），
+        供 GUI 的效能選項卡顯示並與前一次執行比較。
+        
+        寫入失敗只記錄警告，不影響分析。返回：檔案路徑，失敗時為 None
+        """
+        path = os.path.join(self.output_dir, 'performance.json')
+        report = {
+            'video': os.path.abspath(self.input_video_path),
+            'finished': time.strftime('%Y-%m-%dT%H:%M:%S'),
+            'mode': 'streaming' if self.streaming else 'in_memory',
+            'backend': self.detection_backend,
+            'int8': self.int8,
+            'batch_size': self.batch_size,
+            'keyframe_stride': self.keyframe_stride,
+            'render_video': self.render_video,
+        }
+        report.update(self.metrics.report())
+        try:
+            with open(path, 'w', encoding='utf-8') as f:
+                json.dump(report, f, indent=2)
+        except OSError as e:
+            logger.warning(f"Failed to save performance records: {e}")
+            return None
+        
+        slowest = sorted(report['stages'], key=lambda record: record['wall'], reverse=True)[:3]
+        logger.info(f"Run took {report['total_wall']:.1f} s; slowest stages: " + ", ".join(
+            f"{record['stage']} {record['wall']:.1f} s" for record in slowest))
+        return path
+    
+    def _frame_data_path(self) -> str:
+        """逐幀資料 CSV 的路徑（每名球員每幀一列，供 GUI 資料表分頁讀取）。"""
+        return os.path.join(self.output_dir, 'frame_data.csv')
+    
+    def _telemetry_path(self) -> str:
+        """完整追蹤表的二進位遙測檔路徑（格式見 track_store/telemetry.py）。"""
+        return os.path.join(self.output_dir, 'tracks.ftrk')
+    
+    # =========================================================================
+    # 存根快取
+    # =========================================================================
+    
+    def _cache_key(self, kind: str, model_path: Optional[str] = None,
+                   params: Optional[Dict[str, Any]] = None) -> Optional[str]:
+        """計算快取鍵；未啟用快取或無法計算時返回 None。"""
+        if self.stub_cache is None:
+            return None
+        try:
+            return self.stub_cache.make_key(kind, self.input_video_path, model_path, params)
+        except OSError as e:
+            logger.warning(f"Stub cache disabled for {kind}: {e}")
+            return None
+    
+    def _tracks_cache_key(self, tracker: Tracker) -> Optional[str]:
+        """追蹤結果的快取鍵：影片 + 模型 + 偵測參數。"""
+        return self._cache_key('tracks/v2', self.model_path, tracker.cache_params())
+    
+    def _camera_cache_key(self) -> Optional[str]:
+        """相機移動的快取鍵：影片、估計器版本和代理影像縮放比例。"""
+        return self._cache_key(f'camera_movement/v{CameraMovementEstimator.CACHE_VERSION}',
+                               params={'proxy_scale': self.camera_proxy_scale})
+    
+    def _checkpoint_cache_key(self, tracker: Tracker) -> Optional[str]:
+        """串流第一遍檢查點的快取鍵：與追蹤結果相同的偵測參數，加上相機代理縮放比例。"""
+        params = dict(tracker.cache_params(), batch_size=tracker.batch_size,
+                      proxy_scale=self.camera_proxy_scale)
+        return self._cache_key('checkpoint/v1', self.model_path, params)
+    
+    def _load_cached(self, cache_key: Optional[str]) -> Optional[Any]:
+        """讀取快取項目；未命中時返回 None。"""
+        if cache_key is None:
+            return None
+        return self.stub_cache.load(cache_key)
+    
+    def _save_cached(self, cache_key: Optional[str], data: Any) -> None:
+        """寫入快取項目（原子寫入，超出大小上限時淘汰最久未使用的項目）。"""
+        if cache_key is not None:
+            self.stub_cache.save(cache_key, data)
+    
+    # =========================================================================
+    # 階段相依圖
+    # =========================================================================
+    
+    def _teams_stage(self, run, store: TrackStore) -> Stage:
+        """
+        隊伍分配階段：只依賴追蹤結果（球員第一次出現的影格）。
+        
+        串流模式在第一遍逐幀分配，記憶體模式以第一幀建立隊伍顏色，
+        兩者結果不同，所以模式是參數之一。
+        """
+        return Stage('team_assignment', run, inputs=('tracks',),
+                     params={'mode': 'streaming' if self.streaming else 'in_memory'},
+                     columns=('team',),
+                     save=lambda: dict(store.team_colors),
+                     restore=lambda colors: setattr(store, 'team_colors', colors))
+    
+    def _load_cached_analysis(self, tracker: Tracker, graph: StageGraph):
+        """
+        追蹤結果、相機移動和隊伍分配都已快取時直接載入（串流模式不必解碼第一遍）。
+        
+        返回：(store, camera_movement)；任何一項未快取時返回 (None, None)
+        """
+        track_key = self._tracks_cache_key(tracker)
+        camera_key = self._camera_cache_key()
+        columns = self._load_cached(track_key)
+        camera_movement = self._load_cached(camera_key) if columns is not None else None
+        if camera_movement is None:
+            return None, None
+        
+        store = TrackStore.from_columns(columns)
+        graph.add_source('tracks', track_key, hit=True)
+        graph.add_source('camera_movement', camera_key, hit=True)
+        found, _ = graph.load(self._teams_stage(None, store), store)
+        if not found:
+            graph.reset()
+            return None, None
+        logger.info("Tracks, camera movement and teams cached, skipping streaming pass 1")
+        return store, camera_movement
+    
+    def _run_post_detection_stages(self, graph: StageGraph, tracker: Tracker,
+                                   store: TrackStore, camera_movement: List[Any],
+                                   first_frame) -> None:
+        """
+        依相依圖執行不需要影格的階段：
+        位置 → 相機補償 → 透視轉換 → 球插值 → 速度和距離。
+        
+        每個階段的輸出以其輸入的快取鍵和自身參數為鍵快取，
+        命中時直接套用到 store，只有失效的階段重新計算。
+        
+        參數：
+            first_frame: 返回第一幀的函式（相機補償階段未命中時才用來建立估計器）
+        """
+        transformer = ViewTransformer()
+        speed_estimator = self._speed_estimator()
+        
+        def positions():
+            with self.progress.stage('positions', store.frame_count):
+                tracker.add_position_to_store(store)
+        
+        def adjust_camera():
+            with self.progress.stage('camera_adjustment', store.frame_count):
+                estimator = CameraMovementEstimator(first_frame(), proxy_scale=self.camera_proxy_scale)
+                estimator.add_adjust_positions_to_store(store, camera_movement)
+        
+        def ball_rows():
+            rows = store.class_rows(BALL)
+            return {'frame': store.frame[rows], 'bbox': store.bbox[rows]}
+        
+        graph.run(Stage('positions', positions, inputs=('tracks',), columns=('position',)), store)
+        graph.run(Stage('camera_adjustment', adjust_camera,
+                        inputs=('positions', 'camera_movement'),
+                        columns=('position_adjusted',)), store)
+        graph.run(Stage('view_transform',
+                        lambda: self._process_view_transformation(transformer, store),
+                        inputs=('camera_adjustment',),
+                        params={'pixel_vertices': transformer.pixel_vertices.tolist(),
+                                'target_vertices': transformer.target_vertices.tolist()},
+                        columns=('position_transformed',)), store)
+        graph.run(Stage('ball_interpolation',
+                        lambda: self._interpolate_ball_positions(tracker, store),
+                        inputs=('view_transform',),
+                        save=ball_rows,
+                        restore=lambda rows: store.replace_class(BALL, rows['frame'], 1, rows['bbox'])),
+                  store)
+        graph.run(Stage('speed_and_distance',
+                        lambda: self._estimate_speed_and_distance(speed_estimator, store),
+                        inputs=('ball_interpolation',),
+                        params={'frame_rate': speed_estimator.frame_rate,
+                                'frame_window': speed_estimator.frame_window,
+                                'mode': speed_estimator.mode},
+                        columns=('speed', 'distance')), store)
+    
+    def _run_possession_stage(self, graph: StageGraph, store: TrackStore) -> PossessionStats:
+        """
+        控球階段（依賴球插值和隊伍分配），並回報本次執行哪些階段命中快取。
+        
+        返回：控球統計（前綴和），供疊加層、資料匯出和 GUI 摘要共用
+        """
+        assigner = PlayerBallAssigner()
+        team_ball_control = graph.run(Stage(
+            'ball_possession', lambda: self._assign_ball_possession(assigner, store),
+            inputs=('ball_interpolation', 'team_assignment'),
+            params={'max_player_ball_distance': assigner.max_player_ball_distance},
+            columns=('has_ball',)), store)
+        
+        logger.info(graph.report())
+        self.progress.emit({'event': 'stage_cache', 'hits': graph.hits,
+                            'recomputed': graph.recomputed})
+        return PossessionStats(team_ball_control, store)
+    
+    # =========================================================================
+    # 串流模式（兩遍處理）
+    # =========================================================================
+    
+    def _streaming_analysis_pass(self, tracker: Tracker, graph: StageGraph):
+        """
+        第一遍：從解碼器逐幀執行偵測、追蹤、相機移動和隊伍分配。
+        
+        每次只有一個偵測批次的影格在記憶體中，處理完即丟棄；
+        追蹤結果逐幀附加到 TrackStoreBuilder 的緊湊緩衝區，
+        只保留追蹤資料和每幀的相機移動。
+        
+        需要偵測且啟用存根快取時，每 CHECKPOINT_INTERVAL 秒（以及取消時）
+        將目前的狀態存為檢查點；下次以相同影片、模型和參數執行時從檢查點的
+        影格繼續，完成後刪除檢查點。
+        
+        追蹤結果和相機移動登記為相依圖的來源，隊伍分配的結果存為
+        team_assignment 階段的快取項目。
+        
+        每 SNAPSHOT_INTERVAL 秒以到目前為止的影格送出部分結果快照
+        （累計的距離和控球，見 _emit_running_snapshot）。
+        
+        analysis 階段分開計時解碼、推論、追蹤更新、相機移動和隊伍分配。
+        
+        返回：(store, camera_movement)
+        """
+        try:
+            logger.info("Streaming pass 1: detection, tracking, camera movement, teams")
+            
+            track_key = self._tracks_cache_key(tracker)
+            camera_key = self._camera_cache_key()
+            
+            columns = self._load_cached(track_key)
+            camera_movement = self._load_cached(camera_key)
+            detect = columns is None
+            estimate_camera = camera_movement is None
+            graph.add_source('tracks', track_key, hit=not detect)
+            graph.add_source('camera_movement', camera_key, hit=not estimate_camera)
             
-            # 讀取影片
-            video_frames = self._read_video()
+            checkpoint_key = self._checkpoint_cache_key(tracker) if detect else None
+            checkpoint = self._load_cached(checkpoint_key)
+            if checkpoint is not None and checkpoint['estimate_camera'] != estimate_camera:
+                checkpoint = None
             
-            # 初始化追蹤器
-            tracker = self._initialize_tracker()
+            camera_estimator = None
+            team_assigner = TeamAssigner()
+            team_colors_ready = False
+            start_frame = 0
             
-            # 獲取物件追蹤
-            tracks = self._get_object_tracks(tracker, video_frames)
+            if checkpoint is not None:
+                logger.info(f"Resuming from checkpoint at frame {checkpoint['frame_count']}")
+                start_frame = checkpoint['frame_count']
+                builder = checkpoint['builder']
+                tracker.restore_tracking_state(checkpoint['tracking'])
+                team_assigner = checkpoint['team_assigner']
+                team_colors_ready = checkpoint['team_colors_ready']
+                if estimate_camera:
+                    camera_movement = checkpoint['camera_movement']
+            elif detect:
+                builder = TrackStoreBuilder()
+            else:
+                store = TrackStore.from_columns(columns)
+            if estimate_camera and checkpoint is None:
+                camera_movement = []
             
-            # 將位置新增到追蹤
-            tracker.add_position_to_tracks(tracks)
+            frames = self.metrics.timed(iter_video(self.input_video_path, start_frame), 'decode')
+            if detect:
+                stream = self.metrics.timed(tracker.iter_detections(frames), 'inference')
+            else:
+                stream = ((frame, None) for frame in frames)
+            frame_total = get_video_properties(self.input_video_path)['frame_count']
             
-            # 處理相機移動
-            camera_movement = self._process_camera_movement(video_frames, tracks)
+            frame_count = start_frame
             
-            # 應用視圖轉換
-            self._process_view_transformation(tracks)
+            def save_checkpoint():
+                # 關鍵影格模式在批次之間才一致（批次的關鍵影格在讀取時就已決定）
+                if tracker.keyframe_stride > 1 and (frame_count - start_frame) % tracker.batch_size:
+                    return False
+                self._save_cached(checkpoint_key, {
+                    'frame_count': frame_count,
+                    'builder': builder,
+                    'tracking': tracker.tracking_state(),
+                    'team_assigner': team_assigner,
+                    'team_colors_ready': team_colors_ready,
+                    'estimate_camera': estimate_camera,
+                    'camera_movement': camera_movement if estimate_camera else None,
+                    'camera_state': camera_estimator.state if camera_estimator else None,
+                })
+                return True
             
-            # 插值球位置
-            self._interpolate_ball_positions(tracker, tracks)
+            def partial_store():
+                # 目前為止的影格（建立副本，builder 繼續附加）
+                if detect:
+                    return builder.build()
+                keep = store.frame < frame_count
+                return TrackStore(store.frame[keep], store.track_id[keep],
+                                  store.cls[keep], store.bbox[keep], frame_count)
+            
+            last_checkpoint = time.monotonic()
+            last_snapshot = time.monotonic()
+            with self.progress.stage('analysis', frame_total, done=start_frame):
+                try:
+                    for frame_num, (frame, detection) in enumerate(stream, start_frame):
+                        if detect:
+                            with self.metrics.part('tracking'):
+                                frame_tracks = tracker.track_detection(detection)
+                                builder.append_frame(frame_tracks)
+                            player_track = frame_tracks['players']
+                        elif frame_num >= store.frame_count:
+                            logger.warning("Cached tracks are shorter than the video, stopping early")
+                            break
+                        else:
+                            player_track = store.frame_dict(frame_num, PLAYER)
+                        
+                        if camera_estimator is None:
+                            camera_estimator = CameraMovementEstimator(
+                                frame, proxy_scale=self.camera_proxy_scale
+                            )
+                            if checkpoint is not None:
+                                camera_estimator.state = checkpoint['camera_state']
+                        if estimate_camera:
+                            with self.metrics.part('camera_movement'):
+                                camera_movement.append(camera_estimator.update(frame))
+                        
+                        # 隊伍顏色在第一個有球員的幀上建立
+                        with self.metrics.part('team_assignment'):
+                            if not team_colors_ready and player_track:
+                                team_assigner.assign_team_color(frame, player_track)
+                                team_colors_ready = True
+                            if team_colors_ready:
+                                self._assign_frame_teams(team_assigner, frame, player_track)
+                        
+                        frame_count += 1
+                        
+                        if checkpoint_key and time.monotonic() - last_checkpoint >= CHECKPOINT_INTERVAL:
+                            if save_checkpoint():
+                                last_checkpoint = time.monotonic()
+                        
+                        if (self.progress.enabled and team_colors_ready
+                                and time.monotonic() - last_snapshot >= SNAPSHOT_INTERVAL):
+                            self._emit_running_snapshot(tracker, partial_store(), camera_estimator,
+                                                        camera_movement, team_assigner)
+                            last_snapshot = time.monotonic()
+                        
+                        self.progress.advance()
+                except AnalysisCancelled:
+                    if checkpoint_key and frame_count > start_frame and save_checkpoint():
+                        logger.info(f"Checkpoint saved at frame {frame_count}")
+                    raise
+            
+            if frame_count == 0:
+                raise ValueError("No frames read from video")
+            if not team_colors_ready:
+                raise ValueError("No players detected in video")
             
-            # 計算速度和距離
-            self._estimate_speed_and_distance(tracks)
+            if detect:
+                store = builder.build()
+                self._fill_keyframe_gaps(tracker, store)
+                self._save_cached(track_key, store.detection_columns())
+                if checkpoint_key:
+                    self.stub_cache.discard(checkpoint_key)
+            elif store.frame_count > frame_count:
+                # 丟棄超出實際解碼幀數的快取項目
+                keep = store.frame < frame_count
+                store = TrackStore(store.frame[keep], store.track_id[keep],
+                                   store.cls[keep], store.bbox[keep], frame_count)
+            camera_movement = camera_movement[:frame_count]
             
-            # 分配隊伍
-            self._assign_teams(video_frames, tracks)
+            if estimate_camera:
+                self._save_cached(camera_key, camera_movement)
             
-            # 分配控球權
-            team_ball_control = self._assign_ball_possession(tracks)
+            team_assigner.add_team_to_store(store)
+            graph.save(self._teams_stage(None, store), store)
             
-            # 繪製註解
-            output_frames = self._draw_annotations(
-                tracker,
+            logger.info(f"Streaming pass 1 complete ({frame_count} frames, "
+                        f"{len(store)} object observations)")
+            return store, camera_movement
+        except Exception as e:
+            raise RuntimeError(f"Failed streaming analysis pass: {e}")
+    
+    def _run_streaming(self):
+        """以兩遍串流模式執行管道，返回 (影片路徑, 資料路徑)；不輸出影片時影片路徑為 None。"""
+        # 初始化追蹤器
+        tracker = self._initialize_tracker()
+        graph = StageGraph(self.stub_cache)
+        
+        # 第一遍：偵測、追蹤、相機移動、隊伍（全部已快取時略過）
+        store, camera_movement = self._load_cached_analysis(tracker, graph)
+        if store is None:
+            store, camera_movement = self._streaming_analysis_pass(tracker, graph)
+        
+        # 不需要影格的後處理階段（在欄位陣列上整批運算，結果逐階段快取）
+        self._run_post_detection_stages(graph, tracker, store, camera_movement,
+                                        lambda: next(iter_video(self.input_video_path)))
+        self._emit_snapshot('speed_and_distance', store)
+        possession = self._run_possession_stage(graph, store)
+        
+        # 資料在繪製之前儲存：GUI 在編碼期間即可載入
+        data_path = self._save_output_data(store, possession)
+        self._emit_snapshot('save_data', store, possession, self._outputs(None, data_path))
+        
+        # 第二遍：重新解碼，繪製並在背景編碼（不輸出影片時整個第二遍略過）
+        video_path = None
+        if self.render_video:
+            logger.info("Streaming pass 2: rendering")
+            video_path = self._render_video(
+                iter_video(self.input_video_path),
+                store.frame_count,
+                store,
+                possession,
+                camera_movement
+            )
+        return video_path, data_path
+    
+    def _run_in_memory(self):
+        """將整部影片載入記憶體執行管道，返回 (影片路徑, 資料路徑)；不輸出影片時影片路徑為 None。"""
+        # 讀取影片
+        video_frames = self._read_video()
+        
+        # 初始化追蹤器
+        tracker = self._initialize_tracker()
+        graph = StageGraph(self.stub_cache)
+        
+        # 獲取物件追蹤
+        store = self._get_object_tracks(tracker, video_frames, graph)
+        
+        # 估計相機移動
+        camera_movement = self._process_camera_movement(video_frames, graph)
+        
+        # 位置、相機補償、視圖轉換、球插值、速度和距離（結果逐階段快取）
+        self._run_post_detection_stages(graph, tracker, store, camera_movement,
+                                        lambda: video_frames[0])
+        
+        # 分配隊伍
+        graph.run(self._teams_stage(lambda: self._assign_teams(video_frames, store), store), store)
+        self._emit_snapshot('team_assignment', store)
+        
+        # 分配控球權
+        possession = self._run_possession_stage(graph, store)
+        
+        # 儲存輸出（在繪製之前：GUI 在編碼期間即可載入）
+        data_path = self._save_output_data(store, possession)
+        self._emit_snapshot('save_data', store, possession, self._outputs(None, data_path))
+        
+        # 繪製註解並在背景編碼輸出影片
+        video_path = None
+        if self.render_video:
+            video_path = self._render_video(
                 video_frames,
-                tracks,
-                team_ball_control,
+                len(video_frames),
+                store,
+                possession,
                 camera_movement
             )
+        return video_path, data_path
+    
+    def run(self) -> Dict[str, str]:
+        """
+        執行完整的影片分析管道。
+        
+        返回：輸出檔案路徑 {'video': ..., 'data': ..., 'frame_data': ...,
+                          'telemetry': ..., 'performance': ...}
+        """
+        try:
+            self.metrics.reset()
+            logger.info("="*60)
+            logger.info("Starting Football Analysis Pipeline")
+            logger.info("="*60)
             
-            # 儲存輸出
-            video_path = self._save_output_video(output_frames)
-            data_path = self._save_output_data(tracks, team_ball_control)
+            if self.streaming:
+                video_path, data_path = self._run_streaming()
+            else:
+                video_path, data_path = self._run_in_memory()
             
             logger.info("="*60)
             logger.info("Pipeline completed successfully!")
-            logger.info(f"Video output: {video_path}")
+            logger.info(f"Video output: {video_path or 'not rendered'}")
             logger.info(f"Data output: {data_path}")
             logger.info("="*60)
             
+            outputs = self._outputs(video_path, data_path)
+            outputs['performance'] = self._save_performance()
+            return outputs
+            
         except Exception as e:
             logger.error("="*60)
             logger.error(f"Pipeline failed: {e}")
@@ -548,7 +1167,87 @@ def main():
         parser.add_argument(
             '--no-cache',
             action='store_true',
-            help='Disable cached stub files'
+            help='Disable the stub cache (always run detection)'
+        )
+        parser.add_argument(
+            '--cache-dir',
+            type=str,
+            default=None,
+            help='Stub cache directory (default stubs/cache)'
+        )
+        parser.add_argument(
+            '--cache-size-mb',
+            type=int,
+            default=2048,
+            help='Stub cache size limit in MB; least recently used entries are evicted'
+        )
+        parser.add_argument(
+            '--speed-window',
+            type=int,
+            default=5,
+            help='Number of frames used for speed calculation (default 5)'
+        )
+        parser.add_argument(
+            '--speed-mode',
+            choices=SPEED_MODES,
+            default='window',
+            help='Speed calculation: fixed windows, sliding window or smoothed positions'
+        )
+        parser.add_argument(
+            '--camera-proxy-scale',
+            type=float,
+            default=1.0,
+            help='Scale of the grayscale proxy used for camera movement optical flow (0 < s <= 1)'
+        )
+        parser.add_argument(
+            '--codec',
+            choices=sorted(VIDEO_CODECS),
+            default=DEFAULT_VIDEO_CODEC,
+            help='Output video codec: h264 (MP4, falls back to mp4v if unavailable), mp4v, xvid or mjpg (AVI)'
+        )
+        parser.add_argument(
+            '--no-video',
+            action='store_true',
+            help='Skip drawing and encoding the annotated video; only data and track telemetry are written (the GUI can overlay them on the input video)'
+        )
+        parser.add_argument(
+            '--backend',
+            choices=DETECTION_BACKENDS,
+            default='ultralytics',
+            help='Detection backend: ultralytics (PyTorch) or onnx (ONNX Runtime CPU, exported from the .pt model on first use)'
+        )
+        parser.add_argument(
+            '--int8',
+            action='store_true',
+            help='Use the INT8-quantized ONNX model (requires --backend onnx)'
+        )
+        parser.add_argument(
+            '--batch-size',
+            type=int,
+            default=20,
+            help='Frames per detection batch (default 20)'
+        )
+        parser.add_argument(
+            '--keyframe-stride',
+            type=int,
+            default=1,
+            help='Detect every K-th frame (earlier on sharp camera motion or track loss) and interpolate the frames in between (default 1 = every frame)'
+        )
+        parser.add_argument(
+            '--threads',
+            type=int,
+            default=0,
+            help='Threads for chunked camera movement estimation and rendering (default 0 = OpenCV thread count)'
+        )
+        parser.add_argument(
+            '--progress',
+            action='store_true',
+            help='Emit machine-readable JSON-lines progress events on stdout'
+        )
+        parser.add_argument(
+            '--streaming',
+            action='store_true',
+            help='Two-pass streaming mode: never hold the whole video in memory'
         )
         
         args = parser.parse_args()
@@ -567,6 +1266,10 @@ def main():
         model_file = resolve_path(args.model)
         output_directory = resolve_path(args.output)
         use_cached_stubs = not args.no_cache
+        stub_cache = StubCache(
+            cache_dir=resolve_path(args.cache_dir) if args.cache_dir else DEFAULT_CACHE_DIR,
+            max_bytes=args.cache_size_mb * 1024 * 1024
+        )
         
         logger.info(f"Input video: {input_video}")
         logger.info(f"Model file: {model_file}")
@@ -577,7 +1280,20 @@ def main():
             input_video_path=input_video,
             model_path=model_file,
             output_dir=output_directory,
-            use_stubs=use_cached_stubs
+            use_stubs=use_cached_stubs,
+            streaming=args.streaming,
+            progress=ProgressReporter(enabled=args.progress),
+            cache=stub_cache,
+            speed_window=args.speed_window,
+            speed_mode=args.speed_mode,
+            camera_proxy_scale=args.camera_proxy_scale,
+            video_codec=args.codec,
+            detection_backend=args.backend,
+            int8=args.int8,
+            batch_size=args.batch_size,
+            keyframe_stride=args.keyframe_stride,
+            render_video=not args.no_video,
+            threads=args.threads
         )
         
         pipeline.run()
@@ -25,9 +25,11 @@ Results are used to:
 ===============================================================================
 """
 
+import numpy as np
 import sys 
 sys.path.append('../')
 from utils import get_center_of_bbox, measure_distance
+from track_store import PLAYER, BALL
 
 
 ################################################################################
@@ -80,4 +82,53 @@ class PlayerBallAssigner():
                     miniumum_distance = distance
                     assigned_player = player_id
 
-        return assigned_player
\ No newline at end of file
+        return assigned_player
+
+    def assign_ball_possession(self, store):
+        """
+        Assign possession in every frame of a TrackStore at once.
+        
+        Same rule as assign_ball_to_player (nearest foot within the
+        threshold, first player wins ties). Sets has_ball on the assigned
+        rows; frames without a ball or an assignment keep the previous
+        frame's team (0 before the first assignment).
+        
+        Args:
+            store: TrackStore with player teams and ball boxes
+            
+        Returns:
+            Array with the team in control of the ball per frame
+        """
+        number_of_frames = store.frame_count
+        ball_rows = store.find_rows(BALL, np.arange(number_of_frames), 1)
+        ball_bbox = store.bbox[np.maximum(ball_rows, 0)].astype(np.float64)
+        ball_position = np.trunc(np.stack([(ball_bbox[:, 0] + ball_bbox[:, 2]) / 2,
+                                           (ball_bbox[:, 1] + ball_bbox[:, 3]) / 2], axis=1))
+
+        rows = store.class_rows(PLAYER)
+        rows = rows[ball_rows[store.frame[rows]] >= 0]
+        frames = store.frame[rows]
+        player_bbox = store.bbox[rows].astype(np.float64)
+        ball_x = ball_position[frames, 0]
+        ball_y = ball_position[frames, 1]
+
+        offset_y = (player_bbox[:, 3] - ball_y) ** 2
+        distance_left = np.sqrt((player_bbox[:, 0] - ball_x) ** 2 + offset_y)
+        distance_right = np.sqrt((player_bbox[:, 2] - ball_x) ** 2 + offset_y)
+        distance = np.minimum(distance_left, distance_right)
+        distance[~(distance < self.max_player_ball_distance)] = np.inf
+
+        # Nearest player per frame; ties go to the earlier row
+        order = np.lexsort((rows, distance, frames))
+        sorted_frames = frames[order]
+        nearest = order[np.r_[True, sorted_frames[1:] != sorted_frames[:-1]]] if len(order) else order
+        nearest = nearest[np.isfinite(distance[nearest])]
+        assigned_rows = rows[nearest]
+        store.has_ball[assigned_rows] = True
+
+        # Carry the last assigned team forward
+        team_ball_control = np.full(number_of_frames, -1, dtype=np.int64)
+        team_ball_control[frames[nearest]] = store.team[assigned_rows]
+        last_assigned = np.where(team_ball_control >= 0, np.arange(number_of_frames), -1)
+        last_assigned = np.maximum.accumulate(last_assigned) if number_of_frames else last_assigned
+        return np.where(last_assigned >= 0, team_ball_control[last_assigned], 0)
\ No newline at end of file
@@ -0,0 +1,181 @@
+"""
+===============================================================================
+POSSESSION STATISTICS
+===============================================================================
+
+Running possession counts for one video, built once after possession has
+been assigned and then queried by the overlay, the data export and the GUI
+summary.
+
+PREFIX SUMS:
+For every team t, team_prefix[t][n] is the number of frames before frame n
+in which t controlled the ball, so
+- possession up to frame N      = team_prefix[t][N+1]
+- possession in window [a, b]   = team_prefix[t][b+1] - team_prefix[t][a]
+are O(1). Team 0 (no team in control yet) is counted but not included in
+percentages, like the original overlay.
+
+PER PLAYER:
+has_ball rows of the TrackStore give the frames each player had the ball.
+Totals per player are precomputed (O(1)); windowed counts use a binary
+search over the player's possession frames (O(log n) in the number of
+frames the player had the ball). Per-player prefix sums over all frames
+would make them O(1) but cost frame_count entries for every player.
+===============================================================================
+"""
+
+import numpy as np
+import sys
+sys.path.append('../')
+from track_store import PLAYER
+
+# Teams with possession percentages
+TEAMS = (1, 2)
+
+
+################################################################################
+# POSSESSION STATISTICS CLASS
+################################################################################
+
+class PossessionStats:
+    """
+    Team possession and player totals in constant time; windowed player
+    counts in logarithmic time.
+    """
+
+    def __init__(self, team_ball_control, store=None):
+        """
+        Args:
+            team_ball_control: Team in control of the ball per frame (0 = none)
+            store: Optional TrackStore with has_ball set, for per-player stats
+        """
+        team_ball_control = np.asarray(team_ball_control, dtype=np.int64)
+        self.frame_count = len(team_ball_control)
+
+        self.team_prefix = {}
+        for team in (0,) + TEAMS:
+            prefix = np.zeros(self.frame_count + 1, dtype=np.int64)
+            np.cumsum(team_ball_control == team, out=prefix[1:])
+            self.team_prefix[team] = prefix
+
+        # Per player: sorted frames with the ball, and total counts
+        self.player_frames = {}
+        self.player_team = {}
+        if store is not None:
+            rows = store.class_rows(PLAYER)
+            rows = rows[store.has_ball[rows]]
+            order = np.lexsort((store.frame[rows], store.track_id[rows]))
+            rows = rows[order]
+            track_ids = store.track_id[rows]
+            if len(rows):
+                starts = np.flatnonzero(np.r_[True, track_ids[1:] != track_ids[:-1]])
+                ends = np.r_[starts[1:], len(rows)]
+                for start, end in zip(starts.tolist(), ends.tolist()):
+                    track_id = int(track_ids[start])
+                    self.player_frames[track_id] = store.frame[rows[start:end]]
+                    self.player_team[track_id] = int(store.team[rows[start]])
+        self.player_total = {track_id: len(frames) for track_id, frames in self.player_frames.items()}
+        self.assigned_frames = sum(self.player_total.values())
+
+    # =========================================================================
+    # TEAM QUERIES
+    # =========================================================================
+
+    def team_frames(self, team, frame_num=None):
+        """
+        Frames in which a team controlled the ball up to frame_num (inclusive).
+
+        Args:
+            team: Team id (0 = no team)
+            frame_num: Last frame to count, or None for the whole video
+
+        Returns:
+            Number of frames
+        """
+        end = self.frame_count if frame_num is None else min(frame_num + 1, self.frame_count)
+        return int(self.team_prefix[team][max(end, 0)])
+
+    def team_frames_in_window(self, team, start, stop):
+        """
+        Frames in which a team controlled the ball in [start, stop] (inclusive).
+
+        Args:
+            team: Team id (0 = no team)
+            start: First frame of the window
+            stop: Last frame of the window
+
+        Returns:
+            Number of frames
+        """
+        start = min(max(start, 0), self.frame_count)
+        end = min(max(stop + 1, start), self.frame_count)
+        prefix = self.team_prefix[team]
+        return int(prefix[end] - prefix[start])
+
+    def team_percentages(self, frame_num=None):
+        """
+        Possession share of each team up to frame_num (inclusive).
+
+        Frames without a team in control are left out, so the shares add up
+        to 100 once any team had the ball (all 0 before that).
+
+        Args:
+            frame_num: Last frame to count, or None for the whole video
+
+        Returns:
+            {team: percent}
+        """
+        counts = {team: self.team_frames(team, frame_num) for team in TEAMS}
+        return self._percentages(counts)
+
+    def window_percentages(self, start, stop):
+        """
+        Possession share of each team in [start, stop] (inclusive).
+
+        Returns:
+            {team: percent}
+        """
+        counts = {team: self.team_frames_in_window(team, start, stop) for team in TEAMS}
+        return self._percentages(counts)
+
+    @staticmethod
+    def _percentages(counts):
+        total = sum(counts.values())
+        return {team: (count / total * 100 if total else 0.0) for team, count in counts.items()}
+
+    # =========================================================================
+    # PLAYER QUERIES
+    # =========================================================================
+
+    def player_possession_frames(self, track_id, start=None, stop=None):
+        """
+        Frames in which a player had the ball, optionally in [start, stop].
+
+        Args:
+            track_id: Player track id
+            start: First frame of the window, or None for the whole video
+            stop: Last frame of the window, or None for the whole video
+
+        Returns:
+            Number of frames
+        """
+        if start is None and stop is None:
+            return self.player_total.get(track_id, 0)
+
+        frames = self.player_frames.get(track_id)
+        if frames is None:
+            return 0
+        start = 0 if start is None else start
+        stop = self.frame_count - 1 if stop is None else stop
+        return int(np.searchsorted(frames, stop, side='right') - np.searchsorted(frames, start, side='left'))
+
+    def player_percentage(self, track_id):
+        """
+        Share of all frames with a player in possession that this player had.
+
+        Returns:
+            Percent (0 when no player ever had the ball)
+        """
+        if not self.assigned_frames:
+            return 0.0
+        return self.player_total.get(track_id, 0) / self.assigned_frames * 100
@@ -0,0 +1,49 @@
+"""
+===============================================================================
+NATIVE EXTENSIONS BUILD SCRIPT
+===============================================================================
+
+Builds the optional compiled kernels of the analysis pipeline in place:
+
+    cd foot-Function
+    python setup.py build_ext --inplace
+
+EXTENSIONS:
+- team_assigner._jersey_color: two-cluster jersey color kernel
+  (see team_assigner/jersey_color.cpp)
+
+The pipeline falls back to NumPy implementations when an extension has not
+been built, so this step is optional.
+===============================================================================
+"""
+
+from setuptools import setup, Extension
+from setuptools.command.build_ext import build_ext
+
+
+class OptimizedBuildExt(build_ext):
+    """Adds optimization, C++17 and thread flags for the active compiler."""
+
+    def build_extensions(self):
+        if self.compiler.compiler_type == 'msvc':
+            flags, link_flags = ['/O2', '/std:c++17', '/EHsc'], []
+        else:
+            flags, link_flags = ['-O3', '-std=c++17', '-pthread'], ['-pthread']
+
+        for extension in self.extensions:
+            extension.extra_compile_args = flags
+            extension.extra_link_args = link_flags
+        super().build_extensions()
+
+
+setup(
+    name='foot-function-native',
+    ext_modules=[
+        Extension(
+            'team_assigner._jersey_color',
+            sources=['team_assigner/jersey_color.cpp'],
+            language='c++',
+        ),
+    ],
+    cmdclass={'build_ext': OptimizedBuildExt},
+)
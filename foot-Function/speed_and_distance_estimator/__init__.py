@@ -1 +1 @@
-from .speed_and_distance_estimator import SpeedAndDistance_Estimator
\ No newline at end of file
+from .speed_and_distance_estimator import SpeedAndDistance_Estimator, SPEED_MODES, DEFAULT_FRAME_RATE
\ No newline at end of file
@@ -22,8 +22,18 @@ Using a 5-frame window (instead of frame-to-frame) provides more stable
 speed measurements by averaging over short time periods and reducing
 impact of tracking jitter.
 
+MODES (TrackStore version):
+- window:   fixed windows starting every frame_window frames; speed is
+            constant within a window (the original method)
+- sliding:  speed at every frame from the displacement over the last
+            frame_window frames; distance is the integral of that speed
+- smoothed: positions averaged over frame_window consecutive observations
+            of the track, then frame-to-frame speed and path length
+All modes compute every player at once with array operations, so they are
+cheap to re-run with a different window.
+
 CONVERSIONS:
-- Frame rate: 24 fps (assumed)
+- Frame rate: taken from the video container (24 fps if unknown)
 - Speed: meters/second → km/h (multiply by 3.6)
 - Distance: accumulated in meters
 
@@ -34,9 +44,16 @@ annotations on the video output.
 """
 
 import cv2
+import numpy as np
 import sys 
 sys.path.append('../')
 from utils import measure_distance ,get_foot_position
+from track_store import PLAYER
+
+# Used when the container does not report a usable frame rate
+DEFAULT_FRAME_RATE = 24
+
+SPEED_MODES = ('window', 'sliding', 'smoothed')
 
 
 ################################################################################
@@ -48,12 +65,25 @@ class SpeedAndDistance_Estimator():
     Calculates player speed and distance from transformed coordinates.
     """
     
-    def __init__(self):
+    def __init__(self, frame_rate=DEFAULT_FRAME_RATE, frame_window=5, mode='window'):
         """
         Initialize estimator with frame window and frame rate settings.
+        
+        Args:
+            frame_rate: Video frame rate (fps); invalid values fall back to 24
+            frame_window: Number of frames for speed calculation window
+            mode: 'window', 'sliding' or 'smoothed' (see module docstring)
         """
-        self.frame_window=5   # Number of frames for speed calculation window
-        self.frame_rate=24    # Assumed video frame rate (fps)
+        if mode not in SPEED_MODES:
+            raise ValueError(f"Unknown speed mode '{mode}', expected one of {SPEED_MODES}")
+        if int(frame_window) < 1:
+            raise ValueError(f"Frame window must be at least 1, got {frame_window}")
+        if not frame_rate or not 0 < frame_rate < 1000:
+            frame_rate = DEFAULT_FRAME_RATE
+
+        self.frame_window=int(frame_window)   # Number of frames for speed calculation window
+        self.frame_rate=float(frame_rate)     # Video frame rate (fps)
+        self.mode=mode
     
     # =========================================================================
     # METRIC CALCULATION
@@ -119,6 +149,199 @@ class SpeedAndDistance_Estimator():
                             continue
                         tracks[object][frame_num_batch][track_id]['speed'] = speed_km_per_hour
                         tracks[object][frame_num_batch][track_id]['distance'] = total_distance[object][track_id]
+
+    def add_speed_and_distance_to_store(self, store):
+        """
+        Calculate speed and distance for all players of a TrackStore.
+        
+        Uses the estimator's mode, window and frame rate. Previous values
+        are cleared first, so the store can be re-processed with other
+        settings without re-running any earlier stage.
+        
+        Args:
+            store: TrackStore with transformed positions
+        """
+        rows = store.class_rows(PLAYER)
+        store.speed[rows] = np.nan
+        store.distance[rows] = np.nan
+
+        if self.mode == 'window':
+            self._add_window_speed_to_store(store)
+        elif self.mode == 'sliding':
+            self._add_sliding_speed_to_store(store)
+        else:
+            self._add_smoothed_speed_to_store(store)
+
+    def _add_window_speed_to_store(self, store):
+        """
+        Fixed windows, same values as add_speed_and_distance_to_tracks:
+        - A window starts at every frame_window-th frame and ends frame_window
+          frames later (or at the last frame)
+        - A window counts for a player present with a transformed position
+          at both ends; its distance is added to the player's total
+        - Every frame of a window shows the window's speed and the total;
+          the shared end frame shows the next window when that one counts
+        
+        All windows of all players are computed at once; only the running
+        totals are summed per player so they add up in the same order.
+        """
+        rows = store.class_rows(PLAYER)
+        number_of_frames = store.frame_count
+        frames = store.frame[rows]
+        track_ids = store.track_id[rows]
+        window = self.frame_window
+
+        # Windows: start row of each player at each window start frame
+        is_start = frames % window == 0
+        start_rows = rows[is_start]
+        start_frames = frames[is_start]
+        start_ids = track_ids[is_start]
+        last_frames = np.minimum(start_frames + window, number_of_frames - 1)
+        end_rows = store.find_rows(PLAYER, last_frames, start_ids)
+
+        positions = store.position_transformed
+        valid = (end_rows >= 0) & (last_frames > start_frames)
+        valid &= ~np.isnan(positions[start_rows]).any(axis=1)
+        valid &= ~np.isnan(positions[np.where(end_rows >= 0, end_rows, 0)]).any(axis=1)
+
+        start_rows = start_rows[valid]
+        start_ids = start_ids[valid]
+        offset = positions[end_rows[valid]] - positions[start_rows]
+        distance_covered = np.sqrt(offset[:, 0] * offset[:, 0] + offset[:, 1] * offset[:, 1])
+        time_elapsed = (last_frames[valid] - start_frames[valid]) / self.frame_rate
+        speed_km_per_hour = distance_covered / time_elapsed * 3.6
+
+        # Running total per player, summed in window order
+        total_distance = np.empty_like(distance_covered)
+        order = np.lexsort((start_frames[valid], start_ids))
+        sorted_ids = start_ids[order]
+        bounds = np.flatnonzero(np.r_[True, sorted_ids[1:] != sorted_ids[:-1], True])
+        for begin, end in zip(bounds[:-1], bounds[1:]):
+            group = order[begin:end]
+            total_distance[group] = np.cumsum(distance_covered[group])
+
+        # Window values indexed by their start row
+        window_speed = np.full(len(store), np.nan)
+        window_distance = np.full(len(store), np.nan)
+        window_speed[start_rows] = speed_km_per_hour
+        window_distance[start_rows] = total_distance
+
+        # Each frame takes its own window, the shared end frame falls back
+        # to the previous window
+        source = store.find_rows(PLAYER, frames - frames % window, track_ids)
+        source_speed = np.where(source >= 0, window_speed[source], np.nan)
+        fallback = np.isnan(source_speed) & is_start & (frames > 0)
+        previous = store.find_rows(PLAYER, frames - window, track_ids)
+        source = np.where(fallback, previous, source)
+
+        has_value = source >= 0
+        has_value[has_value] = ~np.isnan(window_speed[source[has_value]])
+        store.speed[rows[has_value]] = window_speed[source[has_value]]
+        store.distance[rows[has_value]] = window_distance[source[has_value]]
+
+    def _add_sliding_speed_to_store(self, store):
+        """
+        Sliding window: every frame compares the player's position with the
+        one frame_window frames earlier. Frames without that earlier
+        position get no speed. Distance integrates the speed over the
+        frames since the player's previous speed value (at most one window).
+        """
+        rows = store.class_rows(PLAYER)
+        frames = store.frame[rows]
+        track_ids = store.track_id[rows]
+        window = self.frame_window
+
+        previous = store.find_rows(PLAYER, frames - window, track_ids)
+        positions = store.position_transformed
+        valid = (previous >= 0) & ~np.isnan(positions[rows]).any(axis=1)
+        valid &= ~np.isnan(positions[np.where(previous >= 0, previous, 0)]).any(axis=1)
+
+        rows = rows[valid]
+        offset = positions[rows] - positions[previous[valid]]
+        speed = np.hypot(offset[:, 0], offset[:, 1]) / (window / self.frame_rate)
+
+        # Frames covered by each value: since the previous value, capped at the window
+        frames = frames[valid]
+        track_ids = track_ids[valid]
+        order = np.lexsort((frames, track_ids))
+        covered = np.full(len(rows), window, dtype=np.int64)
+        same_track = track_ids[order][1:] == track_ids[order][:-1]
+        gaps = np.diff(frames[order])
+        covered[order[1:][same_track]] = np.minimum(gaps[same_track], window)
+
+        self._write_speed_and_distance(store, rows, track_ids, order, speed,
+                                       speed * covered / self.frame_rate)
+
+    def _add_smoothed_speed_to_store(self, store):
+        """
+        Smoothed positions: every position is replaced by the mean of up to
+        frame_window observations centered on it. The window never crosses
+        a gap in the track and shrinks symmetrically at the ends of each
+        continuous run, so steady motion is not distorted. Speed and
+        distance then follow the smoothed path from frame to frame; the
+        movement across a gap is not counted (as in the window mode).
+        """
+        rows = store.class_rows(PLAYER)
+        rows = rows[~np.isnan(store.position_transformed[rows]).any(axis=1)]
+        frames = store.frame[rows]
+        track_ids = store.track_id[rows]
+
+        # Observations grouped by track, in frame order
+        order = np.lexsort((frames, track_ids))
+        rows, frames, track_ids = rows[order], frames[order], track_ids[order]
+        count = len(rows)
+        if count == 0:
+            return
+
+        # Continuous runs: a new run starts at a new track or after a gap
+        new_run = np.r_[True, (track_ids[1:] != track_ids[:-1]) | (np.diff(frames) != 1)]
+        starts = np.flatnonzero(new_run)
+        ends = np.r_[starts[1:], count]
+        run = np.cumsum(new_run) - 1
+
+        # Centered moving average within each run via a running sum
+        index = np.arange(count)
+        radius = np.minimum(self.frame_window // 2,
+                            np.minimum(index - starts[run], ends[run] - 1 - index))
+        running = np.vstack([np.zeros((1, 2)), np.cumsum(store.position_transformed[rows], axis=0)])
+        smoothed = (running[index + radius + 1] - running[index - radius]) / (2 * radius + 1)[:, None]
+
+        # Frame-to-frame steps inside each run
+        continues = ~new_run
+        offset = smoothed[1:] - smoothed[:-1]
+        step = np.hypot(offset[:, 0], offset[:, 1])[continues[1:]]
+        rows = rows[continues]
+        track_ids = track_ids[continues]
+
+        self._write_speed_and_distance(store, rows, track_ids, np.arange(len(rows)),
+                                       step * self.frame_rate, step)
+
+    @staticmethod
+    def _write_speed_and_distance(store, rows, track_ids, order, speed, step):
+        """
+        Store speed (m/s → km/h) and the running total of step distances.
+        
+        Args:
+            store: TrackStore to write
+            rows: Rows receiving a value
+            track_ids: Track id of each row
+            order: Permutation sorting the rows by track, then frame
+            speed: Speed in m/s per row
+            step: Distance added at each row in meters
+        """
+        if len(rows) == 0:
+            return
+        store.speed[rows] = speed * 3.6
+
+        # Running sum over all tracks minus the sum before each track starts
+        sorted_ids = track_ids[order]
+        running = np.cumsum(step[order])
+        new_track = np.r_[True, sorted_ids[1:] != sorted_ids[:-1]]
+        track_start = np.maximum.accumulate(np.where(new_track, np.arange(len(order)), 0))
+        before_track = np.where(track_start > 0, running[track_start - 1], 0.0)
+        distance = np.empty(len(order))
+        distance[order] = running - before_track
+        store.distance[rows] = distance
     
     # =========================================================================
     # VISUALIZATION
@@ -143,24 +366,39 @@ class SpeedAndDistance_Estimator():
         """
         output_frames = []
         for frame_num, frame in enumerate(frames):
-            for object, object_tracks in tracks.items():
-                if object == "ball" or object == "referees":
-                    continue 
-                for _, track_info in object_tracks[frame_num].items():
-                   if "speed" in track_info:
-                       speed = track_info.get('speed',None)
-                       distance = track_info.get('distance',None)
-                       if speed is None or distance is None:
-                           continue
-                       
-                       bbox = track_info['bbox']
-                       position = get_foot_position(bbox)
-                       position = list(position)
-                       position[1]+=40
-
-                       position = tuple(map(int,position))
-                       cv2.putText(frame, f"{speed:.2f} km/h",position,cv2.FONT_HERSHEY_SIMPLEX,0.5,(0,0,0),2)
-                       cv2.putText(frame, f"{distance:.2f} m",(position[0],position[1]+20),cv2.FONT_HERSHEY_SIMPLEX,0.5,(0,0,0),2)
+            frame = self.draw_frame_speed_and_distance(frame, frame_num, tracks)
             output_frames.append(frame)
         
-        return output_frames
\ No newline at end of file
+        return output_frames
+
+    def draw_frame_speed_and_distance(self, frame, frame_num, tracks):
+        """
+        Draw speed and distance labels on a single frame in place.
+        
+        Args:
+            frame: Video frame to draw on (modified in place)
+            frame_num: Index of the frame in the video
+            tracks: Tracking dictionary with speed/distance data
+            
+        Returns:
+            The annotated frame
+        """
+        for object, object_tracks in tracks.items():
+            if object == "ball" or object == "referees":
+                continue 
+            for _, track_info in object_tracks[frame_num].items():
+               if "speed" in track_info:
+                   speed = track_info.get('speed',None)
+                   distance = track_info.get('distance',None)
+                   if speed is None or distance is None:
+                       continue
+                   
+                   bbox = track_info['bbox']
+                   position = get_foot_position(bbox)
+                   position = list(position)
+                   position[1]+=40
+
+                   position = tuple(map(int,position))
+                   cv2.putText(frame, f"{speed:.2f} km/h",position,cv2.FONT_HERSHEY_SIMPLEX,0.5,(0,0,0),2)
+                   cv2.putText(frame, f"{distance:.2f} m",(position[0],position[1]+20),cv2.FONT_HERSHEY_SIMPLEX,0.5,(0,0,0),2)
+        return frame
\ No newline at end of file
@@ -0,0 +1,462 @@
+/*******************************************************************************
+ * JERSEY COLOR KERNEL
+ *
+ * Native implementation of TeamAssigner.get_player_color for many players
+ * at once (Python extension module team_assigner._jersey_color).
+ *
+ * For every bounding box of a frame:
+ * 1. Take the top half of the crop (where the jersey is)
+ * 2. Split its pixels into two color clusters with k-means (k = 2)
+ * 3. The cluster holding most of the four corner pixels is background;
+ *    the center of the other cluster is the jersey color
+ * Optionally every jersey color is then assigned to the nearest of the two
+ * team colors.
+ *
+ * SPEED:
+ * - Initialization is deterministic (farthest pixel from the mean, then the
+ *   farthest pixel from that), so no restarts are needed
+ * - The assignment step runs four pixels at a time with SSE2 or NEON;
+ *   other platforms use the scalar loop
+ * - Crops are distributed over a pool of threads with the GIL released
+ *
+ * Python interface (called through team_assigner/jersey_color.py):
+ *     cluster_crops(frame, height, width, boxes, colors, team_centers, teams, threads)
+ *         frame:        uint8 buffer, height x width x 3 (BGR), C-contiguous
+ *         boxes:        int32 buffer, N x 4 [x1, y1, x2, y2], already clipped
+ *         colors:       writable float64 buffer, N x 3 (jersey colors out)
+ *         team_centers: float64 buffer with 6 values, or empty for no prediction
+ *         teams:        writable int32 buffer, N (team index 0/1 out)
+ *         threads:      worker threads (0 = hardware concurrency)
+ ******************************************************************************/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JERSEY_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define JERSEY_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const int kMaxIterations = 100;
+
+struct Color
+{
+    double b = 0.0;
+    double g = 0.0;
+    double r = 0.0;
+};
+
+/*
+ * Pixels of one crop in planar float layout, padded to a multiple of four
+ * so the SIMD loop needs no tail handling. Padding pixels are excluded from
+ * all sums by the caller.
+ */
+struct Pixels
+{
+    std::vector<float> b, g, r;
+    std::vector<uint8_t> labels;
+    size_t count = 0;
+    size_t width = 0;
+};
+
+void loadPixels(const uint8_t *frame, int frameWidth, const int32_t *box, Pixels &pixels)
+{
+    const int x1 = box[0], y1 = box[1], x2 = box[2];
+    const int cropHeight = box[3] - y1;
+    const int halfHeight = cropHeight / 2;   // int(image.shape[0] / 2)
+    const int width = x2 - x1;
+
+    pixels.width = static_cast<size_t>(std::max(width, 0));
+    pixels.count = static_cast<size_t>(std::max(halfHeight, 0)) * pixels.width;
+    const size_t padded = (pixels.count + 3) & ~static_cast<size_t>(3);
+    pixels.b.assign(padded, 0.0f);
+    pixels.g.assign(padded, 0.0f);
+    pixels.r.assign(padded, 0.0f);
+    pixels.labels.assign(padded, 0);
+
+    size_t index = 0;
+    for (int y = 0; y < halfHeight; ++y) {
+        const uint8_t *row = frame + (static_cast<size_t>(y1 + y) * frameWidth + x1) * 3;
+        for (int x = 0; x < width; ++x, ++index) {
+            pixels.b[index] = row[x * 3];
+            pixels.g[index] = row[x * 3 + 1];
+            pixels.r[index] = row[x * 3 + 2];
+        }
+    }
+}
+
+inline double squaredDistance(const Pixels &pixels, size_t i, const Color &c)
+{
+    const double db = pixels.b[i] - c.b;
+    const double dg = pixels.g[i] - c.g;
+    const double dr = pixels.r[i] - c.r;
+    return db * db + dg * dg + dr * dr;
+}
+
+// Index of the pixel farthest from a color (first one on ties)
+size_t farthestPixel(const Pixels &pixels, const Color &from)
+{
+    size_t best = 0;
+    double bestDistance = -1.0;
+    for (size_t i = 0; i < pixels.count; ++i) {
+        const double distance = squaredDistance(pixels, i, from);
+        if (distance > bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+Color pixelColor(const Pixels &pixels, size_t i)
+{
+    Color c;
+    c.b = pixels.b[i];
+    c.g = pixels.g[i];
+    c.r = pixels.r[i];
+    return c;
+}
+
+/*
+ * One assignment step: label every pixel with its nearest center
+ * (ties go to cluster 0) and sum the colors of cluster 1.
+ * Returns the number of labels that changed.
+ */
+size_t assignPixels(Pixels &pixels, const Color &c0, const Color &c1,
+                    double sum1[3], size_t &count1)
+{
+    size_t changed = 0;
+    size_t i = 0;
+    sum1[0] = sum1[1] = sum1[2] = 0.0;
+    count1 = 0;
+
+#if defined(JERSEY_SSE2)
+    const __m128 c0b = _mm_set1_ps(static_cast<float>(c0.b));
+    const __m128 c0g = _mm_set1_ps(static_cast<float>(c0.g));
+    const __m128 c0r = _mm_set1_ps(static_cast<float>(c0.r));
+    const __m128 c1b = _mm_set1_ps(static_cast<float>(c1.b));
+    const __m128 c1g = _mm_set1_ps(static_cast<float>(c1.g));
+    const __m128 c1r = _mm_set1_ps(static_cast<float>(c1.r));
+    const size_t simdEnd = pixels.count & ~static_cast<size_t>(3);
+
+    // Pixel values are integers, so float lane sums stay exact below 2^24;
+    // flush them to double well before that
+    const size_t flushEvery = 4096;
+    __m128 accB = _mm_setzero_ps(), accG = _mm_setzero_ps(), accR = _mm_setzero_ps();
+    size_t sinceFlush = 0;
+    alignas(16) float lanes[4];
+
+    auto flush = [&]() {
+        _mm_store_ps(lanes, accB); sum1[0] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        _mm_store_ps(lanes, accG); sum1[1] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        _mm_store_ps(lanes, accR); sum1[2] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        accB = accG = accR = _mm_setzero_ps();
+        sinceFlush = 0;
+    };
+
+    for (; i < simdEnd; i += 4) {
+        const __m128 b = _mm_loadu_ps(&pixels.b[i]);
+        const __m128 g = _mm_loadu_ps(&pixels.g[i]);
+        const __m128 r = _mm_loadu_ps(&pixels.r[i]);
+
+        __m128 t = _mm_sub_ps(b, c0b);
+        __m128 d0 = _mm_mul_ps(t, t);
+        t = _mm_sub_ps(g, c0g); d0 = _mm_add_ps(d0, _mm_mul_ps(t, t));
+        t = _mm_sub_ps(r, c0r); d0 = _mm_add_ps(d0, _mm_mul_ps(t, t));
+        t = _mm_sub_ps(b, c1b);
+        __m128 d1 = _mm_mul_ps(t, t);
+        t = _mm_sub_ps(g, c1g); d1 = _mm_add_ps(d1, _mm_mul_ps(t, t));
+        t = _mm_sub_ps(r, c1r); d1 = _mm_add_ps(d1, _mm_mul_ps(t, t));
+
+        const __m128 mask = _mm_cmplt_ps(d1, d0);
+        const int bits = _mm_movemask_ps(mask);
+        accB = _mm_add_ps(accB, _mm_and_ps(mask, b));
+        accG = _mm_add_ps(accG, _mm_and_ps(mask, g));
+        accR = _mm_add_ps(accR, _mm_and_ps(mask, r));
+
+        for (int lane = 0; lane < 4; ++lane) {
+            const uint8_t label = static_cast<uint8_t>((bits >> lane) & 1);
+            changed += pixels.labels[i + lane] != label;
+            pixels.labels[i + lane] = label;
+            count1 += label;
+        }
+
+        sinceFlush += 4;
+        if (sinceFlush >= flushEvery) {
+            flush();
+        }
+    }
+    flush();
+#elif defined(JERSEY_NEON)
+    const float32x4_t c0b = vdupq_n_f32(static_cast<float>(c0.b));
+    const float32x4_t c0g = vdupq_n_f32(static_cast<float>(c0.g));
+    const float32x4_t c0r = vdupq_n_f32(static_cast<float>(c0.r));
+    const float32x4_t c1b = vdupq_n_f32(static_cast<float>(c1.b));
+    const float32x4_t c1g = vdupq_n_f32(static_cast<float>(c1.g));
+    const float32x4_t c1r = vdupq_n_f32(static_cast<float>(c1.r));
+    const size_t simdEnd = pixels.count & ~static_cast<size_t>(3);
+    alignas(16) uint32_t maskLanes[4];
+    alignas(16) float lanes[4];
+
+    for (; i < simdEnd; i += 4) {
+        const float32x4_t b = vld1q_f32(&pixels.b[i]);
+        const float32x4_t g = vld1q_f32(&pixels.g[i]);
+        const float32x4_t r = vld1q_f32(&pixels.r[i]);
+
+        float32x4_t t = vsubq_f32(b, c0b);
+        float32x4_t d0 = vmulq_f32(t, t);
+        t = vsubq_f32(g, c0g); d0 = vmlaq_f32(d0, t, t);
+        t = vsubq_f32(r, c0r); d0 = vmlaq_f32(d0, t, t);
+        t = vsubq_f32(b, c1b);
+        float32x4_t d1 = vmulq_f32(t, t);
+        t = vsubq_f32(g, c1g); d1 = vmlaq_f32(d1, t, t);
+        t = vsubq_f32(r, c1r); d1 = vmlaq_f32(d1, t, t);
+
+        const uint32x4_t mask = vcltq_f32(d1, d0);
+        vst1q_u32(maskLanes, mask);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        vst1q_f32(lanes, vbslq_f32(mask, b, zero));
+        sum1[0] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        vst1q_f32(lanes, vbslq_f32(mask, g, zero));
+        sum1[1] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        vst1q_f32(lanes, vbslq_f32(mask, r, zero));
+        sum1[2] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+        for (int lane = 0; lane < 4; ++lane) {
+            const uint8_t label = maskLanes[lane] ? 1 : 0;
+            changed += pixels.labels[i + lane] != label;
+            pixels.labels[i + lane] = label;
+            count1 += label;
+        }
+    }
+#endif
+
+    // Scalar loop: remaining pixels (or all of them without SIMD)
+    for (; i < pixels.count; ++i) {
+        const float db0 = pixels.b[i] - static_cast<float>(c0.b);
+        const float dg0 = pixels.g[i] - static_cast<float>(c0.g);
+        const float dr0 = pixels.r[i] - static_cast<float>(c0.r);
+        const float db1 = pixels.b[i] - static_cast<float>(c1.b);
+        const float dg1 = pixels.g[i] - static_cast<float>(c1.g);
+        const float dr1 = pixels.r[i] - static_cast<float>(c1.r);
+        const float d0 = db0 * db0 + dg0 * dg0 + dr0 * dr0;
+        const float d1 = db1 * db1 + dg1 * dg1 + dr1 * dr1;
+        const uint8_t label = d1 < d0 ? 1 : 0;
+        changed += pixels.labels[i] != label;
+        pixels.labels[i] = label;
+        if (label) {
+            sum1[0] += pixels.b[i];
+            sum1[1] += pixels.g[i];
+            sum1[2] += pixels.r[i];
+            ++count1;
+        }
+    }
+    return changed;
+}
+
+/*
+ * Jersey color of one crop. Returns false for an empty crop.
+ */
+bool jerseyColor(Pixels &pixels, Color &jersey)
+{
+    if (pixels.count == 0) {
+        return false;
+    }
+
+    double total[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < pixels.count; ++i) {
+        total[0] += pixels.b[i];
+        total[1] += pixels.g[i];
+        total[2] += pixels.r[i];
+    }
+    Color mean;
+    mean.b = total[0] / pixels.count;
+    mean.g = total[1] / pixels.count;
+    mean.r = total[2] / pixels.count;
+
+    // Deterministic farthest-point initialization
+    Color c0 = pixelColor(pixels, farthestPixel(pixels, mean));
+    Color c1 = pixelColor(pixels, farthestPixel(pixels, c0));
+
+    // All labels start at 0; the first step counts every pixel of
+    // cluster 1 as changed, so the loop always runs at least once
+    for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+        double sum1[3];
+        size_t count1 = 0;
+        const size_t changed = assignPixels(pixels, c0, c1, sum1, count1);
+        const size_t count0 = pixels.count - count1;
+
+        // An empty cluster keeps its previous center
+        if (count1 > 0) {
+            c1.b = sum1[0] / count1;
+            c1.g = sum1[1] / count1;
+            c1.r = sum1[2] / count1;
+        }
+        if (count0 > 0) {
+            c0.b = (total[0] - sum1[0]) / count0;
+            c0.g = (total[1] - sum1[1]) / count0;
+            c0.r = (total[2] - sum1[2]) / count0;
+        }
+        if (changed == 0 && iteration > 0) {
+            break;
+        }
+    }
+
+    // Background = majority cluster of the four corners (ties: cluster 0)
+    const size_t w = pixels.width;
+    const size_t last = pixels.count - 1;
+    const int cornerOnes = pixels.labels[0] + pixels.labels[w - 1]
+                         + pixels.labels[last - (w - 1)] + pixels.labels[last];
+    const int background = cornerOnes >= 3 ? 1 : 0;
+    jersey = background == 1 ? c0 : c1;
+    return true;
+}
+
+struct Job
+{
+    const uint8_t *frame;
+    int frameWidth;
+    const int32_t *boxes;
+    double *colors;
+    const double *teamCenters;   // nullptr: no prediction
+    int32_t *teams;
+    Py_ssize_t count;
+};
+
+void runJob(const Job &job, std::atomic<Py_ssize_t> &next)
+{
+    Pixels pixels;
+    for (Py_ssize_t n = next++; n < job.count; n = next++) {
+        loadPixels(job.frame, job.frameWidth, job.boxes + n * 4, pixels);
+
+        Color jersey;
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        if (!jerseyColor(pixels, jersey)) {
+            jersey.b = jersey.g = jersey.r = nan;
+        }
+        job.colors[n * 3] = jersey.b;
+        job.colors[n * 3 + 1] = jersey.g;
+        job.colors[n * 3 + 2] = jersey.r;
+
+        if (job.teamCenters) {
+            double distance[2];
+            for (int team = 0; team < 2; ++team) {
+                const double *center = job.teamCenters + team * 3;
+                const double db = jersey.b - center[0];
+                const double dg = jersey.g - center[1];
+                const double dr = jersey.r - center[2];
+                distance[team] = db * db + dg * dg + dr * dr;
+            }
+            job.teams[n] = distance[1] < distance[0] ? 1 : 0;
+        }
+    }
+}
+
+PyObject *clusterCrops(PyObject *, PyObject *args)
+{
+    Py_buffer frame, boxes, colors, teamCenters, teams;
+    int height = 0, width = 0, threads = 0;
+    if (!PyArg_ParseTuple(args, "y*iiy*w*y*w*i", &frame, &height, &width, &boxes,
+                          &colors, &teamCenters, &teams, &threads)) {
+        return nullptr;
+    }
+
+    struct Release
+    {
+        Py_buffer *buffers[5];
+        ~Release() { for (Py_buffer *b : buffers) PyBuffer_Release(b); }
+    } release{{&frame, &boxes, &colors, &teamCenters, &teams}};
+
+    const Py_ssize_t count = boxes.len / static_cast<Py_ssize_t>(4 * sizeof(int32_t));
+    const bool predict = teamCenters.len > 0;
+
+    if (height < 0 || width < 0 ||
+        frame.len < static_cast<Py_ssize_t>(height) * width * 3 ||
+        colors.len < count * static_cast<Py_ssize_t>(3 * sizeof(double)) ||
+        (predict && (teamCenters.len < static_cast<Py_ssize_t>(6 * sizeof(double)) ||
+                     teams.len < count * static_cast<Py_ssize_t>(sizeof(int32_t))))) {
+        PyErr_SetString(PyExc_ValueError, "cluster_crops: buffer sizes do not match");
+        return nullptr;
+    }
+
+    const int32_t *box = static_cast<const int32_t *>(boxes.buf);
+    for (Py_ssize_t n = 0; n < count; ++n, box += 4) {
+        if (box[0] < 0 || box[1] < 0 || box[2] > width || box[3] > height ||
+            box[2] < box[0] || box[3] < box[1]) {
+            PyErr_SetString(PyExc_ValueError, "cluster_crops: box outside the frame");
+            return nullptr;
+        }
+    }
+
+    Job job;
+    job.frame = static_cast<const uint8_t *>(frame.buf);
+    job.frameWidth = width;
+    job.boxes = static_cast<const int32_t *>(boxes.buf);
+    job.colors = static_cast<double *>(colors.buf);
+    job.teamCenters = predict ? static_cast<const double *>(teamCenters.buf) : nullptr;
+    job.teams = static_cast<int32_t *>(teams.buf);
+    job.count = count;
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threads = static_cast<int>(std::min<Py_ssize_t>(threads, std::max<Py_ssize_t>(count, 1)));
+
+    Py_BEGIN_ALLOW_THREADS
+    std::atomic<Py_ssize_t> next(0);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(runJob, std::cref(job), std::ref(next));
+    }
+    runJob(job, next);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+PyObject *simdName(PyObject *, PyObject *)
+{
+#if defined(JERSEY_SSE2)
+    return PyUnicode_FromString("sse2");
+#elif defined(JERSEY_NEON)
+    return PyUnicode_FromString("neon");
+#else
+    return PyUnicode_FromString("scalar");
+#endif
+}
+
+PyMethodDef methods[] = {
+    {"cluster_crops", clusterCrops, METH_VARARGS,
+     "Jersey colors (and optional team predictions) for all boxes of a frame."},
+    {"simd", simdName, METH_NOARGS, "Instruction set used by the kernel."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef moduleDef = {
+    PyModuleDef_HEAD_INIT, "_jersey_color",
+    "Native two-cluster jersey color kernel.", -1, methods,
+    nullptr, nullptr, nullptr, nullptr
+};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit__jersey_color(void)
+{
+    return PyModule_Create(&moduleDef);
+}
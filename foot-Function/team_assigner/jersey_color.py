@@ -0,0 +1,158 @@
+"""
+===============================================================================
+JERSEY COLOR KERNEL
+===============================================================================
+
+Batch interface to the two-cluster jersey color kernel used by
+TeamAssigner. All player crops of a frame are processed in one call.
+
+IMPLEMENTATIONS:
+- Native: team_assigner/_jersey_color (jersey_color.cpp), SIMD assignment
+  step and one thread per crop batch slice. Build it with
+      python setup.py build_ext --inplace
+  in the foot-Function directory.
+- NumPy: the same algorithm in vectorized NumPy, used automatically when
+  the native module has not been built. The assignment step uses the
+  native float32 arithmetic, so both give the same colors
+  (benchmarks/jersey_color_parity.py checks this).
+
+ALGORITHM (per crop, both implementations):
+1. Take the top half of the bounding box
+2. k-means with two clusters, initialized with the pixel farthest from the
+   mean color and the pixel farthest from that one
+3. The cluster holding most corner pixels is background; the other
+   cluster's center is the jersey color
+4. Optionally: the nearest of the two team colors gives the team
+===============================================================================
+"""
+
+import numpy as np
+
+try:
+    from . import _jersey_color as _native
+except ImportError:
+    _native = None
+
+MAX_ITERATIONS = 100
+
+
+def native_available():
+    """True if the compiled kernel is available."""
+    return _native is not None
+
+
+def implementation():
+    """Name of the implementation in use (e.g. 'native-sse2' or 'numpy')."""
+    return f"native-{_native.simd()}" if _native is not None else 'numpy'
+
+
+def crop_boxes(bboxes, height, width):
+    """
+    Integer crop boxes with NumPy slicing semantics.
+
+    Matches frame[int(y1):int(y2), int(x1):int(x2)] as used by
+    get_player_color, including negative and out-of-range coordinates.
+
+    Args:
+        bboxes: (N, 4) bounding boxes [x1, y1, x2, y2]
+        height: Frame height
+        width: Frame width
+
+    Returns:
+        (N, 4) int32 array of [x_start, y_start, x_stop, y_stop]
+    """
+    boxes = np.zeros((len(bboxes), 4), dtype=np.int32)
+    for n, (x1, y1, x2, y2) in enumerate(bboxes):
+        x_start, x_stop, _ = slice(int(x1), int(x2)).indices(width)
+        y_start, y_stop, _ = slice(int(y1), int(y2)).indices(height)
+        boxes[n] = (x_start, y_start, max(x_stop, x_start), max(y_stop, y_start))
+    return boxes
+
+
+def jersey_colors(frame, bboxes, team_centers=None, threads=0):
+    """
+    Jersey colors of all players of a frame, optionally with their teams.
+
+    Args:
+        frame: BGR video frame (H, W, 3) uint8
+        bboxes: (N, 4) player bounding boxes
+        team_centers: (2, 3) team colors, or None to skip team prediction
+        threads: Threads for the native kernel (0 = all cores)
+
+    Returns:
+        (colors, teams): (N, 3) float64 colors (NaN for empty crops) and
+        (N,) team indices 0/1, or None without team_centers
+    """
+    frame = np.ascontiguousarray(frame, dtype=np.uint8)
+    height, width = frame.shape[:2]
+    boxes = crop_boxes(bboxes, height, width)
+    count = len(boxes)
+
+    colors = np.empty((count, 3), dtype=np.float64)
+    teams = np.zeros(count, dtype=np.int32)
+    centers = (np.ascontiguousarray(team_centers, dtype=np.float64).reshape(2, 3)
+               if team_centers is not None else np.zeros(0, dtype=np.float64))
+
+    if count == 0:
+        return colors, (teams if team_centers is not None else None)
+
+    if _native is not None:
+        _native.cluster_crops(frame, height, width, boxes, colors, centers, teams, int(threads))
+    else:
+        for n, (x1, y1, x2, y2) in enumerate(boxes):
+            colors[n] = _numpy_jersey_color(frame[y1:y2, x1:x2])
+        if team_centers is not None:
+            distances = ((colors[:, None, :] - centers[None, :, :]) ** 2).sum(axis=2)
+            teams[:] = (distances[:, 1] < distances[:, 0]).astype(np.int32)
+
+    return colors, (teams if team_centers is not None else None)
+
+
+def _numpy_jersey_color(image):
+    """NumPy implementation of the kernel for one crop."""
+    top_half_image = image[0:int(image.shape[0] / 2), :]
+    rows, columns = top_half_image.shape[:2]
+    if rows == 0 or columns == 0:
+        return np.full(3, np.nan)
+
+    pixels = top_half_image.reshape(-1, 3).astype(np.float64)
+    pixels_32 = pixels.astype(np.float32)
+    total = pixels.sum(axis=0)
+
+    def farthest(color):
+        return pixels[np.argmax(((pixels - color) ** 2).sum(axis=1))]
+
+    def assign_distance(center):
+        # float32 in the native operation order (b, g, r), so both
+        # implementations break near-ties the same way
+        difference = pixels_32 - center.astype(np.float32)
+        squared = difference * difference
+        return squared[:, 0] + squared[:, 1] + squared[:, 2]
+
+    center_0 = farthest(total / len(pixels)).copy()
+    center_1 = farthest(center_0).copy()
+
+    labels = np.zeros(len(pixels), dtype=bool)
+    for iteration in range(MAX_ITERATIONS):
+        distance_0 = assign_distance(center_0)
+        distance_1 = assign_distance(center_1)
+        new_labels = distance_1 < distance_0
+        changed = np.count_nonzero(new_labels != labels)
+        labels = new_labels
+
+        # An empty cluster keeps its previous center
+        count_1 = np.count_nonzero(labels)
+        if count_1 > 0:
+            sum_1 = pixels[labels].sum(axis=0)
+            center_1 = sum_1 / count_1
+        else:
+            sum_1 = np.zeros(3)
+        if count_1 < len(pixels):
+            center_0 = (total - sum_1) / (len(pixels) - count_1)
+        if changed == 0 and iteration > 0:
+            break
+
+    clustered_image = labels.reshape(rows, columns)
+    corner_ones = (int(clustered_image[0, 0]) + int(clustered_image[0, -1])
+                   + int(clustered_image[-1, 0]) + int(clustered_image[-1, -1]))
+    return center_0 if corner_ones >= 3 else center_1
@@ -15,6 +15,9 @@ ALGORITHM:
 5. Cluster all jersey colors into 2 teams using K-means
 6. Assign each player to nearest team cluster by color similarity
 
+Steps 1-3 and 6 run in the batch jersey color kernel (jersey_color.py,
+native SIMD/multi-threaded when built); only step 5 uses sklearn.
+
 KEY ASSUMPTIONS:
 - Two distinct team jersey colors
 - Top half of player bbox contains jersey
@@ -24,12 +27,19 @@ KEY ASSUMPTIONS:
 USAGE:
 1. Initialize TeamAssigner
 2. Call assign_team_color() on first frame with all players
-3. Call get_player_team() for each player in each frame
+3. Call get_player_teams() with all new players of a frame
+   (or get_player_team() for a single player)
 4. Team assignments (1 or 2) are cached for consistent tracking
 ===============================================================================
 """
 
 from sklearn.cluster import KMeans
+import cv2
+import numpy as np
+import sys
+sys.path.append('../')
+from track_store import PLAYER
+from .jersey_color import jersey_colors
 
 
 ################################################################################
@@ -48,44 +58,38 @@ class TeamAssigner:
         """Initialize team assigner with empty color and assignment dictionaries."""
         self.team_colors = {}           # Maps team_id -> RGB color
         self.player_team_dict = {}      # Caches player_id -> team_id assignments
+        self.threads = max(cv2.getNumThreads(), 1)  # Jersey color kernel threads
     
     # =========================================================================
     # COLOR EXTRACTION
     # =========================================================================
     
-    def get_clustering_model(self,image):
+    def get_player_colors(self, frame, bboxes):
         """
-        Create K-means model to separate jersey from background.
+        Extract the dominant jersey colors of several players at once.
         
-        Clusters pixels into 2 groups (jersey vs background) to isolate
-        the dominant jersey color.
+        PROCESS (per player, see jersey_color.py):
+        1. Crop to player bounding box
+        2. Take top half (where jersey is visible)
+        3. Cluster pixels into jersey vs background
+        4. Identify jersey cluster (not in corners)
+        5. Return jersey cluster center color
         
         Args:
-            image: Player image crop (numpy array)
+            frame: Video frame
+            bboxes: Player bounding boxes [[x1, y1, x2, y2], ...]
             
         Returns:
-            Fitted KMeans model with 2 clusters
+            (N, 3) array of jersey colors (BGR)
         """
-        # Reshape the image to 2D array
-        image_2d = image.reshape(-1,3)
-
-        # Preform K-means with 2 clusters
-        kmeans = KMeans(n_clusters=2, init="k-means++",n_init=1)
-        kmeans.fit(image_2d)
-
-        return kmeans
+        colors, _ = jersey_colors(frame, np.asarray(bboxes, dtype=np.float64).reshape(-1, 4),
+                                  threads=self.threads)
+        return colors
 
     def get_player_color(self,frame,bbox):
         """
         Extract the dominant jersey color for a player.
         
-        PROCESS:
-        1. Crop to player bounding box
-        2. Take top half (where jersey is visible)
-        3. Cluster pixels into jersey vs background
-        4. Identify jersey cluster (not in corners)
-        5. Return jersey cluster center color
-        
         Args:
             frame: Video frame
             bbox: Player bounding box [x1, y1, x2, y2]
@@ -93,27 +97,7 @@ class TeamAssigner:
         Returns:
             RGB color array representing jersey color
         """
-        image = frame[int(bbox[1]):int(bbox[3]),int(bbox[0]):int(bbox[2])]
-
-        top_half_image = image[0:int(image.shape[0]/2),:]
-
-        # Get Clustering model
-        kmeans = self.get_clustering_model(top_half_image)
-
-        # Get the cluster labels forr each pixel
-        labels = kmeans.labels_
-
-        # Reshape the labels to the image shape
-        clustered_image = labels.reshape(top_half_image.shape[0],top_half_image.shape[1])
-
-        # Get the player cluster
-        corner_clusters = [clustered_image[0,0],clustered_image[0,-1],clustered_image[-1,0],clustered_image[-1,-1]]
-        non_player_cluster = max(set(corner_clusters),key=corner_clusters.count)
-        player_cluster = 1 - non_player_cluster
-
-        player_color = kmeans.cluster_centers_[player_cluster]
-
-        return player_color
+        return self.get_player_colors(frame, [bbox])[0]
 
 
     # =========================================================================
@@ -132,11 +116,8 @@ class TeamAssigner:
             player_detections: Dictionary of player detections {player_id: {bbox: [...]}}
         """
         
-        player_colors = []
-        for _, player_detection in player_detections.items():
-            bbox = player_detection["bbox"]
-            player_color =  self.get_player_color(frame,bbox)
-            player_colors.append(player_color)
+        bboxes = [player_detection["bbox"] for player_detection in player_detections.values()]
+        player_colors = self.get_player_colors(frame, bboxes)
         
         kmeans = KMeans(n_clusters=2, init="k-means++",n_init=10)
         kmeans.fit(player_colors)
@@ -162,17 +143,54 @@ class TeamAssigner:
         Returns:
             Team ID (1 or 2)
         """
-        if player_id in self.player_team_dict:
-            return self.player_team_dict[player_id]
+        return self.get_player_teams(frame, [player_bbox], [player_id])[0]
 
-        player_color = self.get_player_color(frame,player_bbox)
+    def get_player_teams(self, frame, player_bboxes, player_ids):
+        """
+        Determine the teams of several players of one frame in one batch.
+        
+        Players with a cached assignment are skipped; the jersey colors of
+        the others are extracted and matched to the nearest team color by
+        the kernel in a single call.
+        
+        Args:
+            frame: Current video frame
+            player_bboxes: Player bounding boxes [[x1, y1, x2, y2], ...]
+            player_ids: Tracking IDs, parallel to player_bboxes
+            
+        Returns:
+            List of team IDs (1 or 2), parallel to player_ids
+        """
+        new = [n for n, player_id in enumerate(player_ids) if player_id not in self.player_team_dict]
+        if new:
+            bboxes = np.asarray([player_bboxes[n] for n in new], dtype=np.float64).reshape(-1, 4)
+            _, teams = jersey_colors(frame, bboxes, self.kmeans.cluster_centers_,
+                                     threads=self.threads)
+            for n, team_index in zip(new, teams):
+                player_id = player_ids[n]
+                team_id = int(team_index) + 1
 
-        team_id = self.kmeans.predict(player_color.reshape(1,-1))[0]
-        team_id+=1
+                if player_id ==91:
+                    team_id=1
 
-        if player_id ==91:
-            team_id=1
+                self.player_team_dict[player_id] = team_id
 
-        self.player_team_dict[player_id] = team_id
+        return [self.player_team_dict[player_id] for player_id in player_ids]
 
-        return team_id
+    def add_team_to_store(self, store):
+        """
+        Write the cached team assignments into a TrackStore.
+        
+        Teams are fixed per player id once get_player_team() has seen the
+        player, so the team column is filled by id for all frames at once.
+        Players that were never assigned keep team 0.
+        
+        Args:
+            store: TrackStore whose player rows receive a team
+        """
+        rows = store.class_rows(PLAYER)
+        track_ids, inverse = np.unique(store.track_id[rows], return_inverse=True)
+        teams = np.array([self.player_team_dict.get(int(track_id), 0) for track_id in track_ids],
+                         dtype=np.int8)
+        store.team[rows] = teams[inverse] if len(teams) else 0
+        store.team_colors = dict(self.team_colors)
@@ -0,0 +1,3 @@
+from .track_store import (TrackStore, TrackStoreBuilder, PLAYER, REFEREE, BALL,
+                          OBJECT_NAMES)
+from .telemetry import write_telemetry, read_telemetry, Telemetry, TELEMETRY_COLUMNS
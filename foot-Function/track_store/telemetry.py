@@ -0,0 +1,247 @@
+"""
+===============================================================================
+BINARY TRACK TELEMETRY
+===============================================================================
+
+This module exports the full TrackStore (every object in every frame) as
+a compact columnar binary file that can be memory-mapped without parsing,
+and reads it back.
+
+WHY:
+data_output.json/csv hold only the final distance of the players present
+in the last frame and possession percentages. The telemetry file keeps
+everything the pipeline computed per frame, at 59 bytes per row, and
+readers map the columns they need straight from disk (numpy.memmap in
+Python, QFile::map in the GUI, see TrackTelemetry.h).
+
+FILE LAYOUT (tracks.ftrk, little-endian):
+
+    offset  size  field
+    0       8     magic b'FOOTTRK\\0'
+    8       2     uint16 format version (1)
+    10      2     uint16 column count C
+    12      4     uint32 header size H (fixed header + column directory,
+                  padded to 64 bytes); the first column starts at H
+    16      8     uint64 row count N
+    24      4     uint32 video frame count (frames may have no rows)
+    28      4     float32 frames per second (0 when unknown)
+    32      12    float32[3] team 1 color (BGR, NaN when not assigned)
+    44      12    float32[3] team 2 color
+    56      8     reserved (zero)
+    64      32*C  column directory, one entry per column:
+                    16  name, ASCII, NUL padded
+                    4   numpy dtype string, NUL padded ('<i4', '<f4', '|i1', '|u1')
+                    4   uint32 components per row (1, 2 or 4)
+                    8   uint64 byte offset of the column from the file start
+
+Every column is N * components values stored contiguously (row-major)
+and starts on a 64-byte boundary. Rows are sorted by frame.
+
+COLUMNS (version 1):
+- frame, track_id                 int32
+- cls                             int8  (0 player, 1 referee, 2 ball)
+- team                            int8  (0 = not assigned)
+- has_ball                        uint8 (0/1)
+- bbox                            float32 x4 [x1, y1, x2, y2] (pixels)
+- position, position_adjusted     float32 x2 (pixels)
+- position_transformed            float32 x2 (meters on the pitch)
+- speed                           float32 (km/h)
+- distance                        float32 (meters covered so far)
+Missing values are NaN. Readers look columns up by name in the directory,
+so columns added by later versions do not break them.
+
+USAGE:
+    write_telemetry(store, 'output_videos/run/tracks.ftrk', fps=25)
+    telemetry = read_telemetry('output_videos/run/tracks.ftrk')
+    rows = telemetry.frame_slice(100)
+    speeds = telemetry['speed'][rows]
+===============================================================================
+"""
+
+import os
+import struct
+
+import numpy as np
+
+MAGIC = b'FOOTTRK\0'
+FORMAT_VERSION = 1
+ALIGNMENT = 64
+
+# Fixed header: magic, version, column count, header size, rows, frames,
+# fps, team 1 color, team 2 color, reserved
+_HEADER = struct.Struct('<8sHHIQIf3f3f8x')
+_DIRECTORY_ENTRY = struct.Struct('<16s4sIQ')
+
+# Column name -> (stored dtype, components per row); same names as TrackStore
+TELEMETRY_COLUMNS = {
+    'frame': ('<i4', 1),
+    'track_id': ('<i4', 1),
+    'cls': ('|i1', 1),
+    'team': ('|i1', 1),
+    'has_ball': ('|u1', 1),
+    'bbox': ('<f4', 4),
+    'position': ('<f4', 2),
+    'position_adjusted': ('<f4', 2),
+    'position_transformed': ('<f4', 2),
+    'speed': ('<f4', 1),
+    'distance': ('<f4', 1),
+}
+
+
+def _aligned(offset):
+    return (offset + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def _team_color(team_colors, team):
+    color = team_colors.get(team)
+    if color is None:
+        return (np.nan, np.nan, np.nan)
+    return tuple(float(c) for c in np.asarray(color, dtype=np.float64)[:3])
+
+
+def write_telemetry(store, output_path, fps=0.0):
+    """
+    Write all columns of a TrackStore to a telemetry file.
+
+    The file is written under a temporary name and renamed into place, so
+    readers never map a partial file.
+
+    Args:
+        store: TrackStore
+        output_path: Destination (.ftrk)
+        fps: Frame rate of the video (0 when unknown)
+
+    Returns:
+        Size of the file in bytes
+    """
+    rows = len(store)
+    header_size = _aligned(_HEADER.size + _DIRECTORY_ENTRY.size * len(TELEMETRY_COLUMNS))
+
+    directory = []
+    offset = header_size
+    for name, (dtype, components) in TELEMETRY_COLUMNS.items():
+        directory.append(_DIRECTORY_ENTRY.pack(name.encode('ascii'), dtype.encode('ascii'),
+                                               components, offset))
+        offset = _aligned(offset + rows * components * np.dtype(dtype).itemsize)
+
+    header = _HEADER.pack(
+        MAGIC, FORMAT_VERSION, len(TELEMETRY_COLUMNS), header_size, rows,
+        store.frame_count, float(fps or 0.0),
+        *_team_color(store.team_colors, 1), *_team_color(store.team_colors, 2)
+    )
+
+    output_dir = os.path.dirname(output_path)
+    if output_dir and not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+
+    temp_path = output_path + '.tmp'
+    with open(temp_path, 'wb') as f:
+        f.write(header)
+        f.write(b''.join(directory))
+        for name, (dtype, _) in TELEMETRY_COLUMNS.items():
+            f.seek(_aligned(f.tell()))
+            np.ascontiguousarray(getattr(store, name), dtype=dtype).tofile(f)
+        f.truncate(_aligned(f.tell()))
+    os.replace(temp_path, output_path)
+    return os.path.getsize(output_path)
+
+
+################################################################################
+# TELEMETRY READER
+################################################################################
+
+class Telemetry:
+    """
+    Memory-mapped columns of a telemetry file.
+
+    telemetry['speed'] returns a read-only numpy.memmap; pages are read from
+    disk only when accessed.
+    """
+
+    def __init__(self, path):
+        """
+        Args:
+            path: Telemetry file written by write_telemetry()
+
+        Raises:
+            ValueError: The file is not a telemetry file or is truncated
+        """
+        self.path = path
+        size = os.path.getsize(path)
+        with open(path, 'rb') as f:
+            fixed = f.read(_HEADER.size)
+            if len(fixed) < _HEADER.size or not fixed.startswith(MAGIC):
+                raise ValueError(f"Not a track telemetry file: {path}")
+            (_, self.version, column_count, header_size, self.rows, self.frame_count,
+             self.fps, *colors) = _HEADER.unpack(fixed)
+            entries = f.read(_DIRECTORY_ENTRY.size * column_count)
+
+        if len(entries) < _DIRECTORY_ENTRY.size * column_count or header_size > size:
+            raise ValueError(f"Truncated track telemetry file: {path}")
+
+        self.team_colors = {
+            team: color for team, color in ((1, colors[:3]), (2, colors[3:]))
+            if not np.isnan(color[0])
+        }
+
+        self._columns = {}
+        for i in range(column_count):
+            name, dtype, components, offset = _DIRECTORY_ENTRY.unpack_from(
+                entries, i * _DIRECTORY_ENTRY.size
+            )
+            name = name.rstrip(b'\0').decode('ascii')
+            dtype = np.dtype(dtype.rstrip(b'\0').decode('ascii'))
+            shape = (self.rows,) if components == 1 else (self.rows, components)
+            if offset + self.rows * components * dtype.itemsize > size:
+                raise ValueError(f"Truncated track telemetry file: {path} (column {name})")
+            self._columns[name] = (dtype, shape, offset)
+
+        self._mapped = {}
+        self._frame_offsets = None
+
+    def __len__(self):
+        return self.rows
+
+    def __contains__(self, name):
+        return name in self._columns
+
+    def __getitem__(self, name):
+        if name not in self._mapped:
+            dtype, shape, offset = self._columns[name]
+            if self.rows == 0:
+                self._mapped[name] = np.empty(shape, dtype=dtype)
+            else:
+                self._mapped[name] = np.memmap(self.path, dtype=dtype, mode='r',
+                                               offset=offset, shape=shape)
+        return self._mapped[name]
+
+    @property
+    def columns(self):
+        """Names of the columns in the file."""
+        return list(self._columns)
+
+    def frame_slice(self, frame_num):
+        """
+        Row range of one frame (rows are sorted by frame).
+
+        Returns:
+            slice usable on every column
+        """
+        if self._frame_offsets is None:
+            self._frame_offsets = np.searchsorted(
+                self['frame'], np.arange(self.frame_count + 1), side='left'
+            )
+        return slice(int(self._frame_offsets[frame_num]), int(self._frame_offsets[frame_num + 1]))
+
+
+def read_telemetry(path):
+    """
+    Open a telemetry file for reading.
+
+    Args:
+        path: Telemetry file (.ftrk)
+
+    Returns:
+        Telemetry
+    """
+    return Telemetry(path)
@@ -0,0 +1,514 @@
+"""
+===============================================================================
+COLUMNAR TRACK STORE
+===============================================================================
+
+This module stores every tracked object of a video in flat column arrays
+instead of the nested per-frame dictionaries produced by the tracker
+(tracks[object][frame][track_id] = {...}).
+
+WHY COLUMNS:
+A full match has millions of object observations. As dictionaries every
+observation costs roughly a kilobyte of Python objects (the dict, a bbox
+list, position tuples, boxed floats), and every post-detection stage walks
+all of them in interpreted loops. As columns an observation costs about
+90 bytes and stages operate on whole arrays at once.
+
+LAYOUT:
+One row per object per frame, rows sorted by frame (and in detection
+order within a frame):
+- frame, track_id, cls               int32, int32, int8 (PLAYER/REFEREE/BALL)
+- bbox                               float32 (N, 4) [x1, y1, x2, y2]
+- position, position_adjusted,
+  position_transformed               float64 (N, 2), NaN when not available
+- speed, distance                    float64, NaN when not available
+- team                               int8, 0 = not assigned
+- has_ball                           bool
+Team colors are per team, so they live in the team_colors dictionary.
+
+EDITING:
+- replace_class(cls, ...): swap all rows of a class (interpolated ball)
+- add_rows(...): insert rows (boxes filled in between keyframes)
+
+VIEWS:
+- frame_slice(frame): contiguous row range of one frame
+- track_rows(cls, track_id): rows of one track in frame order
+- find_rows(cls, frames, track_ids): vectorized (frame, track) lookup
+
+COMPATIBILITY:
+as_tracks() returns a read-only object with the old tracks[object][frame]
+interface whose per-frame dictionaries are built on demand, so the
+drawing code and output_data work unchanged.
+
+USAGE:
+    builder = TrackStoreBuilder()
+    for frame_tracks in per_frame_tracks:
+        builder.append_frame(frame_tracks)
+    store = builder.build()
+===============================================================================
+"""
+
+from array import array
+
+import numpy as np
+
+# Object classes (values of the cls column)
+PLAYER = 0
+REFEREE = 1
+BALL = 2
+
+# Keys of the nested tracks dictionary, indexed by class
+OBJECT_NAMES = ('players', 'referees', 'ball')
+
+# Column name -> (dtype, shape of one row, fill value for new rows)
+COLUMNS = {
+    'frame': (np.int32, (), 0),
+    'track_id': (np.int32, (), 0),
+    'cls': (np.int8, (), 0),
+    'bbox': (np.float32, (4,), np.nan),
+    'position': (np.float64, (2,), np.nan),
+    'position_adjusted': (np.float64, (2,), np.nan),
+    'position_transformed': (np.float64, (2,), np.nan),
+    'speed': (np.float64, (), np.nan),
+    'distance': (np.float64, (), np.nan),
+    'team': (np.int8, (), 0),
+    'has_ball': (np.bool_, (), False),
+}
+
+# Columns produced by detection; everything else is derived from them
+DETECTION_COLUMNS = ('frame', 'track_id', 'cls', 'bbox')
+
+
+def _empty_column(name, size):
+    dtype, shape, fill = COLUMNS[name]
+    return np.full((size,) + shape, fill, dtype=dtype)
+
+
+################################################################################
+# TRACK STORE CLASS
+################################################################################
+
+class TrackStore:
+    """
+    All object tracks of one video as contiguous column arrays.
+    """
+
+    def __init__(self, frame, track_id, cls, bbox, frame_count):
+        """
+        Create a store from detection columns; derived columns start empty.
+
+        Args:
+            frame: Frame index per row
+            track_id: Track id per row
+            cls: Object class per row (PLAYER, REFEREE or BALL)
+            bbox: (N, 4) bounding boxes
+            frame_count: Number of frames in the video (frames may have no rows)
+        """
+        frame = np.asarray(frame, dtype=np.int32)
+        # Stable sort keeps the detection order within a frame
+        order = np.argsort(frame, kind='stable')
+
+        self.frame_count = int(frame_count)
+        self.frame = frame[order]
+        self.track_id = np.asarray(track_id, dtype=np.int32)[order]
+        self.cls = np.asarray(cls, dtype=np.int8)[order]
+        self.bbox = np.asarray(bbox, dtype=np.float32).reshape(-1, 4)[order]
+        for name in COLUMNS:
+            if name not in DETECTION_COLUMNS:
+                setattr(self, name, _empty_column(name, len(self.frame)))
+
+        self.team_colors = {}
+        self._reset_indexes()
+
+    @classmethod
+    def from_tracks(cls, tracks):
+        """
+        Build a store from the nested tracks dictionary of the tracker.
+
+        Only the detections (bounding boxes) are imported; positions, speed,
+        teams and possession are recomputed by the pipeline stages.
+
+        Args:
+            tracks: {'players': [...], 'referees': [...], 'ball': [...]}
+
+        Returns:
+            TrackStore
+        """
+        builder = TrackStoreBuilder()
+        frame_count = max((len(tracks.get(name, [])) for name in OBJECT_NAMES), default=0)
+        for frame_num in range(frame_count):
+            builder.append_frame({
+                name: tracks[name][frame_num]
+                for name in OBJECT_NAMES
+                if frame_num < len(tracks.get(name, []))
+            })
+        return builder.build()
+
+    @classmethod
+    def from_columns(cls, columns):
+        """
+        Rebuild a store from the dictionary returned by detection_columns().
+
+        Args:
+            columns: Detection columns plus 'frame_count'
+
+        Returns:
+            TrackStore
+        """
+        return cls(columns['frame'], columns['track_id'], columns['cls'],
+                   columns['bbox'], columns['frame_count'])
+
+    def detection_columns(self):
+        """
+        Detection columns as a plain dictionary of arrays (used for caching).
+
+        Returns:
+            Dictionary with frame, track_id, cls, bbox and frame_count
+        """
+        columns = {name: getattr(self, name) for name in DETECTION_COLUMNS}
+        columns['frame_count'] = self.frame_count
+        return columns
+
+    def __len__(self):
+        return len(self.frame)
+
+    @property
+    def nbytes(self):
+        """Memory used by the column arrays in bytes."""
+        return sum(getattr(self, name).nbytes for name in COLUMNS)
+
+    # =========================================================================
+    # VIEWS
+    # =========================================================================
+
+    def _reset_indexes(self):
+        """Recompute the frame offsets and drop lazily built lookup indexes."""
+        self._frame_offsets = np.searchsorted(
+            self.frame, np.arange(self.frame_count + 1), side='left'
+        )
+        self._id_span = int(self.track_id.max()) + 1 if len(self.track_id) else 1
+        self._class_rows = {}
+        self._lookup = {}
+        self._track_groups = None
+
+    def frame_slice(self, frame_num):
+        """
+        Row range of one frame.
+
+        Args:
+            frame_num: Frame index
+
+        Returns:
+            slice usable on every column
+        """
+        return slice(self._frame_offsets[frame_num], self._frame_offsets[frame_num + 1])
+
+    def class_rows(self, object_cls):
+        """
+        Rows of one object class in frame order.
+
+        Args:
+            object_cls: PLAYER, REFEREE or BALL
+
+        Returns:
+            Array of row indices
+        """
+        if object_cls not in self._class_rows:
+            self._class_rows[object_cls] = np.flatnonzero(self.cls == object_cls)
+        return self._class_rows[object_cls]
+
+    def find_rows(self, object_cls, frames, track_ids):
+        """
+        Look up the rows of (frame, track id) pairs of one class.
+
+        Args:
+            object_cls: PLAYER, REFEREE or BALL
+            frames: Frame indices (array or scalar)
+            track_ids: Track ids (array or scalar, broadcast against frames)
+
+        Returns:
+            Array of row indices, -1 where the track is not in that frame
+        """
+        if object_cls not in self._lookup:
+            rows = self.class_rows(object_cls)
+            keys = self.frame[rows].astype(np.int64) * self._id_span + self.track_id[rows]
+            order = np.argsort(keys, kind='stable')
+            self._lookup[object_cls] = (keys[order], rows[order])
+        keys, rows = self._lookup[object_cls]
+
+        frames, track_ids = np.broadcast_arrays(
+            np.asarray(frames, dtype=np.int64), np.asarray(track_ids, dtype=np.int64)
+        )
+        queries = frames * self._id_span + track_ids
+        if len(keys) == 0:
+            return np.full(queries.shape, -1, dtype=np.int64)
+
+        positions = np.minimum(np.searchsorted(keys, queries), len(keys) - 1)
+        found = (keys[positions] == queries) & (track_ids >= 0) & (track_ids < self._id_span)
+        return np.where(found, rows[positions], -1)
+
+    def track_ids(self, object_cls):
+        """
+        Distinct track ids of one class.
+
+        Args:
+            object_cls: PLAYER, REFEREE or BALL
+
+        Returns:
+            Sorted array of track ids
+        """
+        return np.unique(self.track_id[self.class_rows(object_cls)])
+
+    def track_rows(self, object_cls, track_id):
+        """
+        Rows of one track in frame order.
+
+        Args:
+            object_cls: PLAYER, REFEREE or BALL
+            track_id: Track id
+
+        Returns:
+            Array of row indices (empty if the track does not exist)
+        """
+        if self._track_groups is None:
+            order = np.lexsort((self.frame, self.track_id, self.cls))
+            cls_sorted = self.cls[order]
+            id_sorted = self.track_id[order]
+            starts = np.flatnonzero(np.r_[
+                True, (cls_sorted[1:] != cls_sorted[:-1]) | (id_sorted[1:] != id_sorted[:-1])
+            ]) if len(order) else np.zeros(0, dtype=np.int64)
+            ends = np.r_[starts[1:], len(order)]
+            groups = {
+                (int(cls_sorted[start]), int(id_sorted[start])): (start, end)
+                for start, end in zip(starts.tolist(), ends.tolist())
+            }
+            self._track_groups = (order, groups)
+
+        order, groups = self._track_groups
+        start, end = groups.get((int(object_cls), int(track_id)), (0, 0))
+        return order[start:end]
+
+    def first_rows(self, object_cls):
+        """
+        Row where each track of a class first appears, in frame order.
+
+        Args:
+            object_cls: PLAYER, REFEREE or BALL
+
+        Returns:
+            Array of row indices
+        """
+        rows = self.class_rows(object_cls)
+        _, first = np.unique(self.track_id[rows], return_index=True)
+        return rows[np.sort(first)]
+
+    # =========================================================================
+    # EDITING
+    # =========================================================================
+
+    def replace_class(self, object_cls, frames, track_ids, bbox):
+        """
+        Replace all rows of one class (e.g. with interpolated ball boxes).
+
+        The new rows start with empty derived columns.
+
+        Args:
+            object_cls: Class whose rows are replaced
+            frames: Frame index per new row
+            track_ids: Track id per new row
+            bbox: (M, 4) bounding boxes of the new rows
+        """
+        self._merge_rows(self.cls != object_cls, object_cls, frames, track_ids, bbox)
+
+    def add_rows(self, object_cls, frames, track_ids, bbox):
+        """
+        Insert rows (e.g. boxes filled in between detected frames).
+
+        The new rows start with empty derived columns and are placed after
+        the existing rows of their frame.
+
+        Args:
+            object_cls: Class per new row (array or scalar)
+            frames: Frame index per new row
+            track_ids: Track id per new row
+            bbox: (M, 4) bounding boxes of the new rows
+        """
+        if len(frames):
+            self._merge_rows(np.ones(len(self.frame), dtype=bool), object_cls, frames, track_ids, bbox)
+
+    def _merge_rows(self, keep, object_cls, frames, track_ids, bbox):
+        """Keep the rows selected by keep, append new rows and restore frame order."""
+        count = len(frames)
+        new_rows = {
+            'frame': np.asarray(frames, dtype=np.int32),
+            'track_id': np.broadcast_to(np.asarray(track_ids, dtype=np.int32), (count,)),
+            'cls': np.broadcast_to(np.asarray(object_cls, dtype=np.int8), (count,)),
+            'bbox': np.asarray(bbox, dtype=np.float32).reshape(-1, 4),
+        }
+
+        frame = np.concatenate([self.frame[keep], new_rows['frame']])
+        order = np.argsort(frame, kind='stable')
+        for name in COLUMNS:
+            added = new_rows[name] if name in new_rows else _empty_column(name, count)
+            column = np.concatenate([getattr(self, name)[keep], added])
+            setattr(self, name, column[order])
+
+        self._reset_indexes()
+
+    # =========================================================================
+    # COMPATIBILITY ADAPTER
+    # =========================================================================
+
+    def row_dict(self, row):
+        """
+        One row in the dictionary format of the nested tracks structure.
+
+        Args:
+            row: Row index
+
+        Returns:
+            {'bbox': [...], 'position': ..., 'speed': ..., 'team': ..., ...}
+            containing only the values that are available
+        """
+        info = {'bbox': self.bbox[row].tolist()}
+
+        position = self.position[row]
+        if not np.isnan(position[0]):
+            info['position'] = (int(position[0]), int(position[1]))
+
+        adjusted = self.position_adjusted[row]
+        if not np.isnan(adjusted[0]):
+            info['position_adjusted'] = (float(adjusted[0]), float(adjusted[1]))
+            transformed = self.position_transformed[row]
+            info['position_transformed'] = (
+                None if np.isnan(transformed[0]) else transformed.tolist()
+            )
+
+        if not np.isnan(self.speed[row]):
+            info['speed'] = float(self.speed[row])
+            info['distance'] = float(self.distance[row])
+
+        team = int(self.team[row])
+        if team:
+            info['team'] = team
+            if team in self.team_colors:
+                info['team_color'] = self.team_colors[team]
+
+        if self.has_ball[row]:
+            info['has_ball'] = True
+        return info
+
+    def frame_dict(self, frame_num, object_cls=None):
+        """
+        One frame in the nested tracks format.
+
+        Args:
+            frame_num: Frame index
+            object_cls: Only this class ({track_id: info}), or None for
+                        {'players': {...}, 'referees': {...}, 'ball': {...}}
+
+        Returns:
+            Dictionary built from the rows of the frame
+        """
+        rows = range(*self.frame_slice(frame_num).indices(len(self)))
+        if object_cls is not None:
+            return {
+                int(self.track_id[row]): self.row_dict(row)
+                for row in rows if self.cls[row] == object_cls
+            }
+
+        result = {name: {} for name in OBJECT_NAMES}
+        for row in rows:
+            result[OBJECT_NAMES[self.cls[row]]][int(self.track_id[row])] = self.row_dict(row)
+        return result
+
+    def as_tracks(self):
+        """
+        Read-only view with the tracks[object][frame][track_id] interface.
+
+        Per-frame dictionaries are built on demand, so the view costs no
+        memory; changes made to them are not written back to the store.
+
+        Returns:
+            {'players': ..., 'referees': ..., 'ball': ...} of frame sequences
+        """
+        return {name: _FrameSequence(self, object_cls)
+                for object_cls, name in enumerate(OBJECT_NAMES)}
+
+
+class _FrameSequence:
+    """tracks[object] of the compatibility view: indexable by frame."""
+
+    def __init__(self, store, object_cls):
+        self._store = store
+        self._object_cls = object_cls
+        self._cached = (None, None)
+
+    def __len__(self):
+        return self._store.frame_count
+
+    def __getitem__(self, frame_num):
+        if frame_num < 0:
+            frame_num += len(self)
+        if not 0 <= frame_num < len(self):
+            raise IndexError(f"frame {frame_num} out of range")
+
+        # Drawing looks up the same frame several times in a row
+        if self._cached[0] != frame_num:
+            self._cached = (frame_num, self._store.frame_dict(frame_num, self._object_cls))
+        return self._cached[1]
+
+    def __iter__(self):
+        for frame_num in range(len(self)):
+            yield self[frame_num]
+
+
+################################################################################
+# TRACK STORE BUILDER
+################################################################################
+
+class TrackStoreBuilder:
+    """
+    Appends per-frame tracker output to compact typed buffers.
+
+    Used while detection runs so the nested per-frame dictionaries of a
+    whole video never exist at the same time.
+    """
+
+    def __init__(self):
+        self._frame = array('i')
+        self._track_id = array('i')
+        self._cls = array('b')
+        self._bbox = array('f')
+        self.frame_count = 0
+
+    def append_frame(self, frame_tracks):
+        """
+        Add the objects of the next frame.
+
+        Args:
+            frame_tracks: {'players': {track_id: {'bbox': [...]}}, 'referees': ..., 'ball': ...}
+        """
+        frame_num = self.frame_count
+        for object_cls, name in enumerate(OBJECT_NAMES):
+            for track_id, track_info in frame_tracks.get(name, {}).items():
+                self._frame.append(frame_num)
+                self._track_id.append(int(track_id))
+                self._cls.append(object_cls)
+                self._bbox.extend(track_info['bbox'])
+        self.frame_count += 1
+
+    def build(self):
+        """
+        Create the store from the appended frames.
+
+        Returns:
+            TrackStore
+        """
+        return TrackStore(
+            np.frombuffer(self._frame, dtype=np.int32) if self._frame else np.zeros(0, np.int32),
+            np.frombuffer(self._track_id, dtype=np.int32) if self._track_id else np.zeros(0, np.int32),
+            np.frombuffer(self._cls, dtype=np.int8) if self._cls else np.zeros(0, np.int8),
+            np.frombuffer(self._bbox, dtype=np.float32) if self._bbox else np.zeros(0, np.float32),
+            self.frame_count,
+        )
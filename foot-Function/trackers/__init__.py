@@ -1 +1 @@
-from .tracker import Tracker
\ No newline at end of file
+from .tracker import Tracker, DETECTION_BACKENDS
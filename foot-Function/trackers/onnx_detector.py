@@ -0,0 +1,311 @@
+"""
+===============================================================================
+ONNX RUNTIME DETECTION BACKEND
+===============================================================================
+
+CPU inference of the YOLO model with ONNX Runtime, as an alternative to the
+ultralytics/PyTorch predictor used by Tracker.
+
+MODEL FILES:
+- A .onnx model is used as is
+- For a .pt model the ONNX export is created next to it on first use
+  (best.pt -> best.onnx, exported by ultralytics with a dynamic batch axis)
+- INT8: the export is quantized with ONNX Runtime dynamic quantization
+  (best.int8.onnx); weights are stored as 8-bit integers, which mostly helps
+  on CPUs with VNNI/AVX512 and costs a little accuracy
+Exports are regenerated when the source model is newer than the export.
+
+PIPELINE:
+A prefetch thread decodes frames and letterboxes the next batch while the
+current batch runs in ONNX Runtime, so decoding and inference overlap.
+The session's intra-op thread count follows the worker's thread budget.
+
+PREPROCESSING (same as ultralytics):
+- Letterbox to the model input size (default 640), gray (114) padding
+- BGR -> RGB, HWC -> CHW, scaled to [0, 1]
+
+POSTPROCESSING:
+- YOLOv8 style output (batch, 4 + classes, anchors) or YOLOv5 style
+  output (batch, anchors, 5 + classes) with objectness
+- Confidence threshold, per-class NMS (cv2.dnn.NMSBoxes), boxes mapped
+  back to frame pixels
+- Result per frame: OnnxDetection(names, sv.Detections)
+===============================================================================
+"""
+
+import ast
+import logging
+import os
+import queue
+import threading
+from collections import namedtuple
+from itertools import islice
+
+import cv2
+import numpy as np
+import supervision as sv
+
+logger = logging.getLogger(__name__)
+
+# Per-frame detection result of the ONNX backend
+OnnxDetection = namedtuple('OnnxDetection', ['names', 'detections'])
+
+DEFAULT_INPUT_SIZE = 640
+LETTERBOX_COLOR = (114, 114, 114)
+NMS_IOU = 0.7       # ultralytics default
+MAX_DETECTIONS = 300
+
+
+################################################################################
+# MODEL EXPORT
+################################################################################
+
+def _is_stale(target, source):
+    return not os.path.exists(target) or os.path.getmtime(target) < os.path.getmtime(source)
+
+
+def prepare_onnx_model(model_path, int8=False):
+    """
+    Return the path of the ONNX model to run, exporting/quantizing if needed.
+
+    Args:
+        model_path: .pt or .onnx model
+        int8: Use the dynamically quantized INT8 variant
+
+    Returns:
+        Path to a .onnx file
+    """
+    base, extension = os.path.splitext(model_path)
+    if extension.lower() == '.onnx':
+        onnx_path = model_path
+        base = base[:-len('.int8')] if base.endswith('.int8') else base
+    else:
+        onnx_path = base + '.onnx'
+        if _is_stale(onnx_path, model_path):
+            from ultralytics import YOLO
+            logger.info(f"Exporting {model_path} to ONNX")
+            exported = YOLO(model_path).export(format='onnx', dynamic=True, simplify=True)
+            if os.path.abspath(exported) != os.path.abspath(onnx_path):
+                os.replace(exported, onnx_path)
+
+    if not int8 or onnx_path.endswith('.int8.onnx'):
+        return onnx_path
+
+    int8_path = base + '.int8.onnx'
+    if _is_stale(int8_path, onnx_path):
+        from onnxruntime.quantization import quantize_dynamic, QuantType
+        logger.info(f"Quantizing {onnx_path} to INT8")
+        quantize_dynamic(onnx_path, int8_path, weight_type=QuantType.QUInt8)
+    return int8_path
+
+
+################################################################################
+# ONNX DETECTOR CLASS
+################################################################################
+
+class OnnxDetector:
+    """
+    Batched YOLO inference on ONNX Runtime (CPU) with decode prefetch.
+    """
+
+    def __init__(self, model_path, int8=False, batch_size=20, threads=0):
+        """
+        Args:
+            model_path: .pt (exported on first use) or .onnx model
+            int8: Run the INT8-quantized model
+            batch_size: Frames per inference call
+            threads: ONNX Runtime intra-op threads (0 = OpenCV's thread
+                     count, which follows the worker's thread budget)
+        """
+        import onnxruntime as ort
+
+        self.model_path = prepare_onnx_model(model_path, int8)
+        self.int8 = int8
+        self.batch_size = batch_size
+
+        options = ort.SessionOptions()
+        options.intra_op_num_threads = threads if threads > 0 else max(cv2.getNumThreads(), 1)
+        options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+        self.session = ort.InferenceSession(self.model_path, sess_options=options,
+                                            providers=['CPUExecutionProvider'])
+
+        model_input = self.session.get_inputs()[0]
+        self.input_name = model_input.name
+        shape = model_input.shape
+        self.input_size = shape[2] if isinstance(shape[2], int) else DEFAULT_INPUT_SIZE
+        # Exports without a dynamic batch axis take one frame per call
+        self.fixed_batch = shape[0] if isinstance(shape[0], int) else None
+
+        metadata = self.session.get_modelmeta().custom_metadata_map
+        self.names = ast.literal_eval(metadata['names']) if 'names' in metadata else {}
+
+        logger.info(f"ONNX Runtime model: {self.model_path} "
+                    f"({options.intra_op_num_threads} threads, input {self.input_size})")
+
+    # =========================================================================
+    # DETECTION
+    # =========================================================================
+
+    def iter_detections(self, frames, confidence):
+        """
+        Detect objects lazily over any iterable of frames.
+
+        A prefetch thread reads and letterboxes the next batch while the
+        current batch is inferred; at most two batches are prepared ahead.
+
+        Args:
+            frames: Iterable of video frames (BGR)
+            confidence: Minimum class confidence
+
+        Yields:
+            (frame, OnnxDetection) tuples in frame order
+        """
+        batches = queue.Queue(maxsize=2)
+        stop = threading.Event()
+
+        def prefetch():
+            try:
+                frame_iter = iter(frames)
+                while not stop.is_set():
+                    batch = list(islice(frame_iter, self.batch_size))
+                    if not batch:
+                        break
+                    batches.put((batch, self._preprocess(batch)))
+                batches.put(None)
+            except Exception as e:
+                batches.put(e)
+
+        thread = threading.Thread(target=prefetch, name='onnx-prefetch', daemon=True)
+        thread.start()
+        try:
+            while True:
+                item = batches.get()
+                if item is None:
+                    break
+                if isinstance(item, Exception):
+                    raise item
+                batch, prepared = item
+                yield from zip(batch, self._detect_prepared(batch, prepared, confidence))
+        finally:
+            stop.set()
+            # Unblock the prefetch thread if it waits on a full queue
+            while thread.is_alive():
+                try:
+                    batches.get(timeout=0.1)
+                except queue.Empty:
+                    pass
+
+    def detect_batch(self, batch, confidence):
+        """
+        Detect objects on a list of frames without prefetching.
+
+        Used when the caller decides which frames to detect only after the
+        previous results are known (keyframe mode of Tracker).
+
+        Args:
+            batch: List of video frames (BGR)
+            confidence: Minimum class confidence
+
+        Returns:
+            List of OnnxDetection, one per frame
+        """
+        if not batch:
+            return []
+        return self._detect_prepared(batch, self._preprocess(batch), confidence)
+
+    def _detect_prepared(self, batch, prepared, confidence):
+        blob, ratios, pads = prepared
+        outputs = self._infer(blob)
+        return [
+            OnnxDetection(self.names, self._postprocess(outputs[i], ratios[i], pads[i],
+                                                        frame.shape[:2], confidence))
+            for i, frame in enumerate(batch)
+        ]
+
+    def _infer(self, blob):
+        if self.fixed_batch is None or self.fixed_batch == len(blob):
+            return self.session.run(None, {self.input_name: blob})[0]
+        return np.concatenate([
+            self.session.run(None, {self.input_name: blob[i:i + 1]})[0]
+            for i in range(len(blob))
+        ])
+
+    # =========================================================================
+    # PRE/POSTPROCESSING
+    # =========================================================================
+
+    def _preprocess(self, batch):
+        """
+        Letterbox a batch of frames into one NCHW float32 blob.
+
+        Returns:
+            (blob, ratios, pads) with the scale and (left, top) padding per frame
+        """
+        size = self.input_size
+        blob = np.empty((len(batch), 3, size, size), dtype=np.float32)
+        ratios, pads = [], []
+        for i, frame in enumerate(batch):
+            height, width = frame.shape[:2]
+            ratio = min(size / height, size / width)
+            new_width, new_height = int(round(width * ratio)), int(round(height * ratio))
+            left = (size - new_width) // 2
+            top = (size - new_height) // 2
+
+            canvas = np.full((size, size, 3), LETTERBOX_COLOR, dtype=np.uint8)
+            canvas[top:top + new_height, left:left + new_width] = cv2.resize(
+                frame, (new_width, new_height), interpolation=cv2.INTER_LINEAR
+            )
+            blob[i] = canvas[:, :, ::-1].transpose(2, 0, 1)
+            ratios.append(ratio)
+            pads.append((left, top))
+        blob *= 1.0 / 255
+        return blob, ratios, pads
+
+    def _postprocess(self, output, ratio, pad, frame_shape, confidence):
+        """
+        Decode one frame's raw output into supervision Detections.
+        """
+        class_count = len(self.names)
+        if output.shape[0] < output.shape[1] and output.shape[0] != 5 + class_count:
+            output = output.T  # YOLOv8 layout: (4 + classes, anchors)
+
+        if output.shape[1] == 5 + class_count:
+            # YOLOv5 layout: objectness times class scores
+            scores_all = output[:, 5:] * output[:, 4:5]
+        else:
+            scores_all = output[:, 4:]
+
+        class_id = scores_all.argmax(axis=1)
+        scores = scores_all[np.arange(len(class_id)), class_id]
+        keep = scores > confidence
+        boxes, scores, class_id = output[keep, :4], scores[keep], class_id[keep]
+        if not len(scores):
+            return sv.Detections.empty()
+
+        # cx, cy, w, h in letterbox pixels -> x1, y1, x2, y2 in frame pixels
+        xyxy = np.empty_like(boxes)
+        xyxy[:, 0] = boxes[:, 0] - boxes[:, 2] / 2
+        xyxy[:, 1] = boxes[:, 1] - boxes[:, 3] / 2
+        xyxy[:, 2] = boxes[:, 0] + boxes[:, 2] / 2
+        xyxy[:, 3] = boxes[:, 1] + boxes[:, 3] / 2
+        xyxy[:, [0, 2]] -= pad[0]
+        xyxy[:, [1, 3]] -= pad[1]
+        xyxy /= ratio
+        height, width = frame_shape
+        xyxy[:, [0, 2]] = xyxy[:, [0, 2]].clip(0, width)
+        xyxy[:, [1, 3]] = xyxy[:, [1, 3]].clip(0, height)
+
+        # Per-class NMS: offset boxes by class so classes never suppress each other
+        offset = class_id[:, None] * (max(width, height) + 1)
+        shifted = xyxy + offset
+        rects = np.stack([shifted[:, 0], shifted[:, 1],
+                          shifted[:, 2] - shifted[:, 0], shifted[:, 3] - shifted[:, 1]], axis=1)
+        kept = cv2.dnn.NMSBoxes(rects.tolist(), scores.tolist(), confidence, NMS_IOU,
+                                top_k=MAX_DETECTIONS)
+        kept = np.asarray(kept, dtype=np.int64).reshape(-1)[:MAX_DETECTIONS]
+
+        return sv.Detections(
+            xyxy=xyxy[kept].astype(np.float32),
+            confidence=scores[kept].astype(np.float32),
+            class_id=class_id[kept].astype(int),
+        )
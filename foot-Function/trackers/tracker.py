@@ -9,6 +9,8 @@ the ball across video frames.
 
 KEY COMPONENTS:
 - YOLO: State-of-the-art object detection model (Ultralytics)
+- ONNX Runtime: Optional CPU detection backend, FP32 or INT8
+  (see onnx_detector.py)
 - ByteTrack: Multi-object tracking algorithm (via Supervision library)
 - Position tracking: Converts bounding boxes to field positions
 - Ball interpolation: Fills gaps in ball detection
@@ -21,6 +23,18 @@ TRACKING PROCESS:
 4. Store tracks as dictionaries indexed by frame and track ID
 5. Add position information (center or foot position)
 
+KEYFRAME MODE (keyframe_stride > 1):
+Players move only a few pixels between frames, so YOLO + ByteTrack run on
+every K-th frame only. A frame is detected earlier when
+- the camera moved sharply since the last keyframe (global shift of a
+  small grayscale thumbnail, measured with phase correlation), or
+- ByteTrack lost many of the tracks of the previous keyframe; the next
+  batch is then detected on every frame
+Boxes of players and referees in between are filled by linear
+interpolation along each track (fill_keyframe_gaps_in_store), the ball by
+interpolate_ball_positions_in_store as before. keyframe_stats counts the
+detected frames and why they were detected.
+
 VISUALIZATION:
 - Players: Ellipse at feet with team color and track ID
 - Referees: Yellow ellipse (no team assignment)
@@ -34,12 +48,32 @@ from ultralytics import YOLO
 import supervision as sv
 import pickle
 import os
+from itertools import islice
 import numpy as np
 import pandas as pd
 import cv2
 import sys 
 sys.path.append('../')
 from utils import get_center_of_bbox, get_bbox_width, get_foot_position
+from track_store import BALL
+from player_ball_assigner import PossessionStats
+from .onnx_detector import OnnxDetector, OnnxDetection
+
+# Detection backends selectable with Tracker(backend=...)
+DETECTION_BACKENDS = ('ultralytics', 'onnx')
+
+# Keyframe mode: camera shift since the last keyframe (fraction of the frame
+# width) and share of the previous keyframe's tracks found again, below
+# which a frame is detected before the stride is up
+KEYFRAME_MOTION_THRESHOLD = 0.05
+KEYFRAME_MIN_CONTINUITY = 0.8
+MOTION_THUMBNAIL_WIDTH = 160
+# Longest gap (in strides) filled between two detections of the same track
+KEYFRAME_MAX_GAP_STRIDES = 2
+
+# Keyframe attributes saved with tracking_state()
+_KEYFRAME_STATE = ('keyframe_stats', '_frames_since_keyframe', '_motion_since_keyframe',
+                   '_previous_thumbnail', '_previous_track_ids', '_dense_batch')
 
 
 ################################################################################
@@ -54,15 +88,84 @@ class Tracker:
     object identities across frames.
     """
     
-    def __init__(self, model_path):
+    def __init__(self, model_path, backend='ultralytics', int8=False, batch_size=20,
+                 keyframe_stride=1):
         """
         Initialize tracker with YOLO model.
         
         Args:
-            model_path: Path to trained YOLO model (.pt file)
+            model_path: Path to trained YOLO model (.pt file, or .onnx for
+                        the onnx backend)
+            backend: 'ultralytics' (PyTorch) or 'onnx' (ONNX Runtime CPU)
+            int8: Use the INT8-quantized model (onnx backend only)
+            batch_size: Frames per detection batch
+            keyframe_stride: Detect every K-th frame and fill the frames in
+                             between (1 = detect every frame)
         """
-        self.model = YOLO(model_path)  # Load YOLO detection model
+        if backend not in DETECTION_BACKENDS:
+            raise ValueError(f"Unknown detection backend: {backend}")
+        self.backend = backend
+        self.int8 = int8 and backend == 'onnx'
+        if backend == 'onnx':
+            self.model = OnnxDetector(model_path, int8=int8, batch_size=batch_size)
+        else:
+            self.model = YOLO(model_path)  # Load YOLO detection model
         self.tracker = sv.ByteTrack()  # Initialize ByteTrack for multi-object tracking
+        self.confidence = 0.1          # YOLO confidence threshold
+        self.batch_size = batch_size   # Frames per YOLO batch
+        self.keyframe_stride = keyframe_stride
+        self._reset_keyframe_state()
+
+    def cache_params(self):
+        """
+        Parameters that influence the tracks, for the stub cache key.
+        
+        The model file itself is hashed separately by the cache.
+        """
+        params = {'confidence': self.confidence, 'tracker': 'bytetrack',
+                  'backend': self.backend, 'int8': self.int8}
+        if self.keyframe_stride > 1:
+            params['keyframe_stride'] = self.keyframe_stride
+        return params
+
+    def reset_tracking(self):
+        """
+        Start a fresh ByteTrack session while keeping the loaded model.
+        
+        Used when one Tracker instance analyzes several videos in a row
+        (e.g. the persistent analysis worker), so track IDs and motion state
+        from the previous video do not leak into the next one.
+        """
+        self.tracker = sv.ByteTrack()
+        self._reset_keyframe_state()
+
+    def tracking_state(self):
+        """
+        ByteTrack and keyframe state after the frames tracked so far.
+        
+        Picklable (the model is not included), so a detection pass can be
+        checkpointed and later continued with restore_tracking_state().
+        Only consistent between detection batches in keyframe mode.
+        """
+        return {
+            'bytetrack': self.tracker,
+            'keyframe': {name: getattr(self, name) for name in _KEYFRAME_STATE},
+        }
+
+    def restore_tracking_state(self, state):
+        """Continue tracking from a tracking_state() taken earlier."""
+        self.tracker = state['bytetrack']
+        for name, value in state['keyframe'].items():
+            setattr(self, name, value)
+
+    def _reset_keyframe_state(self):
+        self.keyframe_stats = {'frames': 0, 'keyframes': 0,
+                               'stride': 0, 'camera_motion': 0, 'track_loss': 0}
+        self._frames_since_keyframe = None   # None: next frame is the first
+        self._motion_since_keyframe = 0.0
+        self._previous_thumbnail = None
+        self._previous_track_ids = set()
+        self._dense_batch = False
 
     # =========================================================================
     # POSITION TRACKING
@@ -87,6 +190,24 @@ class Tracker:
                         position = get_foot_position(bbox)
                     tracks[object][frame_num][track_id]['position'] = position
 
+    def add_position_to_store(self, store):
+        """
+        Columnar version of add_position_to_tracks for a TrackStore.
+        
+        Computes the foot position (ball: center) of every row at once,
+        truncated to whole pixels like get_foot_position/get_center_of_bbox.
+        
+        Args:
+            store: TrackStore with bounding boxes
+        """
+        bbox = store.bbox.astype(np.float64)
+        x = np.trunc((bbox[:, 0] + bbox[:, 2]) / 2)
+        y = np.where(store.cls == BALL,
+                     np.trunc((bbox[:, 1] + bbox[:, 3]) / 2),
+                     np.trunc(bbox[:, 3]))
+        store.position[:, 0] = x
+        store.position[:, 1] = y
+
     # =========================================================================
     # BALL INTERPOLATION
     # =========================================================================
@@ -116,6 +237,30 @@ class Tracker:
 
         return ball_positions
 
+    def interpolate_ball_positions_in_store(self, store):
+        """
+        Columnar version of interpolate_ball_positions for a TrackStore.
+        
+        Replaces the ball rows with one interpolated ball (track id 1) per
+        frame. Frames before the first and after the last detection take
+        the nearest detected box; without any detection there is no ball.
+        
+        Args:
+            store: TrackStore with ball detections
+        """
+        frames = np.arange(store.frame_count)
+        rows = store.find_rows(BALL, frames, 1)
+        ball_positions = np.full((store.frame_count, 4), np.nan)
+        ball_positions[rows >= 0] = store.bbox[rows[rows >= 0]]
+
+        df_ball_positions = pd.DataFrame(ball_positions,columns=['x1','y1','x2','y2'])
+        df_ball_positions = df_ball_positions.interpolate()
+        df_ball_positions = df_ball_positions.bfill()
+        ball_positions = df_ball_positions.to_numpy()
+
+        detected = ~np.isnan(ball_positions).any(axis=1)
+        store.replace_class(BALL, frames[detected], 1, ball_positions[detected])
+
     # =========================================================================
     # OBJECT DETECTION
     # =========================================================================
@@ -132,12 +277,162 @@ class Tracker:
         Returns:
             List of YOLO detection results (one per frame)
         """
-        batch_size=20 
-        detections = [] 
-        for i in range(0,len(frames),batch_size):
-            detections_batch = self.model.predict(frames[i:i+batch_size],conf=0.1)
-            detections += detections_batch
-        return detections
+        return [detection for _, detection in self.iter_detections(frames)]
+
+    def iter_detections(self, frames):
+        """
+        Run YOLO detection lazily over any iterable of frames.
+        
+        Only one batch of frames is held at a time, so this works with a
+        streaming decoder (see utils.iter_video) as well as a frame list.
+        The onnx backend prepares the next batch on a prefetch thread.
+        
+        Args:
+            frames: Iterable of video frames (numpy arrays)
+            
+        Yields:
+            (frame, detection) tuples in frame order
+        """
+        if self.keyframe_stride > 1:
+            yield from self._iter_keyframe_detections(frames)
+            return
+        if self.backend == 'onnx':
+            yield from self.model.iter_detections(frames, self.confidence)
+            return
+
+        frame_iter = iter(frames)
+        while True:
+            batch = list(islice(frame_iter, self.batch_size))
+            if not batch:
+                break
+            detections_batch = self.model.predict(batch,conf=self.confidence)
+            for frame, detection in zip(batch, detections_batch):
+                yield frame, detection
+
+    def _detect_batch(self, batch):
+        """Detections for a list of frames with the active backend."""
+        if not batch:
+            return []
+        if self.backend == 'onnx':
+            return self.model.detect_batch(batch, self.confidence)
+        return self.model.predict(batch, conf=self.confidence)
+
+    # =========================================================================
+    # KEYFRAME MODE
+    # =========================================================================
+
+    def _iter_keyframe_detections(self, frames):
+        """
+        Keyframe version of iter_detections: detection is None between keyframes.
+        
+        Frames are read batch_size at a time and only the keyframes of a
+        batch are detected. The batch is scheduled after all earlier frames
+        went through track_detection, so a track loss seen there makes the
+        next batch dense.
+        """
+        frame_iter = iter(frames)
+        while True:
+            batch = list(islice(frame_iter, self.batch_size))
+            if not batch:
+                break
+            dense = self._dense_batch
+            self._dense_batch = False
+
+            keyframes = [i for i, frame in enumerate(batch) if self._is_keyframe(frame, dense)]
+            detections = dict(zip(keyframes, self._detect_batch([batch[i] for i in keyframes])))
+            for i, frame in enumerate(batch):
+                yield frame, detections.get(i)
+
+    def _is_keyframe(self, frame, dense):
+        """Decide whether to detect a frame and update the keyframe statistics."""
+        height, width = frame.shape[:2]
+        thumbnail_size = (MOTION_THUMBNAIL_WIDTH, max(int(height * MOTION_THUMBNAIL_WIDTH / width), 1))
+        thumbnail = cv2.resize(cv2.cvtColor(frame, cv2.COLOR_BGR2GRAY), thumbnail_size,
+                               interpolation=cv2.INTER_AREA).astype(np.float32)
+        if self._previous_thumbnail is not None:
+            (dx, dy), _ = cv2.phaseCorrelate(self._previous_thumbnail, thumbnail)
+            self._motion_since_keyframe += float(np.hypot(dx, dy))
+        self._previous_thumbnail = thumbnail
+
+        stats = self.keyframe_stats
+        stats['frames'] += 1
+        if self._frames_since_keyframe is None or self._frames_since_keyframe + 1 >= self.keyframe_stride:
+            reason = 'stride'
+        elif dense:
+            reason = 'track_loss'
+        elif self._motion_since_keyframe > KEYFRAME_MOTION_THRESHOLD * MOTION_THUMBNAIL_WIDTH:
+            reason = 'camera_motion'
+        else:
+            self._frames_since_keyframe += 1
+            return False
+
+        stats['keyframes'] += 1
+        stats[reason] += 1
+        self._frames_since_keyframe = 0
+        self._motion_since_keyframe = 0.0
+        return True
+
+    def _check_track_continuity(self, detection_with_tracks):
+        """Request a dense batch when many tracks of the previous keyframe are lost."""
+        track_ids = set(detection_with_tracks.tracker_id.tolist())
+        previous = self._previous_track_ids
+        if previous and len(track_ids & previous) < KEYFRAME_MIN_CONTINUITY * len(previous):
+            self._dense_batch = True
+        self._previous_track_ids = track_ids
+
+    def fill_keyframe_gaps_in_store(self, store):
+        """
+        Fill player and referee boxes between keyframes.
+        
+        Boxes are interpolated linearly between two detections of the same
+        track that are at most KEYFRAME_MAX_GAP_STRIDES strides apart (a track
+        missing for longer is left out, as when it is lost in dense mode).
+        Tracks detected on the last keyframe keep their box until the end.
+        
+        Args:
+            store: TrackStore built from keyframe detections
+            
+        Returns:
+            Number of rows added
+        """
+        if self.keyframe_stride <= 1:
+            return 0
+
+        rows = np.flatnonzero(store.cls != BALL)
+        if not len(rows):
+            return 0
+        rows = rows[np.lexsort((store.frame[rows], store.track_id[rows], store.cls[rows]))]
+        frame = store.frame[rows].astype(np.int64)
+        same_track = ((store.cls[rows][1:] == store.cls[rows][:-1]) &
+                      (store.track_id[rows][1:] == store.track_id[rows][:-1]))
+        gap = frame[1:] - frame[:-1]
+        pairs = np.flatnonzero(same_track & (gap > 1) &
+                               (gap <= KEYFRAME_MAX_GAP_STRIDES * self.keyframe_stride))
+
+        # One new row per missing frame: offset t = 1..gap-1 from the earlier detection
+        counts = gap[pairs] - 1
+        pair_of_row = np.repeat(pairs, counts)
+        offset = np.arange(counts.sum()) - np.repeat(np.cumsum(counts) - counts, counts) + 1
+        alpha = (offset / gap[pair_of_row])[:, None]
+        start_bbox = store.bbox[rows[pair_of_row]].astype(np.float64)
+        end_bbox = store.bbox[rows[pair_of_row + 1]].astype(np.float64)
+        new_rows = rows[pair_of_row]
+        new_frames = frame[pair_of_row] + offset
+        new_bbox = start_bbox + alpha * (end_bbox - start_bbox)
+
+        # Hold the boxes of the last detected frame until the end of the video
+        last_frame = int(frame.max())
+        tail = rows[frame == last_frame]
+        tail_length = store.frame_count - 1 - last_frame
+        if 0 < tail_length < self.keyframe_stride:
+            tail_offset = np.tile(np.arange(1, tail_length + 1), len(tail))
+            tail = np.repeat(tail, tail_length)
+            new_rows = np.concatenate([new_rows, tail])
+            new_frames = np.concatenate([new_frames, last_frame + tail_offset])
+            new_bbox = np.concatenate([new_bbox, store.bbox[tail]])
+
+        store.add_rows(store.cls[new_rows], new_frames, store.track_id[new_rows], new_bbox)
+        return len(new_rows)
 
     # =========================================================================
     # OBJECT TRACKING
@@ -166,7 +461,7 @@ class Tracker:
         Each frame_dict contains: {track_id: {"bbox": [x1,y1,x2,y2], ...}}
         
         Args:
-            frames: List of video frames
+            frames: Iterable of video frames (list or streaming decoder)
             read_from_stub: If True, load from cached file
             stub_path: Path to cache file
             
@@ -179,56 +474,86 @@ class Tracker:
                 tracks = pickle.load(f)
             return tracks
 
-        detections = self.detect_frames(frames)
-
         tracks={
             "players":[],
             "referees":[],
             "ball":[]
         }
 
-        for frame_num, detection in enumerate(detections):
-            cls_names = detection.names
-            cls_names_inv = {v:k for k,v in cls_names.items()}
+        for _, detection in self.iter_detections(frames):
+            frame_tracks = self.track_detection(detection)
+            for object, object_track in frame_tracks.items():
+                tracks[object].append(object_track)
+
+        if stub_path is not None:
+            with open(stub_path,'wb') as f:
+                pickle.dump(tracks,f)
+
+        return tracks
+
+    def track_detection(self, detection):
+        """
+        Update ByteTrack with one frame's detections and split by class.
+        
+        Tracker state carries over between calls, so detections must be
+        passed in frame order.
+        
+        Args:
+            detection: YOLO detection result for a single frame
+                       (ultralytics result or OnnxDetection), or None for
+                       a frame between keyframes
+            
+        Returns:
+            {"players": {...}, "referees": {...}, "ball": {...}} for this frame
+            (empty between keyframes; filled later by fill_keyframe_gaps_in_store)
+        """
+        if detection is None:
+            return {"players":{}, "referees":{}, "ball":{}}
+
+        cls_names = detection.names
+        cls_names_inv = {v:k for k,v in cls_names.items()}
 
-            # Covert to supervision Detection format
+        # Covert to supervision Detection format
+        if isinstance(detection, OnnxDetection):
+            detection_supervision = detection.detections
+        else:
             detection_supervision = sv.Detections.from_ultralytics(detection)
 
-            # Convert GoalKeeper to player object
-            for object_ind , class_id in enumerate(detection_supervision.class_id):
-                if cls_names[class_id] == "goalkeeper":
-                    detection_supervision.class_id[object_ind] = cls_names_inv["player"]
+        # Convert GoalKeeper to player object
+        for object_ind , class_id in enumerate(detection_supervision.class_id):
+            if cls_names[class_id] == "goalkeeper":
+                detection_supervision.class_id[object_ind] = cls_names_inv["player"]
 
-            # Track Objects
-            detection_with_tracks = self.tracker.update_with_detections(detection_supervision)
+        # Track Objects
+        detection_with_tracks = self.tracker.update_with_detections(detection_supervision)
+        if self.keyframe_stride > 1:
+            self._check_track_continuity(detection_with_tracks)
 
-            tracks["players"].append({})
-            tracks["referees"].append({})
-            tracks["ball"].append({})
+        frame_tracks = {
+            "players":{},
+            "referees":{},
+            "ball":{}
+        }
 
-            for frame_detection in detection_with_tracks:
-                bbox = frame_detection[0].tolist()
-                cls_id = frame_detection[3]
-                track_id = frame_detection[4]
+        for frame_detection in detection_with_tracks:
+            bbox = frame_detection[0].tolist()
+            cls_id = frame_detection[3]
+            track_id = frame_detection[4]
 
-                if cls_id == cls_names_inv['player']:
-                    tracks["players"][frame_num][track_id] = {"bbox":bbox}
-                
-                if cls_id == cls_names_inv['referee']:
-                    tracks["referees"][frame_num][track_id] = {"bbox":bbox}
+            if cls_id == cls_names_inv['player']:
+                frame_tracks["players"][track_id] = {"bbox":bbox}
             
-            for frame_detection in detection_supervision:
-                bbox = frame_detection[0].tolist()
-                cls_id = frame_detection[3]
-
-                if cls_id == cls_names_inv['ball']:
-                    tracks["ball"][frame_num][1] = {"bbox":bbox}
+            if cls_id == cls_names_inv['referee']:
+                frame_tracks["referees"][track_id] = {"bbox":bbox}
+        
+        for frame_detection in detection_supervision:
+            bbox = frame_detection[0].tolist()
+            cls_id = frame_detection[3]
 
-        if stub_path is not None:
-            with open(stub_path,'wb') as f:
-                pickle.dump(tracks,f)
+            if cls_id == cls_names_inv['ball']:
+                frame_tracks["ball"][1] = {"bbox":bbox}
 
-        return tracks
+        return frame_tracks
     
     # =========================================================================
     # VISUALIZATION: DRAWING METHODS
@@ -323,7 +648,7 @@ class Tracker:
 
         return frame
 
-    def draw_team_ball_control(self,frame,frame_num,team_ball_control):
+    def draw_team_ball_control(self,frame,frame_num,possession):
         """
         Draw team possession statistics overlay on the frame.
         
@@ -333,7 +658,7 @@ class Tracker:
         Args:
             frame: Video frame to draw on
             frame_num: Current frame number
-            team_ball_control: Array of team IDs (1 or 2) indicating possession per frame
+            possession: PossessionStats of the video (O(1) per frame)
             
         Returns:
             Modified frame with possession overlay
@@ -344,15 +669,10 @@ class Tracker:
         alpha = 0.4
         cv2.addWeighted(overlay, alpha, frame, 1 - alpha, 0, frame)
 
-        team_ball_control_till_frame = team_ball_control[:frame_num+1]
-        # Get the number of time each team had ball control
-        team_1_num_frames = team_ball_control_till_frame[team_ball_control_till_frame==1].shape[0]
-        team_2_num_frames = team_ball_control_till_frame[team_ball_control_till_frame==2].shape[0]
-        team_1 = team_1_num_frames/(team_1_num_frames+team_2_num_frames)
-        team_2 = team_2_num_frames/(team_1_num_frames+team_2_num_frames)
+        percentages = possession.team_percentages(frame_num)
 
-        cv2.putText(frame, f"Team 1 Ball Control: {team_1*100:.2f}%",(1400,900), cv2.FONT_HERSHEY_SIMPLEX, 1, (0,0,0), 3)
-        cv2.putText(frame, f"Team 2 Ball Control: {team_2*100:.2f}%",(1400,950), cv2.FONT_HERSHEY_SIMPLEX, 1, (0,0,0), 3)
+        cv2.putText(frame, f"Team 1 Ball Control: {percentages[1]:.2f}%",(1400,900), cv2.FONT_HERSHEY_SIMPLEX, 1, (0,0,0), 3)
+        cv2.putText(frame, f"Team 2 Ball Control: {percentages[2]:.2f}%",(1400,950), cv2.FONT_HERSHEY_SIMPLEX, 1, (0,0,0), 3)
 
         return frame
 
@@ -372,39 +692,61 @@ class Tracker:
         Args:
             video_frames: List of input video frames
             tracks: Complete tracking dictionary from get_object_tracks()
-            team_ball_control: Array of possession data per frame
+            team_ball_control: Array of possession data per frame, or PossessionStats
             
         Returns:
             List of annotated frames ready for video output
         """
+        possession = team_ball_control
+        if not isinstance(possession, PossessionStats):
+            possession = PossessionStats(team_ball_control)
+
         output_video_frames= []
         for frame_num, frame in enumerate(video_frames):
             frame = frame.copy()
+            frame = self.draw_frame_annotations(frame, frame_num, tracks, possession)
+            output_video_frames.append(frame)
 
-            player_dict = tracks["players"][frame_num]
-            ball_dict = tracks["ball"][frame_num]
-            referee_dict = tracks["referees"][frame_num]
+        return output_video_frames
 
-            # Draw Players
-            for track_id, player in player_dict.items():
-                color = player.get("team_color",(0,0,255))
-                frame = self.draw_ellipse(frame, player["bbox"],color, track_id)
+    def draw_frame_annotations(self, frame, frame_num, tracks, possession):
+        """
+        Annotate a single frame in place with tracking visualizations.
+        
+        Same annotations as draw_annotations, for callers that render frames
+        one at a time (streaming mode) instead of holding the whole video.
+        
+        Args:
+            frame: Video frame to draw on (modified in place)
+            frame_num: Index of the frame in the video
+            tracks: Complete tracking dictionary from get_object_tracks()
+            possession: PossessionStats of the video
+            
+        Returns:
+            The annotated frame
+        """
+        player_dict = tracks["players"][frame_num]
+        ball_dict = tracks["ball"][frame_num]
+        referee_dict = tracks["referees"][frame_num]
 
-                if player.get('has_ball',False):
-                    frame = self.draw_traingle(frame, player["bbox"],(0,0,255))
+        # Draw Players
+        for track_id, player in player_dict.items():
+            color = player.get("team_color",(0,0,255))
+            frame = self.draw_ellipse(frame, player["bbox"],color, track_id)
 
-            # Draw Referee
-            for _, referee in referee_dict.items():
-                frame = self.draw_ellipse(frame, referee["bbox"],(0,255,255))
-            
-            # Draw ball 
-            for track_id, ball in ball_dict.items():
-                frame = self.draw_traingle(frame, ball["bbox"],(0,255,0))
+            if player.get('has_ball',False):
+                frame = self.draw_traingle(frame, player["bbox"],(0,0,255))
 
+        # Draw Referee
+        for _, referee in referee_dict.items():
+            frame = self.draw_ellipse(frame, referee["bbox"],(0,255,255))
+        
+        # Draw ball 
+        for track_id, ball in ball_dict.items():
+            frame = self.draw_traingle(frame, ball["bbox"],(0,255,0))
 
-            # Draw Team Ball Control
-            frame = self.draw_team_ball_control(frame, frame_num, team_ball_control)
 
-            output_video_frames.append(frame)
+        # Draw Team Ball Control
+        frame = self.draw_team_ball_control(frame, frame_num, possession)
 
-        return output_video_frames
\ No newline at end of file
+        return frame
\ No newline at end of file
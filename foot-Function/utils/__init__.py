@@ -1,3 +1,9 @@
-from .video_utils import read_video, save_video
+from .video_utils import (iter_video, get_video_properties, VideoFrameWriter, BackgroundVideoWriter,
+                          VIDEO_CODECS, DEFAULT_VIDEO_CODEC, video_extension)
 from .bbox_utils import get_center_of_bbox, get_bbox_width, measure_distance,measure_xy_distance,get_foot_position
-from .data_output import output_data
\ No newline at end of file
+from .data_output import output_data, output_frame_data, summarize_data
+from .progress import ProgressReporter
+from .stage_metrics import StageMetrics, peak_rss
+from .job_control import JobControl, AnalysisCancelled
+from .stub_cache import StubCache, DEFAULT_CACHE_DIR
+from .stage_graph import Stage, StageGraph
\ No newline at end of file
@@ -8,17 +8,29 @@ This module handles exporting analysis results to structured data formats
 
 OUTPUT STRUCTURE:
 JSON and CSV files contain:
-- Player statistics (distance traveled per player)
+- Player statistics (distance traveled and ball possession per player)
 - Team organization (players grouped by team)
 - Possession statistics (percentage of ball control per team)
 
+Possession numbers come from PossessionStats (running counts built once
+in the pipeline), so the export agrees with the video overlay.
+
 DATA FORMATS:
 1. JSON: Hierarchical structure with summary and per-team player data
-2. CSV: Tabular format with columns: Team, Player ID, Distance
+2. CSV: Tabular format with columns: Team, Player ID, Distance, Possession
+3. Per-frame CSV: one row per player per frame with columns: Frame,
+   Player ID, Team, Speed (km/h), Distance (m), Has Ball
+
+summarize_data() builds the same dictionary as data_output.json without
+writing anything; the pipeline sends it to the GUI as a partial result
+snapshot while the analysis is still running.
 
 FILES GENERATED:
 - data_output.json: Complete analysis data in JSON format
 - data_output.csv: Simplified table for spreadsheet applications
+- frame_data.csv: Per-frame player data (output_frame_data), written
+  straight from the TrackStore columns in chunks; empty cells where a
+  value is not available (speed before the first speed window, no team)
 
 USAGE:
 Called at the end of the analysis pipeline to save all computed metrics.
@@ -29,20 +41,79 @@ The GUI automatically loads these files to display results in the interface.
 import json
 import csv
 import os
+
 import numpy as np
 
+# Rows formatted and written per chunk by output_frame_data
+FRAME_DATA_CHUNK_ROWS = 100000
+
+
+def _last_rows(rows, track_ids):
+    """Last row of each track among rows (in frame order): {track_id: row}."""
+    reverse = rows[::-1]
+    ids, last = np.unique(track_ids[::-1], return_index=True)
+    return dict(zip(ids.tolist(), reverse[last].tolist()))
+
+
+def _player_totals(tracks):
+    """
+    Team and total distance of every player that appeared in the video.
+    
+    Distance is cumulative per track, so each player's last known distance
+    is the total, also for players who left the shot before the last frame.
+    
+    Args:
+        tracks: TrackStore, or the nested tracks dictionary
+    
+    Returns:
+        List of (player_id, team, distance_m), ordered by player id
+    """
+    if hasattr(tracks, 'class_rows'):
+        from track_store import PLAYER
+        
+        store = tracks
+        rows = store.class_rows(PLAYER)
+        track_ids = store.track_id[rows]
+        has_distance = ~np.isnan(store.distance[rows])
+        has_team = store.team[rows] > 0
+        distance_rows = _last_rows(rows[has_distance], track_ids[has_distance])
+        team_rows = _last_rows(rows[has_team], track_ids[has_team])
+        return [
+            (player_id,
+             int(store.team[team_rows[player_id]]) if player_id in team_rows else 1,
+             float(store.distance[distance_rows[player_id]]) if player_id in distance_rows else 0)
+            for player_id in np.unique(track_ids).tolist()
+        ]
+    
+    # Nested dictionary: keep the latest values of each player over all frames
+    teams = {}
+    distances = {}
+    for frame_tracks in tracks.get('players', []):
+        for player_id, player_data in frame_tracks.items():
+            # Default team 1 should not happen in normal flow: the pipeline assigns 1 or 2
+            teams[player_id] = player_data.get('team', teams.get(player_id, 1))
+            if 'distance' in player_data:
+                distances[player_id] = player_data['distance']
+    return [(player_id, teams[player_id], distances.get(player_id, 0))
+            for player_id in sorted(teams)]
+
 
-def output_data(tracks, output_path='output_videos/data_output.json', team_ball_control=None):
+def summarize_data(tracks, possession=None):
     """
-    Output numerical data from video analysis including:
+    Build the data_output.json dictionary:
     - Distance covered by each player (in kilometers)
+    - Ball possession per player (frames and share of all player possession)
     - Data separated by team
     - Ball possession percentage per team
     
+    Every player that appeared is listed with their last known cumulative
+    distance. Pass the TrackStore itself rather than its as_tracks() view:
+    the store is summarized with column operations.
+    
     Args:
-        tracks: Dictionary containing tracking information for players
-        output_path: Path to save the output data (default: 'output_videos/data_output.json')
-        team_ball_control: numpy array with team possession per frame (optional)
+        tracks: TrackStore, or the nested tracks dictionary
+        possession: PossessionStats of the video (optional; possession
+                    fields are left out without it)
     
     Returns:
         Dictionary containing the organized data
@@ -52,54 +123,59 @@ def output_data(tracks, output_path='output_videos/data_output.json', team_ball_
         'summary': {}
     }
     
-    # Calculate ball possession percentages if provided
-    if team_ball_control is not None:
-        # Count possession for each team
-        unique_teams, counts = np.unique(team_ball_control, return_counts=True)
-        
-        # Build possession counts dictionary (excluding 0 which represents no possession)
-        possession_counts = {}
-        for team_id, count in zip(unique_teams, counts):
-            if team_id > 0:
-                possession_counts[int(team_id)] = int(count)
-        
-        # Calculate total possession (sum of all teams)
-        total_possession = sum(possession_counts.values())
-        
-        # Calculate possession percentages
-        if total_possession > 0:
-            for team_id, count in possession_counts.items():
-                percent = (count / total_possession) * 100
+    # Ball possession percentages (frames without a team in control excluded)
+    if possession is not None:
+        team_frames = {team: possession.team_frames(team) for team in (1, 2)}
+        if sum(team_frames.values()) > 0:
+            for team_id, percent in possession.team_percentages().items():
                 output_dict['summary'][f'team_{team_id}_possession_percent'] = round(percent, 2)
+                output_dict['summary'][f'team_{team_id}_possession_frames'] = team_frames[team_id]
     
     # Process player tracks
-    if 'players' in tracks and len(tracks['players']) > 0:
-        # Get the last frame to get final distance values
-        last_frame = len(tracks['players']) - 1
+    for player_id, team, distance_m in _player_totals(tracks):
+        # Get distance in meters and convert to kilometers
+        distance_km = distance_m / 1000
+        
+        # Organize by team
+        team_key = f'team_{team}'
+        if team_key not in output_dict:
+            # Create team entry dynamically
+            output_dict[team_key] = {}
         
-        # Ensure the last frame has data
-        if tracks['players'][last_frame]:
-            for player_id, player_data in tracks['players'][last_frame].items():
-                # Get player team (default to 1 if not available, which should not happen in normal flow)
-                # The main pipeline always assigns team 1 or 2
-                team = player_data.get('team', 1)
-                
-                # Get distance in meters and convert to kilometers
-                distance_m = player_data.get('distance', 0)
-                distance_km = distance_m / 1000
-                
-                # Organize by team
-                team_key = f'team_{team}'
-                if team_key not in output_dict:
-                    # Create team entry dynamically
-                    output_dict[team_key] = {}
-                
-                output_dict[team_key][str(player_id)] = {
-                    'distance_km': round(distance_km, 3),
-                    'distance_m': round(distance_m, 2)
-                }
-    
-    # No rounding needed for possession percentages (already rounded to 2 decimal places)
+        output_dict[team_key][str(player_id)] = {
+            'distance_km': round(distance_km, 3),
+            'distance_m': round(distance_m, 2)
+        }
+        if possession is not None:
+            output_dict[team_key][str(player_id)].update({
+                'possession_frames': possession.player_possession_frames(player_id),
+                'possession_percent': round(possession.player_percentage(player_id), 2)
+            })
+    
+    return output_dict
+
+
+def output_data(tracks, output_path='output_videos/data_output.json', team_ball_control=None,
+                possession=None):
+    """
+    Output numerical data from video analysis (see summarize_data) as JSON
+    and CSV.
+    
+    Args:
+        tracks: TrackStore, or the nested tracks dictionary
+        output_path: Path to save the output data (default: 'output_videos/data_output.json')
+        team_ball_control: numpy array with team possession per frame (optional,
+                           used when possession is not given)
+        possession: PossessionStats of the video (optional)
+    
+    Returns:
+        Dictionary containing the organized data
+    """
+    if possession is None and team_ball_control is not None:
+        from player_ball_assigner import PossessionStats
+        possession = PossessionStats(team_ball_control)
+    
+    output_dict = summarize_data(tracks, possession)
     
     # Create output directory if it doesn't exist
     output_dir = os.path.dirname(output_path)
@@ -116,7 +192,7 @@ def output_data(tracks, output_path='output_videos/data_output.json', team_ball_
     csv_path = f'{base_path}.csv'
     with open(csv_path, 'w', newline='', encoding='utf-8') as f:
         writer = csv.writer(f)
-        writer.writerow(['Team', 'Player ID', 'Distance (m)'])
+        writer.writerow(['Team', 'Player ID', 'Distance (m)', 'Possession (%)'])
         
         # Export all teams dynamically
         for team_key in sorted(output_dict.keys()):
@@ -129,19 +205,73 @@ def output_data(tracks, output_path='output_videos/data_output.json', team_ball_
                 writer.writerow([
                     team_key,
                     player_id,
-                    distance_display
+                    distance_display,
+                    data.get('possession_percent', '')
                 ])
         
         # Add summary rows - Team Possession Percentage
         writer.writerow([])
-        writer.writerow(['Summary - Team Possession Percentage', '', ''])
+        writer.writerow(['Summary - Team Possession Percentage', '', '', ''])
         
         # Write possession percentages
         if 'team_1_possession_percent' in output_dict['summary']:
-            writer.writerow(['Team 1 Possession', '', f"{output_dict['summary']['team_1_possession_percent']}%"])
+            writer.writerow(['Team 1 Possession', '', f"{output_dict['summary']['team_1_possession_percent']}%", ''])
         if 'team_2_possession_percent' in output_dict['summary']:
-            writer.writerow(['Team 2 Possession', '', f"{output_dict['summary']['team_2_possession_percent']}%"])
+            writer.writerow(['Team 2 Possession', '', f"{output_dict['summary']['team_2_possession_percent']}%", ''])
     
     print(f"Data output saved to {output_path} and {csv_path}")
     
     return output_dict
+
+
+def _format_column(values, fmt):
+    """Format a numeric column as strings; NaN becomes an empty cell."""
+    values = np.asarray(values, dtype=np.float64)
+    text = np.char.mod(fmt, np.nan_to_num(values))
+    return np.where(np.isnan(values), '', text)
+
+
+def output_frame_data(store, output_path='output_videos/frame_data.csv'):
+    """
+    Output one row per player per frame (speed, distance, team, possession).
+    
+    A full match has millions of rows, so rows are formatted column-wise
+    with numpy and written in chunks instead of one csv.writer call each.
+    
+    Args:
+        store: TrackStore of the analyzed video
+        output_path: Path of the CSV file (default: 'output_videos/frame_data.csv')
+    
+    Returns:
+        Number of rows written
+    """
+    from track_store import PLAYER
+    
+    rows = store.class_rows(PLAYER)
+    
+    output_dir = os.path.dirname(output_path)
+    if output_dir and not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+    
+    with open(output_path, 'w', newline='', encoding='utf-8') as f:
+        f.write('Frame,Player ID,Team,Speed (km/h),Distance (m),Has Ball\n')
+        for start in range(0, len(rows), FRAME_DATA_CHUNK_ROWS):
+            chunk = rows[start:start + FRAME_DATA_CHUNK_ROWS]
+            team = store.team[chunk]
+            columns = [
+                store.frame[chunk].astype(str),
+                store.track_id[chunk].astype(str),
+                np.where(team > 0, team.astype(str), ''),
+                _format_column(store.speed[chunk], '%.2f'),
+                _format_column(store.distance[chunk], '%.2f'),
+                np.where(store.has_ball[chunk], '1', '0'),
+            ]
+            lines = columns[0]
+            for column in columns[1:]:
+                lines = np.char.add(np.char.add(lines, ','), column)
+            f.write('\n'.join(lines.tolist()))
+            f.write('\n')
+    
+    print(f"Per-frame data saved to {output_path} ({len(rows)} rows)")
+    
+    return len(rows)
@@ -0,0 +1,80 @@
+"""
+===============================================================================
+JOB CONTROL
+===============================================================================
+
+This module lets a front end pause, resume and cancel a running analysis.
+
+The pipeline runs on the worker's main thread; commands arrive on another
+thread (the worker's command reader). JobControl holds the requested state
+in two threading.Event objects, and the pipeline polls it with check()
+between frames. ProgressReporter calls check() on every advance(), so every
+frame loop that reports progress is pausable and cancellable without
+further changes.
+
+- pause():  check() blocks until resume() or cancel()
+- cancel(): check() raises AnalysisCancelled; the pipeline unwinds
+            (writers are closed by their context managers, a checkpoint of
+            the detection pass is kept, see main.py)
+
+USAGE:
+    control = JobControl()
+    reporter = ProgressReporter(enabled=True, control=control)
+    # from another thread:
+    control.pause(); control.resume(); control.cancel()
+===============================================================================
+"""
+
+import threading
+
+
+class AnalysisCancelled(BaseException):
+    """
+    Raised inside the pipeline when the job was cancelled.
+
+    Derives from BaseException (like KeyboardInterrupt) so the stages'
+    "except Exception" handlers, which wrap errors into RuntimeError, let it
+    through unchanged.
+    """
+
+
+class JobControl:
+    """Pause/cancel requests for one job, safe to set from any thread."""
+
+    def __init__(self):
+        self._cancelled = threading.Event()
+        self._running = threading.Event()
+        self._running.set()
+
+    def pause(self):
+        """Block the pipeline at its next check()."""
+        if not self._cancelled.is_set():
+            self._running.clear()
+
+    def resume(self):
+        """Let a paused pipeline continue."""
+        self._running.set()
+
+    def cancel(self):
+        """Stop the pipeline at its next check() (also wakes a paused pipeline)."""
+        self._cancelled.set()
+        self._running.set()
+
+    @property
+    def paused(self):
+        return not self._running.is_set()
+
+    @property
+    def cancelled(self):
+        return self._cancelled.is_set()
+
+    def check(self):
+        """
+        Called by the pipeline between units of work.
+
+        Blocks while paused; raises AnalysisCancelled once cancelled.
+        """
+        if not self._running.is_set():
+            self._running.wait()
+        if self._cancelled.is_set():
+            raise AnalysisCancelled("Analysis cancelled")
@@ -0,0 +1,261 @@
+"""
+===============================================================================
+PROGRESS REPORTING
+===============================================================================
+
+This module emits machine-readable progress events so that a front end
+(the Qt GUI) can show determinate per-stage progress instead of a spinner.
+
+PROTOCOL:
+Each event is a single line of JSON written to stdout, prefixed with
+PROGRESS_PREFIX so it can be separated from ordinary log output:
+
+    @@FOOT {"event": "progress", "stage": "detection", "done": 120,
+            "total": 750, "fps": 23.4, "eta": 26.5}
+
+Fields:
+- stage: Pipeline stage name (e.g. "detection", "render")
+- done:  Units (frames) completed in this stage
+- total: Units expected in this stage, or null if unknown
+- fps:   Smoothed current throughput in units per second
+- eta:   Estimated seconds remaining in this stage, or null if unknown
+
+Events are throttled to a few per second; the first and last event of every
+stage are always emitted.
+
+Partial results are sent as snapshot events when a stage that changes them
+completes, so the GUI can show statistics before the run has finished:
+
+    @@FOOT {"event": "snapshot", "stage": "ball_possession", "frames": 750,
+            "data": {...}, "outputs": {...}}
+
+In streaming mode the detection pass ('analysis') also sends a snapshot of
+the frames processed so far every SNAPSHOT_INTERVAL seconds (main.py).
+
+- stage:   Stage after which the snapshot was taken ('analysis': running)
+- frames:  Frames covered by the snapshot
+- data:    Same structure as data_output.json (see utils/data_output.py)
+- outputs: Result files already written (same keys as the final result),
+           only present once they exist
+
+Once the stages have run, the pipeline reports which of them were taken
+from the stage cache (see utils/stage_graph.py):
+
+    @@FOOT {"event": "stage_cache", "hits": ["tracks", ...],
+            "recomputed": ["ball_possession"]}
+
+Every stage also gets a performance record (see utils/stage_metrics.py),
+sent when the stage finishes:
+
+    @@FOOT {"event": "stage_metrics", "stage": "detection", "start": 3.52,
+            "wall": 41.8, "cpu": 160.2, "peak_rss_delta": 524288000,
+            "peak_rss": 2147483648, "frames": 750, "fps": 17.94,
+            "parts": {"inference": {...}, "tracking": {...}}}
+
+A reporter created with a JobControl (see utils/job_control.py) also
+checks it on every advance(), so a paused job blocks and a cancelled job
+raises AnalysisCancelled between two frames.
+
+USAGE:
+    reporter = ProgressReporter(enabled=True)
+    for frame in reporter.track(frames, 'detection', total=len(frames)):
+        ...
+===============================================================================
+"""
+
+import json
+import sys
+import time
+from contextlib import contextmanager
+
+from .stage_metrics import StageMetrics
+
+
+PROGRESS_PREFIX = '@@FOOT '
+
+
+def stdout_sink(event):
+    """Write one event line to the real stdout and flush immediately."""
+    stream = sys.__stdout__
+    stream.write(PROGRESS_PREFIX + json.dumps(event, separators=(',', ':')) + '\n')
+    stream.flush()
+
+
+class ProgressReporter:
+    """
+    Tracks progress of the current pipeline stage and emits events.
+
+    A disabled reporter does all the bookkeeping but emits nothing, so the
+    pipeline can call it unconditionally.
+    """
+
+    def __init__(self, enabled=False, sink=stdout_sink, min_interval=0.25, control=None):
+        """
+        Args:
+            enabled: Whether events are emitted at all
+            sink: Callable receiving each event dictionary
+            min_interval: Minimum seconds between two events of one stage
+            control: JobControl checked on every advance, or None
+        """
+        self.enabled = enabled
+        self.sink = sink
+        self.min_interval = min_interval
+        self.control = control
+        self.metrics = StageMetrics()
+
+        self.current_stage = None
+        self.total = None
+        self.done = 0
+        self.fps = 0.0
+
+        self._stage_start = 0.0
+        self._last_emit = 0.0
+        self._last_done = 0
+        self._initial_done = 0
+
+    # =========================================================================
+    # STAGE CONTROL
+    # =========================================================================
+
+    def start_stage(self, stage, total=None, done=0):
+        """
+        Begin a new stage and emit its first event.
+
+        Args:
+            stage: Stage name
+            total: Expected number of units, or None if unknown
+            done: Units already done before the stage started (a resumed
+                  stage); they count for the progress but not for the fps
+        """
+        if self.control is not None:
+            self.control.check()
+        self.current_stage = stage
+        self.total = total if total and total > 0 else None
+        self.done = done
+        self.fps = 0.0
+
+        now = time.monotonic()
+        self._stage_start = now
+        self._last_emit = now
+        self._last_done = done
+        self._initial_done = done
+        self.metrics.start(stage)
+        self._emit_progress()
+
+    def advance(self, count=1):
+        """
+        Mark count more units as done; emits if the throttle allows.
+
+        Blocks while the job is paused and raises AnalysisCancelled once it
+        is cancelled (only with a control).
+        """
+        self.done += count
+        if self.control is not None:
+            self.control.check()
+
+        now = time.monotonic()
+        elapsed = now - self._last_emit
+        if elapsed < self.min_interval:
+            return
+
+        # Exponential moving average over the interval since the last event
+        instant_fps = (self.done - self._last_done) / elapsed
+        self.fps = instant_fps if self.fps == 0.0 else 0.7 * self.fps + 0.3 * instant_fps
+
+        self._last_emit = now
+        self._last_done = self.done
+        self._emit_progress()
+
+    def finish_stage(self):
+        """Emit the final event and the performance record of the current stage."""
+        if self.current_stage is None:
+            return
+
+        # Units done in this run of the stage; stages that do not advance
+        # (one batch operation) did all of total
+        processed = self.done - self._initial_done
+        record = self.metrics.finish(processed if self.done > 0 else self.total)
+        elapsed = time.monotonic() - self._stage_start
+        if elapsed > 0 and processed > 0:
+            self.fps = processed / elapsed
+        if self.total is None:
+            self.total = max(self.done, 1)
+        self.done = max(self.done, self.total)
+        self._emit_progress()
+        if record is not None:
+            self.emit(dict(record, event='stage_metrics'))
+        self.current_stage = None
+
+    def track(self, iterable, stage, total=None, done=0):
+        """
+        Wrap an iterable so each item consumed advances the given stage.
+
+        The stage is finished when the iterable is exhausted.
+
+        Args:
+            iterable: Items to process (e.g. frames)
+            stage: Stage name
+            total: Expected number of items, or None to use len() if available
+            done: Units already done before the first item (a resumed stage)
+
+        Yields:
+            Items from the iterable
+        """
+        if total is None and hasattr(iterable, '__len__'):
+            total = len(iterable)
+
+        self.start_stage(stage, total, done)
+        for item in iterable:
+            yield item
+            self.advance()
+        self.finish_stage()
+
+    @contextmanager
+    def stage(self, stage, total=None, done=0):
+        """
+        Context manager for a stage that is not driven by an iterable.
+
+        The stage is finished only if the block completes without error.
+        done is as in start_stage().
+        """
+        self.start_stage(stage, total, done)
+        yield self
+        self.finish_stage()
+
+    # =========================================================================
+    # EVENT OUTPUT
+    # =========================================================================
+
+    def emit(self, event):
+        """Send an arbitrary event dictionary through the sink."""
+        if self.enabled:
+            self.sink(event)
+
+    def snapshot(self, stage, data, frames, outputs=None):
+        """
+        Emit a partial result snapshot.
+
+        Args:
+            stage: Stage after which the snapshot was taken
+            data: Summary dictionary (data_output.json structure)
+            frames: Frames covered by the snapshot
+            outputs: Result files already written, or None
+        """
+        event = {'event': 'snapshot', 'stage': stage, 'frames': frames, 'data': data}
+        if outputs:
+            event['outputs'] = outputs
+        self.emit(event)
+
+    def _emit_progress(self):
+        eta = None
+        if self.total is not None and self.fps > 0:
+            eta = round(max(self.total - self.done, 0) / self.fps, 1)
+
+        self.emit({
+            'event': 'progress',
+            'stage': self.current_stage,
+            'done': self.done,
+            'total': self.total,
+            'fps': round(self.fps, 2),
+            'eta': eta,
+        })
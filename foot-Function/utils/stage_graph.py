@@ -0,0 +1,185 @@
+"""
+===============================================================================
+STAGE GRAPH
+===============================================================================
+
+This module runs the post-detection stages of the pipeline as a dependency
+graph and caches the output of every stage, so a re-run only recomputes the
+stages whose inputs or parameters changed.
+
+STAGES:
+A Stage names the stages (or sources) it reads, the parameters that
+influence its output and the TrackStore columns it writes. Sources are
+results cached elsewhere (object tracks, camera movement) and enter the
+graph with their own cache keys.
+
+CACHE KEY:
+A stage's key is derived from its name and version, its parameters and the
+keys of its inputs (StubCache.derive_key). Changing a parameter changes that
+stage's key and therefore the keys of everything downstream, while the
+stages upstream keep theirs. The pipeline's graph (see main.py):
+
+    tracks ── positions ── camera_adjustment ── view_transform ── ball_interpolation ── speed_and_distance
+    camera_movement ───────┘                                           │
+    tracks ── team_assignment ────────────────────────────────── ball_possession
+
+ARTIFACTS:
+An entry holds the columns the stage wrote, an optional extra payload
+(save/restore, e.g. the ball rows replaced by interpolation) and the
+stage's return value. Stages run in dependency order, so on a hit the
+cached columns match the rows of the store at that point.
+
+A stage without a key (an input is not cached, or no cache) always runs.
+
+REPORT:
+hits and recomputed list the stages (and sources) by name; report() formats
+them for the log and the progress event sent to the GUI.
+
+USAGE:
+    graph = StageGraph(cache)
+    graph.add_source('tracks', tracks_key, hit=True)
+    graph.run(Stage('positions', run_positions, inputs=('tracks',),
+                    columns=('position',)), store)
+===============================================================================
+"""
+
+import logging
+
+logger = logging.getLogger(__name__)
+
+
+class Stage:
+    """One cacheable pipeline stage."""
+
+    def __init__(self, name, run, inputs=(), params=None, columns=(),
+                 save=None, restore=None, version=1):
+        """
+        Args:
+            name: Stage name (also the progress stage name)
+            run: Callable doing the work on the store; its return value is cached
+            inputs: Names of the stages and sources the stage reads
+            params: JSON-serializable parameters that influence the output
+            columns: TrackStore columns the stage writes
+            save: Callable returning an extra payload to cache, or None
+            restore: Callable applying a cached extra payload, or None
+            version: Bump when the stage's output changes for the same inputs
+        """
+        self.name = name
+        self.run = run
+        self.inputs = tuple(inputs)
+        self.params = params or {}
+        self.columns = tuple(columns)
+        self.save = save
+        self.restore = restore
+        self.version = version
+
+
+class StageGraph:
+    """Runs stages in dependency order with a per-stage artifact cache."""
+
+    def __init__(self, cache=None):
+        """
+        Args:
+            cache: StubCache holding the artifacts, or None to always recompute
+        """
+        self.cache = cache
+        self.keys = {}
+        self.hits = []
+        self.recomputed = []
+
+    def add_source(self, name, key, hit=False):
+        """
+        Register a result cached outside the graph.
+
+        Args:
+            name: Source name used in Stage.inputs
+            key: Its cache key, or None if it is not cached
+            hit: Whether it was loaded from the cache (for the report)
+        """
+        self.keys[name] = key
+        (self.hits if hit else self.recomputed).append(name)
+
+    def reset(self):
+        """Forget all keys and the report (e.g. after a partial lookup)."""
+        self.keys.clear()
+        self.hits.clear()
+        self.recomputed.clear()
+
+    def key(self, stage):
+        """Cache key of a stage, or None if it cannot be cached."""
+        if self.cache is None:
+            return None
+        input_keys = [self.keys.get(name) for name in stage.inputs]
+        if any(key is None for key in input_keys):
+            return None
+        return self.cache.derive_key(f'stage/{stage.name}/v{stage.version}',
+                                     input_keys, stage.params)
+
+    # =========================================================================
+    # RUNNING
+    # =========================================================================
+
+    def run(self, stage, store):
+        """
+        Apply a stage's cached artifact to the store, or run it and cache it.
+
+        Args:
+            stage: Stage to run
+            store: TrackStore the stage reads and writes
+
+        Returns:
+            The stage's return value (cached or fresh)
+        """
+        found, value = self.load(stage, store)
+        if found:
+            return value
+        value = stage.run()
+        self.save(stage, store, value)
+        return value
+
+    def load(self, stage, store):
+        """
+        Apply a stage's cached artifact without running it.
+
+        Returns:
+            (True, value) on a hit, (False, None) on a miss
+        """
+        key = self.key(stage)
+        self.keys[stage.name] = key
+        artifact = self.cache.load(key) if key is not None else None
+        if artifact is None:
+            return False, None
+
+        columns = artifact['columns']
+        if any(len(column) != len(store) for column in columns.values()):
+            # Rows differ from when the entry was written: treat as a miss
+            logger.warning(f"Stage cache entry of {stage.name} does not match the tracks")
+            return False, None
+        for name, column in columns.items():
+            setattr(store, name, column)
+        if stage.restore is not None:
+            stage.restore(artifact['extra'])
+        self.hits.append(stage.name)
+        return True, artifact['value']
+
+    def save(self, stage, store, value=None):
+        """Cache the output of a stage that was just computed."""
+        key = self.keys.get(stage.name, self.key(stage))
+        self.keys[stage.name] = key
+        self.recomputed.append(stage.name)
+        if key is None:
+            return
+        self.cache.save(key, {
+            'columns': {name: getattr(store, name) for name in stage.columns},
+            'extra': stage.save() if stage.save is not None else None,
+            'value': value,
+        })
+
+    # =========================================================================
+    # REPORT
+    # =========================================================================
+
+    def report(self):
+        """Summary line of cached and recomputed stages."""
+        return (f"Stage cache: {len(self.hits)} cached ({', '.join(self.hits) or '-'}), "
+                f"{len(self.recomputed)} recomputed ({', '.join(self.recomputed) or '-'})")
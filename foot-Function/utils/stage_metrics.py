@@ -0,0 +1,232 @@
+"""
+===============================================================================
+STAGE METRICS
+===============================================================================
+
+This module records where the time of a pipeline run goes: one structured
+record per stage with wall time, CPU time, peak memory growth and
+throughput.
+
+ProgressReporter calls start()/finish() around every stage (see
+progress.py), so each stage of VideoAnalysisPipeline gets a record without
+timing code of its own:
+
+    {"stage": "detection", "start": 3.52, "wall": 41.8, "cpu": 160.2,
+     "peak_rss_delta": 524288000, "peak_rss": 2147483648,
+     "frames": 750, "fps": 17.94,
+     "parts": {"inference": {"wall": 35.1, "frames": 750, "fps": 21.37},
+               "tracking": {"wall": 5.9, "frames": 750, "fps": 127.12}}}
+
+- start:          Seconds from the start of the run to the start of the stage
+- wall / cpu:     Elapsed and process CPU seconds (CPU time counts all
+                  threads, so cpu > wall means the stage ran in parallel)
+- peak_rss_delta: Growth of the process' peak resident set size during the
+                  stage in bytes (0 when the stage stayed below an earlier
+                  peak; null where the platform does not report it)
+- frames / fps:   Units done in the stage and units per wall second
+- parts:          Wall time of parts of the stage measured with part() or
+                  timed(), e.g. decode / inference / tracking in detection
+
+PARTS:
+Parts are exclusive: while a part runs nested in another (the decoder
+called by the detector pulling its next batch), the time counts only for
+the inner part. Nesting is tracked per thread; a part on another thread
+(the ONNX prefetch thread decoding ahead) overlaps the main thread's parts.
+
+USAGE:
+    metrics = StageMetrics()
+    metrics.start('detection')
+    for _, detection in metrics.timed(detections, 'inference'):
+        with metrics.part('tracking'):
+            ...
+    record = metrics.finish(frames=750)
+===============================================================================
+"""
+
+import sys
+import time
+import threading
+from contextlib import contextmanager
+
+try:
+    import resource
+except ImportError:     # Windows
+    resource = None
+
+
+def peak_rss():
+    """Peak resident set size of this process in bytes, or None if unknown."""
+    if resource is not None:
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        # Linux reports kilobytes, macOS bytes
+        return peak if sys.platform == 'darwin' else peak * 1024
+    if sys.platform == 'win32':
+        return _windows_peak_working_set()
+    return None
+
+
+def _windows_peak_working_set():
+    """PeakWorkingSetSize from GetProcessMemoryInfo (psapi)."""
+    try:
+        import ctypes
+        from ctypes import wintypes
+
+        class ProcessMemoryCounters(ctypes.Structure):
+            _fields_ = [('cb', wintypes.DWORD),
+                        ('PageFaultCount', wintypes.DWORD),
+                        ('PeakWorkingSetSize', ctypes.c_size_t),
+                        ('WorkingSetSize', ctypes.c_size_t),
+                        ('QuotaPeakPagedPoolUsage', ctypes.c_size_t),
+                        ('QuotaPagedPoolUsage', ctypes.c_size_t),
+                        ('QuotaPeakNonPagedPoolUsage', ctypes.c_size_t),
+                        ('QuotaNonPagedPoolUsage', ctypes.c_size_t),
+                        ('PagefileUsage', ctypes.c_size_t),
+                        ('PeakPagefileUsage', ctypes.c_size_t)]
+
+        counters = ProcessMemoryCounters()
+        counters.cb = ctypes.sizeof(counters)
+        kernel32 = ctypes.windll.kernel32
+        kernel32.GetCurrentProcess.restype = wintypes.HANDLE
+        if not ctypes.windll.psapi.GetProcessMemoryInfo(
+                kernel32.GetCurrentProcess(), ctypes.byref(counters), counters.cb):
+            return None
+        return counters.PeakWorkingSetSize
+    except (OSError, AttributeError):
+        return None
+
+
+class StageMetrics:
+    """
+    Performance records of the stages of one run.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._local = threading.local()
+        self.reset()
+
+    def reset(self):
+        """Drop all records; start times count from now."""
+        self.records = []
+        self._origin = time.perf_counter()
+        self._stage = None
+        with self._lock:
+            self._parts = {}
+
+    # =========================================================================
+    # STAGES
+    # =========================================================================
+
+    def start(self, stage):
+        """Begin measuring a stage (parts recorded so far are dropped)."""
+        self._stage = stage
+        self._start_peak = peak_rss()
+        self._start_cpu = time.process_time()
+        self._start_wall = time.perf_counter()
+        with self._lock:
+            self._parts = {}
+
+    def finish(self, frames=None):
+        """
+        Close the current stage.
+
+        Args:
+            frames: Units done in the stage (for fps), or None
+
+        Returns:
+            The stage's record, or None if no stage was started
+        """
+        if self._stage is None:
+            return None
+        wall = time.perf_counter() - self._start_wall
+        cpu = time.process_time() - self._start_cpu
+        peak = peak_rss()
+
+        record = {
+            'stage': self._stage,
+            'start': round(self._start_wall - self._origin, 3),
+            'wall': round(wall, 3),
+            'cpu': round(cpu, 3),
+            'peak_rss_delta': (peak - self._start_peak
+                               if peak is not None and self._start_peak is not None else None),
+            'peak_rss': peak,
+            'frames': frames,
+            'fps': round(frames / wall, 2) if frames and wall > 0 else None,
+        }
+        with self._lock:
+            parts, self._parts = self._parts, {}
+        if parts:
+            record['parts'] = {
+                name: {'wall': round(seconds, 3), 'frames': count,
+                       'fps': round(count / seconds, 2) if count and seconds > 0 else None}
+                for name, (seconds, count) in parts.items()
+            }
+
+        self.records.append(record)
+        self._stage = None
+        return record
+
+    def report(self):
+        """All records and the elapsed time of the run so far."""
+        return {
+            'total_wall': round(time.perf_counter() - self._origin, 3),
+            'stages': list(self.records),
+        }
+
+    # =========================================================================
+    # PARTS
+    # =========================================================================
+
+    @contextmanager
+    def part(self, name, frames=1):
+        """
+        Measure a part of the current stage (exclusive of nested parts).
+
+        Args:
+            name: Part name
+            frames: Units the part processes (for its fps)
+        """
+        stack = self._stack()
+        now = time.perf_counter()
+        if stack:
+            # The enclosing part pauses while this one runs
+            outer = stack[-1]
+            self._add(outer[0], now - outer[1], 0)
+        entry = [name, now]
+        stack.append(entry)
+        try:
+            yield
+        finally:
+            now = time.perf_counter()
+            stack.pop()
+            self._add(name, now - entry[1], frames)
+            if stack:
+                stack[-1][1] = now
+
+    def timed(self, iterable, name):
+        """
+        Wrap an iterable so producing each item is measured as a part.
+
+        Yields:
+            Items from the iterable
+        """
+        iterator = iter(iterable)
+        while True:
+            with self.part(name, frames=0):
+                try:
+                    item = next(iterator)
+                except StopIteration:
+                    return
+            self._add(name, 0.0, 1)
+            yield item
+
+    def _stack(self):
+        stack = getattr(self._local, 'stack', None)
+        if stack is None:
+            stack = self._local.stack = []
+        return stack
+
+    def _add(self, name, seconds, frames):
+        with self._lock:
+            total_seconds, total_frames = self._parts.get(name, (0.0, 0))
+            self._parts[name] = (total_seconds + seconds, total_frames + frames)
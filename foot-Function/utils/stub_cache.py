@@ -0,0 +1,307 @@
+"""
+===============================================================================
+CONTENT-ADDRESSED STUB CACHE
+===============================================================================
+
+This module caches expensive intermediate results (object tracks, camera
+movement) keyed by what they were computed from, so re-analyzing a video
+skips detection while a different video can never pick up stale results.
+
+CACHE KEY:
+blake2b over
+- the kind of result and its format version (e.g. "tracks")
+- a fast fingerprint of the input video: file size plus sampled chunks
+  from the start, end and evenly spaced positions of the file
+- a full content hash of the model file (for results that depend on it)
+- the parameters that influence the result (confidence, tracker, ...)
+Results computed from other cached results (pipeline stages, see
+utils/stage_graph.py) use derive_key(): the keys of their inputs take the
+place of the video and model hashes.
+
+Fingerprints are memoized per (path, size, mtime), so a persistent worker
+hashes each video and model only once.
+
+STORAGE:
+One pickle file per key in the cache directory (default stubs/cache).
+- Writes go to a temporary file that is atomically renamed into place, so
+  concurrent workers and interrupted runs never leave a partial entry
+- Reading an entry refreshes its modification time; when the directory
+  grows beyond max_bytes the least recently used entries are deleted
+- Unreadable entries are deleted and treated as a miss
+
+USAGE:
+    cache = StubCache()
+    key = cache.make_key('tracks', video_path, model_path, {'conf': 0.1})
+    tracks = cache.load(key)
+    if tracks is None:
+        tracks = compute_tracks()
+        cache.save(key, tracks)
+===============================================================================
+"""
+
+import hashlib
+import json
+import logging
+import os
+import pickle
+import tempfile
+
+logger = logging.getLogger(__name__)
+
+# foot-Function/stubs/cache, independent of the current working directory
+DEFAULT_CACHE_DIR = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.abspath(__file__))), 'stubs', 'cache'
+)
+DEFAULT_MAX_BYTES = 2 * 1024 ** 3
+
+CACHE_SUFFIX = '.pkl'
+
+# Video fingerprint: head and tail chunks plus evenly spaced samples
+_EDGE_CHUNK = 1024 ** 2
+_SAMPLE_CHUNK = 64 * 1024
+_SAMPLE_COUNT = 16
+_HASH_BLOCK = 4 * 1024 ** 2
+
+_fingerprint_memo = {}
+
+
+def _file_identity(path):
+    stat = os.stat(path)
+    return os.path.abspath(path), stat.st_size, stat.st_mtime_ns
+
+
+def video_fingerprint(video_path):
+    """
+    Fast content fingerprint of a video file.
+
+    Reads at most a few MB regardless of the file size; containers change
+    throughout when any frame changes, so sampled chunks identify a clip.
+
+    Args:
+        video_path: Path to the video file
+
+    Returns:
+        Hex digest string
+    """
+    identity = _file_identity(video_path)
+    memo_key = ('video',) + identity
+    if memo_key in _fingerprint_memo:
+        return _fingerprint_memo[memo_key]
+
+    size = identity[1]
+    digest = hashlib.blake2b(digest_size=20)
+    digest.update(str(size).encode('ascii'))
+    with open(video_path, 'rb') as f:
+        if size <= 2 * _EDGE_CHUNK + _SAMPLE_COUNT * _SAMPLE_CHUNK:
+            digest.update(f.read())
+        else:
+            offsets = [0, size - _EDGE_CHUNK]
+            step = (size - 2 * _EDGE_CHUNK) // (_SAMPLE_COUNT + 1)
+            offsets[1:1] = [_EDGE_CHUNK + step * (i + 1) for i in range(_SAMPLE_COUNT)]
+            for index, offset in enumerate(offsets):
+                f.seek(offset)
+                is_edge = index == 0 or index == len(offsets) - 1
+                digest.update(f.read(_EDGE_CHUNK if is_edge else _SAMPLE_CHUNK))
+
+    result = digest.hexdigest()
+    _fingerprint_memo[memo_key] = result
+    return result
+
+
+def file_hash(path):
+    """
+    Full content hash of a file (used for model weights).
+
+    Args:
+        path: Path to the file
+
+    Returns:
+        Hex digest string
+    """
+    identity = _file_identity(path)
+    memo_key = ('file',) + identity
+    if memo_key in _fingerprint_memo:
+        return _fingerprint_memo[memo_key]
+
+    digest = hashlib.blake2b(digest_size=20)
+    with open(path, 'rb') as f:
+        for block in iter(lambda: f.read(_HASH_BLOCK), b''):
+            digest.update(block)
+
+    result = digest.hexdigest()
+    _fingerprint_memo[memo_key] = result
+    return result
+
+
+################################################################################
+# STUB CACHE CLASS
+################################################################################
+
+class StubCache:
+    """
+    Size-bounded, content-addressed pickle cache with LRU eviction.
+    """
+
+    def __init__(self, cache_dir=DEFAULT_CACHE_DIR, max_bytes=DEFAULT_MAX_BYTES):
+        """
+        Args:
+            cache_dir: Directory holding the cache entries
+            max_bytes: Total size above which least recently used entries are evicted
+        """
+        self.cache_dir = cache_dir
+        self.max_bytes = max_bytes
+
+    # =========================================================================
+    # KEYS
+    # =========================================================================
+
+    def make_key(self, kind, video_path, model_path=None, params=None):
+        """
+        Build the cache key for one result.
+
+        Args:
+            kind: Result name including a format version (e.g. "tracks/v1")
+            video_path: Input video the result was computed from
+            model_path: Model file the result depends on, or None
+            params: JSON-serializable parameters that influence the result
+
+        Returns:
+            Key string usable as a file name
+        """
+        description = {
+            'kind': kind,
+            'video': video_fingerprint(video_path),
+            'model': file_hash(model_path) if model_path else None,
+            'params': params or {},
+        }
+        encoded = json.dumps(description, sort_keys=True, default=str).encode('utf-8')
+        name = kind.split('/')[0].replace(os.sep, '_')
+        return f"{name}-{hashlib.blake2b(encoded, digest_size=16).hexdigest()}"
+
+    def derive_key(self, kind, input_keys, params=None):
+        """
+        Build the key of a result computed from other cached results.
+
+        Args:
+            kind: Result name including a format version (e.g. "stage/speed/v1")
+            input_keys: Keys of the inputs, in a fixed order
+            params: JSON-serializable parameters that influence the result
+
+        Returns:
+            Key string usable as a file name
+        """
+        description = {
+            'kind': kind,
+            'inputs': list(input_keys),
+            'params': params or {},
+        }
+        encoded = json.dumps(description, sort_keys=True, default=str).encode('utf-8')
+        name = kind.replace('/', '_').replace(os.sep, '_')
+        return f"{name}-{hashlib.blake2b(encoded, digest_size=16).hexdigest()}"
+
+    def _entry_path(self, key):
+        return os.path.join(self.cache_dir, key + CACHE_SUFFIX)
+
+    # =========================================================================
+    # LOAD / SAVE
+    # =========================================================================
+
+    def load(self, key):
+        """
+        Load a cached result.
+
+        Args:
+            key: Key from make_key()
+
+        Returns:
+            The cached object, or None on a miss
+        """
+        path = self._entry_path(key)
+        try:
+            with open(path, 'rb') as f:
+                data = pickle.load(f)
+        except FileNotFoundError:
+            logger.info(f"Cache miss: {key}")
+            return None
+        except Exception as e:
+            logger.warning(f"Discarding unreadable cache entry {key}: {e}")
+            self._remove(path)
+            return None
+
+        # Mark as recently used
+        try:
+            os.utime(path)
+        except OSError:
+            pass
+        logger.info(f"Cache hit: {key}")
+        return data
+
+    def save(self, key, data):
+        """
+        Store a result atomically, then evict old entries if over budget.
+
+        Failures are logged and ignored; the cache is only an optimization.
+
+        Args:
+            key: Key from make_key()
+            data: Picklable object
+        """
+        path = self._entry_path(key)
+        temp_path = None
+        try:
+            os.makedirs(self.cache_dir, exist_ok=True)
+            fd, temp_path = tempfile.mkstemp(prefix='.' + key, suffix='.tmp', dir=self.cache_dir)
+            with os.fdopen(fd, 'wb') as f:
+                pickle.dump(data, f, protocol=pickle.HIGHEST_PROTOCOL)
+            os.replace(temp_path, path)
+            temp_path = None
+            logger.info(f"Cached {key}")
+        except Exception as e:
+            logger.warning(f"Failed to write cache entry {key}: {e}")
+        finally:
+            if temp_path is not None:
+                self._remove(temp_path)
+
+        self.evict()
+
+    def discard(self, key):
+        """
+        Delete an entry if it exists (e.g. a checkpoint that is no longer needed).
+
+        Args:
+            key: Key from make_key()
+        """
+        self._remove(self._entry_path(key))
+
+    # =========================================================================
+    # EVICTION
+    # =========================================================================
+
+    def evict(self):
+        """Delete least recently used entries until the cache fits in max_bytes."""
+        entries = []
+        try:
+            with os.scandir(self.cache_dir) as it:
+                for entry in it:
+                    if entry.is_file() and entry.name.endswith(CACHE_SUFFIX):
+                        stat = entry.stat()
+                        entries.append((stat.st_mtime, stat.st_size, entry.path))
+        except FileNotFoundError:
+            return
+
+        total = sum(size for _, size, _ in entries)
+        for _, size, path in sorted(entries):
+            if total <= self.max_bytes:
+                break
+            if self._remove(path):
+                logger.info(f"Evicted cache entry {os.path.basename(path)}")
+            total -= size
+
+    @staticmethod
+    def _remove(path):
+        try:
+            os.remove(path)
+            return True
+        except OSError:
+            # Already removed (e.g. by another worker)
+            return False
@@ -7,11 +7,25 @@ This module handles video input/output operations with comprehensive
 error handling and validation.
 
 FUNCTIONS:
-- read_video: Load video frames from file into memory
-- save_video: Write processed frames to video file
+- iter_video: Decode video frames one at a time (streaming)
+- get_video_properties: Read frame count, FPS and size from the container
+- VideoFrameWriter: Write processed frames one at a time (streaming)
+- BackgroundVideoWriter: Encode frames on a separate thread, fed by a
+  bounded queue, so encoding overlaps rendering
+
+Writers take the frame rate of the input video (get_video_properties) and
+default to DEFAULT_VIDEO_CODEC.
+
+CODECS (VIDEO_CODECS):
+- h264: H.264 in MP4 (default; much smaller files, plays everywhere).
+        Needs an OpenCV build whose FFmpeg/Media Foundation backend has an
+        H.264 encoder; otherwise MPEG-4 Part 2 in the same container is used
+- mp4v: MPEG-4 Part 2 in MP4
+- xvid: XVID in AVI (the original output format)
+- mjpg: Motion JPEG in AVI (large, but fast to encode)
 
 ERROR HANDLING:
-Both functions include extensive validation and error checking to ensure
+All functions include extensive validation and error checking to ensure
 robust operation in production environments. They handle:
 - File existence and accessibility
 - Invalid video formats or corrupted files
@@ -29,23 +43,50 @@ All errors are raised as exceptions with descriptive messages for debugging.
 import cv2
 import os
 import logging
+import queue
+import threading
 
 logger = logging.getLogger(__name__)
 
+# Codec name -> (FourCC candidates in order of preference, file extension)
+VIDEO_CODECS = {
+    'h264': (('avc1', 'H264', 'mp4v'), '.mp4'),
+    'mp4v': (('mp4v',), '.mp4'),
+    'xvid': (('XVID',), '.avi'),
+    'mjpg': (('MJPG',), '.avi'),
+}
+DEFAULT_VIDEO_CODEC = 'h264'
+
+
+def video_extension(codec):
+    """File extension (with dot) of the container used for a codec."""
+    if codec not in VIDEO_CODECS:
+        raise ValueError(f"Unknown video codec: {codec}")
+    return VIDEO_CODECS[codec][1]
+
 
-def read_video(video_path):
+def iter_video(video_path, start_frame=0):
     """
-    Read video frames from file with error handling.
+    Decode video frames lazily, one frame at a time.
+    
+    Only the current frame is held in memory, so the memory footprint does
+    not grow with the length of the video. The
+    generator can be consumed once; call it again to decode a second pass.
+    
+    Frames before start_frame are skipped with grab() (no color conversion
+    or copy). Seeking with CAP_PROP_POS_FRAMES is not frame-accurate for all
+    codecs, so the frames are still decoded.
     
     Args:
         video_path: Path to video file
+        start_frame: Index of the first frame to yield (resuming a pass)
         
-    Returns:
-        List of frames as numpy arrays
+    Yields:
+        Frames as numpy arrays
         
     Raises:
         FileNotFoundError: If video file doesn't exist
-        IOError: If video cannot be opened or read
+        IOError: If video cannot be opened or contains no frames
     """
     if not os.path.exists(video_path):
         raise FileNotFoundError(f"Video file not found: {video_path}")
@@ -55,49 +96,79 @@ def read_video(video_path):
     if not cap.isOpened():
         raise IOError(f"Cannot open video file: {video_path}")
     
-    frames = []
     frame_count = 0
     
-    while True:
-        ret, frame = cap.read()
-        if not ret:
-            break
-        frames.append(frame)
-        frame_count += 1
-    
-    cap.release()
+    try:
+        while frame_count < start_frame and cap.grab():
+            frame_count += 1
+        while True:
+            ret, frame = cap.read()
+            if not ret:
+                break
+            frame_count += 1
+            yield frame
+    finally:
+        cap.release()
     
-    if not frames:
+    if frame_count == 0:
         raise IOError(f"No frames read from video: {video_path}")
     
-    logger.info(f"Read {frame_count} frames from {video_path}")
-    
-    return frames
+    logger.info(f"Decoded {frame_count} frames from {video_path}")
 
 
-def save_video(output_video_frames, output_video_path):
+def get_video_properties(video_path):
     """
-    Save video frames to file with robust error handling.
+    Read basic stream properties from the video container without decoding.
+    
+    The frame count reported by the container is an estimate for some
+    codecs; callers should treat it as a hint (e.g. for progress reporting).
     
     Args:
-        output_video_frames: List of frames to save
-        output_video_path: Path where video should be saved
+        video_path: Path to video file
+        
+    Returns:
+        Dictionary with 'frame_count', 'fps', 'width' and 'height'
         
     Raises:
-        ValueError: If frames list is empty or invalid
-        IOError: If video cannot be written or output directory doesn't exist
+        FileNotFoundError: If video file doesn't exist
+        IOError: If video cannot be opened
     """
-    # Validate inputs
-    if not output_video_frames:
-        raise ValueError("Cannot save video: frames list is empty")
+    if not os.path.exists(video_path):
+        raise FileNotFoundError(f"Video file not found: {video_path}")
     
-    if not isinstance(output_video_frames, list):
-        raise TypeError("output_video_frames must be a list")
+    cap = cv2.VideoCapture(video_path)
+    
+    if not cap.isOpened():
+        raise IOError(f"Cannot open video file: {video_path}")
+    
+    try:
+        properties = {
+            'frame_count': int(cap.get(cv2.CAP_PROP_FRAME_COUNT)),
+            'fps': float(cap.get(cv2.CAP_PROP_FPS)),
+            'width': int(cap.get(cv2.CAP_PROP_FRAME_WIDTH)),
+            'height': int(cap.get(cv2.CAP_PROP_FRAME_HEIGHT)),
+        }
+    finally:
+        cap.release()
+    
+    return properties
+
+
+def _open_video_writer(output_video_path, width, height, fps, codec=DEFAULT_VIDEO_CODEC):
+    """
+    Create the output directory and open a validated VideoWriter.
     
-    # Validate output path
-    if not output_video_path or not output_video_path.strip():
-        raise ValueError("Output video path cannot be empty")
+    The FourCC candidates of the codec are tried in order, so a build
+    without an H.264 encoder falls back to MPEG-4 Part 2.
     
+    Raises:
+        ValueError: If the codec is unknown
+        IOError: If the output directory cannot be created or the writer
+                 cannot be opened
+    """
+    if codec not in VIDEO_CODECS:
+        raise ValueError(f"Unknown video codec: {codec}")
+
     # Create output directory if needed
     output_dir = os.path.dirname(output_video_path)
     if output_dir and not os.path.exists(output_dir):
@@ -107,95 +178,234 @@ def save_video(output_video_frames, output_video_path):
         except Exception as e:
             raise IOError(f"Failed to create output directory {output_dir}: {e}")
     
-    # Get video properties from first frame
-    try:
-        first_frame = output_video_frames[0]
-        height, width = first_frame.shape[:2]
+    fourccs = VIDEO_CODECS[codec][0]
+    for fourcc in fourccs:
+        logger.info(f"Initializing VideoWriter with codec={fourcc}, fps={fps}, size=({width}, {height})")
         
-        if height <= 0 or width <= 0:
-            raise ValueError(f"Invalid frame dimensions: {width}x{height}")
+        out = cv2.VideoWriter(
+            output_video_path,
+            cv2.VideoWriter_fourcc(*fourcc),
+            fps,
+            (width, height)
+        )
         
-        logger.info(f"Video dimensions: {width}x{height}, frames: {len(output_video_frames)}")
+        # Critical check: VideoWriter must be opened before writing
+        if out.isOpened():
+            logger.info("VideoWriter opened successfully")
+            return out
         
-    except (IndexError, AttributeError) as e:
-        raise ValueError(f"Invalid frame data: {e}")
+        out.release()
+        logger.warning(f"Codec '{fourcc}' is not supported by this OpenCV build")
+    
+    raise IOError(
+        f"Failed to open VideoWriter for {output_video_path}. "
+        f"Codecs {', '.join(fourccs)} may not be supported. "
+        f"Frame size: {width}x{height}, FPS: {fps}"
+    )
+
+
+class VideoFrameWriter:
+    """
+    Incremental video writer for streaming output.
     
-    # Initialize VideoWriter with validated parameters
-    fourcc = cv2.VideoWriter_fourcc(*'XVID')
-    fps = 24
+    Frames are written as soon as they are produced, so annotated frames
+    never have to be collected in memory. The frame size is taken from the
+    first frame written; later frames with a different size are resized.
     
-    logger.info(f"Initializing VideoWriter with codec=XVID, fps={fps}, size=({width}, {height})")
+    Usage:
+        with VideoFrameWriter(path, fps=25) as writer:
+            for frame in frames:
+                writer.write(frame)
+    """
     
-    out = cv2.VideoWriter(
-        output_video_path,
-        fourcc,
-        fps,
-        (width, height)
-    )
+    def __init__(self, output_video_path, fps, codec=DEFAULT_VIDEO_CODEC):
+        """
+        Args:
+            output_video_path: Path where video should be saved
+            fps: Output frame rate (the frame rate of the input video)
+            codec: Key of VIDEO_CODECS
+            
+        Raises:
+            ValueError: If output path is empty or the codec is unknown
+        """
+        if not output_video_path or not output_video_path.strip():
+            raise ValueError("Output video path cannot be empty")
+        if codec not in VIDEO_CODECS:
+            raise ValueError(f"Unknown video codec: {codec}")
+        
+        self.output_video_path = output_video_path
+        self.fps = fps
+        self.codec = codec
+        self.frames_written = 0
+        self.frames_skipped = 0
+        self._writer = None
+        self._size = None
     
-    # Critical check: VideoWriter must be opened before writing
-    if not out.isOpened():
-        out.release()
-        raise IOError(
-            f"Failed to open VideoWriter for {output_video_path}. "
-            f"Codec 'XVID' may not be supported. "
-            f"Frame size: {width}x{height}, FPS: {fps}"
+    def write(self, frame):
+        """
+        Append one frame to the output video.
+        
+        Raises:
+            IOError: If the writer cannot be opened or closes unexpectedly
+        """
+        if frame is None or len(frame.shape) < 2:
+            logger.warning(f"Skipping invalid frame at index {self.frames_written + self.frames_skipped}")
+            self.frames_skipped += 1
+            return
+        
+        height, width = frame.shape[:2]
+        
+        if self._writer is None:
+            if height <= 0 or width <= 0:
+                raise ValueError(f"Invalid frame dimensions: {width}x{height}")
+            self._writer = _open_video_writer(self.output_video_path, width, height, self.fps, self.codec)
+            self._size = (width, height)
+        elif (width, height) != self._size:
+            frame = cv2.resize(frame, self._size)
+        
+        if not self._writer.isOpened():
+            raise IOError(f"VideoWriter closed unexpectedly at frame {self.frames_written}")
+        
+        self._writer.write(frame)
+        self.frames_written += 1
+    
+    def close(self):
+        """
+        Release the writer and verify the output file.
+        
+        Raises:
+            IOError: If no frames were written or the output file is empty
+        """
+        if self._writer is None:
+            raise IOError(f"No frames written to video: {self.output_video_path}")
+        
+        self._writer.release()
+        self._writer = None
+        logger.info(
+            f"VideoWriter released. Frames written: {self.frames_written}, "
+            f"skipped: {self.frames_skipped}"
+        )
+        
+        if not os.path.exists(self.output_video_path):
+            raise IOError(f"Output video file was not created: {self.output_video_path}")
+        
+        file_size = os.path.getsize(self.output_video_path)
+        if file_size == 0:
+            raise IOError(f"Output video file is empty: {self.output_video_path}")
+        
+        logger.info(
+            f"Video saved successfully: {self.output_video_path} "
+            f"({file_size / 1024 / 1024:.2f} MB)"
         )
     
-    logger.info("VideoWriter opened successfully")
+    def abort(self):
+        """Release the writer without verifying the output (after an error)."""
+        if self._writer is not None:
+            self._writer.release()
+            self._writer = None
     
-    # Write frames
-    frames_written = 0
-    frames_skipped = 0
+    def __enter__(self):
+        return self
     
-    try:
-        for i, frame in enumerate(output_video_frames):
-            if frame is None:
-                logger.warning(f"Skipping None frame at index {i}")
-                frames_skipped += 1
-                continue
-            
-            # Validate frame has correct shape
-            if len(frame.shape) < 2:
-                logger.warning(f"Skipping frame {i}: invalid shape {frame.shape}")
-                frames_skipped += 1
-                continue
-                
-            # Validate frame dimensions match
-            frame_height, frame_width = frame.shape[:2]
-            if (frame_height, frame_width) != (height, width):
-                logger.warning(
-                    f"Frame {i} has different dimensions ({frame_width}x{frame_height}), "
-                    f"expected ({width}x{height}). Resizing..."
-                )
-                frame = cv2.resize(frame, (width, height))
+    def __exit__(self, exc_type, exc_value, traceback):
+        if exc_type is None:
+            self.close()
+        else:
+            self.abort()
+        return False
+
+
+class BackgroundVideoWriter:
+    """
+    VideoFrameWriter running on its own thread.
+    
+    write() puts the frame into a bounded queue and returns immediately
+    unless the encoder is max_pending frames behind, so rendering and
+    encoding overlap while memory stays bounded. Errors raised by the
+    encoder thread are re-raised by the next write() or by close().
+    
+    Usage:
+        with BackgroundVideoWriter(path, fps=25, codec='h264') as writer:
+            for frame in frames:
+                writer.write(frame)
+    """
+    
+    _END = object()
+    
+    def __init__(self, output_video_path, fps, codec=DEFAULT_VIDEO_CODEC, max_pending=32):
+        """
+        Args:
+            output_video_path: Path where video should be saved
+            fps: Output frame rate (the frame rate of the input video)
+            codec: Key of VIDEO_CODECS
+            max_pending: Frames that may wait in the queue
             
-            # Write frame - cv2.VideoWriter.write() returns None, not boolean
-            # We need to check if writer is still open instead
-            if not out.isOpened():
-                logger.error(f"VideoWriter closed unexpectedly at frame {i}")
+        Raises:
+            ValueError: If output path is empty or the codec is unknown
+        """
+        self._writer = VideoFrameWriter(output_video_path, fps, codec)
+        self._queue = queue.Queue(maxsize=max(max_pending, 1))
+        self._error = None
+        self._thread = threading.Thread(target=self._run, name='video-encoder', daemon=True)
+        self._thread.start()
+    
+    @property
+    def frames_written(self):
+        return self._writer.frames_written
+    
+    def _run(self):
+        """Encoder thread: write queued frames until the end marker."""
+        while True:
+            frame = self._queue.get()
+            if frame is self._END:
                 break
-            
-            out.write(frame)
-            frames_written += 1
-                
-    except Exception as e:
-        logger.error(f"Error writing frames to video: {e}")
-        raise IOError(f"Error writing frames to video: {e}")
-    finally:
-        out.release()
-        logger.info(f"VideoWriter released. Frames written: {frames_written}, skipped: {frames_skipped}")
+            if self._error is not None:
+                continue  # Keep draining so the producer never blocks
+            try:
+                self._writer.write(frame)
+            except Exception as e:
+                self._error = e
+        
+        if self._error is None:
+            try:
+                self._writer.close()
+            except Exception as e:
+                self._error = e
+        else:
+            self._writer.abort()
     
-    # Verify output file was created
-    if not os.path.exists(output_video_path):
-        raise IOError(f"Output video file was not created: {output_video_path}")
+    def write(self, frame):
+        """
+        Queue one frame for encoding (blocks while the queue is full).
+        
+        Raises:
+            IOError: If the encoder thread failed
+        """
+        if self._error is not None:
+            raise IOError(f"Video encoder failed: {self._error}")
+        self._queue.put(frame)
     
-    file_size = os.path.getsize(output_video_path)
-    if file_size == 0:
-        raise IOError(f"Output video file is empty: {output_video_path}")
+    def close(self):
+        """
+        Wait for all queued frames to be encoded and verify the output.
+        
+        Raises:
+            IOError: If encoding failed or the output file is missing/empty
+        """
+        self._queue.put(self._END)
+        self._thread.join()
+        if self._error is not None:
+            raise IOError(f"Video encoder failed: {self._error}")
     
-    logger.info(
-        f"Video saved successfully: {output_video_path} "
-        f"({file_size / 1024 / 1024:.2f} MB)"
-    )
-
+    def __enter__(self):
+        return self
+    
+    def __exit__(self, exc_type, exc_value, traceback):
+        if exc_type is None:
+            self.close()
+        else:
+            # Stop the encoder without masking the original exception
+            self._error = self._error or exc_value
+            self._queue.put(self._END)
+            self._thread.join()
+        return False
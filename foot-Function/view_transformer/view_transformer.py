@@ -28,6 +28,12 @@ COORDINATE SYSTEM:
   - X-axis: Along field length (23.32 meters)
   - Y-axis: Across field width (68 meters)
 
+BATCH TRANSFORMATION:
+transform_points() handles any number of points at once: one vectorized
+inside-quadrilateral test and one perspectiveTransform call for all points
+inside, instead of a polygon test and a one-point transform per object
+per frame.
+
 REFERENCE POINTS:
 The 4 points define a quadrilateral on the field that's visible in video.
 These are manually calibrated based on the specific camera angle and position.
@@ -111,6 +117,64 @@ class ViewTransformer():
         tranform_point = cv2.perspectiveTransform(reshaped_point,self.persepctive_trasnformer)
         return tranform_point.reshape(-1,2)
 
+    def points_inside(self, points):
+        """
+        Vectorized version of the inside test of transform_point.
+        
+        Like cv2.pointPolygonTest on the truncated pixel coordinates, points
+        on the border of the reference quadrilateral count as inside.
+        
+        Args:
+            points: (N, 2) array of pixel coordinates (NaN rows are outside)
+            
+        Returns:
+            (N,) boolean array
+        """
+        points = np.asarray(points, dtype=np.float64).reshape(-1, 2)
+        valid = ~np.isnan(points).any(axis=1)
+        px = np.trunc(np.where(valid, points[:, 0], 0))
+        py = np.trunc(np.where(valid, points[:, 1], 0))
+
+        vertices = self.pixel_vertices.astype(np.float64)
+        inside = np.zeros(len(points), dtype=bool)
+        on_border = np.zeros(len(points), dtype=bool)
+        for (x1, y1), (x2, y2) in zip(vertices, np.roll(vertices, -1, axis=0)):
+            # Even-odd rule: count edges crossed by a ray to the right
+            crosses = (y1 > py) != (y2 > py)
+            with np.errstate(divide='ignore', invalid='ignore'):
+                x_cross = (x2 - x1) * (py - y1) / (y2 - y1) + x1
+            inside ^= crosses & (px < x_cross)
+
+            # Points exactly on an edge (integer coordinates, exact test)
+            cross = (x2 - x1) * (py - y1) - (y2 - y1) * (px - x1)
+            on_border |= ((cross == 0)
+                          & (px >= min(x1, x2)) & (px <= max(x1, x2))
+                          & (py >= min(y1, y2)) & (py <= max(y1, y2)))
+
+        return valid & (inside | on_border)
+
+    def transform_points(self, points):
+        """
+        Transform many points from pixel to field coordinates at once.
+        
+        Args:
+            points: (N, 2) array of pixel coordinates
+            
+        Returns:
+            (N, 2) float array in meters, NaN for points outside the
+            reference area (where transform_point returns None)
+        """
+        points = np.asarray(points, dtype=np.float64).reshape(-1, 2)
+        transformed = np.full(points.shape, np.nan)
+
+        inside = self.points_inside(points)
+        if inside.any():
+            reshaped_points = points[inside].reshape(-1, 1, 2).astype(np.float32)
+            transformed[inside] = cv2.perspectiveTransform(
+                reshaped_points, self.persepctive_trasnformer
+            ).reshape(-1, 2)
+        return transformed
+
     def add_transformed_position_to_tracks(self,tracks):
         """
         Apply perspective transformation to all tracked object positions.
@@ -123,12 +187,31 @@ class ViewTransformer():
         Args:
             tracks: Tracking dictionary for all objects
         """
-        for object, object_tracks in tracks.items():
-            for frame_num, track in enumerate(object_tracks):
-                for track_id, track_info in track.items():
-                    position = track_info['position_adjusted']
-                    position = np.array(position)
-                    position_trasnformed = self.transform_point(position)
-                    if position_trasnformed is not None:
-                        position_trasnformed = position_trasnformed.squeeze().tolist()
-                    tracks[object][frame_num][track_id]['position_transformed'] = position_trasnformed
\ No newline at end of file
+        track_infos = [track_info
+                       for object_tracks in tracks.values()
+                       for track in object_tracks
+                       for track_info in track.values()]
+        if not track_infos:
+            return
+
+        positions = np.array([track_info['position_adjusted'] for track_info in track_infos],
+                             dtype=np.float64)
+        positions_transformed = self.transform_points(positions)
+        inside = ~np.isnan(positions_transformed[:, 0])
+        for track_info, position_trasnformed, is_inside in zip(
+                track_infos, positions_transformed.tolist(), inside.tolist()):
+            track_info['position_transformed'] = position_trasnformed if is_inside else None
+
+    def add_transformed_position_to_store(self, store):
+        """
+        Apply the perspective transformation to all rows of a TrackStore.
+        
+        All camera-adjusted positions go through transform_points() as one
+        array and the result is written back as a whole column. Rows
+        outside the reference area (or without an adjusted position) get
+        NaN as their transformed position.
+        
+        Args:
+            store: TrackStore with camera-adjusted positions
+        """
+        store.position_transformed[:] = self.transform_points(store.position_adjusted)
@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+"""
+===============================================================================
+足球分析 - 常駐分析工作程序
+===============================================================================
+
+長時間執行的分析工作程序，讓 Qt GUI 連續分析多個影片時
+不必每次都重新啟動 Python、匯入 ultralytics/torch 和載入 YOLO 模型。
+
+工作程序只載入一次模型，並在模型路徑（或模型檔案）改變時才重新載入。
+
+連線方式：
+GUI 建立本機伺服器（QLocalServer），以 --server 傳入完整伺服器名稱。
+工作程序建立兩條單向連線：
+- commands：GUI → 工作程序（工作、預載模型、關閉）
+- events：  工作程序 → GUI（就緒、進度、結果）
+每條連線的第一行是 {"type": "hello", "channel": ..., "pid": ...}。
+使用兩條單向連線是因為 Windows 具名管道的同步讀寫會互相阻塞。
+
+訊息格式：每行一個 JSON 物件（UTF-8，以 \\n 結尾）。
+
+GUI → 工作程序：
+    {"type": "job", "job_id": ..., "input": ..., "model": ..., "output": ...,
+     "streaming": bool, "use_cache": bool, "threads": int,
+     "speed_window": int, "speed_mode": "window" | "sliding" | "smoothed",
+     "camera_proxy_scale": float, "video_codec": "h264" | "mp4v" | "xvid" | "mjpg",
+     "backend": "ultralytics" | "onnx", "int8": bool, "batch_size": int,
+     "keyframe_stride": int, "render_video": bool}
+    {"type": "load_model", "model": ..., "backend": ..., "int8": bool}
+    {"type": "pause" | "resume" | "cancel", "job_id": ...}
+    {"type": "shutdown"}
+
+工作程序 → GUI：
+    {"type": "ready"}
+    {"type": "model_loaded", "model": ..., "seconds": ...}
+    {"type": "event", "job_id": ..., "event": {...}}   # 見 utils/progress.py
+    {"type": "result", "job_id": ..., "status": "ok" | "error" | "cancelled",
+     "outputs": {...}, "error": ...}
+
+暫停、繼續和取消：
+命令讀取執行緒直接套用到工作的 JobControl（見 utils/job_control.py），
+不經過命令佇列，所以工作執行期間也會立即生效。暫停和繼續以事件
+{"event": "paused"} / {"event": "resumed"} 回報。取消的工作保留串流
+第一遍的檢查點，以相同參數重新提交時從檢查點繼續。
+關閉命令也會取消執行中的工作。
+
+日誌仍然寫入 stderr，由 GUI 透過 QProcess 擷取。
+
+執行緒預算：
+GUI 同時執行多個工作程序時，每個工作會帶有 threads 欄位，
+工作程序據此限制 torch 和 OpenCV 的執行緒數，以及管道自己的執行緒池
+（相機移動分段估計和註解繪製），避免 CPU 過度訂閱。
+ONNX Runtime 的執行緒數在建立 session 時決定，所以 onnx 後端的
+執行緒預算改變時會重新載入模型。
+OpenMP/BLAS 執行緒池在匯入時決定，由 GUI 以環境變數
+（OMP_NUM_THREADS 等）在啟動程序時設定。
+
+使用方式（由 GUI 啟動）：
+    python worker.py --server <完整伺服器名稱>
+===============================================================================
+"""
+
+import os
+import sys
+import json
+import time
+import queue
+import socket
+import logging
+import argparse
+import threading
+from typing import Any, Dict, Optional, Tuple
+
+import cv2
+
+# 匯入管道（連同 ultralytics/torch）：這是只需支付一次的啟動成本
+from main import VideoAnalysisPipeline
+from trackers import Tracker
+from utils import ProgressReporter, DEFAULT_VIDEO_CODEC, JobControl, AnalysisCancelled
+
+logger = logging.getLogger('worker')
+
+
+################################################################################
+# 連線
+################################################################################
+
+def _connect(server_name: str, channel: str):
+    """
+    連線到 GUI 的本機伺服器並送出識別此連線的 hello 行。
+
+    返回：可讀寫的二進位檔案物件（之後只在單一方向使用）
+    """
+    if os.name == 'nt':
+        # Windows：QLocalServer 使用具名管道 \\.\pipe\<名稱>
+        stream = open(server_name, 'r+b', buffering=0)
+    else:
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.connect(server_name)
+        stream = sock.makefile('rwb')
+
+    hello = {'type': 'hello', 'channel': channel, 'pid': os.getpid()}
+    stream.write(json.dumps(hello).encode('utf-8') + b'\n')
+    stream.flush()
+    return stream
+
+
+class WorkerChannel:
+    """與 GUI 之間的兩條單向 JSON-lines 連線。"""
+
+    def __init__(self, server_name: str):
+        self.commands = _connect(server_name, 'commands')
+        self.events = _connect(server_name, 'events')
+        self._send_lock = threading.Lock()
+
+    def send(self, message: Dict[str, Any]) -> None:
+        """傳送一則訊息（可從任何執行緒呼叫）。"""
+        data = json.dumps(message, separators=(',', ':')).encode('utf-8') + b'\n'
+        with self._send_lock:
+            self.events.write(data)
+            self.events.flush()
+
+    def read_commands(self):
+        """逐行產生 GUI 傳來的命令，連線關閉時結束。"""
+        for line in self.commands:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                message = json.loads(line.decode('utf-8'))
+            except ValueError:
+                logger.warning(f"Ignoring malformed command: {line[:200]!r}")
+                continue
+            if isinstance(message, dict):
+                yield message
+
+
+################################################################################
+# 執行緒預算
+################################################################################
+
+def apply_thread_budget(threads: Optional[int]) -> None:
+    """
+    限制 torch 和 OpenCV 使用的執行緒數。
+
+    參數：
+        threads: 執行緒數；None 或小於 1 表示維持函式庫預設值
+    """
+    if not threads or threads < 1:
+        return
+
+    cv2.setNumThreads(threads)
+    try:
+        import torch
+        if torch.get_num_threads() != threads:
+            torch.set_num_threads(threads)
+    except ImportError:
+        pass
+
+
+################################################################################
+# 工作程序
+################################################################################
+
+class AnalysisWorker:
+    """依序執行 GUI 提交的分析工作，並在工作之間保留已載入的模型。"""
+
+    def __init__(self, channel: WorkerChannel):
+        self.channel = channel
+        self.commands: "queue.Queue[Optional[Dict[str, Any]]]" = queue.Queue()
+
+        self.tracker: Optional[Tracker] = None
+        self.model_key: Optional[Tuple] = None
+
+        # 已收到但尚未結束的工作的控制（job_id -> JobControl），由讀取執行緒建立
+        self.controls: Dict[str, JobControl] = {}
+        self._controls_lock = threading.Lock()
+
+        # 在背景執行緒讀取命令，讓工作執行期間仍能接收訊息
+        self._reader = threading.Thread(target=self._read_commands, daemon=True)
+
+    def _read_commands(self) -> None:
+        try:
+            for message in self.channel.read_commands():
+                if not self._apply_control(message):
+                    self.commands.put(message)
+        except (OSError, ValueError) as e:
+            logger.warning(f"Command channel closed: {e}")
+        finally:
+            # None 表示 GUI 已斷線
+            self.commands.put(None)
+
+    def _apply_control(self, message: Dict[str, Any]) -> bool:
+        """
+        在讀取執行緒上處理控制命令；返回 True 表示命令已處理，不進入佇列。
+
+        工作命令在這裡就建立 JobControl，讓工作開始之前送達的取消也有效。
+        """
+        message_type = message.get('type')
+        job_id = message.get('job_id', '')
+        with self._controls_lock:
+            if message_type == 'job':
+                self.controls[job_id] = JobControl()
+                return False
+            if message_type == 'shutdown':
+                for control in self.controls.values():
+                    control.cancel()
+                return False
+            if message_type not in ('pause', 'resume', 'cancel'):
+                return False
+            control = self.controls.get(job_id)
+
+        if control is None:
+            logger.warning(f"Ignoring {message_type} for unknown job {job_id}")
+        elif message_type == 'cancel':
+            logger.info(f"Cancelling job {job_id}")
+            control.cancel()
+        elif message_type == 'pause' and not control.cancelled:
+            control.pause()
+            self.channel.send({'type': 'event', 'job_id': job_id, 'event': {'event': 'paused'}})
+        elif message_type == 'resume':
+            control.resume()
+            self.channel.send({'type': 'event', 'job_id': job_id, 'event': {'event': 'resumed'}})
+        return True
+
+    # =========================================================================
+    # 模型快取
+    # =========================================================================
+
+    @staticmethod
+    def _model_key(model_path: str, backend: str, int8: bool, batch_size: int) -> Tuple:
+        """
+        模型識別碼：絕對路徑加上修改時間和大小（檔案被覆寫時會重新載入），
+        以及偵測後端設定；onnx 後端另含執行緒數（session 建立後無法更改）。
+        """
+        path = os.path.abspath(model_path)
+        stat = os.stat(path)
+        threads = cv2.getNumThreads() if backend == 'onnx' else 0
+        return path, stat.st_mtime, stat.st_size, backend, int8, batch_size, threads
+
+    def _load_model(self, model_path: str, backend: str = 'ultralytics',
+                    int8: bool = False, batch_size: int = 20) -> Tracker:
+        """返回已載入指定模型的追蹤器；只有模型或後端設定改變時才重新載入。"""
+        key = self._model_key(model_path, backend, int8, batch_size)
+        if self.tracker is not None and key == self.model_key:
+            return self.tracker
+
+        logger.info(f"Loading model: {model_path} ({backend}{' INT8' if int8 else ''})")
+        start = time.monotonic()
+        self.tracker = None  # 先釋放舊模型
+        self.tracker = Tracker(model_path, backend=backend, int8=int8, batch_size=batch_size)
+        self.model_key = key
+        seconds = time.monotonic() - start
+        logger.info(f"Model loaded in {seconds:.2f}s")
+
+        self.channel.send({
+            'type': 'model_loaded',
+            'model': key[0],
+            'seconds': round(seconds, 3),
+        })
+        return self.tracker
+
+    # =========================================================================
+    # 命令處理
+    # =========================================================================
+
+    def serve_forever(self) -> None:
+        """處理命令直到 GUI 要求關閉或斷線。"""
+        self._reader.start()
+        self.channel.send({'type': 'ready'})
+
+        while True:
+            message = self.commands.get()
+            if message is None or message.get('type') == 'shutdown':
+                logger.info("Worker shutting down")
+                break
+
+            message_type = message.get('type')
+            if message_type == 'job':
+                self._run_job(message)
+            elif message_type == 'load_model':
+                self.preload_model(message.get('model', ''),
+                                   message.get('backend', 'ultralytics'),
+                                   bool(message.get('int8', False)))
+            else:
+                logger.warning(f"Unknown command type: {message_type}")
+
+    def preload_model(self, model_path: str, backend: str = 'ultralytics',
+                      int8: bool = False) -> None:
+        """在第一個工作之前載入模型（失敗只記錄，工作執行時會再回報）。"""
+        try:
+            self._load_model(model_path, backend, int8)
+        except Exception as e:
+            logger.error(f"Failed to preload model: {e}")
+
+    def _run_job(self, message: Dict[str, Any]) -> None:
+        job_id = message.get('job_id', '')
+
+        def send_event(event: Dict[str, Any]) -> None:
+            self.channel.send({'type': 'event', 'job_id': job_id, 'event': event})
+
+        with self._controls_lock:
+            control = self.controls.setdefault(job_id, JobControl())
+
+        try:
+            control.check()
+            logger.info(f"Starting job {job_id}: {message.get('input')}")
+            apply_thread_budget(message.get('threads'))
+            backend = message.get('backend', 'ultralytics')
+            int8 = bool(message.get('int8', False))
+            batch_size = int(message.get('batch_size', 20))
+            tracker = self._load_model(message['model'], backend, int8, batch_size)
+
+            pipeline = VideoAnalysisPipeline(
+                input_video_path=message['input'],
+                model_path=message['model'],
+                output_dir=message['output'],
+                use_stubs=message.get('use_cache', True),
+                streaming=message.get('streaming', False),
+                progress=ProgressReporter(enabled=True, sink=send_event, control=control),
+                tracker=tracker,
+                speed_window=int(message.get('speed_window', 5)),
+                speed_mode=message.get('speed_mode', 'window'),
+                camera_proxy_scale=float(message.get('camera_proxy_scale', 1.0)),
+                video_codec=message.get('video_codec', DEFAULT_VIDEO_CODEC),
+                detection_backend=backend,
+                int8=int8,
+                batch_size=batch_size,
+                keyframe_stride=int(message.get('keyframe_stride', 1)),
+                render_video=bool(message.get('render_video', True)),
+                threads=int(message.get('threads') or 0)
+            )
+            outputs = pipeline.run()
+
+            self.channel.send({
+                'type': 'result',
+                'job_id': job_id,
+                'status': 'ok',
+                'outputs': outputs,
+            })
+        except AnalysisCancelled:
+            logger.info(f"Job {job_id} cancelled")
+            self.channel.send({
+                'type': 'result',
+                'job_id': job_id,
+                'status': 'cancelled',
+            })
+        except Exception as e:
+            logger.exception(f"Job {job_id} failed: {e}")
+            self.channel.send({
+                'type': 'result',
+                'job_id': job_id,
+                'status': 'error',
+                'error': str(e),
+            })
+        finally:
+            with self._controls_lock:
+                self.controls.pop(job_id, None)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description='Football Analysis - Persistent analysis worker'
+    )
+    parser.add_argument(
+        '--server',
+        type=str,
+        required=True,
+        help='Full name of the GUI local server to connect to'
+    )
+    parser.add_argument(
+        '--model',
+        type=str,
+        default=None,
+        help='Model to load before the first job'
+    )
+    args = parser.parse_args()
+
+    try:
+        channel = WorkerChannel(args.server)
+    except OSError as e:
+        logger.error(f"Cannot connect to {args.server}: {e}")
+        return 1
+
+    worker = AnalysisWorker(channel)
+    if args.model:
+        worker.preload_model(args.model)
+
+    try:
+        worker.serve_forever()
+    except (BrokenPipeError, ConnectionError):
+        logger.warning("GUI disconnected")
+    except KeyboardInterrupt:
+        return 130
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -2,7 +2,8 @@
  * APPLICATION ENTRY POINT
  * 
  * This is the main entry point for the Football Analysis GUI application.
- * It initializes the Qt application framework and creates the main window.
+ * It initializes the Qt application framework and creates the main window,
+ * or runs a batch of analyses without a display (--batch).
  * 
  * EXECUTION FLOW:
  * 1. Initialize Qt application with command-line arguments
@@ -15,13 +16,93 @@
  * - Window operations (resize, close)
  * - Process signals from Python backend
  * - Timer events for progress updates
+ * 
+ * HEADLESS BATCH MODE:
+ *   FootAnalysisGUI --batch videos.txt [--model best.pt] [--concurrency 4]
+ *                   [--codec h264|mp4v|xvid|mjpg|none] [--backend ultralytics|onnx]
+ *                   [--int8] [--summary summary.json] [--verbose]
+ * runs on QCoreApplication (no display needed) with BatchRunner, which
+ * drives the same scheduler and worker pool as the GUI. The exit status is
+ * 0 when every video was analyzed (see BatchRunner.h for the others).
  ******************************************************************************/
 
 #include "MainWindow.h"
+#include "BatchRunner.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <cstring>
+
+/******************************************************************************
+ * Headless batch mode
+ ******************************************************************************/
+static int runBatch(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("FootAnalysisGUI");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Analyze the videos listed in a manifest (one path per line) without a display");
+    parser.addHelpOption();
+    const QCommandLineOption batchOption("batch", "Manifest listing the input videos", "manifest");
+    const QCommandLineOption modelOption("model", "YOLO model (default foot-Function/models/best.pt)", "path");
+    const QCommandLineOption concurrencyOption("concurrency", "Analyses run in parallel (default: from CPU cores and memory)", "n");
+    const QCommandLineOption codecOption("codec", "Output video codec: h264, mp4v, xvid, mjpg or none (default h264)", "name", "h264");
+    const QCommandLineOption backendOption("backend", "Detection backend: ultralytics or onnx (default ultralytics)", "name", "ultralytics");
+    const QCommandLineOption int8Option("int8", "Run the INT8-quantized ONNX model (with --backend onnx)");
+    const QCommandLineOption summaryOption("summary", "Summary JSON file (default <manifest>_summary.json)", "path");
+    const QCommandLineOption verboseOption("verbose", "Print the worker output");
+    parser.addOptions({batchOption, modelOption, concurrencyOption, codecOption, backendOption,
+                       int8Option, summaryOption, verboseOption});
+    
+    QTextStream err(stderr);
+    if (!parser.parse(app.arguments())) {
+        err << parser.errorText() << Qt::endl;
+        return BatchRunner::UsageError;
+    }
+    if (parser.isSet("help")) {
+        parser.showHelp(BatchRunner::Succeeded);
+    }
+    
+    const QStringList codecs = {"h264", "mp4v", "xvid", "mjpg", "none"};
+    const QStringList backends = {"ultralytics", "onnx"};
+    BatchRunner::Options options;
+    options.manifestPath = parser.value(batchOption);
+    options.modelPath = parser.value(modelOption);
+    options.summaryPath = parser.value(summaryOption);
+    options.videoCodec = parser.value(codecOption);
+    options.backend = parser.value(backendOption);
+    options.int8 = parser.isSet(int8Option);
+    options.verbose = parser.isSet(verboseOption);
+    bool valid = codecs.contains(options.videoCodec) && backends.contains(options.backend);
+    if (parser.isSet(concurrencyOption)) {
+        options.concurrency = parser.value(concurrencyOption).toInt();
+        valid = valid && options.concurrency > 0;
+    }
+    if (!valid) {
+        err << "Invalid --codec, --backend or --concurrency" << Qt::endl;
+        return BatchRunner::UsageError;
+    }
+    
+    BatchRunner runner(options);
+    QObject::connect(&runner, &BatchRunner::finished, &app, &QCoreApplication::exit);
+    if (!runner.start()) {
+        err << runner.errorString() << Qt::endl;
+        return BatchRunner::UsageError;
+    }
+    return app.exec();
+}
 
 int main(int argc, char *argv[])
 {
+    // --batch runs without a display, so it must not create a QApplication
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strncmp(argv[i], "--batch=", 8) == 0) {
+            return runBatch(argc, argv);
+        }
+    }
+    
     // Initialize Qt application framework
     QApplication app(argc, argv);
     